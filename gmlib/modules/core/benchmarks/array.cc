@@ -75,4 +75,4 @@ BENCHMARK(BM_Array_sort)
   ->Ranges({{1, 2 << 15}});
 
 
-BENCHMARK_MAIN()
+BENCHMARK_MAIN();
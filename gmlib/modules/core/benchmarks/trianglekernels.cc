@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+
+#include <fem/gmtrianglekernels.h>
+#include <types/gmpoint.h>
+using namespace GMlib;
+
+#include <vector>
+#include <random>
+#include <cmath>
+
+/*!
+ * \brief BM_LinearTriangle
+ * Stiffness matrices and load vectors of n linear triangles: per object with
+ * Point/Vector temporaries, per element on raw corners, and batched on SoA input.
+ */
+
+
+namespace {
+
+  std::vector<float> makeCorners( int n ) {
+
+    std::default_random_engine            generator;
+    std::uniform_real_distribution<float> distribution( -1.0f, 1.0f );
+
+    std::vector<float> xy( 6*n );
+    for( auto& v : xy ) v = distribution(generator);
+    return xy;
+  }
+
+}
+
+
+static void BM_LinearTriangle_perObject(benchmark::State& state)
+{
+  // Setup
+  const int n = int(state.range(0));
+
+  std::vector<Point<float,2>> p( 3*n );
+  const std::vector<float>    xy = makeCorners(n);
+  for (int e = 0; e < n; ++e)
+    for (int i = 0; i < 3; ++i)
+      p[3*e+i] = Point<float,2>( xy[2*i*n+e], xy[(2*i+1)*n+e] );
+
+  std::vector<float> ke( 9*n ), fe( 3*n );
+
+  // The test loop
+  while (state.KeepRunning()) {
+    for (int e = 0; e < n; ++e) {
+      Vector<Vector<float,2>,3> d;
+      for (int i = 0; i < 3; ++i) d[i] = p[3*e+(i+2)%3] - p[3*e+(i+1)%3];
+
+      const float a2 = std::abs( d[1] ^ d[2] );
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) ke[9*e+3*i+j] = ( d[i] * d[j] ) / ( 2 * a2 );
+        fe[3*e+i] = a2 / 6;
+      }
+    }
+    benchmark::DoNotOptimize( ke.data() );
+  }
+  state.SetItemsProcessed( state.iterations() * n );
+}
+BENCHMARK(BM_LinearTriangle_perObject)
+  ->Unit(benchmark::kMicrosecond)
+  ->RangeMultiplier(16)
+  ->Ranges({{1 << 10, 1 << 20}});
+
+
+static void BM_LinearTriangle_perElement(benchmark::State& state)
+{
+  // Setup, corners per element: x0 y0 x1 y1 x2 y2
+  const int n = int(state.range(0));
+
+  const std::vector<float> soa = makeCorners(n);
+  std::vector<float>       xy( 6*n );
+  for (int e = 0; e < n; ++e)
+    for (int c = 0; c < 6; ++c) xy[6*e+c] = soa[c*n+e];
+
+  std::vector<float> ke( 9*n ), fe( 3*n );
+
+  // The test loop
+  while (state.KeepRunning()) {
+    for (int e = 0; e < n; ++e) {
+      const float* c = &xy[6*e];
+      float dx[3], dy[3];
+      for (int i = 0; i < 3; ++i) {
+        dx[i] = c[2*((i+2)%3)]   - c[2*((i+1)%3)];
+        dy[i] = c[2*((i+2)%3)+1] - c[2*((i+1)%3)+1];
+      }
+
+      const float a2 = std::abs( dx[1]*dy[2] - dy[1]*dx[2] );
+      const float s  = 1.0f / ( 2 * a2 );
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) ke[9*e+3*i+j] = ( dx[i]*dx[j] + dy[i]*dy[j] ) * s;
+        fe[3*e+i] = a2 / 6;
+      }
+    }
+    benchmark::DoNotOptimize( ke.data() );
+  }
+  state.SetItemsProcessed( state.iterations() * n );
+}
+BENCHMARK(BM_LinearTriangle_perElement)
+  ->Unit(benchmark::kMicrosecond)
+  ->RangeMultiplier(16)
+  ->Ranges({{1 << 10, 1 << 20}});
+
+
+static void BM_LinearTriangle_batched(benchmark::State& state)
+{
+  // Setup
+  const int n = int(state.range(0));
+
+  const std::vector<float> xy = makeCorners(n);
+  std::vector<float>       ke( 9*n ), fe( 3*n );
+
+  // The test loop
+  while (state.KeepRunning()) {
+    linearTriangleElements( n, xy.data(), ke.data(), fe.data() );
+    benchmark::DoNotOptimize( ke.data() );
+  }
+  state.SetItemsProcessed( state.iterations() * n );
+}
+BENCHMARK(BM_LinearTriangle_batched)
+  ->Unit(benchmark::kMicrosecond)
+  ->RangeMultiplier(16)
+  ->Ranges({{1 << 10, 1 << 20}});
+
+
+BENCHMARK_MAIN();
@@ -128,7 +128,7 @@ namespace GMlib {
     for(int i=0; i<_no_ptrs; i++)
       if(_ptr[i].size > 0) {delete [] _ptr[i].ptr; _ptr[i].ptr=0x0; }
 
-    if(_no_ptrs > 0 && _ptr != 0x0) delete _ptr;
+    if(_no_ptrs > 0 && _ptr != 0x0) delete [] _ptr;
     _max_elements = _no_elements = _no_ptrs = _no1 = _no2 =0;
     _ptr = 0x0;
     if( inc >0 )	_size_incr = inc;
@@ -201,12 +201,9 @@ namespace GMlib {
   #endif
 
     if(_no_ptrs == 1)	return _ptr[0].ptr[i];
-    int j;
-    for(j=0; j<_no_ptrs; j++)
-      if(i < _ptr[j].size)	break;
-      else			i -= _ptr[j].size;
 
-    return _ptr[j].ptr[i];
+    const int j = _findRow(i);
+    return _ptr[j].ptr[i - _ptr[j].start];
   }
 
 
@@ -496,6 +493,7 @@ namespace GMlib {
       }
       newptr[i].ptr = new T[idx];
       newptr[i].size = idx;
+      newptr[i].start = _max_elements;
 
       if(_no_ptrs > 1) delete [] _ptr;
       _ptr = newptr;
@@ -596,6 +594,7 @@ namespace GMlib {
       LX_ptr<T>*  	newptr  = new LX_ptr<T>[1];
       newptr[0].ptr         = new T[_no_elements];
       newptr[0].size        = _no_elements;
+      newptr[0].start       = 0;
 
       // Copy elements
       for( int i = 0; i < _no_elements; i++ )
@@ -706,6 +705,7 @@ namespace GMlib {
 
 
     newptr[i].size = n;
+    newptr[i].start = _max_elements;
 
     if(_no_ptrs > 1) delete [] _ptr;
     _ptr = newptr;
@@ -714,6 +714,25 @@ namespace GMlib {
   }
 
 
+  /*! \brief The row holding element i
+   *
+   *  Binary search on the row start indices, so indexed access is
+   *  O(log rows) instead of a walk through all the rows.
+   */
+  template <typename T>
+  inline
+  int ArrayLX<T>::_findRow( int i ) const {
+
+    int lo = 0, hi = _no_ptrs - 1;
+    while( lo < hi ) {
+      const int mid = ( lo + hi + 1 ) / 2;
+      if( _ptr[mid].start <= i )  lo = mid;
+      else                        hi = mid - 1;
+    }
+    return lo;
+  }
+
+
   /*! \brief Returns a referance to the given element at index i
    *
    *   Returns a referance to the given element at index i
@@ -730,12 +749,9 @@ namespace GMlib {
   #endif
 
     if(_no_ptrs == 1)	return _ptr[0].ptr[i];
-    int j;
-    for(j=0; j<_no_ptrs; j++)
-      if(i < _ptr[j].size)	break;
-      else			i -= _ptr[j].size;
 
-    return _ptr[j].ptr[i];
+    const int j = _findRow(i);
+    return _ptr[j].ptr[i - _ptr[j].start];
   }
 
 
@@ -755,12 +771,8 @@ namespace GMlib {
   #endif
     if(_no_ptrs == 1)	return _ptr[0].ptr[i];
 
-    int j;
-    for(j=0; j<_no_ptrs; j++)
-      if(i < _ptr[j].size)	break;
-      else			i -= _ptr[j].size;
-
-    return _ptr[j].ptr[i];
+    const int j = _findRow(i);
+    return _ptr[j].ptr[i - _ptr[j].start];
   }
 
 
@@ -43,6 +43,7 @@ namespace GMlib{
   struct LX_ptr {
     T     *ptr;
     int   size;
+    int   start;    // Index of the first element in the row
   };
 
 
@@ -114,6 +115,7 @@ namespace GMlib{
     int           _size_incr;
 
 
+    int           _findRow( int i ) const;
     void          _indexDecr();
     void          _indexIncr();
     void          _newRow( int size, T* ptr = 0x0 );
@@ -0,0 +1,283 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+// STL includes
+#include <algorithm>
+
+
+namespace GMlib {
+
+
+  /*! \brief Assembler for elements with k nodes */
+  template <typename T>
+  inline
+  SparseAssembler<T>::SparseAssembler( int k ) : _k(k), _ne(0) {}
+
+
+  /*! \brief Sum the element buffers into the matrix and the vector
+   *
+   *  Each value is owned by exactly one iteration, so the loops run in
+   *  parallel without synchronization.
+   */
+  template <typename T>
+  void SparseAssembler<T>::assemble() {
+
+    const int *mp   = _mp.getPtr();
+    const int *msrc = _msrc.getPtr();
+    const T   *ke   = _ke.getPtr();
+    T         *av   = _a.getValues().getPtr();
+    const int  nnz  = _a.getNoNonZeros();
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int s = 0; s < nnz; s++ ) {
+      T v = T(0);
+      for( int p = mp[s]; p < mp[s+1]; p++ ) v += ke[msrc[p]];
+      av[s] = v;
+    }
+
+    const int *vp   = _vp.getPtr();
+    const int *vsrc = _vsrc.getPtr();
+    const T   *fe   = _fe.getPtr();
+    T         *bv   = _b.getPtr();
+    const int  n    = _b.getDim();
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int i = 0; i < n; i++ ) {
+      T v = T(0);
+      for( int p = vp[i]; p < vp[i+1]; p++ ) v += fe[vsrc[p]];
+      bv[i] = v;
+    }
+  }
+
+
+  /*! \brief Sum the element matrices ke into a
+   *
+   *  ke has the layout of the element matrix buffer, k x k values per
+   *  element. a gets the pattern of getMatrix() if it does not have it,
+   *  a renumbered mesh has the same size but not the same pattern.
+   */
+  template <typename T>
+  void SparseAssembler<T>::assemble( const DVector<T>& ke, SparseMatrix<T>& a ) const {
+
+    const DVector<int> &r = _a.getRowStart(), &c = _a.getColumns();
+    if( a.getDim() != _a.getDim() || a.getNoNonZeros() != _a.getNoNonZeros() ||
+        !std::equal( r.getPtr(), r.getPtr() + r.getDim(), a.getRowStart().getPtr() ) ||
+        !std::equal( c.getPtr(), c.getPtr() + c.getDim(), a.getColumns().getPtr() ) )
+      a = _a;
+
+    const int *mp   = _mp.getPtr();
+    const int *msrc = _msrc.getPtr();
+    const T   *kp   = ke.getPtr();
+    T         *av   = a.getValues().getPtr();
+    const int  nnz  = a.getNoNonZeros();
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int s = 0; s < nnz; s++ ) {
+      T v = T(0);
+      for( int p = mp[s]; p < mp[s+1]; p++ ) v += kp[msrc[p]];
+      av[s] = v;
+    }
+  }
+
+
+  /*! \brief The k x k matrix of element e, row major */
+  template <typename T>
+  inline
+  T* SparseAssembler<T>::getElementMatrix( int e ) {
+
+    return _ke.getPtr() + e*_k*_k;
+  }
+
+
+  /*! \brief The k vector of element e */
+  template <typename T>
+  inline
+  T* SparseAssembler<T>::getElementVector( int e ) {
+
+    return _fe.getPtr() + e*_k;
+  }
+
+
+  template <typename T>
+  inline
+  const DVector<int>& SparseAssembler<T>::getElements() const {
+
+    return _elem;
+  }
+
+
+  template <typename T>
+  inline
+  SparseMatrix<T>& SparseAssembler<T>::getMatrix() {
+
+    return _a;
+  }
+
+
+  template <typename T>
+  inline
+  int SparseAssembler<T>::getNoElements() const {
+
+    return _ne;
+  }
+
+
+  template <typename T>
+  inline
+  int SparseAssembler<T>::getNoNodesPerElement() const {
+
+    return _k;
+  }
+
+
+  template <typename T>
+  inline
+  DVector<T>& SparseAssembler<T>::getVector() {
+
+    return _b;
+  }
+
+
+  /*! \brief Subtract the coupling to the prescribed values from b
+   *
+   *  b -= A_ud g, where A_ud are the element matrix entries of the last
+   *  assemble() with an unknown row and a prescribed column. Node index
+   *  -1-d has the value g(d). One pass over the coupling entries, parallel
+   *  over the unknowns like assemble().
+   *
+   *  \param[in]     g Prescribed values
+   *  \param[in,out] b Right hand side, one value per unknown
+   */
+  template <typename T>
+  void SparseAssembler<T>::lift( const DVector<T>& g, DVector<T>& b ) const {
+
+    const int *lp   = _lp.getPtr();
+    const int *lsrc = _lsrc.getPtr();
+    const int *lval = _lval.getPtr();
+    const T   *ke   = _ke.getPtr();
+    const T   *gv   = g.getPtr();
+    T         *bv   = b.getPtr();
+    const int  n    = std::min( b.getDim(), _lp.getDim()-1 );
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int i = 0; i < n; i++ ) {
+      T v = T(0);
+      for( int p = lp[i]; p < lp[i+1]; p++ ) v += ke[lsrc[p]] * gv[lval[p]];
+      bv[i] -= v;
+    }
+  }
+
+
+  /*! \brief Build the pattern and the reduction maps
+   *
+   *  \param[in] n        Number of unknowns
+   *  \param[in] elements k node indices per element, negative if not an
+   *                      unknown: -1-d for prescribed value d
+   */
+  template <typename T>
+  void SparseAssembler<T>::setElements( int n, const DVector<int>& elements ) {
+
+    const int k = _k;
+    _ne   = elements.getDim() / k;
+    _elem = elements;
+
+    // Pattern from all node pairs of every element
+    DVector<int> ei( _ne*k*(k-1)/2 ), ej( _ne*k*(k-1)/2 );
+    int m = 0;
+    for( int e = 0; e < _ne; e++ ) {
+      const int *el = _elem.getPtr() + e*k;
+      for( int a = 0; a < k; a++ )
+        for( int b = a+1; b < k; b++ )
+          if( el[a] >= 0 && el[b] >= 0 ) {
+            ei[m] = el[a];
+            ej[m] = el[b];
+            m++;
+          }
+    }
+    ei.setDim( m );
+    ej.setDim( m );
+    _a.setPattern( n, ei, ej );
+
+    _b.setDim( n );
+    _b.clear();
+
+    _ke.setDim( _ne*k*k );
+    _ke.clear();
+    _fe.setDim( _ne*k );
+    _fe.clear();
+
+    // Destination of every buffer entry, and the unknown of the entries
+    // coupling to a prescribed value
+    DVector<int> mdst( _ne*k*k ), vdst( _ne*k ), ldst( _ne*k*k );
+    for( int e = 0; e < _ne; e++ ) {
+      const int *el = _elem.getPtr() + e*k;
+      for( int a = 0; a < k; a++ ) {
+        vdst[e*k+a] = el[a];
+        for( int b = 0; b < k; b++ ) {
+          mdst[(e*k+a)*k+b] = ( el[a] >= 0 && el[b] >= 0 ) ? _a.getIndex( el[a], el[b] ) : -1;
+          ldst[(e*k+a)*k+b] = ( el[a] >= 0 && el[b] <  0 ) ? el[a] : -1;
+        }
+      }
+    }
+
+    _transpose( mdst, _a.getNoNonZeros(), _mp, _msrc );
+    _transpose( vdst, n, _vp, _vsrc );
+    _transpose( ldst, n, _lp, _lsrc );
+
+    _lval.setDim( _lsrc.getDim() );
+    for( int p = 0; p < _lsrc.getDim(); p++ )
+      _lval[p] = -1 - _elem( _lsrc(p) / (k*k) * k + _lsrc(p) % k );
+  }
+
+
+  /*! \brief Invert a many-to-one map
+   *
+   *  For destination d, src[p[d]..p[d+1]) are the positions i with dst[i] == d.
+   */
+  template <typename T>
+  void SparseAssembler<T>::_transpose( const DVector<int>& dst, int n, DVector<int>& p, DVector<int>& src ) {
+
+    p.setDim( n+1 );
+    p.clear();
+    for( int i = 0; i < dst.getDim(); i++ )
+      if( dst(i) >= 0 ) p[dst(i)+1]++;
+    for( int d = 0; d < n; d++ ) p[d+1] += p[d];
+
+    src.setDim( p[n] );
+    DVector<int> pos( n );
+    for( int d = 0; d < n; d++ ) pos[d] = p[d];
+    for( int i = 0; i < dst.getDim(); i++ )
+      if( dst(i) >= 0 ) src[pos[dst(i)]++] = i;
+  }
+
+
+} // END namespace GMlib
@@ -0,0 +1,121 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+/*! \file gmsparseassembler.h
+ *
+ *  Interface for the Sparse Assembler class.
+ */
+
+
+#ifndef GM_CORE_CONTAINERS_SPARSEASSEMBLER_H
+#define GM_CORE_CONTAINERS_SPARSEASSEMBLER_H
+
+
+
+// GMlib includes
+#include "gmdvector.h"
+#include "gmsparsematrix.h"
+
+
+namespace GMlib {
+
+
+  /*! \class SparseAssembler gmsparseassembler.h <gmSparseAssembler>
+   *  \brief Element by element assembly of a sparse matrix and a vector.
+   *
+   *  Every element has k nodes, given as indices into the global unknowns
+   *  (a negative index means the node is not an unknown, e.g. a boundary
+   *  node). setElements() builds the matrix pattern and, for every stored
+   *  value, the list of element matrix entries that add up to it.
+   *
+   *  A node that is not an unknown has a prescribed value: index -1-d is
+   *  value d of the vector given to lift(), which moves the coupling to
+   *  these values over to the right hand side (Dirichlet lifting). The
+   *  matrix does not depend on the values, so new ones only need a new
+   *  right hand side.
+   *
+   *  The element matrices (k x k, row major) and element vectors are
+   *  written into flat buffers, independently for each element, so they
+   *  can be computed in parallel. assemble() then reduces the buffers by
+   *  gathering per matrix row, which needs neither atomics nor colouring.
+   *  Other element matrices on the same elements, e.g. a mass matrix next
+   *  to the stiffness matrix, are reduced the same way into their own
+   *  matrix with the same pattern.
+   */
+  template <typename T>
+  class SparseAssembler {
+  public:
+    SparseAssembler( int k = 3 );
+
+    void                  assemble();
+    void                  assemble( const DVector<T>& ke, SparseMatrix<T>& a ) const;
+    T*                    getElementMatrix( int e );
+    T*                    getElementVector( int e );
+    const DVector<int>&   getElements() const;
+    SparseMatrix<T>&      getMatrix();
+    int                   getNoElements() const;
+    int                   getNoNodesPerElement() const;
+    DVector<T>&           getVector();
+    void                  lift( const DVector<T>& g, DVector<T>& b ) const;
+    void                  setElements( int n, const DVector<int>& elements );
+
+  private:
+    int                   _k;
+    int                   _ne;
+    DVector<int>          _elem;
+
+    SparseMatrix<T>       _a;
+    DVector<T>            _b;
+
+    DVector<T>            _ke;    // Element matrices
+    DVector<T>            _fe;    // Element vectors
+
+    // For every matrix value / vector entry, the buffer positions summed into it
+    DVector<int>          _mp;
+    DVector<int>          _msrc;
+    DVector<int>          _vp;
+    DVector<int>          _vsrc;
+
+    // For every unknown, the element matrix entries coupling it to a
+    // prescribed value, and the index of that value
+    DVector<int>          _lp;
+    DVector<int>          _lsrc;
+    DVector<int>          _lval;
+
+    static void           _transpose( const DVector<int>& dst, int n, DVector<int>& p, DVector<int>& src );
+
+  }; // END class SparseAssembler
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmsparseassembler.c"
+
+
+
+
+#endif // GM_CORE_CONTAINERS_SPARSEASSEMBLER_H
@@ -0,0 +1,310 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+#include <algorithm>
+
+
+
+namespace GMlib {
+
+
+  /*! \brief Diagonal pattern of dimension n */
+  template <typename T>
+  inline
+  SparseMatrix<T>::SparseMatrix( int n ) {
+
+    setPattern( n, DVector<int>(), DVector<int>() );
+  }
+
+
+  /*! \brief Symmetric pattern from index pairs
+   *
+   *  \param[in] n  Dimension
+   *  \param[in] ei First index of each pair
+   *  \param[in] ej Second index of each pair
+   */
+  template <typename T>
+  inline
+  SparseMatrix<T>::SparseMatrix( int n, const DVector<int>& ei, const DVector<int>& ej ) {
+
+    setPattern( n, ei, ej );
+  }
+
+
+  template <typename T>
+  inline
+  SparseMatrix<T>::SparseMatrix( const SparseMatrix<T>& m )
+    : _n(m._n), _row(m._row), _col(m._col), _val(m._val) {}
+
+
+  /*! \brief Add val to the element (i,j)
+   *
+   *  The element must be part of the pattern, otherwise the call is ignored.
+   */
+  template <typename T>
+  inline
+  void SparseMatrix<T>::add( int i, int j, T val ) {
+
+    const int k = getIndex( i, j );
+    if( k >= 0 ) _val[k] += val;
+  }
+
+
+  /*! \brief Set all stored values to val, the pattern is kept */
+  template <typename T>
+  inline
+  void SparseMatrix<T>::clear( T val ) {
+
+    _val.clear( val );
+  }
+
+
+  template <typename T>
+  inline
+  int SparseMatrix<T>::getDim() const {
+
+    return _n;
+  }
+
+
+  template <typename T>
+  inline
+  DVector<T> SparseMatrix<T>::getDiagonal() const {
+
+    DVector<T> d(_n);
+    for( int i = 0; i < _n; i++ ) d[i] = _val( getIndex( i, i ) );
+    return d;
+  }
+
+
+  /*! \brief Position of (i,j) in the value array, -1 if not in the pattern
+   *
+   *  Binary search within row i.
+   */
+  template <typename T>
+  inline
+  int SparseMatrix<T>::getIndex( int i, int j ) const {
+
+    const int *c  = _col.getPtr();
+    const int *b  = c + _row(i);
+    const int *e  = c + _row(i+1);
+    const int *it = std::lower_bound( b, e, j );
+    return ( it != e && *it == j ) ? int(it - c) : -1;
+  }
+
+
+  template <typename T>
+  inline
+  int SparseMatrix<T>::getNoNonZeros() const {
+
+    return _col.getDim();
+  }
+
+
+  template <typename T>
+  inline
+  const DVector<int>& SparseMatrix<T>::getColumns() const {
+
+    return _col;
+  }
+
+
+  template <typename T>
+  inline
+  const DVector<int>& SparseMatrix<T>::getRowStart() const {
+
+    return _row;
+  }
+
+
+  template <typename T>
+  inline
+  DVector<T>& SparseMatrix<T>::getValues() {
+
+    return _val;
+  }
+
+
+  template <typename T>
+  inline
+  const DVector<T>& SparseMatrix<T>::getValues() const {
+
+    return _val;
+  }
+
+
+  /*! \brief Whether the row start and column index arrays equal row and col
+   *
+   *  Matrices of the same size and number of non-zeros can still have
+   *  different patterns, a solver that combines values index by index must
+   *  compare the arrays themselves.
+   */
+  template <typename T>
+  inline
+  bool SparseMatrix<T>::hasPattern( const DVector<int>& row, const DVector<int>& col ) const {
+
+    if( row.getDim() != _row.getDim() || col.getDim() != _col.getDim() )
+      return false;
+
+    return std::equal( _row.getPtr(), _row.getPtr() + _row.getDim(), row.getPtr() ) &&
+           std::equal( _col.getPtr(), _col.getPtr() + _col.getDim(), col.getPtr() );
+  }
+
+
+  /*! \brief y = A x */
+  template <typename T>
+  inline
+  void SparseMatrix<T>::multiply( const DVector<T>& x, DVector<T>& y ) const {
+
+    y.setDim( _n );
+
+    const int *r = _row.getPtr();
+    const int *c = _col.getPtr();
+    const T   *v = _val.getPtr();
+    const T   *p = x.getPtr();
+    T         *q = y.getPtr();
+
+    for( int i = 0; i < _n; i++ ) {
+      T s = T(0);
+      for( int k = r[i]; k < r[i+1]; k++ ) s += v[k] * p[c[k]];
+      q[i] = s;
+    }
+  }
+
+
+  /*! \brief Build the symbolic pattern
+   *
+   *  Every pair (i,j) makes both (i,j) and (j,i) part of the pattern, the
+   *  diagonal is always included. Duplicated pairs are merged. All values
+   *  are set to zero.
+   *
+   *  \param[in] n  Dimension
+   *  \param[in] ei First index of each pair
+   *  \param[in] ej Second index of each pair
+   */
+  template <typename T>
+  void SparseMatrix<T>::setPattern( int n, const DVector<int>& ei, const DVector<int>& ej ) {
+
+    _n = n;
+    const int m = std::min( ei.getDim(), ej.getDim() );
+
+    // Count entries per row, including duplicates
+    DVector<int> cnt( n, 1 );
+    for( int k = 0; k < m; k++ ) {
+      if( ei(k) == ej(k) ) continue;
+      cnt[ei(k)]++;
+      cnt[ej(k)]++;
+    }
+
+    DVector<int> row( n+1 );
+    row[0] = 0;
+    for( int i = 0; i < n; i++ ) row[i+1] = row[i] + cnt[i];
+
+    // Scatter columns
+    DVector<int> col( row[n] );
+    for( int i = 0; i < n; i++ ) {
+      cnt[i] = row[i];
+      col[cnt[i]++] = i;
+    }
+    for( int k = 0; k < m; k++ ) {
+      const int i = ei(k), j = ej(k);
+      if( i == j ) continue;
+      col[cnt[i]++] = j;
+      col[cnt[j]++] = i;
+    }
+
+    // Sort each row and remove duplicates
+    _row.setDim( n+1 );
+    _row[0] = 0;
+    int nz = 0;
+    for( int i = 0; i < n; i++ ) {
+      int *b = col.getPtr() + row[i];
+      int *e = col.getPtr() + row[i+1];
+      std::sort( b, e );
+      e = std::unique( b, e );
+      for( int *it = b; it != e; ++it ) col[nz++] = *it;
+      _row[i+1] = nz;
+    }
+
+    _col.setDim( nz );
+    for( int k = 0; k < nz; k++ ) _col[k] = col[k];
+
+    _val.setDim( nz );
+    _val.clear();
+  }
+
+
+  template <typename T>
+  DMatrix<T> SparseMatrix<T>::toDMatrix() const {
+
+    DMatrix<T> a( _n, _n, T(0) );
+    for( int i = 0; i < _n; i++ )
+      for( int k = _row(i); k < _row(i+1); k++ )
+        a[i][_col(k)] = _val(k);
+    return a;
+  }
+
+
+  template <typename T>
+  inline
+  SparseMatrix<T>& SparseMatrix<T>::operator = ( const SparseMatrix<T>& m ) {
+
+    _n   = m._n;
+    _row = m._row;
+    _col = m._col;
+    _val = m._val;
+    return *this;
+  }
+
+
+  template <typename T>
+  inline
+  SparseMatrix<T>& SparseMatrix<T>::operator *= ( double d ) {
+
+    _val *= d;
+    return *this;
+  }
+
+
+  template <typename T>
+  inline
+  DVector<T> SparseMatrix<T>::operator * ( const DVector<T>& x ) const {
+
+    DVector<T> y( _n );
+    multiply( x, y );
+    return y;
+  }
+
+
+  /*! \brief Element (i,j), zero if not in the pattern */
+  template <typename T>
+  inline
+  T SparseMatrix<T>::operator () ( int i, int j ) const {
+
+    const int k = getIndex( i, j );
+    return k < 0 ? T(0) : _val(k);
+  }
+
+
+} // END namespace GMlib
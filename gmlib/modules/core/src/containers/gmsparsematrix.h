@@ -0,0 +1,118 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+/*! \file gmsparsematrix.h
+ *
+ *  Interface for the Sparse Matrix class.
+ */
+
+
+#ifndef GM_CORE_CONTAINERS_SPARSEMATRIX_H
+#define GM_CORE_CONTAINERS_SPARSEMATRIX_H
+
+
+
+// GMlib includes
+#include "gmdvector.h"
+#include "gmdmatrix.h"
+
+
+namespace GMlib {
+
+
+  /*! \class SparseMatrix gmsparsematrix.h <gmSparseMatrix>
+   *  \brief Square sparse matrix in compressed row storage (CSR).
+   *
+   *  The non-zero pattern is built once (symbolic phase) from a list of
+   *  index pairs, typically the edges of a mesh. The pattern is symmetric
+   *  and always contains the diagonal. After that the values can be
+   *  cleared and re-assembled as often as needed without reallocating.
+   */
+  template <typename T>
+  class SparseMatrix {
+  public:
+    SparseMatrix( int n = 0 );
+    SparseMatrix( int n, const DVector<int>& ei, const DVector<int>& ej );
+    SparseMatrix( const SparseMatrix<T>& m );
+
+    void                  add( int i, int j, T val );
+    void                  clear( T val = T(0) );
+    int                   getDim() const;
+    DVector<T>            getDiagonal() const;
+    int                   getIndex( int i, int j ) const;
+    int                   getNoNonZeros() const;
+    const DVector<int>&   getColumns() const;
+    const DVector<int>&   getRowStart() const;
+    DVector<T>&           getValues();
+    const DVector<T>&     getValues() const;
+    bool                  hasPattern( const DVector<int>& row, const DVector<int>& col ) const;
+    void                  multiply( const DVector<T>& x, DVector<T>& y ) const;
+    void                  setPattern( int n, const DVector<int>& ei, const DVector<int>& ej );
+    DMatrix<T>            toDMatrix() const;
+
+    SparseMatrix<T>&      operator =  ( const SparseMatrix<T>& m );
+    SparseMatrix<T>&      operator *= ( double d );
+    DVector<T>            operator *  ( const DVector<T>& x ) const;
+    T                     operator () ( int i, int j ) const;
+
+  private:
+    int                   _n;
+    DVector<int>          _row;   // Row start, size _n+1
+    DVector<int>          _col;   // Column index of each stored value, sorted per row
+    DVector<T>            _val;   // Stored values
+
+  }; // END class SparseMatrix
+
+
+
+  #ifdef GM_STREAM
+
+  // *****************************
+  // IOSTREAM overloaded operators
+
+  template <typename T_Stream, typename T>
+  T_Stream& operator << ( T_Stream& out, const SparseMatrix<T>& m ) {
+
+    out << m.getDim() << GMseparator::element() << m.getNoNonZeros() << GMseparator::group();
+    for( int i = 0; i < m.getDim(); i++ ) {
+      for( int k = m.getRowStart()(i); k < m.getRowStart()(i+1); k++ )
+        out << m.getColumns()(k) << GMseparator::element() << m.getValues()(k) << GMseparator::element();
+      out << GMseparator::group();
+    }
+    return out;
+  }
+
+  #endif
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmsparsematrix.c"
+
+
+
+
+#endif // GM_CORE_CONTAINERS_SPARSEMATRIX_H
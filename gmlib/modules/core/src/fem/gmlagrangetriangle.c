@@ -0,0 +1,297 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+// STL includes
+#include <cmath>
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  inline
+  TriangleAffineMap<T>::TriangleAffineMap( const Point<T,2>& p0, const Point<T,2>& p1, const Point<T,2>& p2 )
+    : _p0(p0), _e1(p1 - p0), _e2(p2 - p0) {
+
+    _det = _e1[0]*_e2[1] - _e1[1]*_e2[0];
+  }
+
+
+  /*! \brief det J, twice the signed area */
+  template <typename T>
+  inline
+  T TriangleAffineMap<T>::getDeterminant() const {
+
+    return _det;
+  }
+
+
+  /*! \brief |det J| J^-1 J^-T as (g00, g01, g11)
+   *
+   *  The stiffness matrix of the triangle is g00 Sxx + g01 (Sxy + Syx) +
+   *  g11 Syy in terms of the reference tables.
+   */
+  template <typename T>
+  inline
+  Vector<T,3> TriangleAffineMap<T>::getMetric() const {
+
+    const T s = T(1) / std::abs( _det );
+    return Vector<T,3>( s * (_e2 * _e2), -s * (_e1 * _e2), s * (_e1 * _e1) );
+  }
+
+
+  template <typename T>
+  inline
+  Point<T,2> TriangleAffineMap<T>::map( const Point<T,2>& x ) const {
+
+    return _p0 + x[0] * _e1 + x[1] * _e2;
+  }
+
+
+  /*! \brief J^-T g, a reference gradient to the gradient on the triangle */
+  template <typename T>
+  inline
+  Vector<T,2> TriangleAffineMap<T>::mapGradient( const Vector<T,2>& g ) const {
+
+    return Vector<T,2>( _e2[1]*g[0] - _e1[1]*g[1], _e1[0]*g[1] - _e2[0]*g[0] ) / _det;
+  }
+
+
+
+
+  template <typename T, int p>
+  LagrangeTriangle<T,p>::LagrangeTriangle() {
+
+    const int m = Quadrature::N;
+
+    for( int k = 0; k < m; k++ ) {
+      _phi[k]  = eval( _q.getPoint(k) );
+      _dphi[k] = evalDerivatives( _q.getPoint(k) );
+    }
+
+    for( int i = 0; i < N; i++ ) {
+      _load[i] = T(0);
+      for( int j = 0; j < N; j++ ) {
+        _mass[i][j] = T(0);
+        for( int t = 0; t < 3; t++ ) _s[t][i][j] = T(0);
+      }
+    }
+
+    for( int k = 0; k < m; k++ ) {
+      const T w = _q.getWeight(k);
+      for( int i = 0; i < N; i++ ) {
+        _load[i] += w * _phi[k][i];
+        for( int j = 0; j < N; j++ ) {
+          const Vector<T,2>& a = _dphi[k][i];
+          const Vector<T,2>& b = _dphi[k][j];
+          _mass[i][j] += w * _phi[k][i] * _phi[k][j];
+          _s[0][i][j] += w * a[0] * b[0];
+          _s[1][i][j] += w * ( a[0] * b[1] + a[1] * b[0] );
+          _s[2][i][j] += w * a[1] * b[1];
+        }
+      }
+    }
+  }
+
+
+  /*! \brief Shape function values at x on the reference triangle */
+  template <typename T, int p>
+  Vector<T,LagrangeTriangle<T,p>::N> LagrangeTriangle<T,p>::eval( const Point<T,2>& x ) {
+
+    const T l[3] = { T(1) - x[0] - x[1], x[0], x[1] };
+
+    Vector<T,N> v;
+    for( int i = 0; i < N; i++ ) {
+      const Vector<int,3> a = getIndex(i);
+      T d;
+      v[i] = _factor( a[0], l[0], d ) * _factor( a[1], l[1], d ) * _factor( a[2], l[2], d );
+    }
+    return v;
+  }
+
+
+  /*! \brief Shape function derivatives d/dxi and d/deta at x on the reference triangle */
+  template <typename T, int p>
+  Vector<Vector<T,2>,LagrangeTriangle<T,p>::N> LagrangeTriangle<T,p>::evalDerivatives( const Point<T,2>& x ) {
+
+    const T l[3] = { T(1) - x[0] - x[1], x[0], x[1] };
+
+    Vector<Vector<T,2>,N> v;
+    for( int i = 0; i < N; i++ ) {
+      const Vector<int,3> a = getIndex(i);
+      T f[3], d[3];
+      for( int j = 0; j < 3; j++ ) f[j] = _factor( a[j], l[j], d[j] );
+
+      // Gradients of the barycentric coordinates are (-1,-1), (1,0), (0,1)
+      const T g0 = d[0] * f[1] * f[2];
+      const T g1 = f[0] * d[1] * f[2];
+      const T g2 = f[0] * f[1] * d[2];
+      v[i] = Vector<T,2>( g1 - g0, g2 - g0 );
+    }
+    return v;
+  }
+
+
+  /*! \brief Load vector of the triangle, int phi_i */
+  template <typename T, int p>
+  inline
+  void LagrangeTriangle<T,p>::elementLoad( const Point<T,2>& p0, const Point<T,2>& p1, const Point<T,2>& p2, T* fe ) const {
+
+    const T s = std::abs( TriangleAffineMap<T>( p0, p1, p2 ).getDeterminant() );
+    for( int i = 0; i < N; i++ )
+      fe[i] = s * _load(i);
+  }
+
+
+  /*! \brief Consistent mass matrix of the triangle, N x N row major */
+  template <typename T, int p>
+  inline
+  void LagrangeTriangle<T,p>::elementMass( const Point<T,2>& p0, const Point<T,2>& p1, const Point<T,2>& p2, T* me ) const {
+
+    const T s = std::abs( TriangleAffineMap<T>( p0, p1, p2 ).getDeterminant() );
+    for( int i = 0; i < N; i++ )
+      for( int j = 0; j < N; j++ )
+        me[N*i+j] = s * _mass(i)(j);
+  }
+
+
+  /*! \brief Stiffness matrix of the triangle, int grad phi_i . grad phi_j, N x N row major */
+  template <typename T, int p>
+  inline
+  void LagrangeTriangle<T,p>::elementStiffness( const Point<T,2>& p0, const Point<T,2>& p1, const Point<T,2>& p2, T* ke ) const {
+
+    const Vector<T,3> g = TriangleAffineMap<T>( p0, p1, p2 ).getMetric();
+    for( int i = 0; i < N; i++ )
+      for( int j = 0; j < N; j++ )
+        ke[N*i+j] = g[0] * _s[0](i)(j) + g[1] * _s[1](i)(j) + g[2] * _s[2](i)(j);
+  }
+
+
+  /*! \brief Derivatives at the quadrature points, [point][function] */
+  template <typename T, int p>
+  inline
+  const Vector<Vector<Vector<T,2>,LagrangeTriangle<T,p>::N>,LagrangeTriangle<T,p>::Quadrature::N>&
+  LagrangeTriangle<T,p>::getDerivatives() const {
+
+    return _dphi;
+  }
+
+
+  /*! \brief Barycentric multi-index (a,b,c), a+b+c = p, of node i */
+  template <typename T, int p>
+  Vector<int,3> LagrangeTriangle<T,p>::getIndex( int i ) {
+
+    if( i < 3 )
+      return Vector<int,3>( i == 0 ? p : 0, i == 1 ? p : 0, i == 2 ? p : 0 );
+
+    i -= 3;
+    if( i < 3*(p-1) ) {
+      const int e = i / (p-1), k = i % (p-1) + 1;
+      Vector<int,3> a( 0, 0, 0 );
+      a[e]       = p - k;
+      a[(e+1)%3] = k;
+      return a;
+    }
+
+    // Interior nodes, row by row
+    i -= 3*(p-1);
+    for( int b = 1; b < p-1; b++ )
+      for( int c = 1; b + c < p; c++ )
+        if( i-- == 0 ) return Vector<int,3>( p - b - c, b, c );
+
+    return Vector<int,3>( p, 0, 0 );
+  }
+
+
+  /*! \brief The reference load vector, int phi_i */
+  template <typename T, int p>
+  inline
+  const Vector<T,LagrangeTriangle<T,p>::N>& LagrangeTriangle<T,p>::getLoad() const {
+
+    return _load;
+  }
+
+
+  /*! \brief The reference mass matrix, int phi_i phi_j */
+  template <typename T, int p>
+  inline
+  const Matrix<T,LagrangeTriangle<T,p>::N,LagrangeTriangle<T,p>::N>& LagrangeTriangle<T,p>::getMass() const {
+
+    return _mass;
+  }
+
+
+  template <typename T, int p>
+  inline
+  Point<T,2> LagrangeTriangle<T,p>::getNode( int i ) {
+
+    const Vector<int,3> a = getIndex(i);
+    return Point<T,2>( T(a[1]) / p, T(a[2]) / p );
+  }
+
+
+  template <typename T, int p>
+  inline
+  const typename LagrangeTriangle<T,p>::Quadrature& LagrangeTriangle<T,p>::getQuadrature() const {
+
+    return _q;
+  }
+
+
+  /*! \brief Reference stiffness table k: 0 xx, 1 xy + yx, 2 yy */
+  template <typename T, int p>
+  inline
+  const Matrix<T,LagrangeTriangle<T,p>::N,LagrangeTriangle<T,p>::N>& LagrangeTriangle<T,p>::getStiffness( int k ) const {
+
+    return _s[k];
+  }
+
+
+  /*! \brief Values at the quadrature points, [point][function] */
+  template <typename T, int p>
+  inline
+  const Vector<Vector<T,LagrangeTriangle<T,p>::N>,LagrangeTriangle<T,p>::Quadrature::N>&
+  LagrangeTriangle<T,p>::getValues() const {
+
+    return _phi;
+  }
+
+
+  /*! \brief prod_{k<a} (p l - k)/(k+1) and its derivative with respect to l */
+  template <typename T, int p>
+  inline
+  T LagrangeTriangle<T,p>::_factor( int a, T l, T& dl ) {
+
+    T f = T(1);
+    dl  = T(0);
+    for( int k = 0; k < a; k++ ) {
+      const T t = ( p*l - k ) / ( k+1 );
+      dl = dl * t + f * T(p) / ( k+1 );
+      f *= t;
+    }
+    return f;
+  }
+
+
+} // END namespace GMlib
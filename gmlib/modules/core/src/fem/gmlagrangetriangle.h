@@ -0,0 +1,135 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+/*! \file gmlagrangetriangle.h
+ *
+ *  Interface for the Lagrange triangle element classes.
+ */
+
+
+#ifndef GM_CORE_FEM_LAGRANGETRIANGLE_H
+#define GM_CORE_FEM_LAGRANGETRIANGLE_H
+
+
+
+// GMlib includes
+#include "../types/gmpoint.h"
+#include "../types/gmmatrix.h"
+#include "gmtrianglequadrature.h"
+
+
+namespace GMlib {
+
+
+  /*! \class TriangleAffineMap gmlagrangetriangle.h <gmLagrangeTriangle>
+   *  \brief The affine map from the reference triangle to a triangle.
+   *
+   *  x = p0 + xi (p1 - p0) + eta (p2 - p0), J = [ p1-p0  p2-p0 ].
+   */
+  template <typename T>
+  class TriangleAffineMap {
+  public:
+    TriangleAffineMap( const Point<T,2>& p0, const Point<T,2>& p1, const Point<T,2>& p2 );
+
+    T                     getDeterminant() const;
+    Vector<T,3>           getMetric() const;
+    Point<T,2>            map( const Point<T,2>& x ) const;
+    Vector<T,2>           mapGradient( const Vector<T,2>& g ) const;
+
+  private:
+    Point<T,2>            _p0;
+    Vector<T,2>           _e1;
+    Vector<T,2>           _e2;
+    T                     _det;
+
+  }; // END class TriangleAffineMap
+
+
+
+
+  /*! \class LagrangeTriangle gmlagrangetriangle.h <gmLagrangeTriangle>
+   *  \brief Lagrange triangle element of degree p.
+   *
+   *  The N = (p+1)(p+2)/2 nodes on the reference triangle (0,0), (1,0),
+   *  (0,1) are the points with barycentric coordinates (a,b,c)/p. They are
+   *  numbered: the three vertices, the p-1 nodes of each edge (0,1), (1,2)
+   *  and (2,0) running from the first vertex to the second, and the
+   *  interior nodes. Shape function i is 1 at node i and 0 at the others.
+   *
+   *  N and the number of quadrature points are compile time constants.
+   *  The constructor tabulates the shape functions and their derivatives at
+   *  the points of a degree 2p rule, and from them the reference mass
+   *  matrix, load vector and the three stiffness tables int dphi_i/da
+   *  dphi_j/db. The element matrices of a triangle are then linear
+   *  combinations of these tables, with the coefficients from the affine
+   *  map, so no quadrature is done per element.
+   */
+  template <typename T, int p>
+  class LagrangeTriangle {
+  public:
+    enum { N = (p+1)*(p+2)/2 };
+
+    typedef TriangleQuadrature<T,2*p> Quadrature;
+
+    LagrangeTriangle();
+
+    void                        elementLoad( const Point<T,2>& p0, const Point<T,2>& p1, const Point<T,2>& p2, T* fe ) const;
+    void                        elementMass( const Point<T,2>& p0, const Point<T,2>& p1, const Point<T,2>& p2, T* me ) const;
+    void                        elementStiffness( const Point<T,2>& p0, const Point<T,2>& p1, const Point<T,2>& p2, T* ke ) const;
+    const Vector<Vector<Vector<T,2>,N>,Quadrature::N>& getDerivatives() const;
+    const Vector<T,N>&          getLoad() const;
+    const Matrix<T,N,N>&        getMass() const;
+    const Quadrature&           getQuadrature() const;
+    const Matrix<T,N,N>&        getStiffness( int k ) const;
+    const Vector<Vector<T,N>,Quadrature::N>& getValues() const;
+
+    static Vector<T,N>          eval( const Point<T,2>& x );
+    static Vector<Vector<T,2>,N> evalDerivatives( const Point<T,2>& x );
+    static Vector<int,3>        getIndex( int i );
+    static Point<T,2>           getNode( int i );
+
+  private:
+    Quadrature                              _q;
+    Vector<Vector<T,N>,Quadrature::N>       _phi;   // Values at the quadrature points
+    Vector<Vector<Vector<T,2>,N>,Quadrature::N> _dphi;
+
+    Vector<T,N>                             _load;
+    Matrix<T,N,N>                           _mass;
+    Matrix<T,N,N>                           _s[3];  // xx, xy + yx, yy
+
+    static T                                _factor( int a, T l, T& dl );
+
+  }; // END class LagrangeTriangle
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmlagrangetriangle.c"
+
+
+
+
+#endif // GM_CORE_FEM_LAGRANGETRIANGLE_H
@@ -0,0 +1,175 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+// STL includes
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+  #include <immintrin.h>
+#endif
+
+
+namespace GMlib {
+
+
+  namespace Private {
+
+    // Lanes of a block: the six distinct stiffness values and the load
+    enum { LINEAR_BLOCK = 16 };
+
+
+    /*! \brief m <= 16 linear triangles, k[v][lane] */
+    template <typename T>
+    inline
+    void linearTriangleLanes( int m, const T* x0, const T* y0, const T* x1, const T* y1,
+                              const T* x2, const T* y2, T k[7][LINEAR_BLOCK] ) {
+
+#ifdef _OPENMP
+  #pragma omp simd
+#endif
+      for( int l = 0; l < m; l++ ) {
+
+        // Edge opposite to each corner, the gradients are these rotated 90 deg.
+        const T dx0 = x2[l] - x1[l], dx1 = x0[l] - x2[l], dx2 = x1[l] - x0[l];
+        const T dy0 = y2[l] - y1[l], dy1 = y0[l] - y2[l], dy2 = y1[l] - y0[l];
+
+        const T a2 = std::abs( dx1*dy2 - dy1*dx2 );
+        const T s  = T(1) / ( 2 * a2 );
+
+        k[0][l] = ( dx0*dx0 + dy0*dy0 ) * s;
+        k[1][l] = ( dx0*dx1 + dy0*dy1 ) * s;
+        k[2][l] = ( dx0*dx2 + dy0*dy2 ) * s;
+        k[3][l] = ( dx1*dx1 + dy1*dy1 ) * s;
+        k[4][l] = ( dx1*dx2 + dy1*dy2 ) * s;
+        k[5][l] = ( dx2*dx2 + dy2*dy2 ) * s;
+        k[6][l] = a2 / 6;
+      }
+    }
+
+
+#if defined(__AVX512F__)
+
+    /*! \brief A full block of float triangles, 16 lanes */
+    inline
+    void linearTriangleLanes( int m, const float* x0, const float* y0, const float* x1, const float* y1,
+                              const float* x2, const float* y2, float k[7][LINEAR_BLOCK] ) {
+
+      if( m < LINEAR_BLOCK ) {
+        linearTriangleLanes<float>( m, x0, y0, x1, y1, x2, y2, k );
+        return;
+      }
+
+      const __m512 px0 = _mm512_loadu_ps( x0 ), py0 = _mm512_loadu_ps( y0 );
+      const __m512 px1 = _mm512_loadu_ps( x1 ), py1 = _mm512_loadu_ps( y1 );
+      const __m512 px2 = _mm512_loadu_ps( x2 ), py2 = _mm512_loadu_ps( y2 );
+
+      const __m512 dx0 = _mm512_sub_ps( px2, px1 ), dx1 = _mm512_sub_ps( px0, px2 ), dx2 = _mm512_sub_ps( px1, px0 );
+      const __m512 dy0 = _mm512_sub_ps( py2, py1 ), dy1 = _mm512_sub_ps( py0, py2 ), dy2 = _mm512_sub_ps( py1, py0 );
+
+      const __m512 a2 = _mm512_abs_ps( _mm512_fmsub_ps( dx1, dy2, _mm512_mul_ps( dy1, dx2 ) ) );
+      const __m512 s  = _mm512_div_ps( _mm512_set1_ps( 0.5f ), a2 );
+
+      _mm512_storeu_ps( k[0], _mm512_mul_ps( _mm512_fmadd_ps( dx0, dx0, _mm512_mul_ps( dy0, dy0 ) ), s ) );
+      _mm512_storeu_ps( k[1], _mm512_mul_ps( _mm512_fmadd_ps( dx0, dx1, _mm512_mul_ps( dy0, dy1 ) ), s ) );
+      _mm512_storeu_ps( k[2], _mm512_mul_ps( _mm512_fmadd_ps( dx0, dx2, _mm512_mul_ps( dy0, dy2 ) ), s ) );
+      _mm512_storeu_ps( k[3], _mm512_mul_ps( _mm512_fmadd_ps( dx1, dx1, _mm512_mul_ps( dy1, dy1 ) ), s ) );
+      _mm512_storeu_ps( k[4], _mm512_mul_ps( _mm512_fmadd_ps( dx1, dx2, _mm512_mul_ps( dy1, dy2 ) ), s ) );
+      _mm512_storeu_ps( k[5], _mm512_mul_ps( _mm512_fmadd_ps( dx2, dx2, _mm512_mul_ps( dy2, dy2 ) ), s ) );
+      _mm512_storeu_ps( k[6], _mm512_mul_ps( a2, _mm512_set1_ps( 1.0f/6 ) ) );
+    }
+
+#elif defined(__AVX2__)
+
+    /*! \brief A full block of float triangles, two times 8 lanes */
+    inline
+    void linearTriangleLanes( int m, const float* x0, const float* y0, const float* x1, const float* y1,
+                              const float* x2, const float* y2, float k[7][LINEAR_BLOCK] ) {
+
+      if( m < LINEAR_BLOCK ) {
+        linearTriangleLanes<float>( m, x0, y0, x1, y1, x2, y2, k );
+        return;
+      }
+
+      const __m256 sign = _mm256_set1_ps( -0.0f );
+
+      for( int h = 0; h < LINEAR_BLOCK; h += 8 ) {
+
+        const __m256 px0 = _mm256_loadu_ps( x0+h ), py0 = _mm256_loadu_ps( y0+h );
+        const __m256 px1 = _mm256_loadu_ps( x1+h ), py1 = _mm256_loadu_ps( y1+h );
+        const __m256 px2 = _mm256_loadu_ps( x2+h ), py2 = _mm256_loadu_ps( y2+h );
+
+        const __m256 dx0 = _mm256_sub_ps( px2, px1 ), dx1 = _mm256_sub_ps( px0, px2 ), dx2 = _mm256_sub_ps( px1, px0 );
+        const __m256 dy0 = _mm256_sub_ps( py2, py1 ), dy1 = _mm256_sub_ps( py0, py2 ), dy2 = _mm256_sub_ps( py1, py0 );
+
+        const __m256 a2 = _mm256_andnot_ps( sign, _mm256_sub_ps( _mm256_mul_ps( dx1, dy2 ), _mm256_mul_ps( dy1, dx2 ) ) );
+        const __m256 s  = _mm256_div_ps( _mm256_set1_ps( 0.5f ), a2 );
+
+        _mm256_storeu_ps( k[0]+h, _mm256_mul_ps( _mm256_add_ps( _mm256_mul_ps( dx0, dx0 ), _mm256_mul_ps( dy0, dy0 ) ), s ) );
+        _mm256_storeu_ps( k[1]+h, _mm256_mul_ps( _mm256_add_ps( _mm256_mul_ps( dx0, dx1 ), _mm256_mul_ps( dy0, dy1 ) ), s ) );
+        _mm256_storeu_ps( k[2]+h, _mm256_mul_ps( _mm256_add_ps( _mm256_mul_ps( dx0, dx2 ), _mm256_mul_ps( dy0, dy2 ) ), s ) );
+        _mm256_storeu_ps( k[3]+h, _mm256_mul_ps( _mm256_add_ps( _mm256_mul_ps( dx1, dx1 ), _mm256_mul_ps( dy1, dy1 ) ), s ) );
+        _mm256_storeu_ps( k[4]+h, _mm256_mul_ps( _mm256_add_ps( _mm256_mul_ps( dx1, dx2 ), _mm256_mul_ps( dy1, dy2 ) ), s ) );
+        _mm256_storeu_ps( k[5]+h, _mm256_mul_ps( _mm256_add_ps( _mm256_mul_ps( dx2, dx2 ), _mm256_mul_ps( dy2, dy2 ) ), s ) );
+        _mm256_storeu_ps( k[6]+h, _mm256_mul_ps( a2, _mm256_set1_ps( 1.0f/6 ) ) );
+      }
+    }
+
+#endif
+
+  } // END namespace Private
+
+
+  template <typename T>
+  void linearTriangleElements( int n, const T* xy, T* ke, T* fe ) {
+
+    const int B  = Private::LINEAR_BLOCK;
+    const int nb = ( n + B - 1 ) / B;
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int j = 0; j < nb; j++ ) {
+
+      const int b = j * B;
+      const int m = std::min( B, n - b );
+
+      T k[7][Private::LINEAR_BLOCK];
+      Private::linearTriangleLanes( m, xy + b, xy + n + b, xy + 2*n + b, xy + 3*n + b,
+                                    xy + 4*n + b, xy + 5*n + b, k );
+
+      // Per element, the matrix is symmetric
+      T *e = ke + 9*b;
+      T *f = fe + 3*b;
+      for( int l = 0; l < m; l++, e += 9, f += 3 ) {
+        e[0] = k[0][l];  e[1] = k[1][l];  e[2] = k[2][l];
+        e[3] = k[1][l];  e[4] = k[3][l];  e[5] = k[4][l];
+        e[6] = k[2][l];  e[7] = k[4][l];  e[8] = k[5][l];
+        f[0] = f[1] = f[2] = k[6][l];
+      }
+    }
+  }
+
+
+} // END namespace GMlib
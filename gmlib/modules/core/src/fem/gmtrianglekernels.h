@@ -0,0 +1,65 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+/*! \file gmtrianglekernels.h
+ *
+ *  Batched element kernels for triangles.
+ */
+
+
+#ifndef GM_CORE_FEM_TRIANGLEKERNELS_H
+#define GM_CORE_FEM_TRIANGLEKERNELS_H
+
+
+
+namespace GMlib {
+
+
+  /*! \brief Stiffness matrices and load vectors of n linear triangles
+   *
+   *  The corners are given as structure of arrays: xy holds the six arrays
+   *  x0, y0, x1, y1, x2, y2, each of length n. The results are written per
+   *  element, as SparseAssembler expects them: the 3x3 stiffness matrix
+   *  (row major) at ke + 9e and the load vector of the unit source at
+   *  fe + 3e.
+   *
+   *  The triangles are processed in blocks of 16. Each block is computed
+   *  lane-wise, with AVX-512 or AVX2 when the target has them (float),
+   *  otherwise by a loop the compiler vectorizes, and then stored per
+   *  element. Blocks run in parallel.
+   */
+  template <typename T>
+  void linearTriangleElements( int n, const T* xy, T* ke, T* fe );
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmtrianglekernels.c"
+
+
+
+
+#endif // GM_CORE_FEM_TRIANGLEKERNELS_H
@@ -0,0 +1,105 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+namespace GMlib {
+
+
+  template <typename T, int d>
+  TriangleQuadrature<T,d>::TriangleQuadrature() {
+
+    const double *o = TriangleRule<d>::getOrbits();
+
+    int  k   = 0;
+    auto add = [this,&k]( double a, double b, double w ) {
+      if( k < N ) {
+        _x[k] = Point<T,2>( T(a), T(b) );
+        _w[k] = T(w);
+      }
+      k++;
+    };
+
+    // Expand the orbits, the points are (l1,l2) of the barycentric (l0,l1,l2)
+    for( int r = 0; r < TriangleRule<d>::ORBITS; r++, o += 4 ) {
+
+      const double w = o[3] / 2;
+
+      if( o[0] == 1 )
+        add( 1.0/3, 1.0/3, w );
+      else if( o[0] == 3 ) {
+        const double a = o[1], c = 1 - 2*a;
+        add( a, a, w );
+        add( c, a, w );
+        add( a, c, w );
+      }
+      else {
+        const double a = o[1], b = o[2], c = 1 - a - b;
+        add( a, b, w );
+        add( b, a, w );
+        add( b, c, w );
+        add( c, b, w );
+        add( c, a, w );
+        add( a, c, w );
+      }
+    }
+  }
+
+
+  template <typename T, int d>
+  inline
+  const Point<T,2>& TriangleQuadrature<T,d>::getPoint( int i ) const {
+
+    return _x(i);
+  }
+
+
+  template <typename T, int d>
+  inline
+  int TriangleQuadrature<T,d>::getSize() const {
+
+    return N;
+  }
+
+
+  template <typename T, int d>
+  inline
+  T TriangleQuadrature<T,d>::getWeight( int i ) const {
+
+    return _w(i);
+  }
+
+
+  /*! \brief Sum of w_i f(x_i), f is called with a Point<T,2> */
+  template <typename T, int d>
+  template <typename F>
+  inline
+  T TriangleQuadrature<T,d>::integrate( F f ) const {
+
+    T s = T(0);
+    for( int i = 0; i < N; i++ )
+      s += _w(i) * f( _x(i) );
+    return s;
+  }
+
+
+} // END namespace GMlib
@@ -0,0 +1,148 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+/*! \file gmtrianglequadrature.h
+ *
+ *  Interface for the Triangle quadrature class.
+ */
+
+
+#ifndef GM_CORE_FEM_TRIANGLEQUADRATURE_H
+#define GM_CORE_FEM_TRIANGLEQUADRATURE_H
+
+
+
+// GMlib includes
+#include "../types/gmpoint.h"
+
+
+namespace GMlib {
+
+
+  /*! \struct TriangleRule gmtrianglequadrature.h <gmTriangleQuadrature>
+   *  \brief Symmetric Gauss rules on a triangle, exact for polynomials of degree d.
+   *
+   *  The rules (Dunavant) are given as orbits of barycentric points:
+   *  the centroid (1 point), (a,a,1-2a) (3 points) and (a,b,1-a-b)
+   *  (6 points), with the weight of each point, the weights sum to one.
+   *  All weights are positive. N is the number of points.
+   */
+  template <int d>
+  struct TriangleRule;
+
+  template <>
+  struct TriangleRule<1> {
+    enum { N = 1, ORBITS = 1 };
+    static const double* getOrbits() {
+      static const double o[] = { 1, 0, 0, 1 };
+      return o;
+    }
+  };
+
+  template <>
+  struct TriangleRule<2> {
+    enum { N = 3, ORBITS = 1 };
+    static const double* getOrbits() {
+      static const double o[] = { 3, 1.0/6, 0, 1.0/3 };
+      return o;
+    }
+  };
+
+  template <>
+  struct TriangleRule<4> {
+    enum { N = 6, ORBITS = 2 };
+    static const double* getOrbits() {
+      static const double o[] = { 3, 0.445948490915965, 0, 0.223381589678011,
+                                  3, 0.091576213509771, 0, 0.109951743655322 };
+      return o;
+    }
+  };
+
+  template <>
+  struct TriangleRule<3> : TriangleRule<4> {};
+
+  template <>
+  struct TriangleRule<5> {
+    enum { N = 7, ORBITS = 3 };
+    static const double* getOrbits() {
+      static const double o[] = { 1, 0, 0, 0.225,
+                                  3, 0.470142064105115, 0, 0.132394152788506,
+                                  3, 0.101286507323456, 0, 0.125939180544827 };
+      return o;
+    }
+  };
+
+  template <>
+  struct TriangleRule<6> {
+    enum { N = 12, ORBITS = 3 };
+    static const double* getOrbits() {
+      static const double o[] = { 3, 0.249286745170910, 0, 0.116786275726379,
+                                  3, 0.063089014491502, 0, 0.050844906370207,
+                                  6, 0.310352451033784, 0.053145049844817, 0.082851075618374 };
+      return o;
+    }
+  };
+
+
+
+
+  /*! \class TriangleQuadrature gmtrianglequadrature.h <gmTriangleQuadrature>
+   *  \brief Quadrature on the reference triangle (0,0), (1,0), (0,1).
+   *
+   *  The number of points is a compile time constant given by the degree
+   *  d, the points and weights are expanded from TriangleRule<d> by the
+   *  constructor. The weights sum to 1/2, the area of the reference
+   *  triangle.
+   */
+  template <typename T, int d>
+  class TriangleQuadrature {
+  public:
+    enum { N = TriangleRule<d>::N };
+
+    TriangleQuadrature();
+
+    const Point<T,2>&     getPoint( int i ) const;
+    int                   getSize() const;
+    T                     getWeight( int i ) const;
+
+    template <typename F>
+    T                     integrate( F f ) const;
+
+  private:
+    Vector<Point<T,2>,N>  _x;
+    Vector<T,N>           _w;
+
+  }; // END class TriangleQuadrature
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmtrianglequadrature.c"
+
+
+
+
+#endif // GM_CORE_FEM_TRIANGLEQUADRATURE_H
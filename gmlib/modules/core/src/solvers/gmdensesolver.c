@@ -0,0 +1,180 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+// STL includes
+#include <cmath>
+#include <algorithm>
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  inline
+  DenseSolver<T>::DenseSolver() : _n(0), _ok(false), _chol(false) {}
+
+
+  template <typename T>
+  inline
+  DenseSolver<T>::DenseSolver( const DMatrix<T>& a ) : _n(0), _ok(false), _chol(false) {
+
+    factorize( a );
+  }
+
+
+  /*! \brief Factorize a, returns false if a is singular */
+  template <typename T>
+  bool DenseSolver<T>::factorize( const DMatrix<T>& a ) {
+
+    _n    = a.getDim1();
+    _ok   = false;
+    _chol = true;
+    _copy( a );
+
+    T *m = _lu.getPtr();
+    const int n = _n;
+
+    // Cholesky, lower triangle
+    for( int j = 0; j < n && _chol; j++ ) {
+      T d = m[j*n+j];
+      for( int k = 0; k < j; k++ ) d -= m[j*n+k] * m[j*n+k];
+      if( !( d > T(0) ) ) { _chol = false; break; }
+      d = std::sqrt( d );
+      m[j*n+j] = d;
+      for( int i = j+1; i < n; i++ ) {
+        if( std::abs( m[i*n+j] - m[j*n+i] ) > T(1e-6) * ( std::abs( m[i*n+j] ) + std::abs( m[j*n+i] ) ) ) {
+          _chol = false;
+          break;
+        }
+        T s = m[i*n+j];
+        for( int k = 0; k < j; k++ ) s -= m[i*n+k] * m[j*n+k];
+        m[i*n+j] = s / d;
+      }
+    }
+    if( _chol ) return _ok = true;
+
+    // LU with partial pivoting
+    _copy( a );
+    _piv.setDim( n );
+    for( int i = 0; i < n; i++ ) _piv[i] = i;
+
+    for( int k = 0; k < n; k++ ) {
+      int p = k;
+      for( int i = k+1; i < n; i++ )
+        if( std::abs( m[i*n+k] ) > std::abs( m[p*n+k] ) ) p = i;
+      if( m[p*n+k] == T(0) ) return _ok;
+      if( p != k ) {
+        for( int j = 0; j < n; j++ ) std::swap( m[k*n+j], m[p*n+j] );
+        std::swap( _piv[k], _piv[p] );
+      }
+      for( int i = k+1; i < n; i++ ) {
+        const T f = m[i*n+k] /= m[k*n+k];
+        for( int j = k+1; j < n; j++ ) m[i*n+j] -= f * m[k*n+j];
+      }
+    }
+    return _ok = true;
+  }
+
+
+  template <typename T>
+  inline
+  int DenseSolver<T>::getDim() const {
+
+    return _n;
+  }
+
+
+  template <typename T>
+  inline
+  bool DenseSolver<T>::isCholesky() const {
+
+    return _ok && _chol;
+  }
+
+
+  template <typename T>
+  inline
+  bool DenseSolver<T>::isFactorized() const {
+
+    return _ok;
+  }
+
+
+  /*! \brief Solve A x = b using the factorization */
+  template <typename T>
+  void DenseSolver<T>::solve( const DVector<T>& b, DVector<T>& x ) const {
+
+    const int n = _n;
+    const T  *m = _lu.getPtr();
+
+    DVector<T> y( n );
+    for( int i = 0; i < n; i++ ) y[i] = _chol ? b(i) : b(_piv(i));
+
+    if( _chol ) {
+      for( int i = 0; i < n; i++ ) {
+        T s = y[i];
+        for( int k = 0; k < i; k++ ) s -= m[i*n+k] * y[k];
+        y[i] = s / m[i*n+i];
+      }
+      for( int i = n-1; i >= 0; i-- ) {
+        T s = y[i];
+        for( int k = i+1; k < n; k++ ) s -= m[k*n+i] * y[k];
+        y[i] = s / m[i*n+i];
+      }
+    }
+    else {
+      for( int i = 0; i < n; i++ )
+        for( int k = 0; k < i; k++ ) y[i] -= m[i*n+k] * y[k];
+      for( int i = n-1; i >= 0; i-- ) {
+        for( int k = i+1; k < n; k++ ) y[i] -= m[i*n+k] * y[k];
+        y[i] /= m[i*n+i];
+      }
+    }
+
+    x = y;
+  }
+
+
+  template <typename T>
+  inline
+  DVector<T> DenseSolver<T>::solve( const DVector<T>& b ) const {
+
+    DVector<T> x;
+    solve( b, x );
+    return x;
+  }
+
+
+  template <typename T>
+  inline
+  void DenseSolver<T>::_copy( const DMatrix<T>& a ) {
+
+    _lu.setDim( _n*_n );
+    for( int i = 0; i < _n; i++ )
+      for( int j = 0; j < _n; j++ ) _lu[i*_n+j] = a(i)(j);
+  }
+
+
+} // END namespace GMlib
@@ -0,0 +1,87 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+/*! \file gmdensesolver.h
+ *
+ *  Interface for the Dense Solver class.
+ */
+
+
+#ifndef GM_CORE_SOLVERS_DENSESOLVER_H
+#define GM_CORE_SOLVERS_DENSESOLVER_H
+
+
+
+// GMlib includes
+#include "../containers/gmdvector.h"
+#include "../containers/gmdmatrix.h"
+
+
+namespace GMlib {
+
+
+  /*! \class DenseSolver gmdensesolver.h <gmDenseSolver>
+   *  \brief Factor once, solve many, for dense square matrices.
+   *
+   *  factorize() first tries a Cholesky factorization (A = LL^T), which
+   *  succeeds for symmetric positive definite matrices, and otherwise falls
+   *  back to LU with partial pivoting. solve() is a forward and a backward
+   *  substitution, O(n^2), and no inverse is ever formed.
+   */
+  template <typename T>
+  class DenseSolver {
+  public:
+    DenseSolver();
+    DenseSolver( const DMatrix<T>& a );
+
+    bool                  factorize( const DMatrix<T>& a );
+    int                   getDim() const;
+    bool                  isCholesky() const;
+    bool                  isFactorized() const;
+    void                  solve( const DVector<T>& b, DVector<T>& x ) const;
+    DVector<T>            solve( const DVector<T>& b ) const;
+
+  private:
+    int                   _n;
+    bool                  _ok;
+    bool                  _chol;
+    DVector<T>            _lu;    // Row major factors
+    DVector<int>          _piv;   // Row permutation of the LU factorization
+
+    void                  _copy( const DMatrix<T>& a );
+
+  }; // END class DenseSolver
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmdensesolver.c"
+
+
+
+
+#endif // GM_CORE_SOLVERS_DENSESOLVER_H
@@ -0,0 +1,268 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+// STL includes
+#include <algorithm>
+
+
+namespace GMlib {
+
+  namespace GMgraph {
+
+
+    /*! \brief Breadth first level structure rooted at root
+     *
+     *  Only vertices v with mark[v] == tag are visited. On return order[0..cnt)
+     *  holds the visited vertices in BFS order and lvl[v] their level.
+     *  Returns the number of levels.
+     */
+    inline
+    int _levels( const int* r, const int* c, int root, const int* mark, int tag,
+                 int* lvl, int* order, int& cnt ) {
+
+      cnt = 0;
+      order[cnt++] = root;
+      lvl[root] = 0;
+      for( int h = 0; h < cnt; h++ ) {
+        const int v = order[h];
+        for( int k = r[v]; k < r[v+1]; k++ ) {
+          const int w = c[k];
+          if( mark[w] == tag && lvl[w] < 0 ) {
+            lvl[w] = lvl[v] + 1;
+            order[cnt++] = w;
+          }
+        }
+      }
+      return lvl[order[cnt-1]] + 1;
+    }
+
+
+    inline
+    void _resetLevels( int* lvl, const int* order, int cnt ) {
+
+      for( int i = 0; i < cnt; i++ ) lvl[order[i]] = -1;
+    }
+
+
+    /*! \brief One step of the nested dissection
+     *
+     *  The subgraph sub is split by a level-structure separator rooted at a
+     *  pseudo-peripheral vertex. Both halves are ordered recursively and the
+     *  separator is numbered last.
+     */
+    inline
+    void _dissect( const int* r, const int* c, const DVector<int>& sub, int* mark, int& tag,
+                   int* lvl, int* perm, int& pos, int leaf ) {
+
+      const int m = sub.getDim();
+      if( m <= leaf ) {
+        for( int i = 0; i < m; i++ ) perm[pos++] = sub(i);
+        return;
+      }
+
+      const int t = ++tag;
+      for( int i = 0; i < m; i++ ) mark[sub(i)] = t;
+
+      DVector<int> order(m);
+      int cnt;
+      int nlev = _levels( r, c, sub(0), mark, t, lvl, order.getPtr(), cnt );
+
+      // Not connected, order each component on its own
+      if( cnt < m ) {
+        DVector<int> comp(m), size(m);
+        int nc = 0, done = 0;
+        for( int i = 0; i < m; i++ ) {
+          if( i > 0 ) {
+            if( lvl[sub(i)] >= 0 ) continue;
+            _levels( r, c, sub(i), mark, t, lvl, order.getPtr(), cnt );
+          }
+          for( int j = 0; j < cnt; j++ ) comp[done+j] = order[j];
+          size[nc++] = cnt;
+          done += cnt;
+        }
+        _resetLevels( lvl, comp.getPtr(), m );
+
+        for( int i = 0, s = 0; i < nc; s += size[i++] )
+          _dissect( r, c, DVector<int>( size[i], comp.getPtr() + s ), mark, tag, lvl, perm, pos, leaf );
+        return;
+      }
+
+      // Pseudo-peripheral root: restart from the last vertex reached
+      // while the level structure keeps getting deeper
+      for( int it = 0; it < 4; it++ ) {
+        const int far = order[cnt-1];
+        _resetLevels( lvl, order.getPtr(), cnt );
+        const int nl = _levels( r, c, far, mark, t, lvl, order.getPtr(), cnt );
+        const bool deeper = nl > nlev;
+        nlev = nl;
+        if( !deeper ) break;
+      }
+
+      // Too dense to be split
+      if( nlev < 3 ) {
+        _resetLevels( lvl, order.getPtr(), cnt );
+        for( int i = 0; i < m; i++ ) perm[pos++] = order[i];
+        return;
+      }
+
+      // Median level
+      DVector<int> lsize( nlev, 0 );
+      for( int i = 0; i < m; i++ ) lsize[lvl[order[i]]]++;
+      int sep = 0;
+      for( int acc = lsize[0]; 2*acc < m; acc += lsize[++sep] );
+      sep = std::max( 1, std::min( sep, nlev-2 ) );
+
+      // Only the vertices of the median level touching the next level are
+      // needed to separate the two halves
+      DVector<int> a(m), b(m), s(m);
+      int na = 0, nb = 0, ns = 0;
+      for( int i = 0; i < m; i++ ) {
+        const int v = order[i];
+        const int l = lvl[v];
+        if( l < sep )       a[na++] = v;
+        else if( l > sep )  b[nb++] = v;
+        else {
+          bool touch = false;
+          for( int k = r[v]; k < r[v+1] && !touch; k++ )
+            touch = mark[c[k]] == t && lvl[c[k]] == sep+1;
+          if( touch ) s[ns++] = v;
+          else        a[na++] = v;
+        }
+      }
+      _resetLevels( lvl, order.getPtr(), m );
+
+      _dissect( r, c, DVector<int>( na, a.getPtr() ), mark, tag, lvl, perm, pos, leaf );
+      _dissect( r, c, DVector<int>( nb, b.getPtr() ), mark, tag, lvl, perm, pos, leaf );
+      for( int i = 0; i < ns; i++ ) perm[pos++] = s[i];
+    }
+
+
+    /*! \brief pinv[perm[k]] = k */
+    inline
+    void invertPermutation( const DVector<int>& perm, DVector<int>& pinv ) {
+
+      pinv.setDim( perm.getDim() );
+      for( int k = 0; k < perm.getDim(); k++ ) pinv[perm(k)] = k;
+    }
+
+
+    /*! \brief Nested dissection ordering
+     *
+     *  Recursive bisection by level-structure separators, the separators
+     *  are numbered after the parts they split. Parts with at most leaf
+     *  vertices are not split further. For planar meshes the Cholesky fill
+     *  is O(n log n), against O(n^1.5) for a banded ordering.
+     *
+     *  \param[in]  row   Row start of the adjacency, size n+1
+     *  \param[in]  col   Neighbour indices
+     *  \param[out] perm  New-to-old permutation
+     *  \param[in]  leaf  Largest part not split further
+     */
+    inline
+    void nestedDissection( const DVector<int>& row, const DVector<int>& col,
+                           DVector<int>& perm, int leaf ) {
+
+      const int n = row.getDim() - 1;
+      perm.setDim( std::max( n, 0 ) );
+      if( n <= 0 ) return;
+
+      DVector<int> sub(n), mark( n, 0 ), lvl( n, -1 );
+      for( int i = 0; i < n; i++ ) sub[i] = i;
+
+      int tag = 0, pos = 0;
+      _dissect( row.getPtr(), col.getPtr(), sub, mark.getPtr(), tag, lvl.getPtr(), perm.getPtr(), pos, std::max( leaf, 1 ) );
+    }
+
+
+    /*! \brief Reverse Cuthill-McKee ordering
+     *
+     *  Each connected component is numbered breadth first from a
+     *  pseudo-peripheral vertex, the neighbours of a vertex by increasing
+     *  degree, and the whole ordering is reversed. The result has a small
+     *  bandwidth and profile, so rows that are close in the ordering share
+     *  most of their neighbours: matrix-vector products and per-vertex
+     *  sweeps run through memory nearly contiguously.
+     *
+     *  \param[in]  row   Row start of the adjacency, size n+1
+     *  \param[in]  col   Neighbour indices
+     *  \param[out] perm  New-to-old permutation
+     */
+    inline
+    void reverseCuthillMcKee( const DVector<int>& row, const DVector<int>& col,
+                              DVector<int>& perm ) {
+
+      const int n = row.getDim() - 1;
+      perm.setDim( std::max( n, 0 ) );
+      if( n <= 0 ) return;
+
+      const int *r = row.getPtr(), *c = col.getPtr();
+
+      // Vertices not yet numbered have mark 0, the only ones visited
+      DVector<int> mark( n, 0 ), lvl( n, -1 ), order(n), deg(n);
+      for( int v = 0; v < n; v++ ) deg[v] = r[v+1] - r[v];
+
+      int pos = 0;
+      for( int s = 0; s < n; s++ ) {
+        if( mark[s] ) continue;
+
+        // Pseudo-peripheral root of the component of s: restart from the
+        // lowest degree vertex of the last level while it gets deeper
+        int root = s, cnt;
+        int nlev = _levels( r, c, root, mark.getPtr(), 0, lvl.getPtr(), order.getPtr(), cnt );
+        for( int it = 0; it < 4; it++ ) {
+
+          int far = order[cnt-1];
+          for( int i = cnt-1; i >= 0 && lvl[order[i]] == nlev-1; i-- )
+            if( deg[order[i]] < deg[far] ) far = order[i];
+
+          _resetLevels( lvl.getPtr(), order.getPtr(), cnt );
+          const int nl = _levels( r, c, far, mark.getPtr(), 0, lvl.getPtr(), order.getPtr(), cnt );
+          if( nl <= nlev ) break;
+          root = far;
+          nlev = nl;
+        }
+        _resetLevels( lvl.getPtr(), order.getPtr(), cnt );
+
+        // Cuthill-McKee from the root
+        const int first = pos;
+        perm[pos++] = root;
+        mark[root] = 1;
+        for( int h = first; h < pos; h++ ) {
+          const int v = perm[h], start = pos;
+          for( int k = r[v]; k < r[v+1]; k++ ) {
+            const int w = c[k];
+            if( !mark[w] ) { mark[w] = 1; perm[pos++] = w; }
+          }
+          std::sort( perm.getPtr() + start, perm.getPtr() + pos,
+                     [&deg]( int a, int b ) { return deg(a) < deg(b); } );
+        }
+      }
+
+      std::reverse( perm.getPtr(), perm.getPtr() + n );
+    }
+
+
+  } // END namespace GMgraph
+
+} // END namespace GMlib
@@ -0,0 +1,67 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+/*! \file gmgraphordering.h
+ *
+ *  Fill-reducing and bandwidth-reducing orderings of sparse symmetric graphs.
+ *
+ *  The graph is given as a compressed row adjacency (row start and column
+ *  index arrays, as in SparseMatrix), self loops are ignored. A permutation
+ *  perm is returned as new-to-old: perm[k] is the old index of the k-th
+ *  vertex in the new ordering.
+ */
+
+
+#ifndef GM_CORE_SOLVERS_GRAPHORDERING_H
+#define GM_CORE_SOLVERS_GRAPHORDERING_H
+
+
+
+// GMlib includes
+#include "../containers/gmdvector.h"
+
+
+namespace GMlib {
+
+  namespace GMgraph {
+
+    void      invertPermutation( const DVector<int>& perm, DVector<int>& pinv );
+    void      nestedDissection( const DVector<int>& row, const DVector<int>& col,
+                                DVector<int>& perm, int leaf = 64 );
+    void      reverseCuthillMcKee( const DVector<int>& row, const DVector<int>& col,
+                                   DVector<int>& perm );
+
+  } // END namespace GMgraph
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmgraphordering.c"
+
+
+
+
+#endif // GM_CORE_SOLVERS_GRAPHORDERING_H
@@ -0,0 +1,503 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+// STL includes
+#include <cmath>
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  inline
+  MultigridSolver<T>::MultigridSolver( CYCLE c, SMOOTHER s )
+    : _cycle(c), _smoother(s), _steps(2), _max_it(100), _tol(1e-6), _it(0), _res(0.0), _fine(0x0) {}
+
+
+  template <typename T>
+  inline
+  void MultigridSolver<T>::clearProlongations() {
+
+    _p.clear();
+    _fine = 0x0;
+  }
+
+
+  /*! \brief Set up the hierarchy for the matrix a of the finest level
+   *
+   *  The coarse matrices are P^T A P. A pointer to a is kept, it must
+   *  outlive the solver (or the next call to compute()). Returns false if
+   *  the dimensions do not match the prolongations or if the coarsest
+   *  matrix can not be factorized.
+   */
+  template <typename T>
+  bool MultigridSolver<T>::compute( const SparseMatrix<T>& a ) {
+
+    const int nl = int(_p.size()) + 1;
+
+    _fine = 0x0;
+    if( !_p.empty() && _p.back().row.getDim() != a.getDim() + 1 )
+      return false;
+    for( int l = 1; l < nl-1; l++ )
+      if( _p[l].nc != _p[l-1].row.getDim() - 1 )
+        return false;
+
+    _fine = &a;
+    _a.resize( nl );
+    for( int l = nl-2; l >= 0; l-- )
+      _galerkin( getMatrix(l+1), _p[l], _a[l] );
+
+    _dinv.resize( nl );
+    _lmax.resize( nl );
+    _x.resize( nl );
+    _b.resize( nl );
+    _r.resize( nl );
+    _d.resize( nl );
+    for( int l = 0; l < nl; l++ ) {
+      const SparseMatrix<T>& al = getMatrix(l);
+      const int n = al.getDim();
+      _dinv[l].setDim( n );
+      for( int i = 0; i < n; i++ ) {
+        const T d = al( i, i );
+        _dinv[l][i] = d != T(0) ? T(1) / d : T(1);
+      }
+      _lmax[l] = _estimate( l );
+      _x[l].setDim( n );
+      _b[l].setDim( n );
+      _r[l].setDim( n );
+      _d[l].setDim( n );
+    }
+
+    return _coarse.factorize( getMatrix(0) );
+  }
+
+
+  template <typename T>
+  inline
+  typename MultigridSolver<T>::CYCLE MultigridSolver<T>::getCycle() const {
+
+    return _cycle;
+  }
+
+
+  /*! \brief Number of unknowns of a level, 0 is the coarsest */
+  template <typename T>
+  inline
+  int MultigridSolver<T>::getDim( int level ) const {
+
+    return getMatrix( level ).getDim();
+  }
+
+
+  template <typename T>
+  inline
+  int MultigridSolver<T>::getIterations() const {
+
+    return _it;
+  }
+
+
+  /*! \brief The matrix of a level, 0 is the coarsest */
+  template <typename T>
+  inline
+  const SparseMatrix<T>& MultigridSolver<T>::getMatrix( int level ) const {
+
+    return level == int(_p.size()) ? *_fine : _a[level];
+  }
+
+
+  template <typename T>
+  inline
+  int MultigridSolver<T>::getMaxIterations() const {
+
+    return _max_it;
+  }
+
+
+  template <typename T>
+  inline
+  int MultigridSolver<T>::getNoLevels() const {
+
+    return int(_p.size()) + 1;
+  }
+
+
+  /*! \brief Relative residual ||b - Ax|| / ||b|| of the last solve */
+  template <typename T>
+  inline
+  double MultigridSolver<T>::getResidual() const {
+
+    return _res;
+  }
+
+
+  template <typename T>
+  inline
+  typename MultigridSolver<T>::SMOOTHER MultigridSolver<T>::getSmoother() const {
+
+    return _smoother;
+  }
+
+
+  template <typename T>
+  inline
+  double MultigridSolver<T>::getTolerance() const {
+
+    return _tol;
+  }
+
+
+  /*! \brief Add a finer level
+   *
+   *  The prolongation from the current finest level, with nc unknowns, to
+   *  the new one is a sparse matrix by rows: the entries of row i are
+   *  col/val[row[i]..row[i+1]). Levels are inserted from the coarsest to
+   *  the finest, compute() must be called afterwards.
+   *
+   *  \param[in] nc  Number of unknowns of the coarser level
+   *  \param[in] row Start of each row, one more than the fine unknowns
+   *  \param[in] col Coarse unknown of each entry
+   *  \param[in] val Weight of each entry
+   */
+  template <typename T>
+  void MultigridSolver<T>::insertProlongation( int nc, const DVector<int>& row, const DVector<int>& col, const DVector<T>& val ) {
+
+    Prolongation p;
+    p.nc  = nc;
+    p.row = row;
+    p.col = col;
+    p.val = val;
+    _p.push_back( p );
+    _fine = 0x0;
+  }
+
+
+  /*! \brief z = M^-1 r, one cycle from a zero initial guess */
+  template <typename T>
+  void MultigridSolver<T>::precondition( const DVector<T>& r, DVector<T>& z ) const {
+
+    z.setDim( r.getDim() );
+    z.clear();
+    if( _fine )
+      _cycleLevel( getNoLevels()-1, r, z );
+  }
+
+
+  template <typename T>
+  inline
+  void MultigridSolver<T>::setCycle( CYCLE c ) {
+
+    _cycle = c;
+  }
+
+
+  template <typename T>
+  inline
+  void MultigridSolver<T>::setMaxIterations( int n ) {
+
+    _max_it = n;
+  }
+
+
+  /*! \brief The smoother and the number of sweeps (Gauss-Seidel) or the
+   *  polynomial degree (Chebyshev) before and after the coarse correction
+   */
+  template <typename T>
+  inline
+  void MultigridSolver<T>::setSmoother( SMOOTHER s, int steps ) {
+
+    _smoother = s;
+    _steps    = steps;
+  }
+
+
+  template <typename T>
+  inline
+  void MultigridSolver<T>::setTolerance( double tol ) {
+
+    _tol = tol;
+  }
+
+
+  /*! \brief Solve a x = b by repeated cycles, x is the initial guess
+   *
+   *  Returns true if the tolerance was reached.
+   */
+  template <typename T>
+  bool MultigridSolver<T>::solve( const DVector<T>& b, DVector<T>& x ) {
+
+    const int n = b.getDim();
+    if( x.getDim() != n ) {
+      x.setDim( n );
+      x.clear();
+    }
+
+    _it  = 0;
+    _res = 1.0;
+    if( !_fine ) return false;
+
+    double bnorm = 0.0;
+    for( int i = 0; i < n; i++ ) bnorm += double(b(i)) * double(b(i));
+    bnorm = std::sqrt( bnorm );
+    if( bnorm == 0.0 ) {
+      x.clear();
+      _res = 0.0;
+      return true;
+    }
+
+    const int l = getNoLevels()-1;
+    DVector<T> r( n );
+    while( true ) {
+
+      _residual( l, b, x, r );
+      double s = 0.0;
+      for( int i = 0; i < n; i++ ) s += double(r[i]) * double(r[i]);
+      _res = std::sqrt( s ) / bnorm;
+
+      if( _res <= _tol || _it >= _max_it ) break;
+
+      _cycleLevel( l, b, x );
+      _it++;
+    }
+
+    return _res <= _tol;
+  }
+
+
+  /*! \brief One cycle on level l, x is improved in place */
+  template <typename T>
+  void MultigridSolver<T>::_cycleLevel( int l, const DVector<T>& b, DVector<T>& x ) const {
+
+    if( l == 0 ) {
+      _coarse.solve( b, x );
+      return;
+    }
+
+    _smooth( l, b, x, true );
+    _residual( l, b, x, _r[l] );
+
+    // Restrict the residual, b_c = P^T r
+    const Prolongation& p  = _p[l-1];
+    const int          *pr = p.row.getPtr();
+    const int          *pc = p.col.getPtr();
+    const T            *pv = p.val.getPtr();
+    const T            *r  = _r[l].getPtr();
+    const int           n  = x.getDim();
+
+    DVector<T>& bc = _b[l-1];
+    DVector<T>& xc = _x[l-1];
+    bc.clear();
+    xc.clear();
+    T *bp = bc.getPtr();
+    for( int i = 0; i < n; i++ )
+      for( int k = pr[i]; k < pr[i+1]; k++ )
+        bp[pc[k]] += pv[k] * r[i];
+
+    const int g = ( _cycle == CYCLE_W && l > 1 ) ? 2 : 1;
+    for( int k = 0; k < g; k++ )
+      _cycleLevel( l-1, bc, xc );
+
+    // Prolongate the correction
+    const T *xcp = xc.getPtr();
+    T       *xp  = x.getPtr();
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int i = 0; i < n; i++ ) {
+      T s = T(0);
+      for( int k = pr[i]; k < pr[i+1]; k++ ) s += pv[k] * xcp[pc[k]];
+      xp[i] += s;
+    }
+
+    _smooth( l, b, x, false );
+  }
+
+
+  /*! \brief Largest eigenvalue of D^-1 A by power iteration */
+  template <typename T>
+  T MultigridSolver<T>::_estimate( int l ) const {
+
+    const SparseMatrix<T>& a = getMatrix(l);
+    const int n = a.getDim();
+    const T  *d = _dinv[l].getPtr();
+
+    // Pseudo random start, all frequencies are present
+    DVector<T> v( n ), w( n );
+    unsigned int q = 12345u;
+    for( int i = 0; i < n; i++ ) {
+      q = 1664525u * q + 1013904223u;
+      v[i] = T( double(q) / 4294967296.0 - 0.5 );
+    }
+
+    double lambda = 1.0;
+    for( int k = 0; k < 20; k++ ) {
+      a.multiply( v, w );
+      double vv = 0.0, wv = 0.0;
+      for( int i = 0; i < n; i++ ) {
+        w[i] *= d[i];
+        vv   += double(v[i]) * double(v[i]);
+        wv   += double(w[i]) * double(w[i]);
+      }
+      if( vv == 0.0 || wv == 0.0 ) break;
+      lambda = std::sqrt( wv / vv );
+      const T s = T( 1.0 / std::sqrt( wv ) );
+      for( int i = 0; i < n; i++ ) v[i] = s * w[i];
+    }
+
+    return T( lambda );
+  }
+
+
+  /*! \brief c = P^T a P */
+  template <typename T>
+  void MultigridSolver<T>::_galerkin( const SparseMatrix<T>& a, const Prolongation& p, SparseMatrix<T>& c ) const {
+
+    const int  n  = a.getDim();
+    const int *ar = a.getRowStart().getPtr();
+    const int *ac = a.getColumns().getPtr();
+    const T   *av = a.getValues().getPtr();
+    const int *pr = p.row.getPtr();
+    const int *pc = p.col.getPtr();
+    const T   *pv = p.val.getPtr();
+
+    // Coarse pairs coupled through a fine entry
+    int m = 0;
+    for( int i = 0; i < n; i++ )
+      for( int k = ar[i]; k < ar[i+1]; k++ )
+        m += ( pr[i+1] - pr[i] ) * ( pr[ac[k]+1] - pr[ac[k]] );
+
+    DVector<int> ei( m ), ej( m );
+    m = 0;
+    for( int i = 0; i < n; i++ )
+      for( int k = ar[i]; k < ar[i+1]; k++ ) {
+        const int j = ac[k];
+        for( int s = pr[i]; s < pr[i+1]; s++ )
+          for( int t = pr[j]; t < pr[j+1]; t++ )
+            if( pc[s] < pc[t] ) {
+              ei[m] = pc[s];
+              ej[m] = pc[t];
+              m++;
+            }
+      }
+    ei.setDim( m );
+    ej.setDim( m );
+    c.setPattern( p.nc, ei, ej );
+
+    for( int i = 0; i < n; i++ )
+      for( int k = ar[i]; k < ar[i+1]; k++ ) {
+        const int j = ac[k];
+        for( int s = pr[i]; s < pr[i+1]; s++ )
+          for( int t = pr[j]; t < pr[j+1]; t++ )
+            c.add( pc[s], pc[t], pv[s] * av[k] * pv[t] );
+      }
+  }
+
+
+  /*! \brief r = b - A x on level l */
+  template <typename T>
+  void MultigridSolver<T>::_residual( int l, const DVector<T>& b, const DVector<T>& x, DVector<T>& r ) const {
+
+    const SparseMatrix<T>& a = getMatrix(l);
+    const int  n  = a.getDim();
+    const int *ar = a.getRowStart().getPtr();
+    const int *ac = a.getColumns().getPtr();
+    const T   *av = a.getValues().getPtr();
+    const T   *bp = b.getPtr();
+    const T   *xp = x.getPtr();
+
+    r.setDim( n );
+    T *rp = r.getPtr();
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int i = 0; i < n; i++ ) {
+      T s = bp[i];
+      for( int k = ar[i]; k < ar[i+1]; k++ ) s -= av[k] * xp[ac[k]];
+      rp[i] = s;
+    }
+  }
+
+
+  /*! \brief Smoothing steps on level l
+   *
+   *  Gauss-Seidel sweeps in the given direction, or a Chebyshev polynomial
+   *  in D^-1 A damping the eigenvalues in [lmax/8, 1.1 lmax].
+   */
+  template <typename T>
+  void MultigridSolver<T>::_smooth( int l, const DVector<T>& b, DVector<T>& x, bool forward ) const {
+
+    const SparseMatrix<T>& a = getMatrix(l);
+    const int  n  = a.getDim();
+    const int *ar = a.getRowStart().getPtr();
+    const int *ac = a.getColumns().getPtr();
+    const T   *av = a.getValues().getPtr();
+    const T   *dp = _dinv[l].getPtr();
+    const T   *bp = b.getPtr();
+    T         *xp = x.getPtr();
+
+    if( _smoother == SMOOTHER_GAUSS_SEIDEL ) {
+
+      for( int s = 0; s < _steps; s++ )
+        for( int q = 0; q < n; q++ ) {
+          const int i = forward ? q : n-1-q;
+          T t = bp[i];
+          for( int k = ar[i]; k < ar[i+1]; k++ ) t -= av[k] * xp[ac[k]];
+          xp[i] += dp[i] * t;
+        }
+      return;
+    }
+
+    const double lmax  = 1.1 * _lmax[l];
+    const double lmin  = lmax / 8.0;
+    const double theta = 0.5 * ( lmax + lmin );
+    const double delta = 0.5 * ( lmax - lmin );
+    const double sigma = theta / delta;
+    double       rho   = 1.0 / sigma;
+
+    DVector<T>& r = _r[l];
+    DVector<T>& d = _d[l];
+    T *rp = r.getPtr();
+    T *pd = d.getPtr();
+
+    _residual( l, b, x, r );
+    for( int i = 0; i < n; i++ ) pd[i] = T( dp[i] * rp[i] / theta );
+
+    for( int s = 0; s < _steps; s++ ) {
+
+      for( int i = 0; i < n; i++ ) xp[i] += pd[i];
+      if( s == _steps-1 ) break;
+
+      _residual( l, b, x, r );
+      const double rho1 = 1.0 / ( 2.0 * sigma - rho );
+      const T      c0   = T( rho1 * rho );
+      const T      c1   = T( 2.0 * rho1 / delta );
+      for( int i = 0; i < n; i++ ) pd[i] = c0 * pd[i] + c1 * dp[i] * rp[i];
+      rho = rho1;
+    }
+  }
+
+
+} // END namespace GMlib
@@ -0,0 +1,148 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+/*! \file gmmultigridsolver.h
+ *
+ *  Interface for the Multigrid solver class.
+ */
+
+
+#ifndef GM_CORE_SOLVERS_MULTIGRIDSOLVER_H
+#define GM_CORE_SOLVERS_MULTIGRIDSOLVER_H
+
+
+
+// GMlib includes
+#include "../containers/gmdvector.h"
+#include "../containers/gmsparsematrix.h"
+#include "gmsparsecholesky.h"
+
+// STL includes
+#include <vector>
+
+
+namespace GMlib {
+
+
+  /*! \class MultigridSolver gmmultigridsolver.h <gmMultigridSolver>
+   *  \brief Multigrid for symmetric positive definite systems from nested meshes.
+   *
+   *  The hierarchy is given by the prolongations, from the coarsest level
+   *  to the finest, e.g. the linear interpolation from one mesh to its
+   *  refinement. compute() takes the matrix of the finest level and forms
+   *  the coarse matrices as P^T A P, the coarsest one is factorized.
+   *
+   *  A cycle smooths, restricts the residual, recurses (once for a
+   *  V-cycle, twice for a W-cycle), prolongates the correction and smooths
+   *  again. Gauss-Seidel runs forward before and backward after the coarse
+   *  correction, so the cycle is symmetric and precondition() can be passed
+   *  to PCGSolver::solve(). Chebyshev smoothing is a polynomial in D^-1 A
+   *  and only needs matrix-vector products.
+   *
+   *  solve() repeats cycles until ||b - Ax|| <= tolerance * ||b||, the x
+   *  given is used as the initial guess when it has the right dimension.
+   */
+  template <typename T>
+  class MultigridSolver {
+  public:
+    enum CYCLE {
+      CYCLE_V,
+      CYCLE_W
+    };
+
+    enum SMOOTHER {
+      SMOOTHER_GAUSS_SEIDEL,
+      SMOOTHER_CHEBYSHEV
+    };
+
+    MultigridSolver( CYCLE c = CYCLE_V, SMOOTHER s = SMOOTHER_GAUSS_SEIDEL );
+
+    void                  clearProlongations();
+    bool                  compute( const SparseMatrix<T>& a );
+    CYCLE                 getCycle() const;
+    int                   getDim( int level ) const;
+    int                   getIterations() const;
+    const SparseMatrix<T>& getMatrix( int level ) const;
+    int                   getMaxIterations() const;
+    int                   getNoLevels() const;
+    double                getResidual() const;
+    SMOOTHER              getSmoother() const;
+    double                getTolerance() const;
+    void                  insertProlongation( int nc, const DVector<int>& row, const DVector<int>& col, const DVector<T>& val );
+    void                  precondition( const DVector<T>& r, DVector<T>& z ) const;
+    void                  setCycle( CYCLE c );
+    void                  setMaxIterations( int n );
+    void                  setSmoother( SMOOTHER s, int steps = 2 );
+    void                  setTolerance( double tol );
+    bool                  solve( const DVector<T>& b, DVector<T>& x );
+
+  private:
+    // Sparse n x nc matrix by rows
+    struct Prolongation {
+      int                 nc;
+      DVector<int>        row;
+      DVector<int>        col;
+      DVector<T>          val;
+    };
+
+    CYCLE                         _cycle;
+    SMOOTHER                      _smoother;
+    int                           _steps;
+    int                           _max_it;
+    double                        _tol;
+
+    int                           _it;
+    double                        _res;
+
+    // Level 0 is the coarsest, _p[l] maps level l to level l+1
+    std::vector<Prolongation>     _p;
+    std::vector<SparseMatrix<T> > _a;
+    std::vector<DVector<T> >      _dinv;
+    std::vector<T>                _lmax;  // Largest eigenvalue of D^-1 A, estimated
+    const SparseMatrix<T>        *_fine;
+    SparseCholesky<T>             _coarse;
+
+    // Work vectors per level
+    mutable std::vector<DVector<T> > _x, _b, _r, _d;
+
+    void                  _cycleLevel( int l, const DVector<T>& b, DVector<T>& x ) const;
+    T                     _estimate( int l ) const;
+    void                  _galerkin( const SparseMatrix<T>& a, const Prolongation& p, SparseMatrix<T>& c ) const;
+    void                  _residual( int l, const DVector<T>& b, const DVector<T>& x, DVector<T>& r ) const;
+    void                  _smooth( int l, const DVector<T>& b, DVector<T>& x, bool forward ) const;
+
+  }; // END class MultigridSolver
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmmultigridsolver.c"
+
+
+
+
+#endif // GM_CORE_SOLVERS_MULTIGRIDSOLVER_H
@@ -0,0 +1,413 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+// STL includes
+#include <cmath>
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  inline
+  PCGSolver<T>::PCGSolver( PRECONDITIONER p )
+    : _type(p), _active(p), _a(0x0), _max_it(1000), _tol(1e-6), _omega(T(1)), _it(0), _res(0.0) {}
+
+
+  /*! \brief Set up the preconditioner for the matrix a
+   *
+   *  If the incomplete Cholesky factorization breaks down it is retried
+   *  with an increasing diagonal shift. Returns false, and falls back to
+   *  Jacobi for this matrix, if it still fails. The next call tries the
+   *  requested preconditioner again.
+   */
+  template <typename T>
+  bool PCGSolver<T>::compute( const SparseMatrix<T>& a ) {
+
+    _a = &a;
+
+    const int n = a.getDim();
+    _dinv.setDim( n );
+    for( int i = 0; i < n; i++ ) {
+      const T d = a( i, i );
+      _dinv[i] = d != T(0) ? T(1) / d : T(1);
+    }
+
+    _active = _type;
+    if( _type == PRECONDITIONER_IC0 ) {
+      T shift = T(0);
+      for( int k = 0; k < 8; k++ ) {
+        if( _factorIC0( a, shift ) ) return true;
+        shift = shift == T(0) ? T(1e-3) : T(2) * shift;
+      }
+      _lp.setDim( 0 );
+      _active = PRECONDITIONER_JACOBI;
+      return false;
+    }
+
+    return true;
+  }
+
+
+  /*! \brief The preconditioner used by solve()
+   *
+   *  The one set, or Jacobi if compute() could not set it up.
+   */
+  template <typename T>
+  inline
+  typename PCGSolver<T>::PRECONDITIONER PCGSolver<T>::getActivePreconditioner() const {
+
+    return _active;
+  }
+
+
+  template <typename T>
+  inline
+  int PCGSolver<T>::getIterations() const {
+
+    return _it;
+  }
+
+
+  template <typename T>
+  inline
+  int PCGSolver<T>::getMaxIterations() const {
+
+    return _max_it;
+  }
+
+
+  template <typename T>
+  inline
+  typename PCGSolver<T>::PRECONDITIONER PCGSolver<T>::getPreconditioner() const {
+
+    return _type;
+  }
+
+
+  /*! \brief Relative residual ||b - Ax|| / ||b|| of the last solve */
+  template <typename T>
+  inline
+  double PCGSolver<T>::getResidual() const {
+
+    return _res;
+  }
+
+
+  template <typename T>
+  inline
+  double PCGSolver<T>::getTolerance() const {
+
+    return _tol;
+  }
+
+
+  /*! \brief z = M^-1 r */
+  template <typename T>
+  void PCGSolver<T>::precondition( const DVector<T>& r, DVector<T>& z ) const {
+
+    const int n = r.getDim();
+    z.setDim( n );
+
+    const T *rp = r.getPtr();
+    T       *zp = z.getPtr();
+    const T *di = _dinv.getPtr();
+    const bool diag = _dinv.getDim() == n;
+
+    if( _active == PRECONDITIONER_IC0 && _lp.getDim() == n+1 ) {
+
+      const int *lp = _lp.getPtr();
+      const int *lj = _lj.getPtr();
+      const T   *lx = _lx.getPtr();
+
+      // L y = r
+      for( int i = 0; i < n; i++ ) {
+        T s = rp[i];
+        const int e = lp[i+1] - 1;
+        for( int q = lp[i]; q < e; q++ ) s -= lx[q] * zp[lj[q]];
+        zp[i] = s / lx[e];
+      }
+
+      // L^T z = y
+      for( int i = n-1; i >= 0; i-- ) {
+        const int e = lp[i+1] - 1;
+        zp[i] /= lx[e];
+        for( int q = lp[i]; q < e; q++ ) zp[lj[q]] -= lx[q] * zp[i];
+      }
+    }
+    else if( _active == PRECONDITIONER_SSOR && _a && _a->getDim() == n && diag ) {
+
+      const int *ar = _a->getRowStart().getPtr();
+      const int *ac = _a->getColumns().getPtr();
+      const T   *av = _a->getValues().getPtr();
+      const T    w  = _omega;
+
+      // (D/w + L) y = r, then y = D/w y
+      for( int i = 0; i < n; i++ ) {
+        T s = rp[i];
+        for( int k = ar[i]; k < ar[i+1] && ac[k] < i; k++ ) s -= av[k] * zp[ac[k]];
+        zp[i] = s * w * di[i];
+      }
+      for( int i = 0; i < n; i++ ) zp[i] /= w * di[i];
+
+      // (D/w + U) z = y
+      for( int i = n-1; i >= 0; i-- ) {
+        T s = zp[i];
+        for( int k = ar[i+1]-1; k >= ar[i] && ac[k] > i; k-- ) s -= av[k] * zp[ac[k]];
+        zp[i] = s * w * di[i];
+      }
+
+      const T f = ( T(2) - w ) / w;
+      for( int i = 0; i < n; i++ ) zp[i] *= f;
+    }
+    else if( _active != PRECONDITIONER_NONE && diag ) {
+
+      for( int i = 0; i < n; i++ ) zp[i] = di[i] * rp[i];
+    }
+    else {
+
+      for( int i = 0; i < n; i++ ) zp[i] = rp[i];
+    }
+  }
+
+
+  /*! \brief Diagonal for the Jacobi preconditioner of a matrix-free operator */
+  template <typename T>
+  inline
+  void PCGSolver<T>::setDiagonal( const DVector<T>& d ) {
+
+    _dinv.setDim( d.getDim() );
+    for( int i = 0; i < d.getDim(); i++ )
+      _dinv[i] = d(i) != T(0) ? T(1) / d(i) : T(1);
+  }
+
+
+  template <typename T>
+  inline
+  void PCGSolver<T>::setMaxIterations( int n ) {
+
+    _max_it = n;
+  }
+
+
+  /*! \brief Relaxation factor of SSOR, 0 < omega < 2 */
+  template <typename T>
+  inline
+  void PCGSolver<T>::setOmega( T omega ) {
+
+    _omega = omega;
+  }
+
+
+  /*! \brief Takes effect at the next call to compute() */
+  template <typename T>
+  inline
+  void PCGSolver<T>::setPreconditioner( PRECONDITIONER p ) {
+
+    _type = _active = p;
+  }
+
+
+  template <typename T>
+  inline
+  void PCGSolver<T>::setTolerance( double tol ) {
+
+    _tol = tol;
+  }
+
+
+  /*! \brief Solve with the matrix given to compute() */
+  template <typename T>
+  inline
+  bool PCGSolver<T>::solve( const DVector<T>& b, DVector<T>& x ) {
+
+    if( !_a ) {
+      _it  = 0;
+      _res = 1.0;
+      return false;
+    }
+    return solve( *_a, b, x );
+  }
+
+
+  /*! \brief Solve a x = b, x is the initial guess
+   *
+   *  Returns true if the tolerance was reached.
+   */
+  template <typename T>
+  template <typename Op>
+  inline
+  bool PCGSolver<T>::solve( const Op& a, const DVector<T>& b, DVector<T>& x ) {
+
+    return solve( a, *this, b, x );
+  }
+
+
+  /*! \brief Solve a x = b with the preconditioner m, x is the initial guess
+   *
+   *  m must be symmetric positive definite. Returns true if the tolerance
+   *  was reached.
+   */
+  template <typename T>
+  template <typename Op, typename Pre>
+  bool PCGSolver<T>::solve( const Op& a, const Pre& m, const DVector<T>& b, DVector<T>& x ) {
+
+    const int n = b.getDim();
+    if( x.getDim() != n ) {
+      x.setDim( n );
+      x.clear();
+    }
+
+    _it  = 0;
+    _res = 0.0;
+
+    const double bnorm = std::sqrt( _dot( b, b ) );
+    if( bnorm == 0.0 ) {
+      x.clear();
+      return true;
+    }
+
+    _r.setDim( n );
+    _p.setDim( n );
+
+    a.multiply( x, _q );
+    for( int i = 0; i < n; i++ ) _r[i] = b(i) - _q[i];
+
+    _res = std::sqrt( _dot( _r, _r ) ) / bnorm;
+    if( _res <= _tol ) return true;
+
+    m.precondition( _r, _z );
+    _p = _z;
+    double rz = _dot( _r, _z );
+
+    T *xp = x.getPtr();
+    T *rp = _r.getPtr();
+    T *pp = _p.getPtr();
+
+    while( _it < _max_it ) {
+
+      a.multiply( _p, _q );
+      const double pq = _dot( _p, _q );
+      if( !( pq > 0.0 ) ) break;
+
+      const T  alpha = T( rz / pq );
+      const T *qp    = _q.getPtr();
+      for( int i = 0; i < n; i++ ) {
+        xp[i] += alpha * pp[i];
+        rp[i] -= alpha * qp[i];
+      }
+
+      _it++;
+      _res = std::sqrt( _dot( _r, _r ) ) / bnorm;
+      if( _res <= _tol ) break;
+
+      m.precondition( _r, _z );
+      const double rz1  = _dot( _r, _z );
+      const T      beta = T( rz1 / rz );
+      rz = rz1;
+
+      const T *zp = _z.getPtr();
+      for( int i = 0; i < n; i++ ) pp[i] = zp[i] + beta * pp[i];
+    }
+
+    return _res <= _tol;
+  }
+
+
+  template <typename T>
+  inline
+  double PCGSolver<T>::_dot( const DVector<T>& a, const DVector<T>& b ) {
+
+    const T *ap = a.getPtr();
+    const T *bp = b.getPtr();
+    double s = 0.0;
+    for( int i = 0; i < a.getDim(); i++ ) s += double(ap[i]) * double(bp[i]);
+    return s;
+  }
+
+
+  /*! \brief Incomplete Cholesky with zero fill
+   *
+   *  L has the pattern of the lower triangle of a. The diagonal of a is
+   *  scaled by (1 + shift). Returns false on a non-positive pivot.
+   */
+  template <typename T>
+  bool PCGSolver<T>::_factorIC0( const SparseMatrix<T>& a, T shift ) {
+
+    const int  n  = a.getDim();
+    const int *ar = a.getRowStart().getPtr();
+    const int *ac = a.getColumns().getPtr();
+    const T   *av = a.getValues().getPtr();
+
+    // Lower pattern, columns are sorted so the diagonal ends each row
+    _lp.setDim( n+1 );
+    _lp[0] = 0;
+    for( int i = 0; i < n; i++ ) {
+      int k = ar[i];
+      while( k < ar[i+1] && ac[k] <= i ) k++;
+      _lp[i+1] = _lp[i] + ( k - ar[i] );
+    }
+    _lj.setDim( _lp[n] );
+    _lx.setDim( _lp[n] );
+    for( int i = 0, q = 0; i < n; i++ )
+      for( int k = ar[i]; k < ar[i+1] && ac[k] <= i; k++, q++ ) {
+        _lj[q] = ac[k];
+        _lx[q] = ac[k] == i ? av[k] * ( T(1) + shift ) : av[k];
+      }
+
+    const int *lp = _lp.getPtr();
+    const int *lj = _lj.getPtr();
+    T         *lx = _lx.getPtr();
+
+    for( int i = 0; i < n; i++ ) {
+
+      const int e = lp[i+1] - 1;
+      if( e < lp[i] || lj[e] != i ) return false;
+
+      for( int q = lp[i]; q < e; q++ ) {
+        const int j  = lj[q];
+        const int ej = lp[j+1] - 1;
+
+        // L(i,j) -= sum_k<j L(i,k) L(j,k), merge of the two sorted rows
+        T s = lx[q];
+        for( int u = lp[i], v = lp[j]; u < q && v < ej; ) {
+          if( lj[u] < lj[v] )       u++;
+          else if( lj[u] > lj[v] )  v++;
+          else                      s -= lx[u++] * lx[v++];
+        }
+        lx[q] = s / lx[ej];
+      }
+
+      T d = lx[e];
+      for( int q = lp[i]; q < e; q++ ) d -= lx[q] * lx[q];
+      if( !( d > T(0) ) ) return false;
+      lx[e] = std::sqrt( d );
+    }
+
+    return true;
+  }
+
+
+} // END namespace GMlib
@@ -0,0 +1,132 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+/*! \file gmpcgsolver.h
+ *
+ *  Interface for the Preconditioned Conjugate Gradient solver class.
+ */
+
+
+#ifndef GM_CORE_SOLVERS_PCGSOLVER_H
+#define GM_CORE_SOLVERS_PCGSOLVER_H
+
+
+
+// GMlib includes
+#include "../containers/gmdvector.h"
+#include "../containers/gmsparsematrix.h"
+
+
+namespace GMlib {
+
+
+  /*! \class PCGSolver gmpcgsolver.h <gmPCGSolver>
+   *  \brief Preconditioned conjugate gradient for symmetric positive definite systems.
+   *
+   *  compute() sets up the preconditioner from a sparse matrix and keeps a
+   *  pointer to it, the matrix must outlive the solver (or the next call to
+   *  compute()). The operator can also be matrix-free: any type with a
+   *  multiply( const DVector<T>& x, DVector<T>& y ) const member can be
+   *  passed to solve(), then only the preconditioner is taken from
+   *  compute() or setDiagonal().
+   *
+   *  An external preconditioner, any type with a precondition( const
+   *  DVector<T>& r, DVector<T>& z ) const member such as MultigridSolver,
+   *  can be passed to solve() as well.
+   *
+   *  The x given to solve() is used as the initial guess when it has the
+   *  right dimension, so the previous solution gives a warm start.
+   *  Iteration stops when ||b - Ax|| <= tolerance * ||b|| or after the
+   *  maximum number of iterations.
+   */
+  template <typename T>
+  class PCGSolver {
+  public:
+    enum PRECONDITIONER {
+      PRECONDITIONER_NONE,
+      PRECONDITIONER_JACOBI,
+      PRECONDITIONER_IC0,
+      PRECONDITIONER_SSOR
+    };
+
+    PCGSolver( PRECONDITIONER p = PRECONDITIONER_JACOBI );
+
+    bool                  compute( const SparseMatrix<T>& a );
+    PRECONDITIONER        getActivePreconditioner() const;
+    int                   getIterations() const;
+    int                   getMaxIterations() const;
+    PRECONDITIONER        getPreconditioner() const;
+    double                getResidual() const;
+    double                getTolerance() const;
+    void                  precondition( const DVector<T>& r, DVector<T>& z ) const;
+    void                  setDiagonal( const DVector<T>& d );
+    void                  setMaxIterations( int n );
+    void                  setOmega( T omega );
+    void                  setPreconditioner( PRECONDITIONER p );
+    void                  setTolerance( double tol );
+    bool                  solve( const DVector<T>& b, DVector<T>& x );
+
+    template <typename Op>
+    bool                  solve( const Op& a, const DVector<T>& b, DVector<T>& x );
+
+    template <typename Op, typename Pre>
+    bool                  solve( const Op& a, const Pre& m, const DVector<T>& b, DVector<T>& x );
+
+  private:
+    PRECONDITIONER          _type;
+    PRECONDITIONER          _active;  // In use, _type unless compute() fell back
+    const SparseMatrix<T>  *_a;
+    int                     _max_it;
+    double                  _tol;
+    T                       _omega;
+
+    int                     _it;
+    double                  _res;
+
+    DVector<T>              _dinv;  // Inverse diagonal (Jacobi, SSOR)
+
+    // Incomplete Cholesky factor, lower triangle by rows, diagonal last
+    DVector<int>            _lp;
+    DVector<int>            _lj;
+    DVector<T>              _lx;
+
+    DVector<T>              _r, _z, _p, _q;
+
+    static double           _dot( const DVector<T>& a, const DVector<T>& b );
+    bool                    _factorIC0( const SparseMatrix<T>& a, T shift );
+
+  }; // END class PCGSolver
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmpcgsolver.c"
+
+
+
+
+#endif // GM_CORE_SOLVERS_PCGSOLVER_H
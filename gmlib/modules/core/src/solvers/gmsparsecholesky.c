@@ -0,0 +1,291 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+// STL includes
+#include <cmath>
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  inline
+  SparseCholesky<T>::SparseCholesky() : _n(0), _ok(false) {}
+
+
+  template <typename T>
+  inline
+  SparseCholesky<T>::SparseCholesky( const SparseMatrix<T>& a ) : _n(0), _ok(false) {
+
+    factorize( a );
+  }
+
+
+  /*! \brief Symbolic analysis and numeric factorization
+   *
+   *  Returns false if the matrix is not positive definite.
+   */
+  template <typename T>
+  inline
+  bool SparseCholesky<T>::factorize( const SparseMatrix<T>& a ) {
+
+    _analyze( a );
+    return refactorize( a );
+  }
+
+
+  template <typename T>
+  inline
+  int SparseCholesky<T>::getDim() const {
+
+    return _n;
+  }
+
+
+  template <typename T>
+  inline
+  int SparseCholesky<T>::getNoNonZerosL() const {
+
+    return _li.getDim();
+  }
+
+
+  template <typename T>
+  inline
+  const DVector<int>& SparseCholesky<T>::getPermutation() const {
+
+    return _perm;
+  }
+
+
+  template <typename T>
+  inline
+  bool SparseCholesky<T>::isFactorized() const {
+
+    return _ok;
+  }
+
+
+  /*! \brief Numeric factorization reusing the symbolic analysis
+   *
+   *  The matrix must have the same pattern as the one given to factorize().
+   *  Up-looking algorithm: row k of L is found by a sparse triangular solve
+   *  whose pattern is the reach of A(0:k,k) in the elimination tree.
+   */
+  template <typename T>
+  bool SparseCholesky<T>::refactorize( const SparseMatrix<T>& a ) {
+
+    _ok = false;
+    if( a.getDim() != _n || !a.hasPattern( _row, _col ) ) return _ok;
+
+    DVector<T>    x( _n, T(0) );
+    DVector<int>  s( _n ), w( _n, -1 ), c( _n );
+
+    const T   *av   = a.getValues().getPtr();
+    const int *cp   = _cp.getPtr();
+    const int *ci   = _ci.getPtr();
+    const int *cmap = _cmap.getPtr();
+    const int *lp   = _lp.getPtr();
+    int       *li   = _li.getPtr();
+    T         *lx   = _lx.getPtr();
+    T         *xp   = x.getPtr();
+    int       *cc   = c.getPtr();
+
+    for( int k = 0; k < _n; k++ ) cc[k] = lp[k];
+
+    for( int k = 0; k < _n; k++ ) {
+
+      int top = _ereach( k, s.getPtr(), w.getPtr() );
+
+      for( int p = cp[k]; p < cp[k+1]; p++ ) xp[ci[p]] = av[cmap[p]];
+
+      T d = xp[k];
+      xp[k] = T(0);
+
+      for( ; top < _n; top++ ) {
+        const int i   = s[top];
+        const T   lki = xp[i] / lx[lp[i]];
+        xp[i] = T(0);
+        for( int q = lp[i] + 1; q < cc[i]; q++ ) xp[li[q]] -= lx[q] * lki;
+        d -= lki * lki;
+        const int q = cc[i]++;
+        li[q] = k;
+        lx[q] = lki;
+      }
+
+      if( !( d > T(0) ) ) return _ok;
+
+      const int q = cc[k]++;
+      li[q] = k;
+      lx[q] = std::sqrt( d );
+    }
+
+    return _ok = true;
+  }
+
+
+  /*! \brief Solve A x = b using the factorization */
+  template <typename T>
+  void SparseCholesky<T>::solve( const DVector<T>& b, DVector<T>& x ) const {
+
+    const int *perm = _perm.getPtr();
+    const int *lp   = _lp.getPtr();
+    const int *li   = _li.getPtr();
+    const T   *lx   = _lx.getPtr();
+
+    DVector<T> y( _n );
+    T *yp = y.getPtr();
+    for( int k = 0; k < _n; k++ ) yp[k] = b(perm[k]);
+
+    // L y = P b
+    for( int j = 0; j < _n; j++ ) {
+      yp[j] /= lx[lp[j]];
+      for( int p = lp[j] + 1; p < lp[j+1]; p++ ) yp[li[p]] -= lx[p] * yp[j];
+    }
+
+    // L^T z = y
+    for( int j = _n - 1; j >= 0; j-- ) {
+      for( int p = lp[j] + 1; p < lp[j+1]; p++ ) yp[j] -= lx[p] * yp[li[p]];
+      yp[j] /= lx[lp[j]];
+    }
+
+    x.setDim( _n );
+    for( int k = 0; k < _n; k++ ) x[perm[k]] = yp[k];
+  }
+
+
+  template <typename T>
+  inline
+  DVector<T> SparseCholesky<T>::solve( const DVector<T>& b ) const {
+
+    DVector<T> x;
+    solve( b, x );
+    return x;
+  }
+
+
+  /*! \brief Symbolic analysis
+   *
+   *  Computes the fill-reducing ordering, the upper triangle of the
+   *  permuted matrix, the elimination tree and the column pointers of L.
+   */
+  template <typename T>
+  void SparseCholesky<T>::_analyze( const SparseMatrix<T>& a ) {
+
+    _n   = a.getDim();
+    _row = a.getRowStart();
+    _col = a.getColumns();
+
+    const DVector<int>& row = _row;
+    const DVector<int>& col = _col;
+
+    GMgraph::nestedDissection( row, col, _perm );
+    GMgraph::invertPermutation( _perm, _pinv );
+
+    // Upper triangle of C = P A P^T, column k of C is row perm[k] of A
+    _cp.setDim( _n+1 );
+    _cp[0] = 0;
+    for( int k = 0; k < _n; k++ ) {
+      const int o = _perm[k];
+      int cnt = 0;
+      for( int p = row(o); p < row(o+1); p++ )
+        if( _pinv[col(p)] <= k ) cnt++;
+      _cp[k+1] = _cp[k] + cnt;
+    }
+
+    _ci.setDim( _cp[_n] );
+    _cmap.setDim( _cp[_n] );
+    for( int k = 0, q = 0; k < _n; k++ ) {
+      const int o = _perm[k];
+      for( int p = row(o); p < row(o+1); p++ ) {
+        const int j = _pinv[col(p)];
+        if( j <= k ) {
+          _ci[q]   = j;
+          _cmap[q] = p;
+          q++;
+        }
+      }
+    }
+
+    // Elimination tree, with path compression through ancestor links
+    _parent.setDim( _n );
+    DVector<int> anc( _n );
+    for( int k = 0; k < _n; k++ ) {
+      _parent[k] = -1;
+      anc[k]     = -1;
+      for( int p = _cp[k]; p < _cp[k+1]; p++ ) {
+        int i = _ci[p], next;
+        for( ; i != -1 && i < k; i = next ) {
+          next   = anc[i];
+          anc[i] = k;
+          if( next == -1 ) _parent[i] = k;
+        }
+      }
+    }
+
+    // Column counts of L from the row patterns
+    DVector<int> cnt( _n, 1 ), s( _n ), w( _n, -1 );
+    for( int k = 0; k < _n; k++ )
+      for( int top = _ereach( k, s.getPtr(), w.getPtr() ); top < _n; top++ )
+        cnt[s[top]]++;
+
+    _lp.setDim( _n+1 );
+    _lp[0] = 0;
+    for( int k = 0; k < _n; k++ ) _lp[k+1] = _lp[k] + cnt[k];
+
+    _li.setDim( _lp[_n] );
+    _lx.setDim( _lp[_n] );
+  }
+
+
+  /*! \brief Pattern of row k of L
+   *
+   *  The nodes reachable in the elimination tree from the entries of
+   *  column k of C are returned in s[top.._n), in topological order.
+   *  w is a work array marked with k.
+   */
+  template <typename T>
+  inline
+  int SparseCholesky<T>::_ereach( int k, int* s, int* w ) const {
+
+    const int *cp     = _cp.getPtr();
+    const int *ci     = _ci.getPtr();
+    const int *parent = _parent.getPtr();
+
+    int top = _n;
+    w[k] = k;
+    for( int p = cp[k]; p < cp[k+1]; p++ ) {
+      int i = ci[p], len = 0;
+      for( ; w[i] != k; i = parent[i] ) {
+        s[len++] = i;
+        w[i] = k;
+      }
+      while( len > 0 ) s[--top] = s[--len];
+    }
+    return top;
+  }
+
+
+} // END namespace GMlib
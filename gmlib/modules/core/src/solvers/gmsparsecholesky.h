@@ -0,0 +1,107 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+/*! \file gmsparsecholesky.h
+ *
+ *  Interface for the Sparse Cholesky solver class.
+ */
+
+
+#ifndef GM_CORE_SOLVERS_SPARSECHOLESKY_H
+#define GM_CORE_SOLVERS_SPARSECHOLESKY_H
+
+
+
+// GMlib includes
+#include "../containers/gmdvector.h"
+#include "../containers/gmsparsematrix.h"
+#include "gmgraphordering.h"
+
+
+namespace GMlib {
+
+
+  /*! \class SparseCholesky gmsparsecholesky.h <gmSparseCholesky>
+   *  \brief Sparse LL^T factorization of a symmetric positive definite matrix.
+   *
+   *  factorize() does the symbolic analysis (nested dissection ordering,
+   *  elimination tree, pattern of L) followed by the numeric factorization.
+   *  refactorize() only redoes the numeric part and requires a matrix with
+   *  the same pattern, e.g. after re-assembly. solve() is a forward and a
+   *  backward substitution, O(nnz(L)), and can be called any number of times.
+   */
+  template <typename T>
+  class SparseCholesky {
+  public:
+    SparseCholesky();
+    SparseCholesky( const SparseMatrix<T>& a );
+
+    bool                  factorize( const SparseMatrix<T>& a );
+    int                   getDim() const;
+    int                   getNoNonZerosL() const;
+    const DVector<int>&   getPermutation() const;
+    bool                  isFactorized() const;
+    bool                  refactorize( const SparseMatrix<T>& a );
+    void                  solve( const DVector<T>& b, DVector<T>& x ) const;
+    DVector<T>            solve( const DVector<T>& b ) const;
+
+  private:
+    int                   _n;
+    bool                  _ok;
+
+    // Pattern of the analyzed A, refactorize() requires the same
+    DVector<int>          _row;
+    DVector<int>          _col;
+
+    DVector<int>          _perm;    // New to old
+    DVector<int>          _pinv;    // Old to new
+    DVector<int>          _parent;  // Elimination tree
+
+    // Upper triangle of P A P^T by columns, _cmap is the position in A's values
+    DVector<int>          _cp;
+    DVector<int>          _ci;
+    DVector<int>          _cmap;
+
+    // L by columns, diagonal first
+    DVector<int>          _lp;
+    DVector<int>          _li;
+    DVector<T>            _lx;
+
+    void                  _analyze( const SparseMatrix<T>& a );
+    int                   _ereach( int k, int* s, int* w ) const;
+
+  }; // END class SparseCholesky
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmsparsecholesky.c"
+
+
+
+
+#endif // GM_CORE_SOLVERS_SPARSECHOLESKY_H
@@ -0,0 +1,352 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  inline
+  TransientSolver<T>::TransientSolver( SCHEME s )
+    : _scheme(s), _beta(0.25), _gamma(0.5), _m(0x0), _a(0x0), _kc(-1.0), _c(-1.0),
+      _dt(0.0), _it(0), _t(0.0) {}
+
+
+  /*! \brief Factorize M + c A for the time step dt
+   *
+   *  The state is set to zero if its dimension does not match the
+   *  matrices, otherwise it is kept, so the mesh can be re-assembled while
+   *  running. Returns false if the patterns of m and a differ or if the
+   *  matrix can not be factorized.
+   */
+  template <typename T>
+  bool TransientSolver<T>::compute( const SparseMatrix<T>& m, const SparseMatrix<T>& a, double dt ) {
+
+    _m  = 0x0;
+    _a  = 0x0;
+    _kc = -1.0;
+    _c  = -1.0;
+    if( m.getDim() != a.getDim() || !m.hasPattern( a.getRowStart(), a.getColumns() ) )
+      return false;
+
+    _m  = &m;
+    _a  = &a;
+    _dt = dt;
+    _it = 0;
+
+    const int n = a.getDim();
+    if( _u.getDim() != n ) {
+      _u.setDim( n );
+      _u.clear();
+      _v.setDim( n );
+      _v.clear();
+      _acc.setDim( 0 );
+      _f.setDim( 0 );
+      _t = 0.0;
+    }
+
+    // K has the pattern of A, which may be new for the same size
+    _k = a;
+    _setMatrix( _coefficient( dt ) );
+    if( !_chol.factorize( _k ) )
+      return false;
+
+    _c = _kc;
+    return true;
+  }
+
+
+  /*! \brief u'' at the current time, Newmark only */
+  template <typename T>
+  inline
+  const DVector<T>& TransientSolver<T>::getAcceleration() const {
+
+    return _acc;
+  }
+
+
+  /*! \brief The solver used for steps of another length than the factorized one */
+  template <typename T>
+  inline
+  PCGSolver<T>& TransientSolver<T>::getIterativeSolver() {
+
+    return _cg;
+  }
+
+
+  /*! \brief Conjugate gradient iterations of the last step, 0 if it used the factorization */
+  template <typename T>
+  inline
+  int TransientSolver<T>::getIterations() const {
+
+    return _it;
+  }
+
+
+  template <typename T>
+  inline
+  typename TransientSolver<T>::SCHEME TransientSolver<T>::getScheme() const {
+
+    return _scheme;
+  }
+
+
+  template <typename T>
+  inline
+  const DVector<T>& TransientSolver<T>::getSolution() const {
+
+    return _u;
+  }
+
+
+  template <typename T>
+  inline
+  double TransientSolver<T>::getTime() const {
+
+    return _t;
+  }
+
+
+  /*! \brief The time step of the factorization */
+  template <typename T>
+  inline
+  double TransientSolver<T>::getTimeStep() const {
+
+    return _dt;
+  }
+
+
+  template <typename T>
+  inline
+  const DVector<T>& TransientSolver<T>::getVelocity() const {
+
+    return _v;
+  }
+
+
+  /*! \brief Set u, and u' (zero if not given), at time 0 */
+  template <typename T>
+  void TransientSolver<T>::setInitial( const DVector<T>& u, const DVector<T>& v ) {
+
+    _u = u;
+    if( v.getDim() == u.getDim() )
+      _v = v;
+    else {
+      _v.setDim( u.getDim() );
+      _v.clear();
+    }
+    _acc.setDim( 0 );
+    _f.setDim( 0 );
+    _t = 0.0;
+  }
+
+
+  /*! \brief Newmark parameters, beta = 1/4 and gamma = 1/2 by default
+   *
+   *  The default is the average acceleration method, second order and
+   *  unconditionally stable without numerical damping. Takes effect at the
+   *  next call to compute().
+   */
+  template <typename T>
+  inline
+  void TransientSolver<T>::setNewmark( double beta, double gamma ) {
+
+    _beta  = beta;
+    _gamma = gamma;
+  }
+
+
+  /*! \brief Takes effect at the next call to compute() */
+  template <typename T>
+  inline
+  void TransientSolver<T>::setScheme( SCHEME s ) {
+
+    _scheme = s;
+  }
+
+
+  /*! \brief One step of the time step given to compute() */
+  template <typename T>
+  inline
+  bool TransientSolver<T>::step( const DVector<T>& f ) {
+
+    return step( f, _dt );
+  }
+
+
+  /*! \brief One step of length dt with the load f at the end of it
+   *
+   *  Returns false if the system of the step could not be solved, the
+   *  state is updated anyway.
+   */
+  template <typename T>
+  bool TransientSolver<T>::step( const DVector<T>& f, double dt ) {
+
+    if( !_m || !_a )
+      return false;
+
+    const int n = _a->getDim();
+    if( _f.getDim() != n )
+      _f = f;
+
+    const T *fp = f.getPtr();
+    const T *f0 = _f.getPtr();
+    bool     ok = true;
+
+    if( _scheme != SCHEME_NEWMARK ) {
+
+      // (M + theta dt A) u1 = M u0 - (1-theta) dt A u0 + dt (theta f1 + (1-theta) f0)
+      const T theta = _scheme == SCHEME_BACKWARD_EULER ? T(1) : T(0.5);
+      const T h     = T(dt);
+
+      _m->multiply( _u, _r );
+      T *rp = _r.getPtr();
+
+      if( theta < T(1) ) {
+        _a->multiply( _u, _w );
+        const T *wp = _w.getPtr();
+        for( int i = 0; i < n; i++ )
+          rp[i] += h * ( theta * fp[i] + (1-theta) * ( f0[i] - wp[i] ) );
+      }
+      else
+        for( int i = 0; i < n; i++ )
+          rp[i] += h * fp[i];
+
+      _w = _u;
+      ok = _solve( _r, _u, dt );
+
+      const T *up = _u.getPtr();
+      const T *wp = _w.getPtr();
+      T       *vp = _v.getPtr();
+      for( int i = 0; i < n; i++ )
+        vp[i] = ( up[i] - wp[i] ) / h;
+    }
+    else {
+
+      // Initial acceleration from M a0 = f0 - A u0
+      if( _acc.getDim() != n ) {
+        _a->multiply( _u, _w );
+        _r = _f - _w;
+        _kc = -1.0;
+        _cg.compute( *_m );
+        _cg.solve( _r, _acc );
+      }
+
+      // Predictors, then (M + beta dt^2 A) a1 = f1 - A u*
+      const T h  = T(dt);
+      const T cu = T( (0.5 - _beta) * dt * dt );
+      const T cv = T( (1.0 - _gamma) * dt );
+
+      T       *up = _u.getPtr();
+      T       *vp = _v.getPtr();
+      const T *ap = _acc.getPtr();
+      for( int i = 0; i < n; i++ ) {
+        up[i] += h * vp[i] + cu * ap[i];
+        vp[i] += cv * ap[i];
+      }
+
+      _a->multiply( _u, _w );
+      _r.setDim( n );
+      T       *rp = _r.getPtr();
+      const T *wp = _w.getPtr();
+      for( int i = 0; i < n; i++ )
+        rp[i] = fp[i] - wp[i];
+
+      ok = _solve( _r, _acc, dt );
+
+      const T  bu = T( _beta * dt * dt );
+      const T  bv = T( _gamma * dt );
+      const T *an = _acc.getPtr();
+      for( int i = 0; i < n; i++ ) {
+        up[i] += bu * an[i];
+        vp[i] += bv * an[i];
+      }
+    }
+
+    _f  = f;
+    _t += dt;
+    return ok;
+  }
+
+
+  /*! \brief The factor of A in the matrix of a step of length dt */
+  template <typename T>
+  inline
+  double TransientSolver<T>::_coefficient( double dt ) const {
+
+    switch( _scheme ) {
+      case SCHEME_BACKWARD_EULER: return dt;
+      case SCHEME_CRANK_NICOLSON: return 0.5 * dt;
+      default:                    return _beta * dt * dt;
+    }
+  }
+
+
+  /*! \brief K = M + c A, M and A have the same pattern */
+  template <typename T>
+  void TransientSolver<T>::_setMatrix( double c ) {
+
+    const int  nnz = _k.getNoNonZeros();
+    const T   *mv  = _m->getValues().getPtr();
+    const T   *av  = _a->getValues().getPtr();
+    T         *kv  = _k.getValues().getPtr();
+    const T    ct  = T(c);
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int s = 0; s < nnz; s++ )
+      kv[s] = mv[s] + ct * av[s];
+
+    _kc = c;
+  }
+
+
+  /*! \brief Solve K x = b for a step of length dt, x is the initial guess
+   *
+   *  The factorization is used when it is for the same K, otherwise K is
+   *  formed for dt and solved with the conjugate gradient method.
+   */
+  template <typename T>
+  bool TransientSolver<T>::_solve( const DVector<T>& b, DVector<T>& x, double dt ) {
+
+    const double c = _coefficient( dt );
+
+    if( c == _c && _chol.isFactorized() ) {
+      _it = 0;
+      _chol.solve( b, x );
+      return true;
+    }
+
+    if( c != _kc ) {
+      _setMatrix( c );
+      _cg.compute( _k );
+    }
+
+    const bool ok = _cg.solve( _k, b, x );
+    _it = _cg.getIterations();
+    return ok;
+  }
+
+
+} // END namespace GMlib
@@ -0,0 +1,131 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+
+
+/*! \file gmtransientsolver.h
+ *
+ *  Interface for the Transient solver class.
+ */
+
+
+#ifndef GM_CORE_SOLVERS_TRANSIENTSOLVER_H
+#define GM_CORE_SOLVERS_TRANSIENTSOLVER_H
+
+
+
+// GMlib includes
+#include "../containers/gmdvector.h"
+#include "../containers/gmsparsematrix.h"
+#include "gmpcgsolver.h"
+#include "gmsparsecholesky.h"
+
+
+namespace GMlib {
+
+
+  /*! \class TransientSolver gmtransientsolver.h <gmTransientSolver>
+   *  \brief Time stepping of M u' + A u = f and M u'' + A u = f.
+   *
+   *  M (mass) and A (stiffness) are symmetric positive (semi-)definite
+   *  sparse matrices with the same pattern. Backward Euler and
+   *  Crank-Nicolson integrate the first order (heat) equation, Newmark-beta
+   *  the second order (wave) equation. Every step solves a system with
+   *  K = M + c A, where c is theta dt for the first order schemes and
+   *  beta dt^2 for Newmark.
+   *
+   *  compute() factorizes K for one time step, every step() of that length
+   *  is then a forward and a backward substitution. A step of another
+   *  length is solved with the conjugate gradient method instead, started
+   *  from the previous solution, and the factorization is kept. compute()
+   *  keeps pointers to M and A, they must outlive the solver (or the next
+   *  call to compute()).
+   *
+   *  The load f given to step() is the one at the end of the step,
+   *  Crank-Nicolson averages it with the load of the previous step.
+   */
+  template <typename T>
+  class TransientSolver {
+  public:
+    enum SCHEME {
+      SCHEME_BACKWARD_EULER,
+      SCHEME_CRANK_NICOLSON,
+      SCHEME_NEWMARK
+    };
+
+    TransientSolver( SCHEME s = SCHEME_BACKWARD_EULER );
+
+    bool                  compute( const SparseMatrix<T>& m, const SparseMatrix<T>& a, double dt );
+    const DVector<T>&     getAcceleration() const;
+    PCGSolver<T>&         getIterativeSolver();
+    int                   getIterations() const;
+    SCHEME                getScheme() const;
+    const DVector<T>&     getSolution() const;
+    double                getTime() const;
+    double                getTimeStep() const;
+    const DVector<T>&     getVelocity() const;
+    void                  setInitial( const DVector<T>& u, const DVector<T>& v = DVector<T>() );
+    void                  setNewmark( double beta, double gamma );
+    void                  setScheme( SCHEME s );
+    bool                  step( const DVector<T>& f );
+    bool                  step( const DVector<T>& f, double dt );
+
+  private:
+    SCHEME                  _scheme;
+    double                  _beta;
+    double                  _gamma;
+
+    const SparseMatrix<T>  *_m;
+    const SparseMatrix<T>  *_a;
+    SparseMatrix<T>         _k;     // M + _kc A
+    double                  _kc;
+    SparseCholesky<T>       _chol;  // Factorization of M + _c A
+    double                  _c;
+    PCGSolver<T>            _cg;
+    double                  _dt;
+    int                     _it;
+
+    double                  _t;
+    DVector<T>              _u, _v, _acc;
+    DVector<T>              _f;     // Load of the previous step
+    DVector<T>              _r, _w;
+
+    double                  _coefficient( double dt ) const;
+    void                    _setMatrix( double c );
+    bool                    _solve( const DVector<T>& b, DVector<T>& x, double dt );
+
+  }; // END class TransientSolver
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmtransientsolver.c"
+
+
+
+
+#endif // GM_CORE_SOLVERS_TRANSIENTSOLVER_H
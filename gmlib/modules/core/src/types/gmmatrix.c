@@ -30,7 +30,7 @@ namespace GMlib {
 
 
   template <typename T, int n, int m>
-  Vector<T,n>	Matrix<T,n,m>::_c;
+  thread_local Vector<T,n>	Matrix<T,n,m>::_c;
 
   template <typename T, int n, int m>
   M_I_<T,n,m>	Matrix<T,n,m>::_I;
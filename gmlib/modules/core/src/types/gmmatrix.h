@@ -128,7 +128,7 @@ namespace GMlib {
   protected:
 
     static              M_I_<T,n,m>    _I;
-    static              Vector<T,n>    _c;
+    static thread_local Vector<T,n>    _c;
 
     void                cpy();
     void                cpy(const T* v);
@@ -383,7 +383,7 @@ namespace GMlib {
     template <typename T>
     inline
     void compute2D( T& p, double du, double dv, bool closed_u, bool closed_v,
-                    int d1, int d2, int ed1, int ed2 ) {
+                    int d1, int d2, int ed1, int ed2, bool parallel ) {
 
       assert( ed1 >= 0 );
       assert( ed2 >= 0 );
@@ -403,6 +403,9 @@ namespace GMlib {
         int i1 = i-1;
 
         // ordinary divided differences
+#ifdef _OPENMP
+  #pragma omp parallel for if(parallel)
+#endif
         for(int k = 1; k < ku; ++k)       // data points u
           for(int l = 0; l < kv+1; ++l) { // data points v
             double scale = relationCK(p(k-1)(l)(0)(0), p(k)(l)(0)(0), p(k+1)(l)(0)(0));
@@ -411,6 +414,9 @@ namespace GMlib {
 
         if(closed_u) { // biting its own tail
 
+#ifdef _OPENMP
+  #pragma omp parallel for if(parallel)
+#endif
           for(int l = 0; l < kv+1; ++l) { // data points u
             double scale = relationCK(p(ku-1)(l)(0)(0), p(0)(l)(0)(0), p(1)(l)(0)(0));
             p[0 ][l][i][0] = scale * (p[1][l][i1][0] - p[ku-1][l][i1][0]) / du2;
@@ -419,6 +425,9 @@ namespace GMlib {
         }
         else { // second degree endpoints divided differences
 
+#ifdef _OPENMP
+  #pragma omp parallel for if(parallel)
+#endif
           for(int l = 0; l < kv+1; ++l) { // data points u
             double scale = relationCK(p(0)(l)(0)(0), p(1)(l)(0)(0), p(2)(l)(0)(0));
             p[0 ][l][i][0] = scale * ( 4*p[1   ][l][i1][0] - 3*p[0 ][l][i1][0] - p[2   ][l][i1][0] ) / du2;
@@ -437,6 +446,9 @@ namespace GMlib {
           int j1 = j-1;
 
           // ordinary divided differences
+#ifdef _OPENMP
+  #pragma omp parallel for if(parallel)
+#endif
           for(int k = 0; k < ku+1; ++k)   // data points u
             for(int l = 1; l < kv; ++l) {  // data points v
               double scale = relationCK(p(k)(l-1)(0)(0), p(k)(l)(0)(0), p(k)(l+1)(0)(0) );
@@ -445,6 +457,9 @@ namespace GMlib {
 
           if(closed_v) { // biting its own tail
 
+#ifdef _OPENMP
+  #pragma omp parallel for if(parallel)
+#endif
             for(int k = 0; k < ku+1; ++k) { // data points v
               double scale = relationCK(p(k)(kv-1)(0)(0), p(k)(0)(0)(0), p(k)(1)(0)(0) );
               p[k][0 ][i][j] = scale * (p[k][1][i][j1] - p[k][kv-1][i][j1]) / dv2;
@@ -453,6 +468,9 @@ namespace GMlib {
           }
           else { // second degree endpoints divided differences
 
+#ifdef _OPENMP
+  #pragma omp parallel for if(parallel)
+#endif
             for(int k = 0; k < ku+1; ++k) { // data points v
               double scale = relationCK(p(k)(0)(0)(0), p(k)(1)(0)(0), p(k)(2)(0)(0) );
               p[k][0 ][i][j] = scale * ( 4*p[k][1   ][i][j1] - 3*p[k][0 ][i][j1] - p[k][2   ][i][j1] ) / dv2;
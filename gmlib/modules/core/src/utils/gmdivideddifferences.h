@@ -34,8 +34,12 @@ namespace GMlib {
     template <typename T>
     void compute1D( T& p, double dt, bool closed, int d, int ed = 0 );
 
+    /*!
+     * With parallel set, the data point loops of each derivative level are shared by the OpenMP threads,
+     * otherwise they run on the calling thread.
+     */
     template <typename T>
-    void compute2D( T& p, double du, double dv, bool closed_u, bool closed_v, int d1, int d2, int ed1 = 0, int ed2 = 0 );
+    void compute2D( T& p, double du, double dv, bool closed_u, bool closed_v, int d1, int d2, int ed1 = 0, int ed2 = 0, bool parallel = false );
 
 
     /*!
@@ -0,0 +1,58 @@
+
+
+#include <gtest/gtest.h>
+
+#include <solvers/gmdensesolver.h>
+using namespace GMlib;
+
+
+namespace {
+
+  TEST(Core_Solvers, DenseSolver_cholesky) {
+
+    const int n = 8;
+    DMatrix<double> a( n, n, 0.0 );
+    for( int i = 0; i < n; i++ ) {
+      a[i][i] = 2.0;
+      if( i > 0 )   a[i][i-1] = -1.0;
+      if( i < n-1 ) a[i][i+1] = -1.0;
+    }
+
+    DenseSolver<double> s( a );
+    ASSERT_TRUE( s.isFactorized() );
+    EXPECT_TRUE( s.isCholesky() );
+
+    DVector<double> b( n, 1.0 );
+    DVector<double> x = s.solve( b );
+    for( int i = 0; i < n; i++ ) {
+      double r = 0.0;
+      for( int j = 0; j < n; j++ ) r += a(i)(j) * x(j);
+      EXPECT_NEAR( 1.0, r, 1e-12 );
+    }
+  }
+
+
+  TEST(Core_Solvers, DenseSolver_lu) {
+
+    DMatrix<double> a( 3, 3, 0.0 );
+    a[0][1] = 2.0;  a[0][2] =  1.0;
+    a[1][0] = 1.0;  a[1][2] = -1.0;
+    a[2][0] = 3.0;  a[2][1] =  1.0;
+
+    DenseSolver<double> s( a );
+    ASSERT_TRUE( s.isFactorized() );
+    EXPECT_FALSE( s.isCholesky() );
+
+    DVector<double> b(3);
+    b[0] = 3.0; b[1] = 0.0; b[2] = 4.0;
+    DVector<double> x = s.solve( b );
+    EXPECT_NEAR( 1.0, x[0], 1e-12 );
+    EXPECT_NEAR( 1.0, x[1], 1e-12 );
+    EXPECT_NEAR( 1.0, x[2], 1e-12 );
+
+    // Singular
+    a[2][0] = 1.0; a[2][1] = 2.0; a[2][2] = 0.0;
+    EXPECT_FALSE( s.factorize( a ) );
+  }
+
+}
@@ -0,0 +1,36 @@
+#ifndef GM_CORE_TESTS_GRIDLAPLACIAN_H
+#define GM_CORE_TESTS_GRIDLAPLACIAN_H
+
+
+#include <containers/gmsparsematrix.h>
+
+
+namespace {
+
+  // 5-point Laplacian on a m x m grid with Dirichlet boundary
+  inline
+  GMlib::SparseMatrix<double> makeGrid( int m ) {
+
+    GMlib::DVector<int> ei(2*m*m), ej(2*m*m);
+    int k = 0;
+    for( int i = 0; i < m; i++ )
+      for( int j = 0; j < m; j++ ) {
+        if( i+1 < m ) { ei[k] = i*m+j; ej[k] = (i+1)*m+j; k++; }
+        if( j+1 < m ) { ei[k] = i*m+j; ej[k] = i*m+j+1;   k++; }
+      }
+    ei.setDim(k);
+    ej.setDim(k);
+
+    GMlib::SparseMatrix<double> a( m*m, ei, ej );
+    for( int i = 0; i < m*m; i++ ) a.add( i, i, 4.0 );
+    for( int p = 0; p < k; p++ ) {
+      a.add( ei[p], ej[p], -1.0 );
+      a.add( ej[p], ei[p], -1.0 );
+    }
+    return a;
+  }
+
+}
+
+
+#endif // GM_CORE_TESTS_GRIDLAPLACIAN_H
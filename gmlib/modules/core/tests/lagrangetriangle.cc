@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <fem/gmlagrangetriangle.h>
+using namespace GMlib;
+
+#include <cmath>
+
+
+namespace {
+
+  template <int p>
+  void checkShapeFunctions() {
+
+    typedef LagrangeTriangle<double,p> Element;
+    const int n = Element::N;
+
+    // Nodal: phi_i(x_j) = delta_ij
+    for( int j = 0; j < n; j++ ) {
+      const Vector<double,Element::N> v = Element::eval( Element::getNode(j) );
+      for( int i = 0; i < n; i++ )
+        EXPECT_NEAR( i == j ? 1.0 : 0.0, v(i), 1e-13 ) << "p " << p;
+    }
+
+    // Partition of unity, and derivatives against central differences
+    const Point<double,2> x( 0.23, 0.41 );
+    const double          h = 1e-6;
+
+    const Vector<double,Element::N>              v  = Element::eval( x );
+    const Vector<Vector<double,2>,Element::N>    dv = Element::evalDerivatives( x );
+    const Vector<double,Element::N> vx0 = Element::eval( Point<double,2>( x[0]-h, x[1] ) );
+    const Vector<double,Element::N> vx1 = Element::eval( Point<double,2>( x[0]+h, x[1] ) );
+    const Vector<double,Element::N> vy0 = Element::eval( Point<double,2>( x[0], x[1]-h ) );
+    const Vector<double,Element::N> vy1 = Element::eval( Point<double,2>( x[0], x[1]+h ) );
+
+    double s = 0.0, sx = 0.0, sy = 0.0;
+    for( int i = 0; i < n; i++ ) {
+      s  += v(i);
+      sx += dv(i)(0);
+      sy += dv(i)(1);
+      EXPECT_NEAR( ( vx1(i) - vx0(i) ) / (2*h), dv(i)(0), 1e-7 );
+      EXPECT_NEAR( ( vy1(i) - vy0(i) ) / (2*h), dv(i)(1), 1e-7 );
+    }
+    EXPECT_NEAR( 1.0, s,  1e-13 );
+    EXPECT_NEAR( 0.0, sx, 1e-12 );
+    EXPECT_NEAR( 0.0, sy, 1e-12 );
+  }
+
+
+  TEST(Core_Fem, LagrangeTriangle_shapeFunctions) {
+
+    checkShapeFunctions<1>();
+    checkShapeFunctions<2>();
+    checkShapeFunctions<3>();
+  }
+
+
+  TEST(Core_Fem, LagrangeTriangle_linear) {
+
+    // The linear element against the closed form (cot formula)
+    LagrangeTriangle<double,1> e;
+    const Point<double,2> p[3] = { Point<double,2>( 0.1, 0.2 ), Point<double,2>( 1.3, 0.4 ), Point<double,2>( 0.5, 1.1 ) };
+
+    double ke[9], fe[3], me[9];
+    e.elementStiffness( p[0], p[1], p[2], ke );
+    e.elementLoad( p[0], p[1], p[2], fe );
+    e.elementMass( p[0], p[1], p[2], me );
+
+    const double area = 0.5 * std::abs( Vector<double,2>( p[1] - p[0] ) ^ ( p[2] - p[0] ) );
+    for( int i = 0; i < 3; i++ ) {
+      const Vector<double,2> a = p[(i+2)%3] - p[(i+1)%3];
+      EXPECT_NEAR( area / 3, fe[i], 1e-14 );
+      for( int j = 0; j < 3; j++ ) {
+        const Vector<double,2> b = p[(j+2)%3] - p[(j+1)%3];
+        EXPECT_NEAR( ( a * b ) / ( 4 * area ), ke[3*i+j], 1e-13 );
+        EXPECT_NEAR( area / 12 * ( i == j ? 2 : 1 ), me[3*i+j], 1e-14 );
+      }
+    }
+  }
+
+
+  // u^T K u = int |grad u|^2 for a polynomial u of degree p, interpolated exactly
+  template <int p, typename U, typename G>
+  void checkEnergy( U u, G grad ) {
+
+    typedef LagrangeTriangle<double,p> Element;
+    const int n = Element::N;
+
+    Element e;
+    const Point<double,2> p0( 0.3, -0.2 ), p1( 1.1, 0.5 ), p2( -0.4, 0.9 );
+    TriangleAffineMap<double> map( p0, p1, p2 );
+
+    double ke[n*n], fe[n], me[n*n];
+    e.elementStiffness( p0, p1, p2, ke );
+    e.elementLoad( p0, p1, p2, fe );
+    e.elementMass( p0, p1, p2, me );
+
+    double x[n];
+    for( int i = 0; i < n; i++ ) x[i] = u( map.map( Element::getNode(i) ) );
+
+    double energy = 0.0, load = 0.0, mass = 0.0;
+    for( int i = 0; i < n; i++ ) {
+      load += fe[i] * x[i];
+      for( int j = 0; j < n; j++ ) {
+        energy += x[i] * ke[n*i+j] * x[j];
+        mass   += me[n*i+j];
+      }
+    }
+
+    const double det = std::abs( map.getDeterminant() );
+    TriangleQuadrature<double,6> q;
+    const double e2 = det * q.integrate( [&]( const Point<double,2>& r ) {
+      const Vector<double,2> g = grad( map.map(r) ); return g * g; } );
+    const double e1 = det * q.integrate( [&]( const Point<double,2>& r ) { return u( map.map(r) ); } );
+
+    EXPECT_NEAR( e2, energy, 1e-12 ) << "p " << p;
+    EXPECT_NEAR( e1, load, 1e-12 ) << "p " << p;
+    EXPECT_NEAR( det / 2, mass, 1e-13 ) << "p " << p;
+
+    // Gradients mapped from the reference triangle
+    const Point<double,2>                     r( 0.2, 0.3 );
+    const Vector<Vector<double,2>,Element::N> d = Element::evalDerivatives( r );
+    Vector<double,2> g( 0.0, 0.0 );
+    for( int i = 0; i < n; i++ ) g += x[i] * map.mapGradient( d(i) );
+    EXPECT_NEAR( grad( map.map(r) )(0), g(0), 1e-12 );
+    EXPECT_NEAR( grad( map.map(r) )(1), g(1), 1e-12 );
+  }
+
+
+  TEST(Core_Fem, LagrangeTriangle_energy) {
+
+    checkEnergy<1>( []( const Point<double,2>& x ) { return 2.0*x[0] - x[1] + 0.5; },
+                    []( const Point<double,2>& )   { return Vector<double,2>( 2.0, -1.0 ); } );
+
+    checkEnergy<2>( []( const Point<double,2>& x ) { return x[0]*x[0] - 3.0*x[0]*x[1] + x[1]; },
+                    []( const Point<double,2>& x ) { return Vector<double,2>( 2.0*x[0] - 3.0*x[1], 1.0 - 3.0*x[0] ); } );
+
+    checkEnergy<3>( []( const Point<double,2>& x ) { return x[0]*x[0]*x[0] + x[0]*x[1]*x[1] - x[1]*x[1]; },
+                    []( const Point<double,2>& x ) { return Vector<double,2>( 3.0*x[0]*x[0] + x[1]*x[1], 2.0*x[0]*x[1] - 2.0*x[1] ); } );
+  }
+
+}
@@ -0,0 +1,148 @@
+
+
+#include <gtest/gtest.h>
+
+#include <solvers/gmmultigridsolver.h>
+#include <solvers/gmpcgsolver.h>
+using namespace GMlib;
+
+#include "gridlaplacian.h"
+
+#include <cmath>
+
+
+namespace {
+
+  // Bilinear interpolation from a mc x mc grid to a (2mc+1) x (2mc+1) grid
+  void insertBilinear( MultigridSolver<double>& mg, int mc ) {
+
+    const int m = 2*mc+1;
+    DVector<int>    row( m*m+1 ), col( 4*m*m );
+    DVector<double> val( 4*m*m );
+
+    int k = 0;
+    row[0] = 0;
+    for( int i = 0; i < m; i++ )
+      for( int j = 0; j < m; j++ ) {
+        for( int a = (i-1)/2; a <= i/2; a++ )
+          for( int b = (j-1)/2; b <= j/2; b++ ) {
+            if( a < 0 || a >= mc || b < 0 || b >= mc ) continue;
+            col[k] = a*mc+b;
+            val[k] = ( i%2 ? 1.0 : 0.5 ) * ( j%2 ? 1.0 : 0.5 );
+            k++;
+          }
+        row[i*m+j+1] = k;
+      }
+    col.setDim(k);
+    val.setDim(k);
+    mg.insertProlongation( mc*mc, row, col, val );
+  }
+
+
+  // Hierarchy from a 3 x 3 grid refined to (2^(levels+1) - 1)^2 unknowns
+  int makeHierarchy( MultigridSolver<double>& mg, int levels ) {
+
+    int m = 3;
+    for( int l = 1; l < levels; l++ ) {
+      insertBilinear( mg, m );
+      m = 2*m+1;
+    }
+    return m;
+  }
+
+
+  int cycles( MultigridSolver<double>& mg, int levels ) {
+
+    const int m = makeHierarchy( mg, levels );
+    SparseMatrix<double> a = makeGrid(m);
+    EXPECT_TRUE( mg.compute( a ) );
+    EXPECT_EQ( levels, mg.getNoLevels() );
+
+    DVector<double> x0( m*m );
+    for( int i = 0; i < m*m; i++ ) x0[i] = std::cos( 0.05*i );
+    DVector<double> b = a * x0;
+
+    DVector<double> x;
+    mg.setTolerance( 1e-10 );
+    EXPECT_TRUE( mg.solve( b, x ) );
+    for( int i = 0; i < m*m; i++ ) EXPECT_NEAR( x0[i], x[i], 1e-7 );
+    return mg.getIterations();
+  }
+
+
+  TEST(Core_Solvers, MultigridSolver_galerkin) {
+
+    MultigridSolver<double> mg;
+    const int m = makeHierarchy( mg, 2 );
+    SparseMatrix<double> a = makeGrid(m);
+    ASSERT_TRUE( mg.compute( a ) );
+
+    // P^T A P of the 5-point stencil is a 9-point stencil
+    const SparseMatrix<double>& c = mg.getMatrix(0);
+    EXPECT_EQ( 9, mg.getDim(0) );
+    EXPECT_EQ( 49, mg.getDim(1) );
+    EXPECT_DOUBLE_EQ( c(4,4), 3.0 );
+    EXPECT_DOUBLE_EQ( c(4,1), c(1,4) );
+    EXPECT_DOUBLE_EQ( c(4,0), c(0,4) );
+    EXPECT_NE( 0.0, c(4,0) );
+  }
+
+
+  TEST(Core_Solvers, MultigridSolver_cycles) {
+
+    // The number of cycles does not grow with the number of unknowns
+    for( int s = 0; s < 2; s++ )
+      for( int c = 0; c < 2; c++ ) {
+        MultigridSolver<double> a( static_cast<MultigridSolver<double>::CYCLE>(c),
+                                   static_cast<MultigridSolver<double>::SMOOTHER>(s) );
+        MultigridSolver<double> b( static_cast<MultigridSolver<double>::CYCLE>(c),
+                                   static_cast<MultigridSolver<double>::SMOOTHER>(s) );
+        const int na = cycles( a, 4 );
+        const int nb = cycles( b, 6 );
+        EXPECT_LE( na, 15 );
+        EXPECT_LE( nb, na + 2 );
+      }
+  }
+
+
+  TEST(Core_Solvers, MultigridSolver_oneLevel) {
+
+    MultigridSolver<double> mg;
+    SparseMatrix<double> a = makeGrid(10);
+    ASSERT_TRUE( mg.compute( a ) );
+
+    DVector<double> b( 100, 1.0 ), x;
+    EXPECT_TRUE( mg.solve( b, x ) );
+    EXPECT_EQ( 1, mg.getIterations() );
+
+    // Prolongation of the wrong size
+    MultigridSolver<double> bad;
+    makeHierarchy( bad, 3 );
+    EXPECT_FALSE( bad.compute( a ) );
+  }
+
+
+  TEST(Core_Solvers, MultigridSolver_preconditioner) {
+
+    MultigridSolver<double> mg;
+    const int m = makeHierarchy( mg, 6 );
+    SparseMatrix<double> a = makeGrid(m);
+    ASSERT_TRUE( mg.compute( a ) );
+
+    DVector<double> b( m*m, 1.0 );
+
+    PCGSolver<double> cg( PCGSolver<double>::PRECONDITIONER_IC0 );
+    cg.setTolerance( 1e-10 );
+    ASSERT_TRUE( cg.compute( a ) );
+
+    DVector<double> x;
+    ASSERT_TRUE( cg.solve( b, x ) );
+    const int ic0 = cg.getIterations();
+
+    DVector<double> y;
+    ASSERT_TRUE( cg.solve( a, mg, b, y ) );
+    EXPECT_LT( 2*cg.getIterations(), ic0 );
+    for( int i = 0; i < m*m; i++ ) EXPECT_NEAR( x[i], y[i], 1e-6 );
+  }
+
+}
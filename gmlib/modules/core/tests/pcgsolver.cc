@@ -0,0 +1,126 @@
+
+
+#include <gtest/gtest.h>
+
+#include <solvers/gmpcgsolver.h>
+using namespace GMlib;
+
+#include "gridlaplacian.h"
+
+#include <cmath>
+
+
+namespace {
+
+  // Matrix-free 1D Laplacian
+  struct Laplace1D {
+    void multiply( const DVector<double>& x, DVector<double>& y ) const {
+      const int n = x.getDim();
+      y.setDim( n );
+      for( int i = 0; i < n; i++ )
+        y[i] = 2.0*x(i) - ( i > 0 ? x(i-1) : 0.0 ) - ( i < n-1 ? x(i+1) : 0.0 );
+    }
+  };
+
+
+  TEST(Core_Solvers, PCGSolver_preconditioners) {
+
+    const int m = 25;
+    SparseMatrix<double> a = makeGrid(m);
+
+    DVector<double> x0( m*m );
+    for( int i = 0; i < m*m; i++ ) x0[i] = std::cos( 0.05*i );
+    DVector<double> b = a * x0;
+
+    int it[4];
+    for( int p = 0; p < 4; p++ ) {
+      PCGSolver<double> cg( static_cast<PCGSolver<double>::PRECONDITIONER>(p) );
+      cg.setTolerance( 1e-10 );
+      cg.setOmega( 1.5 );
+      ASSERT_TRUE( cg.compute( a ) );
+
+      DVector<double> x;
+      EXPECT_TRUE( cg.solve( b, x ) );
+      EXPECT_LE( cg.getResidual(), 1e-10 );
+      for( int i = 0; i < m*m; i++ ) EXPECT_NEAR( x0[i], x[i], 1e-7 );
+      it[p] = cg.getIterations();
+    }
+
+    EXPECT_LT( it[PCGSolver<double>::PRECONDITIONER_IC0],  it[PCGSolver<double>::PRECONDITIONER_NONE] );
+    EXPECT_LT( it[PCGSolver<double>::PRECONDITIONER_SSOR], it[PCGSolver<double>::PRECONDITIONER_NONE] );
+  }
+
+
+  TEST(Core_Solvers, PCGSolver_warmStart) {
+
+    const int m = 20;
+    SparseMatrix<double> a = makeGrid(m);
+    DVector<double> b( m*m, 1.0 ), x;
+
+    PCGSolver<double> cg( PCGSolver<double>::PRECONDITIONER_IC0 );
+    cg.compute( a );
+    ASSERT_TRUE( cg.solve( b, x ) );
+    const int cold = cg.getIterations();
+    EXPECT_GT( cold, 0 );
+
+    // Same right hand side, the previous solution is already converged
+    ASSERT_TRUE( cg.solve( b, x ) );
+    EXPECT_EQ( 0, cg.getIterations() );
+
+    // Slightly changed load
+    b *= 1.01;
+    ASSERT_TRUE( cg.solve( b, x ) );
+    EXPECT_LT( cg.getIterations(), cold );
+
+    // Iteration cap
+    DVector<double> y;
+    cg.setMaxIterations( 2 );
+    EXPECT_FALSE( cg.solve( b, y ) );
+    EXPECT_EQ( 2, cg.getIterations() );
+  }
+
+
+  TEST(Core_Solvers, PCGSolver_ic0Fallback) {
+
+    const int m = 20;
+    SparseMatrix<double> a = makeGrid(m);
+
+    // Indefinite, IC0 breaks down also with a shifted diagonal
+    SparseMatrix<double> bad = makeGrid(m);
+    bad.add( m, m, -8.0 );
+
+    PCGSolver<double> cg( PCGSolver<double>::PRECONDITIONER_IC0 );
+    EXPECT_FALSE( cg.compute( bad ) );
+    EXPECT_EQ( PCGSolver<double>::PRECONDITIONER_IC0,    cg.getPreconditioner() );
+    EXPECT_EQ( PCGSolver<double>::PRECONDITIONER_JACOBI, cg.getActivePreconditioner() );
+
+    // The next matrix gets IC0 again
+    ASSERT_TRUE( cg.compute( a ) );
+    EXPECT_EQ( PCGSolver<double>::PRECONDITIONER_IC0, cg.getActivePreconditioner() );
+
+    PCGSolver<double> jacobi( PCGSolver<double>::PRECONDITIONER_JACOBI );
+    ASSERT_TRUE( jacobi.compute( a ) );
+
+    DVector<double> b( m*m, 1.0 ), x, y;
+    ASSERT_TRUE( cg.solve( b, x ) );
+    ASSERT_TRUE( jacobi.solve( b, y ) );
+    EXPECT_LT( cg.getIterations(), jacobi.getIterations() );
+  }
+
+
+  TEST(Core_Solvers, PCGSolver_matrixFree) {
+
+    const int n = 50;
+    PCGSolver<double> cg( PCGSolver<double>::PRECONDITIONER_JACOBI );
+    cg.setDiagonal( DVector<double>( n, 2.0 ) );
+    cg.setTolerance( 1e-12 );
+
+    DVector<double> b( n, 1.0 ), x;
+    ASSERT_TRUE( cg.solve( Laplace1D(), b, x ) );
+
+    DVector<double> r;
+    Laplace1D().multiply( x, r );
+    for( int i = 0; i < n; i++ ) EXPECT_NEAR( 1.0, r[i], 1e-9 );
+  }
+
+}
@@ -0,0 +1,147 @@
+
+
+#include <gtest/gtest.h>
+
+#include <containers/gmsparseassembler.h>
+using namespace GMlib;
+
+
+namespace {
+
+  // Chain of n+1 line elements, the end nodes are not unknowns
+  TEST(Core_Containers, SparseAssembler_line) {
+
+    const int n = 20;
+
+    DVector<int> elem( 2*(n+1) );
+    for( int e = 0; e <= n; e++ ) {
+      elem[2*e]   = e-1;
+      elem[2*e+1] = e < n ? e : -1;
+    }
+
+    SparseAssembler<double> asmb(2);
+    asmb.setElements( n, elem );
+    ASSERT_EQ( n+1, asmb.getNoElements() );
+    EXPECT_EQ( 3*n-2, asmb.getMatrix().getNoNonZeros() );
+
+    for( int e = 0; e < asmb.getNoElements(); e++ ) {
+      double *ke = asmb.getElementMatrix(e);
+      ke[0] =  1.0; ke[1] = -1.0;
+      ke[2] = -1.0; ke[3] =  1.0;
+      double *fe = asmb.getElementVector(e);
+      fe[0] = fe[1] = 0.5;
+    }
+
+    // Twice, the result must not accumulate
+    asmb.assemble();
+    asmb.assemble();
+
+    const SparseMatrix<double>& a = asmb.getMatrix();
+    for( int i = 0; i < n; i++ ) {
+      EXPECT_DOUBLE_EQ( 2.0, a(i,i) );
+      if( i+1 < n ) {
+        EXPECT_DOUBLE_EQ( -1.0, a(i,i+1) );
+        EXPECT_DOUBLE_EQ( -1.0, a(i+1,i) );
+      }
+      EXPECT_DOUBLE_EQ( 1.0, asmb.getVector()[i] );
+    }
+  }
+
+
+  // A second matrix on the same elements, line mass matrices
+  TEST(Core_Containers, SparseAssembler_otherMatrix) {
+
+    const int n = 12;
+
+    DVector<int> elem( 2*(n+1) );
+    for( int e = 0; e <= n; e++ ) {
+      elem[2*e]   = e-1;
+      elem[2*e+1] = e < n ? e : -1;
+    }
+
+    SparseAssembler<double> asmb(2);
+    asmb.setElements( n, elem );
+
+    DVector<double> me( 4*asmb.getNoElements() );
+    for( int e = 0; e < asmb.getNoElements(); e++ ) {
+      me[4*e]   = 2.0; me[4*e+1] = 1.0;
+      me[4*e+2] = 1.0; me[4*e+3] = 2.0;
+    }
+
+    SparseMatrix<double> m;
+    asmb.assemble( me, m );
+
+    ASSERT_EQ( n, m.getDim() );
+    EXPECT_EQ( asmb.getMatrix().getNoNonZeros(), m.getNoNonZeros() );
+    for( int i = 0; i < n; i++ ) {
+      EXPECT_DOUBLE_EQ( 4.0, m(i,i) );
+      if( i+1 < n ) {
+        EXPECT_DOUBLE_EQ( 1.0, m(i,i+1) );
+      }
+    }
+
+    // The matrix of the assembler is not touched
+    EXPECT_DOUBLE_EQ( 0.0, asmb.getMatrix()(0,0) );
+
+    // Renumbered nodes: same size, other pattern
+    for( int e = 0; e <= n; e++ ) {
+      elem[2*e]   = e > 0 ? (5*(e-1)) % n : -1;
+      elem[2*e+1] = e < n ? (5*e) % n : -1;
+    }
+    asmb.setElements( n, elem );
+    ASSERT_EQ( asmb.getMatrix().getNoNonZeros(), m.getNoNonZeros() );
+
+    asmb.assemble( me, m );
+    for( int e = 1; e < n; e++ ) {
+      EXPECT_DOUBLE_EQ( 1.0, m( (5*(e-1)) % n, (5*e) % n ) );
+    }
+  }
+
+
+  // Chain with the end values prescribed, the linear interpolation of
+  // them solves the lifted system
+  TEST(Core_Containers, SparseAssembler_lift) {
+
+    const int    n  = 15;
+    const double g0 = 2.0, g1 = -1.0;
+
+    DVector<int> elem( 2*(n+1) );
+    for( int e = 0; e <= n; e++ ) {
+      elem[2*e]   = e > 0 ? e-1 : -1;
+      elem[2*e+1] = e < n ? e   : -2;
+    }
+
+    SparseAssembler<double> asmb(2);
+    asmb.setElements( n, elem );
+    for( int e = 0; e < asmb.getNoElements(); e++ ) {
+      double *ke = asmb.getElementMatrix(e);
+      ke[0] =  1.0; ke[1] = -1.0;
+      ke[2] = -1.0; ke[3] =  1.0;
+    }
+    asmb.assemble();
+    EXPECT_EQ( 3*n-2, asmb.getMatrix().getNoNonZeros() );
+
+    DVector<double> g(2), b( n, 0.0 );
+    g[0] = g0;
+    g[1] = g1;
+    asmb.lift( g, b );
+    EXPECT_DOUBLE_EQ( g0, b[0] );
+    EXPECT_DOUBLE_EQ( g1, b[n-1] );
+
+    DVector<double> x(n);
+    for( int i = 0; i < n; i++ ) x[i] = g0 + (g1-g0)*(i+1)/(n+1);
+    DVector<double> r = asmb.getMatrix() * x;
+    for( int i = 0; i < n; i++ )
+      EXPECT_NEAR( b[i], r[i], 1e-12 );
+
+    // Other values, same matrix
+    g[1] = 4.0;
+    b.clear();
+    asmb.lift( g, b );
+    EXPECT_DOUBLE_EQ( g0, b[0] );
+    EXPECT_DOUBLE_EQ( 4.0, b[n-1] );
+    for( int i = 1; i < n-1; i++ )
+      EXPECT_DOUBLE_EQ( 0.0, b[i] );
+  }
+
+}
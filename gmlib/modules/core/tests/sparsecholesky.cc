@@ -0,0 +1,149 @@
+
+
+#include <gtest/gtest.h>
+
+#include <solvers/gmsparsecholesky.h>
+using namespace GMlib;
+
+#include "gridlaplacian.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+  TEST(Core_Solvers, GraphOrdering_nestedDissection) {
+
+    SparseMatrix<double> a = makeGrid(40);
+
+    DVector<int> perm, pinv;
+    GMgraph::nestedDissection( a.getRowStart(), a.getColumns(), perm, 8 );
+    ASSERT_EQ( a.getDim(), perm.getDim() );
+
+    DVector<int> seen( a.getDim(), 0 );
+    for( int k = 0; k < perm.getDim(); k++ ) seen[perm[k]]++;
+    for( int k = 0; k < perm.getDim(); k++ ) EXPECT_EQ( 1, seen[k] );
+
+    GMgraph::invertPermutation( perm, pinv );
+    for( int k = 0; k < perm.getDim(); k++ ) EXPECT_EQ( k, pinv[perm[k]] );
+  }
+
+
+  TEST(Core_Solvers, GraphOrdering_reverseCuthillMcKee) {
+
+    // Grid with randomly numbered vertices, and a few isolated ones
+    const int m = 40, n = m*m + 3;
+    SparseMatrix<double> a = makeGrid(m);
+
+    std::vector<int> q( m*m );
+    for( int i = 0; i < m*m; i++ ) q[i] = i;
+    std::shuffle( q.begin(), q.end(), std::default_random_engine(3) );
+
+    std::vector<std::vector<int>> adj( n );
+    for( int i = 0; i < m*m; i++ )
+      for( int k = a.getRowStart()(i); k < a.getRowStart()(i+1); k++ )
+        adj[q[i]].push_back( q[a.getColumns()(k)] );
+
+    DVector<int> row( n+1 ), col( a.getNoNonZeros() );
+    row[0] = 0;
+    for( int i = 0; i < n; i++ ) {
+      std::copy( adj[i].begin(), adj[i].end(), col.getPtr() + row[i] );
+      row[i+1] = row[i] + int( adj[i].size() );
+    }
+
+    DVector<int> perm, pinv;
+    GMgraph::reverseCuthillMcKee( row, col, perm );
+    ASSERT_EQ( n, perm.getDim() );
+
+    DVector<int> seen( n, 0 );
+    for( int k = 0; k < n; k++ ) seen[perm[k]]++;
+    for( int k = 0; k < n; k++ ) EXPECT_EQ( 1, seen[k] );
+
+    // Bandwidth of about one grid row
+    GMgraph::invertPermutation( perm, pinv );
+    int bw = 0;
+    for( int i = 0; i < n; i++ )
+      for( int k = row[i]; k < row[i+1]; k++ )
+        bw = std::max( bw, std::abs( pinv[i] - pinv[col[k]] ) );
+    EXPECT_LE( bw, m+1 );
+  }
+
+
+  TEST(Core_Solvers, SparseCholesky_solve) {
+
+    const int m = 30;
+    SparseMatrix<double> a = makeGrid(m);
+
+    DVector<double> x0( m*m );
+    for( int i = 0; i < m*m; i++ ) x0[i] = std::sin( 0.1*i );
+    DVector<double> b = a * x0;
+
+    SparseCholesky<double> chol( a );
+    ASSERT_TRUE( chol.isFactorized() );
+
+    // Fill should stay far below the dense triangle
+    EXPECT_LT( chol.getNoNonZerosL(), m*m*m*m / 20 );
+
+    DVector<double> x = chol.solve( b );
+    for( int i = 0; i < m*m; i++ ) EXPECT_NEAR( x0[i], x[i], 1e-10 );
+  }
+
+
+  TEST(Core_Solvers, SparseCholesky_refactorize) {
+
+    const int m = 12;
+    SparseMatrix<double> a = makeGrid(m);
+    SparseCholesky<double> chol( a );
+
+    a *= 2.0;
+    ASSERT_TRUE( chol.refactorize( a ) );
+
+    DVector<double> b( m*m, 2.0 ), x;
+    chol.solve( b, x );
+    DVector<double> r = a * x;
+    for( int i = 0; i < m*m; i++ ) EXPECT_NEAR( 2.0, r[i], 1e-10 );
+
+    // Not positive definite
+    a *= -1.0;
+    EXPECT_FALSE( chol.refactorize( a ) );
+  }
+
+
+  TEST(Core_Solvers, SparseCholesky_refactorizePattern) {
+
+    const int m = 12, n = m*m;
+    SparseMatrix<double> a = makeGrid(m);
+    SparseCholesky<double> chol( a );
+
+    // The grid with renumbered vertices, same size and number of non-zeros
+    DVector<int> ei, ej;
+    for( int i = 0; i < n; i++ )
+      for( int k = a.getRowStart()(i); k < a.getRowStart()(i+1); k++ )
+        if( i < a.getColumns()(k) ) {
+          ei.append( (7*i) % n );
+          ej.append( (7*a.getColumns()(k)) % n );
+        }
+
+    SparseMatrix<double> b( n, ei, ej );
+    for( int i = 0; i < n; i++ ) b.add( i, i, 4.0 );
+    for( int p = 0; p < ei.getDim(); p++ ) {
+      b.add( ei[p], ej[p], -1.0 );
+      b.add( ej[p], ei[p], -1.0 );
+    }
+    ASSERT_EQ( a.getNoNonZeros(), b.getNoNonZeros() );
+    EXPECT_FALSE( b.hasPattern( a.getRowStart(), a.getColumns() ) );
+
+    EXPECT_FALSE( chol.refactorize( b ) );
+    EXPECT_FALSE( chol.isFactorized() );
+
+    ASSERT_TRUE( chol.factorize( b ) );
+    DVector<double> x0( n ), x;
+    for( int i = 0; i < n; i++ ) x0[i] = std::cos( 0.2*i );
+    chol.solve( b * x0, x );
+    for( int i = 0; i < n; i++ ) EXPECT_NEAR( x0[i], x[i], 1e-10 );
+  }
+
+}
@@ -0,0 +1,84 @@
+
+
+#include <gtest/gtest.h>
+
+#include <containers/gmsparsematrix.h>
+using namespace GMlib;
+
+
+namespace {
+
+  // 1D Laplacian pattern: pairs (i,i+1), with one duplicated pair
+  SparseMatrix<double> makeLaplace( int n ) {
+
+    DVector<int> ei(n), ej(n);
+    for( int i = 0; i < n-1; i++ ) { ei[i] = i; ej[i] = i+1; }
+    ei[n-1] = 1; ej[n-1] = 0;
+
+    SparseMatrix<double> a( n, ei, ej );
+    for( int i = 0; i < n-1; i++ ) {
+      a.add( i,   i,    1.0 );
+      a.add( i+1, i+1,  1.0 );
+      a.add( i,   i+1, -1.0 );
+      a.add( i+1, i,   -1.0 );
+    }
+    return a;
+  }
+
+
+  TEST(Core_Containers, SparseMatrix_pattern) {
+
+    const int n = 10;
+    SparseMatrix<double> a = makeLaplace(n);
+
+    EXPECT_EQ( n, a.getDim() );
+    EXPECT_EQ( 3*n-2, a.getNoNonZeros() );
+
+    for( int i = 0; i < n; i++ )
+      for( int j = 0; j < n; j++ )
+        EXPECT_EQ( std::abs(i-j) <= 1, a.getIndex(i,j) >= 0 );
+  }
+
+
+  TEST(Core_Containers, SparseMatrix_assemble) {
+
+    const int n = 10;
+    SparseMatrix<double> a = makeLaplace(n);
+
+    EXPECT_DOUBLE_EQ(  1.0, a(0,0) );
+    EXPECT_DOUBLE_EQ(  2.0, a(5,5) );
+    EXPECT_DOUBLE_EQ( -1.0, a(4,5) );
+    EXPECT_DOUBLE_EQ(  0.0, a(0,5) );
+
+    // Values outside the pattern are ignored
+    a.add( 0, 5, 3.0 );
+    EXPECT_DOUBLE_EQ(  0.0, a(0,5) );
+
+    a.clear();
+    EXPECT_DOUBLE_EQ(  0.0, a(5,5) );
+    EXPECT_EQ( 3*n-2, a.getNoNonZeros() );
+  }
+
+
+  TEST(Core_Containers, SparseMatrix_multiply) {
+
+    const int n = 17;
+    SparseMatrix<double> a = makeLaplace(n);
+    DMatrix<double>      d = a.toDMatrix();
+
+    DVector<double> x(n);
+    for( int i = 0; i < n; i++ ) x[i] = 0.5*i*i - 3.0*i + 1.0;
+
+    DVector<double> y = a * x;
+    for( int i = 0; i < n; i++ ) {
+      double s = 0.0;
+      for( int j = 0; j < n; j++ ) s += d(i)(j) * x(j);
+      EXPECT_DOUBLE_EQ( s, y(i) );
+    }
+
+    DVector<double> diag = a.getDiagonal();
+    EXPECT_DOUBLE_EQ( 1.0, diag(0) );
+    EXPECT_DOUBLE_EQ( 2.0, diag(n/2) );
+  }
+
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include <solvers/gmtransientsolver.h>
+using namespace GMlib;
+
+#include <cmath>
+
+
+namespace {
+
+  // 1D tridiagonal c1 * tridiag(-1,2,-1) + c0 * tridiag(1,4,1)/6 on n nodes
+  SparseMatrix<double> makeTridiag( int n, double c1, double c0 ) {
+
+    DVector<int> ei(n-1), ej(n-1);
+    for( int i = 0; i < n-1; i++ ) { ei[i] = i; ej[i] = i+1; }
+
+    SparseMatrix<double> a( n, ei, ej );
+    for( int i = 0; i < n; i++ ) a.add( i, i, 2.0*c1 + 4.0*c0/6.0 );
+    for( int i = 0; i < n-1; i++ ) {
+      a.add( i, i+1, -c1 + c0/6.0 );
+      a.add( i+1, i, -c1 + c0/6.0 );
+    }
+    return a;
+  }
+
+
+  // Identity with the pattern of makeTridiag
+  SparseMatrix<double> makeIdentity( int n ) {
+
+    SparseMatrix<double> m = makeTridiag( n, 0.0, 0.0 );
+    for( int i = 0; i < n; i++ ) m.add( i, i, 1.0 );
+    return m;
+  }
+
+
+  // Eigenvector k of tridiag(-1,2,-1), the eigenvalue is 2 - 2 cos(k pi/(n+1))
+  DVector<double> mode( int n, int k ) {
+
+    DVector<double> u(n);
+    for( int i = 0; i < n; i++ ) u[i] = std::sin( k*M_PI*(i+1)/(n+1) );
+    return u;
+  }
+
+
+  TEST(Core_Solvers, TransientSolver_firstOrder) {
+
+    const int    n      = 30;
+    const double dt     = 0.5;
+    const double lambda = 2.0 - 2.0*std::cos( M_PI/(n+1) );
+
+    SparseMatrix<double> m = makeIdentity(n);
+    SparseMatrix<double> a = makeTridiag( n, 1.0, 0.0 );
+    DVector<double>      f( n, 0.0 );
+    DVector<double>      u0 = mode( n, 1 );
+
+    // A single mode decays by the amplification factor of the scheme
+    const double g[2] = { 1.0 / ( 1.0 + dt*lambda ),
+                          ( 1.0 - 0.5*dt*lambda ) / ( 1.0 + 0.5*dt*lambda ) };
+
+    for( int s = 0; s < 2; s++ ) {
+      TransientSolver<double> ts( s == 0 ? TransientSolver<double>::SCHEME_BACKWARD_EULER
+                                         : TransientSolver<double>::SCHEME_CRANK_NICOLSON );
+      ASSERT_TRUE( ts.compute( m, a, dt ) );
+      ts.setInitial( u0 );
+
+      for( int k = 0; k < 10; k++ ) {
+        EXPECT_TRUE( ts.step( f ) );
+        EXPECT_EQ( 0, ts.getIterations() );
+      }
+      EXPECT_DOUBLE_EQ( 10*dt, ts.getTime() );
+
+      const double c = std::pow( g[s], 10 );
+      for( int i = 0; i < n; i++ )
+        EXPECT_NEAR( c*u0(i), ts.getSolution()(i), 1e-12 );
+    }
+  }
+
+
+  TEST(Core_Solvers, TransientSolver_steadyState) {
+
+    const int n = 20;
+    SparseMatrix<double> m = makeTridiag( n, 0.0, 1.0 );
+    SparseMatrix<double> a = makeTridiag( n, 1.0, 0.0 );
+    DVector<double>      f( n, 1.0 );
+
+    // A constant load drives the heat equation to A u = f
+    TransientSolver<double> ts;
+    ASSERT_TRUE( ts.compute( m, a, 100.0 ) );
+    for( int k = 0; k < 50; k++ )
+      ts.step( f );
+
+    DVector<double> r = a * ts.getSolution();
+    for( int i = 0; i < n; i++ )
+      EXPECT_NEAR( 1.0, r(i), 1e-8 );
+  }
+
+
+  TEST(Core_Solvers, TransientSolver_newmarkEnergy) {
+
+    const int    n  = 40;
+    const double dt = 0.3;
+
+    SparseMatrix<double> m = makeTridiag( n, 0.0, 1.0 );
+    SparseMatrix<double> a = makeTridiag( n, 1.0, 0.0 );
+    DVector<double>      f( n, 0.0 );
+
+    DVector<double> u0 = mode( n, 1 ) + 0.3 * mode( n, 5 );
+    DVector<double> v0 = 0.2 * mode( n, 2 );
+
+    auto energy = [&]( const DVector<double>& u, const DVector<double>& v ) {
+      return 0.5 * ( v * ( m * v ) ) + 0.5 * ( u * ( a * u ) );
+    };
+
+    // The average acceleration method conserves the energy without load
+    TransientSolver<double> ts( TransientSolver<double>::SCHEME_NEWMARK );
+    ASSERT_TRUE( ts.compute( m, a, dt ) );
+    ts.setInitial( u0, v0 );
+
+    const double e0 = energy( u0, v0 );
+    for( int k = 0; k < 200; k++ ) {
+      ts.step( f );
+      EXPECT_EQ( 0, ts.getIterations() );
+    }
+    EXPECT_NEAR( e0, energy( ts.getSolution(), ts.getVelocity() ), 1e-10 * e0 );
+
+    // The motion does not stay at the start
+    double d = 0.0;
+    for( int i = 0; i < n; i++ ) d += std::abs( ts.getSolution()(i) - u0(i) );
+    EXPECT_GT( d, 1e-3 );
+  }
+
+
+  TEST(Core_Solvers, TransientSolver_otherTimeStep) {
+
+    const int n = 25;
+    SparseMatrix<double> m = makeTridiag( n, 0.0, 1.0 );
+    SparseMatrix<double> a = makeTridiag( n, 4.0, 0.0 );
+    DVector<double>      u0 = mode( n, 2 );
+    DVector<double>      f( n );
+    for( int i = 0; i < n; i++ ) f[i] = 0.1*i;
+
+    for( int s = 0; s < 3; s++ ) {
+      const typename TransientSolver<double>::SCHEME scheme =
+          static_cast<TransientSolver<double>::SCHEME>(s);
+
+      // Steps of another length than the factorized one use CG
+      TransientSolver<double> ts( scheme ), ref( scheme );
+      ts.getIterativeSolver().setTolerance( 1e-12 );
+      ref.getIterativeSolver().setTolerance( 1e-12 );
+      ASSERT_TRUE( ts.compute( m, a, 0.1 ) );
+      ASSERT_TRUE( ref.compute( m, a, 0.05 ) );
+      ts.setInitial( u0 );
+      ref.setInitial( u0 );
+
+      for( int k = 0; k < 6; k++ ) {
+        EXPECT_TRUE( ts.step( f, 0.05 ) );
+        EXPECT_GT( ts.getIterations(), 0 );
+        ref.step( f );
+      }
+      for( int i = 0; i < n; i++ )
+        EXPECT_NEAR( ref.getSolution()(i), ts.getSolution()(i), 1e-9 );
+
+      // And the factorization is still used for its own length
+      ts.step( f, 0.1 );
+      EXPECT_EQ( 0, ts.getIterations() );
+    }
+  }
+
+
+  TEST(Core_Solvers, TransientSolver_renumbered) {
+
+    // The chain of makeTridiag with node i numbered q(i): same size and
+    // number of non-zeros, other pattern
+    const int    n  = 30;
+    const double dt = 0.5;
+    auto q = [n]( int i ) { return ( 7*i ) % n; };
+
+    DVector<int> ei(n-1), ej(n-1);
+    for( int i = 0; i < n-1; i++ ) { ei[i] = q(i); ej[i] = q(i+1); }
+    SparseMatrix<double> ap( n, ei, ej ), mp( n, ei, ej );
+    for( int i = 0; i < n; i++ ) { ap.add( i, i, 2.0 ); mp.add( i, i, 1.0 ); }
+    for( int i = 0; i < n-1; i++ ) {
+      ap.add( q(i), q(i+1), -1.0 );
+      ap.add( q(i+1), q(i), -1.0 );
+    }
+
+    SparseMatrix<double> m = makeIdentity(n);
+    SparseMatrix<double> a = makeTridiag( n, 1.0, 0.0 );
+    DVector<double>      u0 = mode( n, 2 ), up(n);
+    for( int i = 0; i < n; i++ ) up[q(i)] = u0[i];
+
+    TransientSolver<double> ref, ts;
+    ASSERT_TRUE( ref.compute( m, a, dt ) );
+    ASSERT_TRUE( ts.compute( m, a, dt ) );
+    ASSERT_TRUE( ts.compute( mp, ap, dt ) );
+
+    ref.setInitial( u0 );
+    ts.setInitial( up );
+    for( int k = 0; k < 3; k++ ) {
+      ASSERT_TRUE( ref.step( DVector<double>( n, 1.0 ) ) );
+      ASSERT_TRUE( ts.step( DVector<double>( n, 1.0 ) ) );
+    }
+    for( int i = 0; i < n; i++ )
+      EXPECT_NEAR( ref.getSolution()(i), ts.getSolution()(q(i)), 1e-12 );
+  }
+
+
+  TEST(Core_Solvers, TransientSolver_patternMismatch) {
+
+    SparseMatrix<double> m( 10 );
+    SparseMatrix<double> a = makeTridiag( 10, 1.0, 0.0 );
+
+    TransientSolver<double> ts;
+    EXPECT_FALSE( ts.compute( m, a, 0.1 ) );
+    EXPECT_FALSE( ts.step( DVector<double>( 10, 0.0 ) ) );
+
+    // Same size and number of non-zeros, the chain is renumbered
+    DVector<int> ei(9), ej(9);
+    for( int i = 0; i < 9; i++ ) { ei[i] = (3*i) % 10; ej[i] = (3*i+3) % 10; }
+    SparseMatrix<double> p( 10, ei, ej );
+    for( int i = 0; i < 10; i++ ) p.add( i, i, 1.0 );
+    ASSERT_EQ( a.getNoNonZeros(), p.getNoNonZeros() );
+
+    EXPECT_FALSE( ts.compute( p, a, 0.1 ) );
+    EXPECT_FALSE( ts.step( DVector<double>( 10, 0.0 ) ) );
+    SparseMatrix<double> id = makeIdentity( 10 );
+    EXPECT_TRUE( ts.compute( id, a, 0.1 ) );
+  }
+
+}
@@ -0,0 +1,85 @@
+
+
+#include <gtest/gtest.h>
+
+#include <fem/gmtrianglekernels.h>
+#include <fem/gmlagrangetriangle.h>
+using namespace GMlib;
+
+#include <random>
+#include <vector>
+
+
+namespace {
+
+  // n triangles, both orientations, as SoA corners
+  template <typename T>
+  std::vector<T> makeTriangles( int n ) {
+
+    std::default_random_engine             generator(7);
+    std::uniform_real_distribution<double> distribution( -1.0, 1.0 );
+
+    std::vector<T> xy( 6*n );
+    for( int e = 0; e < n; e++ )
+      for( int c = 0; c < 6; c++ ) xy[c*n+e] = T( distribution(generator) );
+    return xy;
+  }
+
+
+  template <typename T>
+  void checkLinear( int n, double tol ) {
+
+    const std::vector<T> xy = makeTriangles<T>(n);
+    std::vector<T>       ke( 9*n ), fe( 3*n );
+    linearTriangleElements( n, xy.data(), ke.data(), fe.data() );
+
+    for( int e = 0; e < n; e++ ) {
+
+      Point<double,2> p[3];
+      for( int i = 0; i < 3; i++ ) p[i] = Point<double,2>( xy[2*i*n+e], xy[(2*i+1)*n+e] );
+
+      // Reference from the tables of the linear Lagrange element
+      const LagrangeTriangle<double,1> element;
+      double k[3][3], f[3];
+      element.elementStiffness( p[0], p[1], p[2], k[0] );
+      element.elementLoad( p[0], p[1], p[2], f );
+
+      const double scale = std::abs( k[0][0] ) + 1.0;
+      for( int i = 0; i < 3; i++ ) {
+        EXPECT_NEAR( f[i], fe[3*e+i], tol ) << "element " << e;
+        for( int j = 0; j < 3; j++ )
+          EXPECT_NEAR( k[i][j], ke[9*e+3*i+j], tol * scale ) << "element " << e;
+      }
+    }
+  }
+
+
+  TEST(Core_Fem, TriangleKernels_linearDouble) {
+
+    // Full blocks and a tail
+    checkLinear<double>( 37, 1e-10 );
+  }
+
+
+  TEST(Core_Fem, TriangleKernels_linearFloat) {
+
+    checkLinear<float>( 16, 1e-4 );
+    checkLinear<float>( 5,  1e-4 );
+  }
+
+
+  TEST(Core_Fem, TriangleKernels_rowSums) {
+
+    // Constants are in the kernel: the rows of the stiffness matrix sum to zero
+    const int          n  = 100;
+    const std::vector<float> xy = makeTriangles<float>(n);
+    std::vector<float> ke( 9*n ), fe( 3*n );
+    linearTriangleElements( n, xy.data(), ke.data(), fe.data() );
+
+    for( int e = 0; e < 3*n; e++ ) {
+      const float s = std::abs( ke[3*e] ) + std::abs( ke[3*e+1] ) + std::abs( ke[3*e+2] );
+      EXPECT_NEAR( 0.0f, ke[3*e] + ke[3*e+1] + ke[3*e+2], 1e-5f * s );
+    }
+  }
+
+}
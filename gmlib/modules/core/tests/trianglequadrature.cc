@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include <fem/gmtrianglequadrature.h>
+using namespace GMlib;
+
+#include <cmath>
+
+
+namespace {
+
+  double factorial( int n ) {
+
+    double f = 1.0;
+    for( int i = 2; i <= n; i++ ) f *= i;
+    return f;
+  }
+
+
+  // Every monomial x^a y^b, a+b <= d, is integrated exactly
+  template <int d>
+  void checkExact() {
+
+    TriangleQuadrature<double,d> q;
+    EXPECT_EQ( int(TriangleRule<d>::N), q.getSize() );
+
+    for( int a = 0; a <= d; a++ )
+      for( int b = 0; a + b <= d; b++ ) {
+        const double exact = factorial(a) * factorial(b) / factorial(a+b+2);
+        const double s = q.integrate( [a,b]( const Point<double,2>& x ) {
+          return std::pow( x[0], a ) * std::pow( x[1], b ); } );
+        EXPECT_NEAR( exact, s, 1e-13 ) << "d " << d << " a " << a << " b " << b;
+      }
+
+    for( int i = 0; i < q.getSize(); i++ ) {
+      EXPECT_GT( q.getWeight(i), 0.0 );
+      EXPECT_GT( q.getPoint(i)[0], 0.0 );
+      EXPECT_GT( q.getPoint(i)[1], 0.0 );
+      EXPECT_LT( q.getPoint(i)[0] + q.getPoint(i)[1], 1.0 );
+    }
+  }
+
+
+  TEST(Core_Fem, TriangleQuadrature_exact) {
+
+    checkExact<1>();
+    checkExact<2>();
+    checkExact<3>();
+    checkExact<4>();
+    checkExact<5>();
+    checkExact<6>();
+  }
+
+}
@@ -72,6 +72,14 @@ namespace GMlib { namespace GL {
     safeUnbind(id);
   }
 
+  /*! Immutable storage, requires OpenGL 4.4 or ARB_buffer_storage */
+  void BufferObject::bufferStorage(GLsizeiptr size, const GLvoid *data, GLbitfield flags) const {
+
+    GLint id = safeBind();
+    GL_CHECK(::glBufferStorage( getTarget(), size, data, flags ));
+    safeUnbind(id);
+  }
+
   void BufferObject::bufferSubData(GLintptr offset, GLsizeiptr size, const GLvoid* data) const {
 
     GLint id = safeBind();
@@ -50,12 +50,15 @@ namespace GL {
     GLenum                  getTarget() const;
 
     void                    bufferData( GLsizeiptr size, const GLvoid* data, GLenum usage ) const;
+    void                    bufferStorage( GLsizeiptr size, const GLvoid* data, GLbitfield flags ) const;
     void                    bufferSubData( GLintptr offset, GLsizeiptr size, const GLvoid* data ) const;
     void                    disableVertexArrayPointer( const GL::AttributeLocation& vert_loc ) const;
     void                    enableVertexArrayPointer( const GL::AttributeLocation& vert_loc, int size, GLenum type, bool normalized, GLsizei stride, const void* offset ) const;
 
     template <typename T>
     T*                      mapBuffer( GLenum access = GL_WRITE_ONLY ) const;
+    template <typename T>
+    T*                      mapBufferRange( GLintptr offset, GLsizeiptr length, GLbitfield access ) const;
     void                    unmapBuffer() const;
 
   protected:
@@ -95,6 +98,18 @@ namespace GL {
     return static_cast<T*>(ptr);
   }
 
+  template <typename T>
+  inline
+  T* BufferObject::mapBufferRange( GLintptr offset, GLsizeiptr length, GLbitfield access ) const {
+
+    auto id = safeBind();
+    void *ptr;
+    GL_CHECK(ptr = ::glMapBufferRange( getTarget(), offset, length, access ));
+    safeUnbind(id);
+
+    return static_cast<T*>(ptr);
+  }
+
 
 
 
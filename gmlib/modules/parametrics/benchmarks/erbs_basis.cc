@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include "../src/evaluators/gmerbsevaluator.h"
+using namespace GMlib;
+
+
+
+namespace {
+
+  // Exposes the Romberg integration the tables are built from
+  class Erbs : public ERBSEvaluator<long double> {
+  public:
+    long double integrate( long double t ) {
+      return this->getScale() * this->getIntegral( 0, t, 0.5*( getPhi(0) + getPhi(t) ), 1e-17 );
+    }
+  };
+
+  const int N = 1024;
+
+}
+
+
+// Shared, immutable table
+static void BM_ERBS_Table(benchmark::State& state)
+{
+  const BasisTable<long double>& table = ERBSEvaluator<long double>::getTable();
+  long double b[3];
+
+  // The test loop
+  while (state.KeepRunning()) {
+    for( int i = 0; i < N; i++ ) {
+      table.eval( 1.0l + i * 0.5l / N, 1.0l, 0.5l, state.range(0), b );
+      benchmark::DoNotOptimize( b[0] );
+    }
+  }
+  state.SetItemsProcessed( state.iterations() * N );
+}
+
+BENCHMARK(BM_ERBS_Table)
+  ->Arg(0)
+  ->Arg(2)
+  ->Threads(1)
+  ->Threads(4);
+
+
+// The stateful evaluator, one per thread
+static void BM_ERBS_Evaluator(benchmark::State& state)
+{
+  ERBSEvaluator<long double> e;
+  long double b[3];
+
+  // The test loop
+  while (state.KeepRunning()) {
+    e.set( 1.0l, 0.5l );
+    for( int i = 0; i < N; i++ ) {
+      b[0] = e( 1.0l + i * 0.5l / N );
+      if( state.range(0) > 0 ) b[1] = e.getDer1();
+      if( state.range(0) > 1 ) b[2] = e.getDer2();
+      benchmark::DoNotOptimize( b[0] );
+    }
+  }
+  state.SetItemsProcessed( state.iterations() * N );
+}
+
+BENCHMARK(BM_ERBS_Evaluator)
+  ->Arg(0)
+  ->Arg(2);
+
+
+// Integrating the basis function for every value
+static void BM_ERBS_Romberg(benchmark::State& state)
+{
+  Erbs e;
+  const int n = 64;
+
+  // The test loop
+  while (state.KeepRunning()) {
+    for( int i = 0; i < n; i++ )
+      benchmark::DoNotOptimize( e.integrate( (i+0.5l) / n ) );
+  }
+  state.SetItemsProcessed( state.iterations() * n );
+}
+
+BENCHMARK(BM_ERBS_Romberg);
+
+
+// Building the tables
+static void BM_ERBS_TableBuild(benchmark::State& state)
+{
+  // The test loop
+  while (state.KeepRunning()) {
+    ERBSEvaluator<long double> e( state.range(0) );
+    BasisTable<long double>    table( e );
+    benchmark::DoNotOptimize( table.getResolution() );
+  }
+}
+
+BENCHMARK(BM_ERBS_TableBuild)
+  ->Unit(benchmark::kMillisecond)
+  ->Arg(256)
+  ->Arg(1024);
+
+BENCHMARK_MAIN();
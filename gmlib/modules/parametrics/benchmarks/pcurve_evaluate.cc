@@ -22,4 +22,4 @@ BENCHMARK(BM_PCircle_Resample)
   ->RangeMultiplier(2)
   ->Ranges({{2, 2 << 15}, {1,2}});
 
-BENCHMARK_MAIN()
+BENCHMARK_MAIN();
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include "../src/surfaces/gmptorus.h"
+using namespace GMlib;
+
+
+
+namespace {
+
+  // Exposes the protected resample
+  class Torus : public PTorus<float> {
+  public:
+    using PSurf<float,3>::resample;
+  };
+
+}
+
+
+// Arguments: samples in each direction, derivatives, parallel
+static void BM_PTorus_Resample(benchmark::State& state)
+{
+  Torus torus;
+  torus.setParallelResample( state.range(2) );
+  DMatrix<DMatrix<Vector<float,3>>> samps;
+
+  const int m = state.range(0);
+  const int d = state.range(1);
+
+  // The test loop
+  while (state.KeepRunning()) {
+    torus.resample( samps, m, m, d, d, torus.getParStartU(), torus.getParStartV(),
+                    torus.getParEndU(), torus.getParEndV() );
+  }
+  state.SetItemsProcessed( state.iterations() * m * m );
+}
+
+
+BENCHMARK(BM_PTorus_Resample)
+  ->Unit(benchmark::kMillisecond)
+  ->Args({100, 1, 0})
+  ->Args({100, 1, 1})
+  ->Args({1000, 1, 0})
+  ->Args({1000, 1, 1})
+  ->Args({1000, 2, 0})
+  ->Args({1000, 2, 1});
+
+
+// Arguments: samples in each direction, derivatives, parallel, SoA layout
+static void BM_PTorus_ResampleGrid(benchmark::State& state)
+{
+  Torus torus;
+  torus.setParallelResample( state.range(2) );
+  PSampleGrid<float,3> samps( state.range(3) ? PSampleGrid<float,3>::LAYOUT_SOA
+                                             : PSampleGrid<float,3>::LAYOUT_AOS );
+
+  const int m = state.range(0);
+  const int d = state.range(1);
+
+  // The test loop
+  while (state.KeepRunning()) {
+    torus.resample( samps, m, m, d, d, torus.getParStartU(), torus.getParStartV(),
+                    torus.getParEndU(), torus.getParEndV() );
+  }
+  state.SetItemsProcessed( state.iterations() * m * m );
+}
+
+
+BENCHMARK(BM_PTorus_ResampleGrid)
+  ->Unit(benchmark::kMillisecond)
+  ->Args({100, 1, 0, 0})
+  ->Args({100, 1, 0, 1})
+  ->Args({1000, 1, 0, 0})
+  ->Args({1000, 1, 0, 1})
+  ->Args({1000, 1, 1, 1})
+  ->Args({1000, 2, 0, 1});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+
+#include "../src/surfaces/gmpbeziersurf.h"
+#include "../src/surfaces/gmpbsplinesurf.h"
+using namespace GMlib;
+
+// stl
+#include <algorithm>
+
+
+namespace {
+
+  DMatrix< Vector<float,3> > makeControlPoints( int n ) {
+
+    DMatrix< Vector<float,3> > c( n, n );
+    for( int i = 0; i < n; i++ )
+      for( int j = 0; j < n; j++ )
+        c[i][j] = Vector<float,3>( float(i), float(j), float((i*j) % 3) );
+    return c;
+  }
+
+
+  DVector<float> makeKnots( int n, int d ) {
+
+    DVector<float> t( n+d+1 );
+    for( int i = 0; i < t.getDim(); i++ )
+      t[i] = float( std::min( std::max( i-d, 0 ), n-d ) );
+    return t;
+  }
+
+
+  // m x m samples, one evaluation at a time
+  void evaluateGrid( const PSurf<float,3>& s, int m, int d, DMatrix< Vector<float,3> >& p ) {
+
+    for( int i = 0; i < m; i++ )
+      for( int j = 0; j < m; j++ )
+        s.evaluate( s.getParStartU() + i * s.getParDeltaU() / (m-1),
+                    s.getParStartV() + j * s.getParDeltaV() / (m-1), d, d, p );
+  }
+
+}
+
+
+// Arguments: samples in each direction, derivatives
+static void BM_PBezierSurf_Evaluate(benchmark::State& state)
+{
+  PBezierSurf<float> surf( makeControlPoints(4) );
+  DMatrix< Vector<float,3> > p;
+
+  while (state.KeepRunning())
+    evaluateGrid( surf, state.range(0), state.range(1), p );
+  state.SetItemsProcessed( state.iterations() * state.range(0) * state.range(0) );
+}
+
+
+// Arguments: samples in each direction, derivatives
+static void BM_PBezierSurf_Replot(benchmark::State& state)
+{
+  PBezierSurf<float> surf( makeControlPoints(4) );
+
+  while (state.KeepRunning())
+    surf.replot( state.range(0), state.range(0), state.range(1), state.range(1) );
+  state.SetItemsProcessed( state.iterations() * state.range(0) * state.range(0) );
+}
+
+
+// Arguments: samples in each direction, derivatives
+static void BM_PBSplineSurf_Evaluate(benchmark::State& state)
+{
+  PBSplineSurf<float> surf( makeControlPoints(20), makeKnots(20,3), makeKnots(20,3), 3, 3 );
+  DMatrix< Vector<float,3> > p;
+
+  while (state.KeepRunning())
+    evaluateGrid( surf, state.range(0), state.range(1), p );
+  state.SetItemsProcessed( state.iterations() * state.range(0) * state.range(0) );
+}
+
+
+// Arguments: samples in each direction, derivatives
+static void BM_PBSplineSurf_Replot(benchmark::State& state)
+{
+  PBSplineSurf<float> surf( makeControlPoints(20), makeKnots(20,3), makeKnots(20,3), 3, 3 );
+
+  while (state.KeepRunning())
+    surf.replot( state.range(0), state.range(0), state.range(1), state.range(1) );
+  state.SetItemsProcessed( state.iterations() * state.range(0) * state.range(0) );
+}
+
+
+BENCHMARK(BM_PBezierSurf_Evaluate)->Unit(benchmark::kMillisecond)->Args({100, 1})->Args({500, 1});
+BENCHMARK(BM_PBezierSurf_Replot)->Unit(benchmark::kMillisecond)->Args({100, 1})->Args({500, 1});
+BENCHMARK(BM_PBSplineSurf_Evaluate)->Unit(benchmark::kMillisecond)->Args({100, 1})->Args({500, 1});
+BENCHMARK(BM_PBSplineSurf_Replot)->Unit(benchmark::kMillisecond)->Args({100, 1})->Args({500, 1});
+
+BENCHMARK_MAIN();
@@ -125,9 +125,6 @@ namespace GMlib {
       SceneObject::remove( _c[i] );
       delete _c[i];
     }
-
-    if( _evaluator )
-      delete _evaluator;
   }
 
   template <typename T>
@@ -223,13 +220,15 @@ namespace GMlib {
   inline
   void PERBSCurve<T>::getB( DVector<T>& B, int k, T t, int d ) const {
 
+    long double b[3];
+    _evaluator->eval( t, _t[k], _t[k+1] - _t[k], std::min( d, 2 ), b );
+
     B.setDim(d+1);
-    _evaluator->set( _t[k], _t[k+1] - _t[k] );
-    B[0] = 1 - (*_evaluator)(t);
+    B[0] = 1 - b[0];
     switch(d) {
       case 3: B[3] = T(0);
-      case 2: B[2] = - _evaluator->getDer2();
-      case 1: B[1] = - _evaluator->getDer1();
+      case 2: B[2] = - b[2];
+      case 1: B[1] = - b[1];
     }
   }
 
@@ -302,7 +301,7 @@ namespace GMlib {
     _no_sam           = 20;
     _no_der           = 1;
 
-    _evaluator = new ERBSEvaluator<long double>();
+    _evaluator = &ERBSEvaluator<long double>::getTable();
 
     _resamp_mode = GM_RESAMPLE_PREEVAL;
     _pre_eval    = true;
@@ -104,7 +104,7 @@ namespace GMlib {
     DVector<T>                      _t;
     DVector<PCurve<T,3>*>           _c;
 
-    BasisEvaluator<long double>*    _evaluator;
+    const BasisTable<long double>*  _evaluator;   // Shared ERBS basis tables
 
     // Using pre evaulating of GERBS-basis functions
     GM_RESAMPLE_MODE                _resamp_mode;
@@ -38,6 +38,8 @@
 
 namespace GMlib {
 
+  template <typename T>
+  class BasisTable;
 
 
   template <typename T>
@@ -90,6 +92,8 @@ namespace GMlib {
   private:
     virtual void    _prepare( T t );
 
+    friend class BasisTable<T>;
+
 
   }; // END class BasisEvaluator
 
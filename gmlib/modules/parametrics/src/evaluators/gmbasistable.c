@@ -0,0 +1,171 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  BasisTable<T>::BasisTable( const BasisEvaluator<T>& e )
+    : _m(e._m), _dt(e._dt), _scale(e._scale), _a(e._a), _b(e._b) {}
+
+
+  template <typename T>
+  inline
+  int BasisTable<T>::getResolution() const {
+
+    return _m;
+  }
+
+
+  template <typename T>
+  inline
+  T BasisTable<T>::getValue( T t, T tk, T dtk ) const {
+
+    int local;
+    T   local_dt;
+    _locate( t, tk, dtk, local, local_dt );
+    return _value( local, local_dt );
+  }
+
+
+  template <typename T>
+  inline
+  T BasisTable<T>::getDer1( T t, T tk, T dtk ) const {
+
+    int local;
+    T   local_dt;
+    _locate( t, tk, dtk, local, local_dt );
+    return _der1( local, local_dt, _scale / dtk );
+  }
+
+
+  template <typename T>
+  inline
+  T BasisTable<T>::getDer2( T t, T tk, T dtk ) const {
+
+    int local;
+    T   local_dt;
+    _locate( t, tk, dtk, local, local_dt );
+    return _der2( local, local_dt, _scale / ( _dt*dtk*dtk ) );
+  }
+
+
+  /*! void BasisTable<T>::eval( T t, T tk, T dtk, int d, T b[3] ) const
+   *  The value and the d <= 2 first derivatives at t in one lookup.
+   */
+  template <typename T>
+  inline
+  void BasisTable<T>::eval( T t, T tk, T dtk, int d, T b[3] ) const {
+
+    int local;
+    T   local_dt;
+    _locate( t, tk, dtk, local, local_dt );
+
+    b[0] = _value( local, local_dt );
+    if( d > 0 ) b[1] = _der1( local, local_dt, _scale / dtk );
+    if( d > 1 ) b[2] = _der2( local, local_dt, _scale / ( _dt*dtk*dtk ) );
+  }
+
+
+  template <typename T>
+  inline
+  T BasisTable<T>::operator () ( T t, T tk, T dtk ) const {
+
+    return getValue( t, tk, dtk );
+  }
+
+
+  template <typename T>
+  inline
+  void BasisTable<T>::_locate( T t, T tk, T dtk, int& local, T& local_dt ) const {
+
+    // Translate/Scale the input paramter
+    t  = ( t - tk ) / dtk;
+
+    // Find the local interval
+    local    = std::min<int>( int(t*_m), _m-1 );
+
+    // Translate/Scale the local dt parameter
+    local_dt = ( t - local*_dt ) / _dt;
+  }
+
+
+  template <typename T>
+  inline
+  T BasisTable<T>::_value( int i, T s ) const {
+
+    if( s > 0.5 )
+      return _scale * (
+        _b(i+1) - _dt * (
+          _a(i)(4) - s * (
+            _a(i)(0) + s * (
+              _a(i)(1) / 2 + s * (
+                _a(i)(2) / 3 + s * _a(i)(3)/4
+              )
+            )
+          )
+        )
+      );
+    else
+      return _scale * (
+        _b(i) + _dt * s * (
+          _a(i)(0) + s * (
+            _a(i)(1)/2 + s * (
+              _a(i)(2)/3 + s * _a(i)(3)/4
+            )
+          )
+        )
+      );
+  }
+
+
+  template <typename T>
+  inline
+  T BasisTable<T>::_der1( int i, T s, T scale1 ) const {
+
+    return scale1 * (
+      _a(i)(0) + s * (
+        _a(i)(1) + s * (
+          _a(i)(2) + s * _a(i)(3)
+        )
+      )
+    );
+  }
+
+
+  template <typename T>
+  inline
+  T BasisTable<T>::_der2( int i, T s, T scale2 ) const {
+
+    return scale2 * (
+      _a(i)(1) + s * (
+        2 * _a(i)(2) + s *
+          3 * _a(i)(3)
+      )
+    );
+  }
+
+
+} // END namespace GMlib
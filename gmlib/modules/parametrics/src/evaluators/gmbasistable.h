@@ -0,0 +1,86 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+#ifndef GM_PARAMETRICS_EVALUATORS_BASISTABLE_H
+#define GM_PARAMETRICS_EVALUATORS_BASISTABLE_H
+
+
+// gmlib
+#include "gmbasisevaluator.h"
+
+// stl
+#include <algorithm>
+
+
+namespace GMlib {
+
+
+  /*! \class BasisTable gmbasistable.h <gmBasisTable>
+   *  \brief The precomputed tables of a BasisEvaluator, read only
+   *
+   *  A copy of the integral and interpolation tables that a BasisEvaluator
+   *  builds in init(). All lookups are const functions of their arguments,
+   *  so one table can be shared by any number of threads. The knot interval
+   *  [tk, tk+dtk] is given with each lookup instead of through set().
+   *
+   *  ERBSEvaluator<T>::getTable() gives a shared table of the default ERBS
+   *  basis function.
+   */
+  template <typename T>
+  class BasisTable {
+  public:
+    explicit BasisTable( const BasisEvaluator<T>& evaluator );
+
+    int             getResolution() const;
+
+    T               getValue( T t, T tk = T(0), T dtk = T(1) ) const;
+    T               getDer1( T t, T tk = T(0), T dtk = T(1) ) const;
+    T               getDer2( T t, T tk = T(0), T dtk = T(1) ) const;
+    void            eval( T t, T tk, T dtk, int d, T b[3] ) const;
+
+    T               operator () ( T t, T tk = T(0), T dtk = T(1) ) const;
+
+  private:
+    int             _m;
+    T               _dt;
+    T               _scale;
+    DMatrix<T>      _a;
+    DVector<T>      _b;
+
+    void            _locate( T t, T tk, T dtk, int& local, T& local_dt ) const;
+    T               _value( int local, T local_dt ) const;
+    T               _der1( int local, T local_dt, T scale1 ) const;
+    T               _der2( int local, T local_dt, T scale2 ) const;
+
+  }; // END class BasisTable
+
+} // END namespace GMlib
+
+
+// Include BasisTable class function implementations
+#include "gmbasistable.c"
+
+
+#endif // GM_PARAMETRICS_EVALUATORS_BASISTABLE_H
@@ -138,6 +138,18 @@ namespace GMlib {
   }
 
 
+  /*! const BasisTable<T>& ERBSEvaluator<T>::getTable()
+   *  The tables of the default ERBS basis function, built on first use.
+   *  Unlike getInstance() it has no state, and can be used from any thread.
+   */
+  template <typename T>
+  inline
+  const BasisTable<T>& ERBSEvaluator<T>::getTable() {
+    static const BasisTable<T> table{ ERBSEvaluator<T>() };
+    return table;
+  }
+
+
   //**************************************
   //            lokal functions         **
   //**************************************
@@ -30,6 +30,7 @@
 
 // GMlib includes
 #include "gmbasisevaluator.h"
+#include "gmbasistable.h"
 
 
 namespace GMlib {
@@ -51,6 +52,7 @@ namespace GMlib {
     void          texParameters( T alpha = T(1), T beta = T(1), T gamma = T(1), T lambda = T(0.5) );
 
     static ERBSEvaluator<T>*    getInstance();
+    static const BasisTable<T>& getTable();
 
   protected:
     T             _alpha;
@@ -129,7 +129,7 @@ namespace GMlib {
             this->append(i);
             for(++i; i <= n; i++) {
                 int j=1;
-                while (eq(t(i+j), t(i))) ++j;
+                while (i+j < t.getDim() && eq(t(i+j), t(i))) ++j;
                 if(i+j-1 >= n) {
                     this->append(i);
                     break;
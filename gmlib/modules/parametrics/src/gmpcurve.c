@@ -80,6 +80,13 @@ namespace GMlib {
   inline
   void	PCurve<T,n>::_eval( T t, int d ) const {
 
+    // The last evaluation cache is shared by all threads, skip it when
+    // evaluating into a thread private buffer
+    if( _p.isRedirected() ) {
+      eval( shift(t), d );
+      return;
+    }
+
     if( d <= _d && t == _t ) return;
 
     _t = t; _d = d;
@@ -132,14 +139,31 @@ namespace GMlib {
   DVector<Vector<T,n> >& PCurve<T,n>::evaluate( T t, int d ) const {
 
     _eval(t,d);
-    return _p;
+    return _p.get();
+  }
+
+
+  /*! void PCurve<T,n>::evaluate( T t, int d, DVector<Vector<T,n> >& p ) const
+   *  Reentrant evaluation, the result is written to p.
+   *  Touches no member of the curve, so several threads may evaluate the
+   *  same curve at once.
+   *  \param[in]  t   Evaluation parameter.
+   *  \param[in]  d   Number of derivatives to be computed.
+   *  \param[out] p   Position and belonging derivatives.
+   */
+  template <typename T, int n>
+  inline
+  void PCurve<T,n>::evaluate( T t, int d, DVector<Vector<T,n> >& p ) const {
+
+    typename PEvalBuffer< DVector< Vector<T,n> > >::Redirect r( _p, p );
+    eval( shift(t), d );
   }
 
 
   template <typename T, int n>
   DVector<Vector<T,n> >& PCurve<T,n>::evaluateGlobal( T t, int d ) const {
 
-    static DVector< Vector<T,n> > p;
+    static thread_local DVector< Vector<T,n> > p;
 
     _eval(t,d);
     p.setDim(_p.getDim());
@@ -156,7 +180,7 @@ namespace GMlib {
   template <typename T, int n>
   DVector<Vector<T,n> >& PCurve<T,n>::evaluateParent( T t, int d ) const {
 
-    static DVector< Vector<T,n> > p;
+    static thread_local DVector< Vector<T,n> > p;
 
     _eval(t,d);
     p.setDim(_p.getDim());
@@ -178,7 +202,7 @@ namespace GMlib {
 
     DVector<Vector<T,n> > c;
     for (int i=0; i < max_iterations; i++) {
-      c = evaluate(t, 2);
+      evaluate(t, 2, c);
       T dt = -( (c[0] - q) * c[1]) / ( (c[0] - q) * c[2] + c[1] * c[1] );
 
       p = c[0];
@@ -194,13 +218,14 @@ namespace GMlib {
   inline
   T PCurve<T,n>::getCurvature( T t ) const {
 
-    _eval( t, 2 );
-    Vector<T,n> d1 = _p[1];
+    DVector< Vector<T,n> > p;
+    evaluate( t, 2, p );
+    Vector<T,n> d1 = p[1];
     T a1= d1.getLength();
 
     if( a1 < T(1.0e-5) ) return T(0);
 
-    return (d1^_p[2]).getLength() / pow(a1,3);
+    return (d1^p[2]).getLength() / pow(a1,3);
   }
 
 
@@ -462,10 +487,10 @@ namespace GMlib {
 
     for( int i = 0; i < m - 1; i++ ) {
       eval( start + i * du, d, true);
-      p[i] = _p;
+      p[i] = _p.get();
     }
     eval( end, d, false );
-    p[m-1] = _p;
+    p[m-1] = _p.get();
 
     switch( this->_dm ) {
       case GM_DERIVATION_EXPLICIT:
@@ -29,6 +29,7 @@
 
 
 #include "gmparametrics.h"
+#include "gmpevalbuffer.h"
 
 // gmlib
 #include <core/containers/gmarray.h>
@@ -53,6 +54,7 @@ namespace GMlib {
     ~PCurve();
 
     DVector<Vector<T,n> >&        evaluate( T t, int d ) const;
+    void                          evaluate( T t, int d, DVector<Vector<T,n> >& p ) const;
     DVector<Vector<T,n> >&        evaluateGlobal( T t, int d ) const;
     DVector<Vector<T,n> >&        evaluateParent( T t, int d ) const;
 
@@ -104,7 +106,7 @@ namespace GMlib {
 
 
     // The result of the previous evaluation
-    mutable DVector<Vector<T,n> >  _p;           // Position and belonging derivatives
+    mutable PEvalBuffer< DVector<Vector<T,n> > > _p; // Position and belonging derivatives
     DVector<Vector<T,n> >&         _q = _p;
     mutable T                      _t;           // The parameter value used for last evaluation
     mutable int                    _d;           // Number of derivatives computed last time
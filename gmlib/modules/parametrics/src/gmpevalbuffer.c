@@ -0,0 +1,242 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+namespace GMlib {
+
+
+  template <typename R>
+  inline
+  PEvalBuffer<R>::PEvalBuffer() {}
+
+
+  template <typename R>
+  inline
+  PEvalBuffer<R>::PEvalBuffer( const PEvalBuffer<R>& copy ) : _own( copy.get() ) {}
+
+
+  /*! R& PEvalBuffer<R>::get() const
+   *  Returns the buffer the calling thread is to use.
+   */
+  template <typename R>
+  inline
+  R& PEvalBuffer<R>::get() const {
+
+    Context& c = _context();
+    if( !c.depth )
+      return _own;
+
+    if( c.last != this ) {
+      c.buf  = &_lookup();
+      c.last = this;
+    }
+    return *c.buf;
+  }
+
+
+  /*! bool PEvalBuffer<R>::isRedirected() const
+   *  True while the calling thread runs inside a Redirect scope. The
+   *  object members cached next to the buffer must not be used then.
+   */
+  template <typename R>
+  inline
+  bool PEvalBuffer<R>::isRedirected() const {
+
+    return _context().depth > 0;
+  }
+
+
+  template <typename R>
+  inline
+  int PEvalBuffer<R>::getDim() const {
+
+    return get().getDim();
+  }
+
+
+  template <typename R>
+  inline
+  int PEvalBuffer<R>::getDim1() const {
+
+    return get().getDim1();
+  }
+
+
+  template <typename R>
+  inline
+  int PEvalBuffer<R>::getDim2() const {
+
+    return get().getDim2();
+  }
+
+
+  template <typename R>
+  template <typename... I>
+  inline
+  void PEvalBuffer<R>::resetDim( I... i ) const {
+
+    get().resetDim( i... );
+  }
+
+
+  template <typename R>
+  template <typename... I>
+  inline
+  void PEvalBuffer<R>::setDim( I... i ) const {
+
+    get().setDim( i... );
+  }
+
+
+  template <typename R>
+  inline
+  PEvalBuffer<R>& PEvalBuffer<R>::operator = ( const PEvalBuffer<R>& copy ) {
+
+    get() = copy.get();
+    return *this;
+  }
+
+
+  template <typename R>
+  inline
+  PEvalBuffer<R>& PEvalBuffer<R>::operator = ( const R& r ) {
+
+    get() = r;
+    return *this;
+  }
+
+
+  template <typename R>
+  inline
+  PEvalBuffer<R>& PEvalBuffer<R>::operator *= ( double d ) {
+
+    get() *= d;
+    return *this;
+  }
+
+
+  template <typename R>
+  template <typename I>
+  inline
+  auto PEvalBuffer<R>::operator [] ( I i ) const -> decltype( std::declval<R&>()[i] ) {
+
+    return get()[i];
+  }
+
+
+  template <typename R>
+  template <typename I>
+  inline
+  auto PEvalBuffer<R>::operator () ( I i ) const -> decltype( std::declval<R&>()(i) ) {
+
+    return get()(i);
+  }
+
+
+  template <typename R>
+  inline
+  PEvalBuffer<R>::operator R& () const {
+
+    return get();
+  }
+
+
+  template <typename R>
+  inline
+  typename PEvalBuffer<R>::Context& PEvalBuffer<R>::_context() {
+
+    static thread_local Context c;
+    return c;
+  }
+
+
+  template <typename R>
+  R& PEvalBuffer<R>::_lookup() const {
+
+    Context& c = _context();
+    R*&      t = c.targets[this];
+    if( !t ) {
+      if( c.used == c.scratch.size() )
+        c.scratch.emplace_back();
+      t = &c.scratch[c.used++];
+    }
+    return *t;
+  }
+
+
+
+
+  //*****************************************
+  // PEvalBuffer<R>::Redirect
+  //*****************************************
+
+  template <typename R>
+  inline
+  PEvalBuffer<R>::Redirect::Redirect( const PEvalBuffer<R>& buffer )
+    : _buffer(buffer), _prev(nullptr), _slot(nullptr) {
+
+    Context& c = _context();
+    c.depth++;
+    c.last     = nullptr;
+  }
+
+
+  template <typename R>
+  inline
+  PEvalBuffer<R>::Redirect::Redirect( const PEvalBuffer<R>& buffer, R& target )
+    : _buffer(buffer) {
+
+    Context& c = _context();
+    _slot      = &c.targets[&buffer];
+    _prev      = *_slot;
+    *_slot     = &target;
+
+    c.depth++;
+    c.last     = nullptr;
+  }
+
+
+  template <typename R>
+  inline
+  PEvalBuffer<R>::Redirect::~Redirect() {
+
+    Context& c = _context();
+    c.last     = nullptr;
+
+    if( --c.depth == 0 ) {
+
+      // Keep the table allocated, unless it has collected many buffers
+      if( c.targets.size() > 64 )
+        c.targets.clear();
+      else
+        for( auto& t : c.targets )
+          t.second = nullptr;
+      c.used = 0;
+    }
+    else if( _slot )
+      *_slot = _prev;
+  }
+
+
+} // END namespace GMlib
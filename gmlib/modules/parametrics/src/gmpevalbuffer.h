@@ -0,0 +1,128 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+#ifndef GM_PARAMETRICS_PEVALBUFFER_H
+#define GM_PARAMETRICS_PEVALBUFFER_H
+
+
+// stl
+#include <deque>
+#include <unordered_map>
+#include <utility>
+
+
+namespace GMlib {
+
+
+  /*! \class PEvalBuffer gmpevalbuffer.h <gmPEvalBuffer>
+   *  \brief Result buffer of a parametric evaluator that is private per thread
+   *
+   *  Holds the result of the last evaluation, the _p of PCurve and PSurf.
+   *  The evaluators of the sub-classes write it as if it was the container
+   *  itself. Outside a Redirect scope all calls go to the buffer owned by
+   *  the object, as before. While a Redirect scope is active on a thread,
+   *  the buffer named by the scope goes to the caller supplied target, and
+   *  every other buffer touched by the same thread, e.g. the local patches
+   *  of a composite surface, goes to scratch storage private to the thread.
+   *  Evaluations running inside a scope therefore never share state with
+   *  other threads.
+   */
+  template <typename R>
+  class PEvalBuffer {
+  public:
+    PEvalBuffer();
+    PEvalBuffer( const PEvalBuffer<R>& copy );
+
+    R&                    get() const;
+    bool                  isRedirected() const;
+
+    int                   getDim() const;
+    int                   getDim1() const;
+    int                   getDim2() const;
+
+    template <typename... I>
+    void                  resetDim( I... i ) const;
+    template <typename... I>
+    void                  setDim( I... i ) const;
+
+    PEvalBuffer<R>&       operator =  ( const PEvalBuffer<R>& copy );
+    PEvalBuffer<R>&       operator =  ( const R& r );
+    PEvalBuffer<R>&       operator *= ( double d );
+
+    template <typename I>
+    auto                  operator [] ( I i ) const -> decltype( std::declval<R&>()[i] );
+    template <typename I>
+    auto                  operator () ( I i ) const -> decltype( std::declval<R&>()(i) );
+
+                          operator R& () const;
+
+
+    /*! \class Redirect
+     *  \brief Scope in which a buffer writes to a caller supplied target
+     *
+     *  Without a target the buffer writes to the thread private scratch.
+     *  Scopes nest, also for the same buffer. The scratch storage is
+     *  recycled, not freed, when the outermost scope ends.
+     */
+    class Redirect {
+    public:
+      Redirect( const PEvalBuffer<R>& buffer );
+      Redirect( const PEvalBuffer<R>& buffer, R& target );
+      ~Redirect();
+
+    private:
+      const PEvalBuffer<R>&   _buffer;
+      R*                      _prev;
+      R**                     _slot;
+
+    }; // END class Redirect
+
+
+  private:
+    mutable R             _own;
+
+    struct Context {
+      int                                          depth = 0;
+      const PEvalBuffer<R>*                        last  = nullptr;
+      R*                                           buf   = nullptr;
+      std::unordered_map<const PEvalBuffer<R>*,R*> targets;
+      std::deque<R>                                scratch;
+      size_t                                       used  = 0;
+    };
+
+    static Context&       _context();
+    R&                    _lookup() const;
+
+  }; // END class PEvalBuffer
+
+
+} // END namespace GMlib
+
+
+// Include PEvalBuffer class function implementations
+#include "gmpevalbuffer.c"
+
+
+#endif  // GM_PARAMETRICS_PEVALBUFFER_H
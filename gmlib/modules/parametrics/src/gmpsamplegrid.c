@@ -0,0 +1,345 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+// stl
+#include <cstdint>
+#include <new>
+
+
+namespace GMlib {
+
+
+  template <typename T, int n>
+  inline
+  PSampleGrid<T,n>::PSampleGrid( LAYOUT layout )
+    : _layout(layout), _size(0), _capacity(0), _mem(0x0), _data(0x0) {
+
+    setDim( 0, 0 );
+  }
+
+
+  template <typename T, int n>
+  inline
+  PSampleGrid<T,n>::PSampleGrid( const PSampleGrid<T,n>& copy )
+    : _layout(copy._layout), _size(0), _capacity(0), _mem(0x0), _data(0x0) {
+
+    *this = copy;
+  }
+
+
+  template <typename T, int n>
+  PSampleGrid<T,n>::~PSampleGrid() {
+
+    ::operator delete( _mem );
+  }
+
+
+  template <typename T, int n>
+  inline
+  int PSampleGrid<T,n>::getDim1() const {
+
+    return _s[4];
+  }
+
+
+  template <typename T, int n>
+  inline
+  int PSampleGrid<T,n>::getDim2() const {
+
+    return _s[5];
+  }
+
+
+  template <typename T, int n>
+  inline
+  int PSampleGrid<T,n>::getDerivativesU() const {
+
+    return _s[6]-1;
+  }
+
+
+  template <typename T, int n>
+  inline
+  int PSampleGrid<T,n>::getDerivativesV() const {
+
+    return _s[7]-1;
+  }
+
+
+  template <typename T, int n>
+  inline
+  typename PSampleGrid<T,n>::LAYOUT PSampleGrid<T,n>::getLayout() const {
+
+    return _layout;
+  }
+
+
+  /*! size_t PSampleGrid<T,n>::getSize() const
+   *  Number of elements spanned by the grid, padding included.
+   */
+  template <typename T, int n>
+  inline
+  size_t PSampleGrid<T,n>::getSize() const {
+
+    return _size;
+  }
+
+
+  /*! int PSampleGrid<T,n>::getStride( int k ) const
+   *  The distance, in elements, between two neighbours along index k:
+   *  0 and 1 the sample indices in u and v, 2 and 3 the derivative orders
+   *  in u and v.
+   */
+  template <typename T, int n>
+  inline
+  int PSampleGrid<T,n>::getStride( int k ) const {
+
+    return _s[k];
+  }
+
+
+  template <typename T, int n>
+  inline
+  Vector<T,n>* PSampleGrid<T,n>::getPtr() {
+
+    return _data;
+  }
+
+
+  template <typename T, int n>
+  inline
+  const Vector<T,n>* PSampleGrid<T,n>::getPtr() const {
+
+    return _data;
+  }
+
+
+  /*! Vector<T,n>* PSampleGrid<T,n>::getPlane( int k, int l )
+   *  The (k,l) partial derivative of all samples, contiguous in LAYOUT_SOA.
+   */
+  template <typename T, int n>
+  inline
+  Vector<T,n>* PSampleGrid<T,n>::getPlane( int k, int l ) {
+
+    return _data + k*_s[2] + l*_s[3];
+  }
+
+
+  template <typename T, int n>
+  inline
+  const Vector<T,n>* PSampleGrid<T,n>::getPlane( int k, int l ) const {
+
+    return _data + k*_s[2] + l*_s[3];
+  }
+
+
+  /*! Vector<T,n>* PSampleGrid<T,n>::getSample( int i, int j )
+   *  The partial derivatives of sample (i,j), contiguous in LAYOUT_AOS.
+   */
+  template <typename T, int n>
+  inline
+  Vector<T,n>* PSampleGrid<T,n>::getSample( int i, int j ) {
+
+    return _data + i*_s[0] + j*_s[1];
+  }
+
+
+  template <typename T, int n>
+  inline
+  const Vector<T,n>* PSampleGrid<T,n>::getSample( int i, int j ) const {
+
+    return _data + i*_s[0] + j*_s[1];
+  }
+
+
+  /*! void PSampleGrid<T,n>::setDim( int m1, int m2, int d1, int d2 )
+   *  Sets the number of samples and of derivatives in each direction.
+   *  Does not keep the contents. Only allocates when the grid grows beyond
+   *  what it has held before.
+   */
+  template <typename T, int n>
+  void PSampleGrid<T,n>::setDim( int m1, int m2, int d1, int d2 ) {
+
+    _s[4] = m1;
+    _s[5] = m2;
+    _s[6] = d1+1;
+    _s[7] = d2+1;
+    _strides();
+
+    if( _size <= _capacity )
+      return;
+
+    // The elements have no state to construct or destroy
+    const size_t line = 64;
+    ::operator delete( _mem );
+    _mem      = ::operator new( _size * sizeof(Vector<T,n>) + line );
+    _data     = reinterpret_cast<Vector<T,n>*>( ( reinterpret_cast<std::uintptr_t>(_mem) + line ) & ~std::uintptr_t(line-1) );
+    _capacity = _size;
+  }
+
+
+  /*! void PSampleGrid<T,n>::setLayout( LAYOUT layout )
+   *  Does not keep the contents.
+   */
+  template <typename T, int n>
+  void PSampleGrid<T,n>::setLayout( LAYOUT layout ) {
+
+    _layout = layout;
+    setDim( _s[4], _s[5], _s[6]-1, _s[7]-1 );
+  }
+
+
+  /*! void PSampleGrid<T,n>::toDMatrix( DMatrix< DMatrix< Vector<T,n> > >& p ) const
+   *  Copies the grid to the nested matrix form used by older interfaces.
+   */
+  template <typename T, int n>
+  void PSampleGrid<T,n>::toDMatrix( DMatrix< DMatrix< Vector<T,n> > >& p ) const {
+
+    p.setDim( _s[4], _s[5] );
+    for( int i = 0; i < _s[4]; i++ )
+      for( int j = 0; j < _s[5]; j++ ) {
+        DMatrix< Vector<T,n> >& q = p[i][j];
+        q.setDim( _s[6], _s[7] );
+        for( int k = 0; k < _s[6]; k++ )
+          for( int l = 0; l < _s[7]; l++ )
+            q[k][l] = (*this)(i,j,k,l);
+      }
+  }
+
+
+  template <typename T, int n>
+  inline
+  Vector<T,n>& PSampleGrid<T,n>::operator () ( int i, int j, int k, int l ) {
+
+    return _data[i*_s[0] + j*_s[1] + k*_s[2] + l*_s[3]];
+  }
+
+
+  template <typename T, int n>
+  inline
+  const Vector<T,n>& PSampleGrid<T,n>::operator () ( int i, int j, int k, int l ) const {
+
+    return _data[i*_s[0] + j*_s[1] + k*_s[2] + l*_s[3]];
+  }
+
+
+  template <typename T, int n>
+  inline
+  PSampleIndex_<Vector<T,n>,1> PSampleGrid<T,n>::operator [] ( int i ) {
+
+    return PSampleIndex_<Vector<T,n>,1>( _data + i*_s[0], _s );
+  }
+
+
+  template <typename T, int n>
+  inline
+  PSampleIndex_<const Vector<T,n>,1> PSampleGrid<T,n>::operator () ( int i ) const {
+
+    return PSampleIndex_<const Vector<T,n>,1>( _data + i*_s[0], _s );
+  }
+
+
+  template <typename T, int n>
+  PSampleGrid<T,n>& PSampleGrid<T,n>::operator = ( const PSampleGrid<T,n>& copy ) {
+
+    if( this == &copy )
+      return *this;
+
+    _layout = copy._layout;
+    setDim( copy._s[4], copy._s[5], copy._s[6]-1, copy._s[7]-1 );
+    std::copy( copy._data, copy._data + _size, _data );
+    return *this;
+  }
+
+
+  template <typename T, int n>
+  void PSampleGrid<T,n>::_strides() {
+
+    const size_t m  = size_t(_s[4]) * _s[5];
+    const int    dd = _s[6] * _s[7];
+
+    if( _layout == LAYOUT_AOS ) {
+      _s[3] = 1;
+      _s[2] = _s[7];
+      _s[1] = dd;
+      _s[0] = _s[5] * dd;
+      _size = m * dd;
+    }
+    else {
+      // Each plane starts on a cache line
+      size_t a = 1;
+      while( ( a * sizeof(Vector<T,n>) ) % 64 ) a++;
+      const size_t plane = ( m + a - 1 ) / a * a;
+
+      _s[1] = 1;
+      _s[0] = _s[5];
+      _s[3] = int(plane);
+      _s[2] = int(plane) * _s[7];
+      _size = plane * dd;
+    }
+  }
+
+
+
+
+  namespace Private {
+
+    /*! \brief y[j*s] += b * x[j] for j < m, a row of a PSampleGrid
+     *
+     *  A contiguous row, stride 1 as in LAYOUT_SOA, is one flat loop over
+     *  its m*n scalars.
+     */
+    template <typename T, int n>
+    inline
+    void sampleRowAxpy( int m, T b, const Vector<T,n>* x, Vector<T,n>* y, int s ) {
+
+      if( s == 1 ) {
+        const T* xp = x->getPtr();
+        T*       yp = y->getPtr();
+#ifdef _OPENMP
+  #pragma omp simd
+#endif
+        for( int q = 0; q < m*n; q++ )
+          yp[q] += b * xp[q];
+      }
+      else
+        for( int j = 0; j < m; j++ )
+          y[j*s] += b * x[j];
+    }
+
+
+    /*! \brief y[j*s] = 0 for j < m, a row of a PSampleGrid */
+    template <typename T, int n>
+    inline
+    void sampleRowZero( int m, Vector<T,n>* y, int s ) {
+
+      for( int j = 0; j < m; j++ )
+        y[j*s] = Vector<T,n>( T(0) );
+    }
+
+  } // END namespace Private
+
+
+} // END namespace GMlib
@@ -0,0 +1,172 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+#ifndef GM_PARAMETRICS_PSAMPLEGRID_H
+#define GM_PARAMETRICS_PSAMPLEGRID_H
+
+
+// gmlib
+#include <core/types/gmpoint.h>
+#include <core/containers/gmdmatrix.h>
+
+// stl
+#include <algorithm>
+#include <cstddef>
+
+
+namespace GMlib {
+
+
+  /*! \class PSampleIndex_ gmpsamplegrid.h <gmPSampleGrid>
+   *  \brief A partly indexed PSampleGrid, k of its four indices are given
+   *
+   *  Makes p[i][j][k][l] and p(i)(j)(k)(l) work on a PSampleGrid as on a
+   *  DMatrix< DMatrix< Vector<T,n> > >.
+   */
+  template <typename V, int k>
+  class PSampleIndex_ {
+  public:
+    PSampleIndex_( V* b, const int* s ) : _b(b), _s(s) {}
+
+    PSampleIndex_<V,k+1>    operator [] ( int i ) const { return PSampleIndex_<V,k+1>( _b + i*_s[k], _s ); }
+    PSampleIndex_<V,k+1>    operator () ( int i ) const { return PSampleIndex_<V,k+1>( _b + i*_s[k], _s ); }
+
+    int                     getDim() const  { return _s[4+k]; }
+    int                     getDim1() const { return _s[4+k]; }
+    int                     getDim2() const { return _s[5+k]; }
+
+    /*! Copies a derivative matrix into a sample, for k = 2 */
+    template <typename M>
+    const PSampleIndex_<V,k>& operator = ( const M& m ) const {
+      const int d1 = std::min( m.getDim1(), _s[6] );
+      const int d2 = std::min( m.getDim2(), _s[7] );
+      for( int i = 0; i < d1; i++ )
+        for( int j = 0; j < d2; j++ )
+          _b[i*_s[2] + j*_s[3]] = m(i)(j);
+      return *this;
+    }
+
+  private:
+    V*                      _b;
+    const int*              _s;   // Strides, then dimensions
+
+  }; // END class PSampleIndex_
+
+
+  template <typename V>
+  class PSampleIndex_<V,3> {
+  public:
+    PSampleIndex_( V* b, const int* s ) : _b(b), _s(s) {}
+
+    V&                      operator [] ( int i ) const { return _b[i*_s[3]]; }
+    V&                      operator () ( int i ) const { return _b[i*_s[3]]; }
+
+    int                     getDim() const  { return _s[7]; }
+
+  private:
+    V*                      _b;
+    const int*              _s;
+
+  }; // END class PSampleIndex_<V,3>
+
+
+
+
+  /*! \class PSampleGrid gmpsamplegrid.h <gmPSampleGrid>
+   *  \brief The samples of a surface with their partial derivatives in one block
+   *
+   *  Sample (i,j) of an m1 x m2 grid holds the (d1+1) x (d2+1) partial
+   *  derivatives of a surface, the same content as a
+   *  DMatrix< DMatrix< Vector<T,n> > > but in a single, cache line aligned
+   *  allocation that is kept when the dimensions shrink or come back.
+   *
+   *  Element (i,j,k,l) is at getPtr() + i*getStride(0) + j*getStride(1) +
+   *  k*getStride(2) + l*getStride(3).
+   *  - LAYOUT_AOS: the derivative matrix of each sample is contiguous,
+   *    getSample(i,j) points at it.
+   *  - LAYOUT_SOA: each derivative is a contiguous m1 x m2 row major plane,
+   *    getPlane(k,l) points at it. Plane (0,0) is the positions.
+   */
+  template <typename T, int n>
+  class PSampleGrid {
+  public:
+    enum LAYOUT {
+      LAYOUT_AOS,
+      LAYOUT_SOA
+    };
+
+    PSampleGrid( LAYOUT layout = LAYOUT_AOS );
+    PSampleGrid( const PSampleGrid<T,n>& copy );
+    ~PSampleGrid();
+
+    int                       getDim1() const;
+    int                       getDim2() const;
+    int                       getDerivativesU() const;
+    int                       getDerivativesV() const;
+    LAYOUT                    getLayout() const;
+    size_t                    getSize() const;
+    int                       getStride( int k ) const;
+
+    Vector<T,n>*              getPtr();
+    const Vector<T,n>*        getPtr() const;
+    Vector<T,n>*              getPlane( int k, int l );
+    const Vector<T,n>*        getPlane( int k, int l ) const;
+    Vector<T,n>*              getSample( int i, int j );
+    const Vector<T,n>*        getSample( int i, int j ) const;
+
+    void                      setDim( int m1, int m2, int d1 = 0, int d2 = 0 );
+    void                      setLayout( LAYOUT layout );
+
+    void                      toDMatrix( DMatrix< DMatrix< Vector<T,n> > >& p ) const;
+
+    Vector<T,n>&              operator () ( int i, int j, int k = 0, int l = 0 );
+    const Vector<T,n>&        operator () ( int i, int j, int k = 0, int l = 0 ) const;
+
+    PSampleIndex_<Vector<T,n>,1>        operator [] ( int i );
+    PSampleIndex_<const Vector<T,n>,1>  operator () ( int i ) const;
+
+    PSampleGrid<T,n>&         operator = ( const PSampleGrid<T,n>& copy );
+
+  private:
+    LAYOUT                    _layout;
+    int                       _s[8];        // Strides and dimensions (m1, m2, d1+1, d2+1)
+    size_t                    _size;        // Number of elements in use
+    size_t                    _capacity;    // Number of elements allocated
+    void*                     _mem;         // The allocation
+    Vector<T,n>*              _data;        // Its first cache line aligned element
+
+    void                      _strides();
+
+  }; // END class PSampleGrid
+
+
+} // END namespace GMlib
+
+
+// Include PSampleGrid class function implementations
+#include "gmpsamplegrid.c"
+
+
+#endif  // GM_PARAMETRICS_PSAMPLEGRID_H
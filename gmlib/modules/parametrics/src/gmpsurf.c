@@ -56,6 +56,10 @@ namespace GMlib {
     _tr_v                           = T(0);
     _sc_v                           = T(1);
     _resample                       = false;
+    _parallel_resample              = false;
+    _resample_tile                  = 32;
+    _samples.setLayout( PSampleGrid<T,n>::LAYOUT_SOA );
+    _normals.setLayout( PSampleGrid<T,3>::LAYOUT_SOA );
 
     setNoDer( 2 );
     //_setSam( s1, s2 );
@@ -91,6 +95,11 @@ namespace GMlib {
 
     _resample     = false;
 
+    _parallel_resample = copy._parallel_resample;
+    _resample_tile     = copy._resample_tile;
+    _samples.setLayout( PSampleGrid<T,n>::LAYOUT_SOA );
+    _normals.setLayout( PSampleGrid<T,3>::LAYOUT_SOA );
+
     _default_visualizer = 0x0;
   }
 
@@ -107,6 +116,13 @@ namespace GMlib {
   inline
   void PSurf<T,n>::_eval( T u, T v, int d1, int d2 ) const {
 
+    // The last evaluation cache is shared by all threads, skip it when
+    // evaluating into a thread private buffer
+    if( _p.isRedirected() ) {
+      eval( shiftU(u), shiftV(v), d1, d2 );
+      return;
+    }
+
     if( !(d1 <= _d1 and d2 <=_d2 and GMutils::compValueF(u,_u) and GMutils::compValueF(v,_v) ) ) {
 
       _u  = u;
@@ -118,6 +134,70 @@ namespace GMlib {
     }
   }
 
+  /*! void PSurf<T,n>::_resampleGrid( G& p, ... )
+   *  The grid of resample(), for both sample containers, p must have its
+   *  dimensions set. With parallel resampling the grid is split in tiles
+   *  shared by all threads. Each thread evaluates into its own buffers, with
+   *  its own pre-eval index _ind, and copies the result into p.
+   */
+  template <typename T, int n>
+  template <typename G>
+  void PSurf<T,n>::_resampleGrid( G& p, int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v ) {
+
+    _resample = true;
+
+    const T du = (e_u-s_u)/(m1-1);
+    const T dv = (e_v-s_v)/(m2-1);
+
+    const int b  = _parallel_resample ? _resample_tile : std::max( m1, m2 );
+    const int t1 = (m1 + b - 1) / b;
+    const int t2 = (m2 + b - 1) / b;
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic) if(_parallel_resample)
+#endif
+    for( int t = 0; t < t1*t2; t++ ) {
+
+      const int i0 = (t / t2) * b, i1 = std::min( i0 + b, m1 );
+      const int j0 = (t % t2) * b, j1 = std::min( j0 + b, m2 );
+
+      Vector<int,2> ind;
+      typename PEvalBuffer< Vector<int,2> >::Redirect          ri( _ind, ind );
+      typename PEvalBuffer< DMatrix< Vector<T,n> > >::Redirect rp( _p );
+
+      for( int i = i0; i < i1; i++ ) {
+
+        // The last row and column are evaluated from the right
+        const bool lu = i < m1-1;
+        const T    u  = lu ? s_u + i*du : e_u;
+        ind[0] = i;
+
+        for( int j = j0; j < j1; j++ ) {
+
+          const bool lv = j < m2-1;
+          ind[1] = j;
+
+          eval( u, lv ? s_v + j*dv : e_v, d1, d2, lu, lv );
+          p[i][j] = _p.get();
+        }
+      }
+    }
+
+    switch( this->_dm ) {
+      case GM_DERIVATION_EXPLICIT:
+        // Do nothing, evaluator algorithms for explicite calculation of derivatives
+        // should be defined in the eval( ... ) function enclosed by
+        // if( this->_derivation_method == this->EXPLICIT ) { ... eval algorithms for derivatives ... }
+        break;
+      case GM_DERIVATION_DD:
+        DD::compute2D(p,du,dv,isClosedU(),isClosedV(),d1,d2,0,0,_parallel_resample);
+        break;
+    }
+
+    _resample = false;
+  }
+
+
   template <typename T, int n>
   inline
   void PSurf<T,n>::_evalNormal() {
@@ -190,7 +270,27 @@ namespace GMlib {
   DMatrix<Vector<T,n> >& PSurf<T,n>::evaluate( T u, T v, int d1, int d2 ) const {
 
     _eval(u, v, d1, d2);
-    return _p;
+    return _p.get();
+  }
+
+
+  /*! void PSurf<T,n>::evaluate( T u, T v, int d1, int d2, DMatrix<Vector<T,n> >& p ) const
+   *  Reentrant evaluation, the result is written to p.
+   *  Touches no member of the surface, so several threads may evaluate the
+   *  same surface at once. Evaluators of composite surfaces write their
+   *  local patches to thread private buffers as well.
+   *  \param[in]  u   Evaluation parameter in u-direction.
+   *  \param[in]  v   Evaluation parameter in v-direction.
+   *  \param[in]  d1  Number of derivatives to be computed for u.
+   *  \param[in]  d2  Number of derivatives to be computed for v.
+   *  \param[out] p   Position and belonging partial derivatives.
+   */
+  template <typename T, int n>
+  inline
+  void PSurf<T,n>::evaluate( T u, T v, int d1, int d2, DMatrix<Vector<T,n> >& p ) const {
+
+    typename PEvalBuffer< DMatrix< Vector<T,n> > >::Redirect r( _p, p );
+    eval( shiftU(u), shiftV(v), d1, d2 );
   }
 
 
@@ -241,7 +341,7 @@ namespace GMlib {
   inline
   DMatrix<Vector<T,n> >& PSurf<T,n>::evaluateGlobal( T u, T v, int d1, int d2 ) const {
 
-    static DMatrix<Vector<T,n> > p;
+    static thread_local DMatrix<Vector<T,n> > p;
 
     eval(u,v,d1,d2);
     p.setDim( _p.getDim1(), _p.getDim2() );
@@ -271,7 +371,7 @@ namespace GMlib {
   inline
   DMatrix<Vector<T,n> >& PSurf<T,n>::evaluateParent( T u, T v, int d1, int d2 ) const {
 
-    static DMatrix<Vector<T,n> > p;
+    static thread_local DMatrix<Vector<T,n> > p;
 
     eval(u,v,d1,d2);
     p.setDim( _p.getDim1(), _p.getDim2() );
@@ -332,13 +432,14 @@ namespace GMlib {
   template <typename T, int n>
   inline
   void PSurf<T,n>::_computeEFGefg( T u, T v, T& E, T& F, T& G, T& e, T& f, T& g ) const {
-      _eval(u,v,2,2);
-      UnitVector<T,n>  N   = _p[1][0]^_p[0][1];
-      Vector<T,n>      du  = _p[1][0];
-      Vector<T,n>      dv  = _p[0][1];
-      Vector<T,n>      duu = _p[2][0];
-      Vector<T,n>      duv = _p[1][1];
-      Vector<T,n>      dvv = _p[0][2];
+      DMatrix< Vector<T,n> > p;
+      evaluate(u,v,2,2,p);
+      UnitVector<T,n>  N   = p[1][0]^p[0][1];
+      Vector<T,n>      du  = p[1][0];
+      Vector<T,n>      dv  = p[0][1];
+      Vector<T,n>      duu = p[2][0];
+      Vector<T,n>      duv = p[1][1];
+      Vector<T,n>      dvv = p[0][2];
       E = du * du;
       F = du * dv;
       G = dv * dv;
@@ -541,6 +642,17 @@ namespace GMlib {
   // Virtual functons for surface properies **
   //******************************************
 
+  /*! bool PSurf<T,n>::isParallelResample() const
+   *  Whether resample() evaluates its grid on several threads.
+   */
+  template <typename T, int n>
+  inline
+  bool PSurf<T,n>::isParallelResample() const {
+
+    return _parallel_resample;
+  }
+
+
   template <typename T, int n>
   bool PSurf<T,n>::isClosedU() const {
     return false;
@@ -565,9 +677,10 @@ namespace GMlib {
     Point<T,n> p = invmat * q;  // Egentlig _present
 
 
+    DMatrix< Vector<T,n> > r;
     for(int i = 0; i < 20; i++ ) {
 
-      DMatrix< Vector<T,n> > &r = evaluate( u, v, 2, 2 );
+      evaluate( u, v, 2, 2, r );
       Vector<T,n> d = p-r[0][0];
 
       a11 = d*r[2][0] - r[1][0] * r[1][0];
@@ -637,20 +750,18 @@ namespace GMlib {
     else            _no_der_v = d2;
 
     // Sample Positions and related Derivatives
-    DMatrix< DMatrix< Vector<T,n> > > p;
-    resample( p, m1, m2, d1, d2, getStartPU(), getStartPV(), getEndPU(), getEndPV() );
+    resample( _samples, m1, m2, d1, d2, getStartPU(), getStartPV(), getEndPU(), getEndPV() );
 
     // Compute normals at the sample points
-    DMatrix< Vector<T,n> > normals;
-    resampleNormals( p, normals );
+    resampleNormals( _samples, _normals );
 
 
     // Set The Surrounding Sphere
-    setSurroundingSphere( p );
+    setSurroundingSphere( _samples );
 
     // Replot Visaulizers
     for( int i = 0; i < this->_psurf_visualizers.getSize(); i++ )
-      this->_psurf_visualizers[i]->replot( p, normals, m1, m2, d1, d2, isClosedU(), isClosedV() );
+      this->_psurf_visualizers[i]->replot( _samples, _normals, m1, m2, d1, d2, isClosedU(), isClosedV() );
   }
 
 
@@ -670,48 +781,22 @@ namespace GMlib {
   template <typename T, int n>
   void PSurf<T,n>::resample( DMatrix< DMatrix < Vector<T,n> > >& p,
                                     int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v ) {
-    _resample = true;
-
-    T du = (e_u-s_u)/(m1-1);
-    T dv = (e_v-s_v)/(m2-1);
 
     p.setDim(m1, m2);
+    _resampleGrid( p, m1, m2, d1, d2, s_u, s_v, e_u, e_v );
+  }
 
-    for(int i=0; i<m1-1; i++) {
-      _ind[0]=i;
-      T u = s_u + i*du;
-      for(int j=0;j<m2-1;j++) {
-        _ind[1]=j;
-        eval(u, s_v + j*dv, d1, d2, true, true );
-        p[i][j] = _p;
-      }
-      _ind[1]=m2-1;
-      eval(u, e_v, d1, d2, true, false);
-      p[i][m2-1] = _p;
-    }
-
-    _ind[0]=m1-1;
-    for(int j=0;j<m2-1;j++) {
-      _ind[1]=j;
-      eval(e_u, s_v + j*dv, d1, d2, false, true);
-      p[m1-1][j] = _p;
-    }
-    _ind[1]=m2-1;
-    eval(e_u, e_v, d1, d2, false, false);
-    p[m1-1][m2-1] = _p;
 
-    switch( this->_dm ) {
-      case GM_DERIVATION_EXPLICIT:
-        // Do nothing, evaluator algorithms for explicite calculation of derivatives
-        // should be defined in the eval( ... ) function enclosed by
-        // if( this->_derivation_method == this->EXPLICIT ) { ... eval algorithms for derivatives ... }
-        break;
-      case GM_DERIVATION_DD:
-        DD::compute2D(p,du,dv,isClosedU(),isClosedV(),d1,d2);
-        break;
-    }
+  /*! void PSurf<T,n>::resample( PSampleGrid<T,n>& p, int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v )
+   *  As the nested matrix version, into a flat sample grid. The grid keeps
+   *  its layout, and only allocates when it grows.
+   */
+  template <typename T, int n>
+  void PSurf<T,n>::resample( PSampleGrid<T,n>& p,
+                             int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v ) {
 
-    _resample = false;
+    p.setDim(m1, m2, d1, d2);
+    _resampleGrid( p, m1, m2, d1, d2, s_u, s_v, e_u, e_v );
   }
 
 
@@ -737,6 +822,19 @@ namespace GMlib {
   }
 
 
+  template <typename T, int n>
+  void PSurf<T,n>::resampleNormals( const PSampleGrid<T,n>& p, PSampleGrid<T,3>& normals ) const {
+
+    normals.setDim( p.getDim1(), p.getDim2() );
+
+    for( int i = 0; i < p.getDim1(); i++ )
+      for( int j = 0; j < p.getDim2(); j++ ){
+        normals(i,j) = p(i,j,1,0) ^ p(i,j,0,1);
+        normals(i,j).normalize();
+      }
+  }
+
+
   template <typename T, int n>
   inline
   void PSurf<T,n>::setDomainU( T start, T end ) {
@@ -796,6 +894,24 @@ namespace GMlib {
   }
 
 
+  /*! void PSurf<T,n>::setParallelResample( bool parallel, int tile )
+   *  Turns the tile parallel resample on or off.
+   *  The sample grid is cut into tile x tile blocks that the threads pick
+   *  up as they become idle. Only for surfaces whose evaluator may run on
+   *  several threads at once, i.e. keeps its scratch data in _p or on the
+   *  stack. Without OpenMP the tiles are evaluated one after the other.
+   *  \param[in]  parallel  Turn the parallel resample on.
+   *  \param[in]  tile      Edge length of a tile in samples.
+   */
+  template <typename T, int n>
+  inline
+  void PSurf<T,n>::setParallelResample( bool parallel, int tile ) {
+
+    _parallel_resample = parallel;
+    _resample_tile     = tile > 0 ? tile : 1;
+  }
+
+
   template <typename T, int n>
   void PSurf<T,n>::setSurroundingSphere( const DMatrix< DMatrix< Vector<T,n> > >& p ) {
     Sphere<T,n>  s;
@@ -804,6 +920,14 @@ namespace GMlib {
   }
 
 
+  template <typename T, int n>
+  void PSurf<T,n>::setSurroundingSphere( const PSampleGrid<T,n>& p ) {
+    Sphere<T,n>  s;
+    uppdateSurroundingSphere(s, p);
+    Parametrics<T,2,n>::setSurroundingSphere(s);
+  }
+
+
   template <typename T, int n>
   inline
   void PSurf<T,n>::uppdateSurroundingSphere( Sphere<T,n>& s, const DMatrix< DMatrix< Vector<T,n> > >& p ) {
@@ -819,6 +943,21 @@ namespace GMlib {
   }
 
 
+  template <typename T, int n>
+  inline
+  void PSurf<T,n>::uppdateSurroundingSphere( Sphere<T,n>& s, const PSampleGrid<T,n>& p ) {
+      s += Point<T,n>( p(0)(0)(0)(0) );
+      s += Point<T,n>( p( p.getDim1()-1 )( p.getDim2()-1 )(0)(0) );
+      s += Point<T,n>( p( p.getDim1()/2 )( p.getDim2()/2 )(0)(0) );
+      s += Point<T,n>( p( p.getDim1()-1 )( 0             )(0)(0) );
+      s += Point<T,n>( p( 0             )( p.getDim2()-1 )(0)(0) );
+      s += Point<T,n>( p( p.getDim1()-1 )( p.getDim2()/2 )(0)(0) );
+      s += Point<T,n>( p( p.getDim1()/2 )( p.getDim2()-1 )(0)(0) );
+      s += Point<T,n>( p( 0             )( p.getDim2()/2 )(0)(0) );
+      s += Point<T,n>( p( p.getDim1()/2 )( 0             )(0)(0) );
+  }
+
+
   template <typename T, int n>
   inline
   T PSurf<T,n>::shiftU( T u ) const {
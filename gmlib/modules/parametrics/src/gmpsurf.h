@@ -28,6 +28,8 @@
 
 
 #include "gmparametrics.h"
+#include "gmpevalbuffer.h"
+#include "gmpsamplegrid.h"
 
 // gmlib
 #include <core/containers/gmarray.h>
@@ -58,6 +60,7 @@ namespace GMlib {
 
     DMatrix<Vector<T,n> >&        evaluate( const APoint<T,2>& p, const APoint<int,2>& d ) const;
     DMatrix<Vector<T,n> >&        evaluate( T u, T v, int d1, int d2 ) const;
+    void                          evaluate( T u, T v, int d1, int d2, DMatrix<Vector<T,n> >& p ) const;
     DVector<Vector<T,n> >         evaluateD( const APoint<T,2>& p, const APoint<int,2>& d ) const;
     DVector<Vector<T,n> >         evaluateD( T u, T v, int d1, int d2 ) const;
     DMatrix<Vector<T,n> >&        evaluateGlobal( const APoint<T,2>& p, const APoint<int,2>& d ) const;
@@ -106,7 +109,10 @@ namespace GMlib {
     void                          setDomainVTrans( T tr );
 
     void                          setNoDer( int d );
+    void                          setParallelResample( bool parallel, int tile = 32 );
+    bool                          isParallelResample() const;
     virtual void                  setSurroundingSphere( const DMatrix< DMatrix< Vector<T,n> > >& p );
+    virtual void                  setSurroundingSphere( const PSampleGrid<T,n>& p );
     virtual Parametrics<T,2,n>*   split( T t, int uv );
 
     virtual void                  showSelectors(T /*rad*/, bool /*grid*/, const Color& /*selector_color*/, const Color& /*grid_color*/) {}
@@ -142,13 +148,21 @@ namespace GMlib {
     int                           _default_d;
 
     // Can be used by resample -- index in pre-eval
-    int                           _ind[2];
+    mutable PEvalBuffer< Vector<int,2> > _ind;
     bool                          _resample;
     int                           _pre_eval_kode;
 
+    // Tile parallel resample
+    bool                          _parallel_resample;
+    int                           _resample_tile;  // Edge length of a tile in samples
+
+    // Kept between replots, so that resampling does not allocate
+    PSampleGrid<T,n>              _samples;     // Positions and derivatives of the last replot
+    PSampleGrid<T,3>              _normals;     // Normals of the last replot
+
 
     // The result of the previous evaluation
-    mutable DMatrix< Vector<T,n> > _p;           // Position and belonging partial derivatives
+    mutable PEvalBuffer< DMatrix< Vector<T,n> > > _p; // Position and belonging partial derivatives
     mutable Vector<T,n>            _n;           // Surface normal, for display in 3D
     mutable T                      _u;           // The parameter value in u-direction used for last evaluation
     mutable T                      _v;           // The parameter value in v-direction used for last evaluation
@@ -207,9 +221,13 @@ namespace GMlib {
     void                          resample(DMatrix<DMatrix <DMatrix <Vector<T,n> > > >	& a, int m1, int m2, int d1, int d2 );
     virtual void                  resample(DMatrix<DMatrix <Vector<T,n> > >& a, int m1, int m2, int d1, int d2, T s_u = T(0), T s_v = T(0), T e_u = T(0), T e_v = T(0));
 
+    virtual void                  resample( PSampleGrid<T,n>& p, int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v );
+
     virtual void                  resampleNormals( const DMatrix<DMatrix<Vector<T,n> > > &sample, DMatrix<Vector<T,3> > &normals ) const;
+    virtual void                  resampleNormals( const PSampleGrid<T,n>& sample, PSampleGrid<T,3>& normals ) const;
 
     void                          uppdateSurroundingSphere( Sphere<T,n>& s, const DMatrix< DMatrix< Vector<T,n> > >& p );
+    void                          uppdateSurroundingSphere( Sphere<T,n>& s, const PSampleGrid<T,n>& p );
 
     T                             shiftU(T u) const;
     T                             shiftV(T v) const;
@@ -218,6 +236,8 @@ namespace GMlib {
 
     void                          _eval( T u, T v, int d1, int d2 ) const;
     void                          _evalNormal();
+    template <typename G>
+    void                          _resampleGrid( G& p, int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v );
     void                          _computeEFGefg( T u, T v, T& E, T& F, T& G, T& e, T& f, T& g ) const;
 //    void                          _setSam( int m1, int m2 );
     int                           _sum( int i, int j );
@@ -294,7 +294,7 @@ namespace GMlib {
       // Set Dimensions
       this->_p.setDim( du+1, dv+1 );
 
-      DMatrix<T> bu, bv;
+      static thread_local DMatrix<T> bu, bv;
       EvaluatorStatic<T>::evaluateBhp( bu, this->getDegreeU(), u, _su );
       EvaluatorStatic<T>::evaluateBhp( bv, this->getDegreeV(), v, _sv );
 
@@ -357,15 +357,61 @@ namespace GMlib {
   template <typename T>
   void PBezierSurf<T>::resample( DMatrix< DMatrix < Vector<T,3> > >& p,
                                  int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v ) {
-      // Set Dimensions
-      this->_p.setDim(d1+1,d2+1);
-      p.setDim(m1, m2);
 
+      resample( _rg, m1, m2, d1, d2, s_u, s_v, e_u, e_v );
+      _rg.toDMatrix( p );
+  }
+
+
+  /*! void PBezierSurf<T>::resample( PSampleGrid<T,3>& p, int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v )
+   *  The grid as a tensor product of the pre-evaluated basis, see preSample().
+   *  The control points are first contracted with the v-basis of each
+   *  column, then each row of samples is a sum of these columns weighted
+   *  by the u-basis of the row.
+   */
+  template <typename T>
+  void PBezierSurf<T>::resample( PSampleGrid<T,3>& p,
+                                 int m1, int m2, int d1, int d2, T /*s_u*/, T /*s_v*/, T /*e_u*/, T /*e_v*/ ) {
+
+      if( _ru.getDim() != m1 )  preSample( 1, m1 );
+      if( _rv.getDim() != m2 )  preSample( 2, m2 );
+
+      const int ku = getDegreeU()+1;
+      const int kv = getDegreeV()+1;
+      const int D2 = d2+1;
+
+      // Set Dimensions, the strides follow the layout and the dimensions
+      p.setDim(m1, m2, d1, d2);
+      _rc.setDim(ku*D2*m2);
+      const int s  = p.getStride(1);
+
+      //    _rc(a,l,j) = sum_k _c(a)(k) * _rv[j](l)(k), j contiguous
+#ifdef _OPENMP
+  #pragma omp parallel for if(this->_parallel_resample)
+#endif
+      for(int j=0; j<m2; j++)
+          for(int a=0; a<ku; a++)
+              for(int l=0; l<D2; l++) {
+                  Vector<T,3> c(T(0));
+                  if( l < kv )  // Higher derivatives vanish
+                      for(int k=0; k<kv; k++)
+                          c += _c(a)(k)*_rv(j)(l)(k);
+                  _rc[(a*D2+l)*m2+j] = c;
+              }
+
+      //    p(i,j,r,l) = sum_a _ru[i](r)(a) * _rc(a,l,j)
+#ifdef _OPENMP
+  #pragma omp parallel for if(this->_parallel_resample)
+#endif
       for(int i=0; i<m1; i++)
-          for(int j=0; j<m2; j++) {
-              multEval( _ru[i], _rv[j], d1, d2);
-              p[i][j] = this->_p;
-          }
+          for(int r=0; r<=d1; r++)
+              for(int l=0; l<D2; l++) {
+                  Vector<T,3>* row = &p(i,0,r,l);
+                  Private::sampleRowZero( m2, row, s );
+                  if( r < ku )
+                      for(int a=0; a<ku; a++)
+                          Private::sampleRowAxpy( m2, _ru(i)(r)(a), &_rc(( a*D2+l )*m2), row, s );
+              }
   }
 
 
@@ -409,7 +455,8 @@ namespace GMlib {
       int ku = this->getDegreeU()+1;
       int kv = this->getDegreeV()+1;
 
-      DMatrix<Vector<T,3>> c(ku, dv+1);
+      static thread_local DMatrix<Vector<T,3>> c;
+      c.setDim(ku, dv+1);
 
       // We do these two operations manually here!
       //    bv.transpose();
@@ -423,8 +470,8 @@ namespace GMlib {
                   c[i][j] += _c(i)(k)*bv(j)(k);
           }
       //    _p = bu * c
-      for(int i=0; i<=dv; i++)
-          for(int j=0; j<=du; j++) {
+      for(int i=0; i<=du; i++)
+          for(int j=0; j<=dv; j++) {
               this->_p[i][j] = bu(i)(0)*c[0][j];
               for(int k=1; k<ku; k++)
                   this->_p[i][j] += bu(i)(k)*c[k][j];
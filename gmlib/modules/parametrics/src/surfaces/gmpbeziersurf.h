@@ -92,6 +92,8 @@ namespace GMlib {
       DVector< DMatrix< T > >    _rv;      // Pre-evaluation of basis in v-direction
 
       DMatrix< DMatrix< Vector<T,3>>> _pr; // preeval as local surface
+      DVector< Vector<T,3> >     _rc;      // Control points contracted with the pre-evaluated v-basis, used by resample
+      PSampleGrid<T,3>           _rg;      // Grid of the nested matrix resample, kept between calls
 
       bool                       _selectors;   // Mark if we have selectors or not
       SelectorGridVisualizer<T>* _sgv;         // Selectorgrid
@@ -113,6 +115,7 @@ namespace GMlib {
 
       // Virtual function from PSurf
       void                       resample(DMatrix<DMatrix <Vector<T,3> > >& a, int m1, int m2, int d1, int d2, T s_u = T(0), T s_v = T(0), T e_u = T(0), T e_v = T(0)) override;
+      void                       resample(PSampleGrid<T,3>& a, int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v) override;
       void                       preSample( int dir, int m ) override;
 
       // Help functions
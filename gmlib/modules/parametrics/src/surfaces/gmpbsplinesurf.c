@@ -357,8 +357,10 @@ namespace GMlib {
   template <typename T>
   void PBSplineSurf<T>::eval( T u, T v, int du, int dv, bool lu, bool lv ) const {
 
-      DMatrix<T>   bu, bv;
-      DVector<int> ind_i(_ku), ind_j(_kv);
+      static thread_local DMatrix<T>   bu, bv;
+      static thread_local DVector<int> ind_i, ind_j;
+      ind_i.setDim(_ku);
+      ind_j.setDim(_kv);
 
       int i = EvaluatorStatic<T>::evaluateBSp( bu, u, _u, _du, lu) - _du;
       int j = EvaluatorStatic<T>::evaluateBSp( bv, v, _v, _dv, lv) - _dv;
@@ -424,6 +426,19 @@ namespace GMlib {
 
 
 
+  /*! PSurfVisualizer<T,3>* PBSplineSurf<T>::makePartitionVisualizer()
+   *  A new default visualizer, one is made for every patch when the
+   *  partition visualization is set up.
+   */
+  template <typename T>
+  inline
+  PSurfVisualizer<T,3>* PBSplineSurf<T>::makePartitionVisualizer() {
+
+      return new PSurfDefaultVisualizer<T,3>();
+  }
+
+
+
 
   //***************************************************
   // Overrided (private) virtual functons from PSurf **
@@ -467,11 +482,20 @@ namespace GMlib {
   template <typename T>
   void PBSplineSurf<T>::resample( DMatrix< DMatrix< Vector<T,3> > >& p, int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v ) {
 
-      p.setDim(m1, m2);
+      resample( _rg, m1, m2, d1, d2, s_u, s_v, e_u, e_v );
+      _rg.toDMatrix( p );
+  }
 
-      for(int i=0; i<m1; i++)
-          for(int j=0; j<m2; j++)
-              multEval( p[i][j], _ru[0][i].m, _rv[0][j].m, _ru[0][i].ind, _rv[0][j].ind, d1, d2 );
+
+
+  template <typename T>
+  void PBSplineSurf<T>::resample( PSampleGrid<T,3>& p, int m1, int m2, int d1, int d2, T /*s_u*/, T /*s_v*/, T /*e_u*/, T /*e_v*/ ) {
+
+      if( !_part_viz ) {
+          if( _ru[0].getDim() != m1 )  preSample( 1, m1 );
+          if( _rv[0].getDim() != m2 )  preSample( 2, m2 );
+      }
+      resample( p, _ru[0], _rv[0], m1, m2, d1, d2 );
   }
 
 
@@ -479,11 +503,66 @@ namespace GMlib {
   template <typename T>
   void PBSplineSurf<T>::resample( DMatrix< DMatrix< Vector<T,3> > >& p, const DVector<PreMat>& bu, const DVector<PreMat>& bv, int m1, int m2, int d1, int d2 ) {
 
-      p.setDim(m1, m2);
+      resample( _rg, bu, bv, m1, m2, d1, d2 );
+      _rg.toDMatrix( p );
+  }
+
+
+
+  /*! void PBSplineSurf<T>::resample( PSampleGrid<T,3>& p, const DVector<PreMat>& bu, const DVector<PreMat>& bv, int m1, int m2, int d1, int d2 )
+   *  The grid as a tensor product of the pre-evaluated basis. The control
+   *  point rows in the support of bu are first contracted with the v-basis
+   *  of each column, then each row of samples is a sum of these columns
+   *  weighted by the u-basis of the row.
+   */
+  template <typename T>
+  void PBSplineSurf<T>::resample( PSampleGrid<T,3>& p, const DVector<PreMat>& bu, const DVector<PreMat>& bv, int m1, int m2, int d1, int d2 ) {
+
+      const int D2 = d2+1;
+
+      // Set Dimensions, the strides follow the layout and the dimensions
+      p.setDim(m1, m2, d1, d2);
+      const int s  = p.getStride(1);
 
+      // The control point rows in use get a slot each
+      int no_rows = 0;
+      _rs.setDim(_c.getDim1());
+      for(int a=0; a<_rs.getDim(); a++)  _rs[a] = -1;
       for(int i=0; i<m1; i++)
-          for(int j=0; j<m2; j++)
-              multEval( p[i][j], bu(i).m, bv(j).m, bu(i).ind, bv(j).ind, d1, d2);
+          for(int k=0; k<_ku; k++)
+              if( _rs[bu(i).ind(k)] < 0 )  _rs[bu(i).ind(k)] = no_rows++;
+
+      _rc.setDim(no_rows*D2*m2);
+
+      //    _rc(_rs[a],l,j) = sum_k _c(a)(bv[j].ind(k)) * bv[j].m(l)(k), j contiguous
+#ifdef _OPENMP
+  #pragma omp parallel for if(this->_parallel_resample)
+#endif
+      for(int j=0; j<m2; j++)
+          for(int a=0; a<_rs.getDim(); a++) {
+              if( _rs(a) < 0 ) continue;
+              for(int l=0; l<D2; l++) {
+                  Vector<T,3> c(T(0));
+                  if( l < _kv )  // Higher derivatives vanish
+                      for(int k=0; k<_kv; k++)
+                          c += _c(a)(bv(j).ind(k))*bv(j).m(l)(k);
+                  _rc[(_rs(a)*D2+l)*m2+j] = c;
+              }
+          }
+
+      //    p(i,j,r,l) = sum_k bu[i].m(r)(k) * _rc(_rs[bu[i].ind(k)],l,j)
+#ifdef _OPENMP
+  #pragma omp parallel for if(this->_parallel_resample)
+#endif
+      for(int i=0; i<m1; i++)
+          for(int r=0; r<=d1; r++)
+              for(int l=0; l<D2; l++) {
+                  Vector<T,3>* row = &p(i,0,r,l);
+                  Private::sampleRowZero( m2, row, s );
+                  if( r < _ku )
+                      for(int k=0; k<_ku; k++)
+                          Private::sampleRowAxpy( m2, bu(i).m(r)(k), &_rc(( _rs(bu(i).ind(k))*D2+l )*m2), row, s );
+              }
   }
 
 
@@ -523,7 +602,8 @@ namespace GMlib {
       // The reason why we do it manually is that we only copmpute the du first lines of bu and the dv first lines of bv
 
       //    c = _c^bvT
-      DMatrix<Vector<T,3>> c(_ku, dv+1);
+      static thread_local DMatrix<Vector<T,3>> c;
+      c.setDim(_ku, dv+1);
 
       for(int i=0; i< _ku; i++)
           for(int j=0; j<=dv; j++) {
@@ -532,8 +612,8 @@ namespace GMlib {
                   c[i][j] += _c(ii(i))(ij(k))*bv(j)(k);
           }
       //    p = bu * c
-      for(int i=0; i<=dv; i++)
-          for(int j=0; j<=du; j++) {
+      for(int i=0; i<=du; i++)
+          for(int j=0; j<=dv; j++) {
               p[i][j] = bu(i)(0)*c[0][j];
               for(int k=1; k<_ku; k++)
                   p[i][j] += bu(i)(k)*c[k][j];
@@ -614,7 +694,7 @@ namespace GMlib {
           _visu.setDim(_vpu.getDim(), _vpv.getDim());
           for(int i=0; i<_visu.getDim1(); i++)
               for(int j=0; j<_visu.getDim2(); j++) {
-                  PSurfVisualizer<T,3>* vis = new PSurfDefaultVisualizer<T,3>();
+                  PSurfVisualizer<T,3>* vis = makePartitionVisualizer();
                   _visu[i][j].vis += vis;
                   this->insertVisualizer(vis);
                   _visu[i][j].s_u = Vector<T,2>(_u[_vpu[i].is], _u[_vpu[i].ie]);
@@ -115,6 +115,9 @@ namespace GMlib {
       // Pre-evaluation in visualization
       DVector<DVector<PreMat>>   _ru;      // Pre-evaluation of basis in u-direction
       DVector<DVector<PreMat>>   _rv;      // Pre-evaluation of basis in v-direction
+      DVector< Vector<T,3> >     _rc;      // Control points contracted with the pre-evaluated v-basis, used by resample
+      DVector<int>               _rs;      // Slot in _rc of each control point row, -1 if unused
+      PSampleGrid<T,3>           _rg;      // Grid of the nested matrix resample, kept between calls
       DVector<VisuPar>           _vpu;
       DVector<VisuPar>           _vpv;
       DMatrix<VisuSet>           _visu;
@@ -140,13 +143,18 @@ namespace GMlib {
       // Help function to ensure consistent initialization
       virtual void               init();
 
+      // The visualizer made for each patch of the partition visualization
+      virtual PSurfVisualizer<T,3>*  makePartitionVisualizer();
+
   private:
 
       // Virtual function from PSurf
       void                       preSample( int dir, int m ) override;
 
       void                       resample( DMatrix<DMatrix <Vector<T,3> > >& a, int m1, int m2, int d1, int d2, T s_u = T(0), T s_v = T(0), T e_u = T(0), T e_v = T(0)) override;
+      void                       resample( PSampleGrid<T,3>& a, int m1, int m2, int d1, int d2, T s_u, T s_v, T e_u, T e_v) override;
       void                       resample( DMatrix<DMatrix <Vector<T,3> > >& p, const DVector<PreMat>& bu, const DVector<PreMat>& bv, int m1, int m2, int d1, int d2 );
+      void                       resample( PSampleGrid<T,3>& p, const DVector<PreMat>& bu, const DVector<PreMat>& bv, int m1, int m2, int d1, int d2 );
 
       // Help functions
       void                       makeIndex( DVector<int>& ind, int i, int k, int n) const;
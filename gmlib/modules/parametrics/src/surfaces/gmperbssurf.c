@@ -456,8 +456,6 @@ namespace GMlib {
     for( int i = 0; i < _c.getDim1(); i++ )
       for( int j = 0; j < _c.getDim2(); j++ )
         SceneObject::remove( _c[i][j] );
-
-    delete _evaluator;
   }
 
   template <typename T>
@@ -850,12 +848,13 @@ namespace GMlib {
   inline
   void PERBSSurf<T>::getB( DVector<T>& B, const DVector<T>& kv, int tk, T t, int d ) {
 
-    B.setDim(d+1);
+    long double b[3];
+    _evaluator->eval( t, kv(tk), kv(tk+1) - kv(tk), std::min( d, 2 ), b );
 
-    _evaluator->set( kv(tk), kv(tk+1) - kv(tk) );
-    B[0] = 1 - _evaluator->operator()(t);
-    B[1] = - _evaluator->getDer1();
-    B[2] = - _evaluator->getDer2();
+    B.setDim(d+1);
+    B[0] = 1 - b[0];
+    if( d > 0 ) B[1] = - b[1];
+    if( d > 1 ) B[2] = - b[2];
   }
 
   template <typename T>
@@ -1091,8 +1090,7 @@ namespace GMlib {
     _no_der_u                       = 1;
     _no_der_v                       = 1;
 
-//    _evaluator = ERBSEvaluator<long double>::getInstance();
-    _evaluator = new ERBSEvaluator<long double>;
+    _evaluator = &ERBSEvaluator<long double>::getTable();
     _resamp_mode = GM_RESAMPLE_PREEVAL;
     _pre_eval = true;
   }
@@ -119,7 +119,7 @@ namespace GMlib {
     bool                                _closed_u;
     bool                                _closed_v;
 
-    ERBSEvaluator<long double>          *_evaluator;
+    const BasisTable<long double>       *_evaluator;   // Shared ERBS basis tables
 
     DVector< PreVec >                   _ru;
     DVector< PreVec >                   _rv;
@@ -258,6 +258,16 @@ namespace GMlib {
   }
 
 
+  template <typename T>
+  void PSphere<T>::resampleNormals(const PSampleGrid<T,3>&, PSampleGrid<T,3>& n) const {
+    if(_nmap.getDim1() == 0) makeNmap(32,32);//(66,66);
+    n.setDim( _nmap.getDim1(), _nmap.getDim2() );
+    for( int i = 0; i < _nmap.getDim1(); i++ )
+      for( int j = 0; j < _nmap.getDim2(); j++ )
+        n(i,j) = _nmap(i)(j);
+  }
+
+
 
 
   //*****************************************
@@ -69,6 +69,7 @@ namespace GMlib {
   private:
     // Virtual function from PSurf
     void   resampleNormals( const DMatrix<DMatrix<Vector<T,3> > >& sample, DMatrix<Vector<T,3> >& normals ) const override;
+    void   resampleNormals( const PSampleGrid<T,3>& sample, PSampleGrid<T,3>& normals ) const override;
 
     // Help function to initiate
     void   makeNmap( int s = 64, int t = 64) const;
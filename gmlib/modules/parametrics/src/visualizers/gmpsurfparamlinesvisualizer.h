@@ -49,6 +49,11 @@ namespace GMlib {
                           int m1, int m2, int d1, int d2,
                           bool closed_u, bool closed_v
     ) override;
+    virtual void  replot( const PSampleGrid<T,n>& p,
+                          const PSampleGrid<T,3>& normals,
+                          int m1, int m2, int d1, int d2,
+                          bool closed_u, bool closed_v
+    ) override;
 
   private:
     GL::Program                 _prog;
@@ -77,6 +77,35 @@ void PSurfVisualizer<T,n>::fillMap(GL::Texture& map, const DMatrix<DMatrix<Vecto
 }
 
 
+/*! void PSurfVisualizer<T,n>::fillMap( GL::Texture& map, const PSampleGrid<T,n>& p, int d1, int d2, bool closed_u, bool closed_v )
+ *  The (d1,d2) partial derivatives as a texture, with the orientation of
+ *  the normal map: row i is u sample i.
+ */
+template <typename T, int n>
+inline
+void PSurfVisualizer<T,n>::fillMap(GL::Texture& map, const PSampleGrid<T,n>& p, int d1, int d2, bool closed_u, bool closed_v) {
+
+  int m1 = closed_u ? p.getDim1()-1 : p.getDim1();
+  int m2 = closed_v ? p.getDim2()-1 : p.getDim2();
+
+  DVector< Vector<float,3> > tex_data(m1*m2);
+  Vector<float,3> *ptr = tex_data.getPtr();
+  for( int i = 0; i < m1; ++i )
+    for( int j = 0; j < m2; ++j )
+      *ptr++ = p(i,j,d1,d2);
+
+  // Create Normal map texture and set texture parameters
+  map.texImage2D( 0, GL_RGB16F, m2, m1, 0, GL_RGB, GL_FLOAT, tex_data.getPtr()->getPtr() );
+  map.texParameteri( GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+  map.texParameteri( GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+  if( closed_v )  map.texParameterf(GL_TEXTURE_WRAP_S, GL_REPEAT);
+  else            map.texParameterf(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+
+  if( closed_u )  map.texParameterf(GL_TEXTURE_WRAP_T, GL_REPEAT);
+  else            map.texParameterf(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+
 template <typename T, int n>
 inline
 void PSurfVisualizer<T,n>::fillNMap( GL::Texture& nmap, const DMatrix< Vector<T, 3> >& ns, bool closed_u, bool closed_v) {
@@ -116,6 +145,37 @@ void PSurfVisualizer<T,n>::fillNMap( GL::Texture& nmap, const DMatrix< Vector<T,
 }
 
 
+/*! void PSurfVisualizer<T,n>::fillNMap( GL::Texture& nmap, const PSampleGrid<T,3>& normals, bool closed_u, bool closed_v )
+ *  The rows of a grid without derivatives are contiguous, a grid that is
+ *  not closed in v is uploaded in one go.
+ */
+template <typename T, int n>
+inline
+void PSurfVisualizer<T,n>::fillNMap( GL::Texture& nmap, const PSampleGrid<T,3>& ns, bool closed_u, bool closed_v) {
+
+  int m1 = closed_u ? ns.getDim1()-1 : ns.getDim1();
+  int m2 = closed_v ? ns.getDim2()-1 : ns.getDim2();
+
+  if( !closed_v )
+    nmap.texImage2D( 0, GL_RGB16F, m2, m1, 0, GL_RGB, GL_FLOAT, reinterpret_cast<const float*>(ns.getPtr()) );
+  else {
+    nmap.texImage2D( 0, GL_RGB16F, m2, m1, 0, GL_RGB, GL_FLOAT, 0x0 );
+    for( int i = 0; i < m1; ++i )
+      nmap.texSubImage2D( 0, 0, i, m2, 1, GL_RGB, GL_FLOAT, reinterpret_cast<const float*>(ns.getSample(i,0)) );
+  }
+
+  // set texture parameters for the nmap
+  nmap.texParameteri( GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+  nmap.texParameteri( GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+
+  if( closed_v )  nmap.texParameterf(GL_TEXTURE_WRAP_S, GL_REPEAT);
+  else            nmap.texParameterf(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+
+  if( closed_u )  nmap.texParameterf(GL_TEXTURE_WRAP_T, GL_REPEAT);
+  else            nmap.texParameterf(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+
 template <typename T, int n>
 inline
 void PSurfVisualizer<T,n>::fillStandardIBO( GLuint ibo_id, int m1, int m2 ) {
@@ -161,6 +221,33 @@ void PSurfVisualizer<T,n>::fillStandardVBO(GL::VertexBufferObject &vbo,
 
 
 
+template <typename T, int n>
+inline
+void PSurfVisualizer<T,n>::fillStandardVBO(GL::VertexBufferObject &vbo,
+                                       const PSampleGrid<T,n>& p) {
+
+  GLsizeiptr no_vertices = p.getDim1() * p.getDim2() * sizeof(GL::GLVertexTex2D);
+
+  vbo.bufferData( no_vertices, 0x0, GL_STATIC_DRAW );
+  GL::GLVertexTex2D *ptr = vbo.mapBuffer<GL::GLVertexTex2D>();
+  for( int i = 0; i < p.getDim1(); i++ ) {
+    const Vector<T,n>* q = p.getSample(i,0);
+    float s = i/float(p.getDim1()-1);
+    for( int j = 0; j < p.getDim2(); j++, ptr++, q += p.getStride(1) ) {
+      // vertex position
+      ptr->x = (*q)(0);
+      ptr->y = (*q)(1);
+      ptr->z = (*q)(2);
+      // tex coords
+      ptr->s = s;
+      ptr->t = j/float(p.getDim2()-1);
+    }
+  }
+  vbo.unmapBuffer();
+}
+
+
+
 template <typename T, int n>
 inline
 void PSurfVisualizer<T,n>::fillStandardVBO(GL::VertexBufferObject &vbo,
@@ -353,6 +440,31 @@ void PSurfVisualizer<T,n>::replot(
 
 
 
+/*! void PSurfVisualizer<T,n>::replot( const PSampleGrid<T,n>& p, const PSampleGrid<T,3>& normals, ... )
+ *  Called by PSurf::replot. Hands the samples on to the nested matrix
+ *  replot, visualizers that override this one avoid the conversion.
+ */
+template <typename T, int n>
+void PSurfVisualizer<T,n>::replot(
+  const PSampleGrid<T,n>& p,
+  const PSampleGrid<T,3>& normals,
+  int m1, int m2, int d1, int d2,
+  bool closed_u, bool closed_v
+) {
+
+  DMatrix< DMatrix< Vector<T,n> > > q;
+  p.toDMatrix( q );
+
+  DMatrix< Vector<T,3> > ns( normals.getDim1(), normals.getDim2() );
+  for( int i = 0; i < ns.getDim1(); i++ )
+    for( int j = 0; j < ns.getDim2(); j++ )
+      ns[i][j] = normals(i,j);
+
+  replot( q, ns, m1, m2, d1, d2, closed_u, closed_v );
+}
+
+
+
 template <typename T, int n>
 void PSurfVisualizer<T,n>::replot(
   const DVector< DVector< Vector<T, n> > >& /*p*/,
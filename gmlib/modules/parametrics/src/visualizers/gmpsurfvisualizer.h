@@ -31,6 +31,7 @@
 // gmlib
 #include <core/types/gmpoint.h>
 #include <core/containers/gmdmatrix.h>
+#include "../gmpsamplegrid.h"
 #include <opengl/gmtexture.h>
 #include <opengl/bufferobjects/gmvertexbufferobject.h>
 #include <opengl/bufferobjects/gmindexbufferobject.h>
@@ -51,17 +52,23 @@ namespace GMlib {
     virtual void  replot( const DMatrix< DMatrix< Vector<T, n> > >& p, const DMatrix< Vector<T,3> >& normals,
                                                             int m1, int m2, int d1, int d2, bool closed_u, bool closed_v );
 
+    virtual void  replot( const PSampleGrid<T,n>& p, const PSampleGrid<T,3>& normals,
+                                                            int m1, int m2, int d1, int d2, bool closed_u, bool closed_v );
+
     virtual void  replot( const DVector<DVector<Vector<T, n> > >& p, const DMatrix< Vector<T,3> >& normals, int m, bool closed_u, bool closed_v );
 
 
     static void   fillStandardVBO(GL::VertexBufferObject &vbo, const DMatrix< DMatrix< Vector<T,n> > >& p );
     static void   fillStandardVBO(GL::VertexBufferObject &vbo, const DVector<DVector<Vector<T,n> > >& p );
+    static void   fillStandardVBO(GL::VertexBufferObject &vbo, const PSampleGrid<T,n>& p );
 
     static void   fillTriangleStripIBO(GL::IndexBufferObject& ibo, int m1, int m2, GLuint& no_strips, GLuint& no_strip_indices, GLsizei& strip_size );
     static void   fillNMap( GL::Texture& nmap, const DMatrix< Vector<T, 3> >& normals, bool closed_u, bool closed_v);
+    static void   fillNMap( GL::Texture& nmap, const PSampleGrid<T,3>& normals, bool closed_u, bool closed_v);
     static void   compTriangleStripProperties( int m1, int m2, GLuint& no_strips, GLuint& no_strip_indices, GLsizei& strip_size );
 
     static void   fillMap( GL::Texture& map, const DMatrix< DMatrix< Vector<T,n> > >& p, int d1, int d2, bool closed_u, bool closed_v );
+    static void   fillMap( GL::Texture& map, const PSampleGrid<T,n>& p, int d1, int d2, bool closed_u, bool closed_v );
     static void   fillStandardIBO( GLuint vbo_id, int m1, int m2 );
     static void   fillTriangleStripTexVBO( GLuint vbo_id, int m1, int m2 );
     static void   fillTriangleStripNormalVBO( GLuint vbo_id, DMatrix< Vector<T,3> >& normals );
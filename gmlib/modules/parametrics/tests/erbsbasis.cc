@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "../src/evaluators/gmerbsevaluator.h"
+using namespace GMlib;
+
+// stl
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+  TEST(Parametrics_Evaluators, BasisTable_matchesEvaluator) {
+
+    ERBSEvaluator<double>     e;
+    const BasisTable<double>  table( e );
+
+    EXPECT_EQ( e.getResolution(), table.getResolution() );
+
+    // The lookups give what the stateful evaluator gives after set()
+    const double tk[2]  = { 0.0, 2.5 };
+    const double dtk[2] = { 1.0, 0.75 };
+    for( int k = 0; k < 2; k++ ) {
+
+      e.set( tk[k], dtk[k] );
+      for( int i = 0; i <= 200; i++ ) {
+
+        const double t = tk[k] + i * dtk[k] / 200;
+        double b[3];
+        table.eval( t, tk[k], dtk[k], 2, b );
+
+        EXPECT_DOUBLE_EQ( e(t), b[0] );
+        EXPECT_DOUBLE_EQ( e.getDer1(), b[1] );
+        EXPECT_DOUBLE_EQ( e.getDer2(), b[2] );
+
+        EXPECT_DOUBLE_EQ( b[0], table( t, tk[k], dtk[k] ) );
+        EXPECT_DOUBLE_EQ( b[1], table.getDer1( t, tk[k], dtk[k] ) );
+        EXPECT_DOUBLE_EQ( b[2], table.getDer2( t, tk[k], dtk[k] ) );
+      }
+    }
+  }
+
+
+  TEST(Parametrics_Evaluators, BasisTable_erbsShape) {
+
+    const BasisTable<double>& table = ERBSEvaluator<double>::getTable();
+
+    // The same shared table every time
+    EXPECT_EQ( &table, &ERBSEvaluator<double>::getTable() );
+
+    EXPECT_NEAR( 0.0, table(0.0), 1e-12 );
+    EXPECT_NEAR( 1.0, table(1.0), 1e-12 );
+    EXPECT_NEAR( 0.0, table.getDer1(0.0), 1e-12 );
+    EXPECT_NEAR( 0.0, table.getDer1(1.0), 1e-12 );
+
+    // Symmetric about the midpoint
+    for( int i = 0; i <= 100; i++ ) {
+      const double t = i / 100.0;
+      EXPECT_NEAR( 1.0, table(t) + table(1.0-t), 1e-12 );
+      EXPECT_NEAR( table.getDer1(t), table.getDer1(1.0-t), 1e-9 );
+    }
+  }
+
+
+  TEST(Parametrics_Evaluators, BasisTable_threads) {
+
+    const BasisTable<long double>& table = ERBSEvaluator<long double>::getTable();
+
+    const int n = 4096;
+    std::vector<long double> ref( 3*n );
+    for( int i = 0; i < n; i++ )
+      table.eval( 1.0 + 2.0*i/n, 1.0, 2.0, 2, &ref[3*i] );
+
+    // All threads read the one table at the same time
+    const int nt = 4;
+    std::vector<std::vector<long double> > res( nt, std::vector<long double>( 3*n ) );
+    std::vector<std::thread> threads;
+    for( int k = 0; k < nt; k++ )
+      threads.emplace_back( [&table,&res,k,n]() {
+        for( int r = 0; r < 8; r++ )
+          for( int i = 0; i < n; i++ )
+            table.eval( 1.0 + 2.0*i/n, 1.0, 2.0, 2, &res[k][3*i] );
+      } );
+    for( auto& t : threads )
+      t.join();
+
+    for( int k = 0; k < nt; k++ )
+      for( int i = 0; i < 3*n; i++ )
+        EXPECT_EQ( ref[i], res[k][i] );
+  }
+
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include "../src/curves/gmpcircle.h"
+#include "../src/curves/gmpsubcurve.h"
+#include "../src/surfaces/gmptorus.h"
+#include "../src/surfaces/gmpsubsurf.h"
+using namespace GMlib;
+
+// stl
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+  // Exposes the protected resample
+  class Torus : public PTorus<float> {
+  public:
+    using PSurf<float,3>::resample;
+  };
+
+
+  // Evaluates an m x m grid of the surface with the reentrant evaluate
+  template <typename T>
+  std::vector<DMatrix<Vector<T,3> > > sampleSurf( const PSurf<T,3>& s, int m ) {
+
+    std::vector<DMatrix<Vector<T,3> > > r( m*m );
+    for( int i = 0; i < m; i++ )
+      for( int j = 0; j < m; j++ )
+        s.evaluate( s.getParStartU() + i * s.getParDeltaU() / m,
+                    s.getParStartV() + j * s.getParDeltaV() / m, 2, 2, r[i*m+j] );
+    return r;
+  }
+
+
+  TEST(Parametrics_Evaluation, PSurf_reentrantMatchesCached) {
+
+    PTorus<float> torus;
+    DMatrix<Vector<float,3> > p;
+
+    for( int k = 0; k < 5; k++ ) {
+      const float u = 0.3f + k, v = 1.1f * k;
+      torus.evaluate( u, v, 2, 2, p );
+      const DMatrix<Vector<float,3> >& q = torus.evaluate( u, v, 2, 2 );
+
+      ASSERT_EQ( q.getDim1(), p.getDim1() );
+      ASSERT_EQ( q.getDim2(), p.getDim2() );
+      for( int i = 0; i < p.getDim1(); i++ )
+        for( int j = 0; j < p.getDim2(); j++ )
+          EXPECT_EQ( q(i)(j), p(i)(j) );
+    }
+
+    // The reentrant call does not disturb the cached result
+    const Vector<float,3> c = torus.evaluate( 0.5f, 0.5f, 1, 1 )(0)(0);
+    torus.evaluate( 2.0f, 2.0f, 1, 1, p );
+    EXPECT_EQ( c, torus.evaluate( 0.5f, 0.5f, 1, 1 )(0)(0) );
+  }
+
+
+  TEST(Parametrics_Evaluation, PSurf_parallel) {
+
+    PTorus<float>   torus;
+    PSubSurf<float> sub( &torus, 0.5f, 2.0f, 0.5f, 2.0f );
+
+    const int m = 40;
+    const PSurf<float,3>* surfs[2] = { &torus, &sub };
+
+    for( const PSurf<float,3>* s : surfs ) {
+      const std::vector<DMatrix<Vector<float,3> > > ref = sampleSurf( *s, m );
+
+      // Threads on the same surface, the sub surface also evaluates the torus
+      std::vector<std::vector<DMatrix<Vector<float,3> > > > res(4);
+      std::vector<std::thread> threads;
+      for( size_t t = 0; t < res.size(); t++ )
+        threads.emplace_back( [&res,s,t]() { res[t] = sampleSurf( *s, m ); } );
+      for( auto& t : threads )
+        t.join();
+
+      for( const auto& r : res )
+        for( int k = 0; k < m*m; k++ )
+          for( int i = 0; i < 3; i++ )
+            for( int j = 0; j < 3; j++ )
+              ASSERT_EQ( ref[k](i)(j), r[k](i)(j) );
+    }
+  }
+
+
+  TEST(Parametrics_Evaluation, PCurve_parallel) {
+
+    PCircle<float>   circle( 2.0f );
+    PSubCurve<float> sub( &circle, 0.5f, 2.5f );
+
+    const int m = 500;
+    auto sample = [m]( const PCurve<float,3>& c, std::vector<DVector<Vector<float,3> > >& r ) {
+      r.resize( m );
+      for( int i = 0; i < m; i++ )
+        c.evaluate( c.getParStart() + i * c.getParDelta() / m, 2, r[i] );
+    };
+
+    const PCurve<float,3>* curves[2] = { &circle, &sub };
+    for( const PCurve<float,3>* c : curves ) {
+      std::vector<DVector<Vector<float,3> > > ref;
+      sample( *c, ref );
+      EXPECT_EQ( c->evaluate( c->getParStart(), 2 )[1], ref[0][1] );
+
+      std::vector<std::vector<DVector<Vector<float,3> > > > res(4);
+      std::vector<std::thread> threads;
+      for( size_t t = 0; t < res.size(); t++ )
+        threads.emplace_back( [&,t]() { sample( *c, res[t] ); } );
+      for( auto& t : threads )
+        t.join();
+
+      for( const auto& r : res )
+        for( int k = 0; k < m; k++ )
+          for( int i = 0; i < 3; i++ )
+            ASSERT_EQ( ref[k][i], r[k][i] );
+    }
+
+    // Curvature goes through the reentrant path as well
+    EXPECT_NEAR( 0.5f, circle.getCurvature( 1.0f ), 1e-5f );
+  }
+
+
+
+  TEST(Parametrics_Evaluation, PSurf_parallelResample) {
+
+    Torus torus;
+    for( int dd = 0; dd < 2; dd++ ) {
+      torus.setDerivationMethod( dd ? GM_DERIVATION_DD : GM_DERIVATION_EXPLICIT );
+
+      DMatrix<DMatrix<Vector<float,3> > > ref, res;
+      torus.setParallelResample( false );
+      torus.resample( ref, 45, 31, 1, 1, 0.0f, 0.0f, 6.0f, 6.2f );
+
+      // Tiles that do not divide the grid, and one tile per sample
+      const int tiles[3] = { 7, 32, 1 };
+      for( int b : tiles ) {
+        torus.setParallelResample( true, b );
+        EXPECT_TRUE( torus.isParallelResample() );
+        torus.resample( res, 45, 31, 1, 1, 0.0f, 0.0f, 6.0f, 6.2f );
+
+        ASSERT_EQ( 45, res.getDim1() );
+        ASSERT_EQ( 31, res.getDim2() );
+        for( int i = 0; i < 45; i++ )
+          for( int j = 0; j < 31; j++ )
+            for( int k = 0; k < 2; k++ )
+              for( int l = 0; l < 2; l++ )
+                ASSERT_EQ( ref[i][j][k][l], res[i][j][k][l] );
+      }
+    }
+  }
+
+}
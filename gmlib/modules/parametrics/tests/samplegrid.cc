@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#include "../src/gmpsamplegrid.h"
+#include "../src/surfaces/gmptorus.h"
+using namespace GMlib;
+
+// stl
+#include <cstdint>
+
+
+namespace {
+
+  // Exposes the protected resample functions
+  class Torus : public PTorus<float> {
+  public:
+    using PSurf<float,3>::resample;
+    using PSurf<float,3>::resampleNormals;
+  };
+
+
+  bool isAligned( const void* p ) {
+
+    return reinterpret_cast<std::uintptr_t>(p) % 64 == 0;
+  }
+
+
+  TEST(Parametrics_SampleGrid, PSampleGrid_layouts) {
+
+    const PSampleGrid<float,3>::LAYOUT layouts[2] = { PSampleGrid<float,3>::LAYOUT_AOS,
+                                                      PSampleGrid<float,3>::LAYOUT_SOA };
+    for( auto layout : layouts ) {
+
+      PSampleGrid<float,3> g( layout );
+      g.setDim( 5, 7, 2, 1 );
+      ASSERT_EQ( 5, g.getDim1() );
+      ASSERT_EQ( 7, g.getDim2() );
+      ASSERT_EQ( 2, g.getDerivativesU() );
+      ASSERT_EQ( 1, g.getDerivativesV() );
+      EXPECT_TRUE( isAligned( g.getPtr() ) );
+
+      for( int i = 0; i < 5; i++ )
+        for( int j = 0; j < 7; j++ )
+          for( int k = 0; k < 3; k++ )
+            for( int l = 0; l < 2; l++ )
+              g(i,j,k,l) = Vector<float,3>( float(i), float(j), float(10*k+l) );
+
+      // All the ways to address an element agree
+      const PSampleGrid<float,3>& c = g;
+      for( int i = 0; i < 5; i++ )
+        for( int j = 0; j < 7; j++ )
+          for( int k = 0; k < 3; k++ )
+            for( int l = 0; l < 2; l++ ) {
+              const Vector<float,3>* e = &g(i,j,k,l);
+              EXPECT_EQ( e, &g[i][j][k][l] );
+              EXPECT_EQ( e, &c(i)(j)(k)(l) );
+              EXPECT_EQ( e, g.getPlane(k,l) + i*g.getStride(0) + j*g.getStride(1) );
+              EXPECT_EQ( e, g.getSample(i,j) + k*g.getStride(2) + l*g.getStride(3) );
+              EXPECT_EQ( ( Vector<float,3>( float(i), float(j), float(10*k+l) ) ), *e );
+            }
+
+      if( layout == PSampleGrid<float,3>::LAYOUT_AOS ) {
+        // The derivatives of a sample are contiguous
+        EXPECT_EQ( 1, g.getStride(3) );
+        EXPECT_EQ( 2, g.getStride(2) );
+        EXPECT_EQ( 6, g.getStride(1) );
+      }
+      else {
+        // Each derivative is a contiguous row major plane on a cache line
+        EXPECT_EQ( 1, g.getStride(1) );
+        EXPECT_EQ( 7, g.getStride(0) );
+        for( int k = 0; k < 3; k++ )
+          for( int l = 0; l < 2; l++ )
+            EXPECT_TRUE( isAligned( g.getPlane(k,l) ) );
+      }
+
+      // Round trip through the nested matrix form
+      DMatrix< DMatrix< Vector<float,3> > > m;
+      g.toDMatrix( m );
+      ASSERT_EQ( 5, m.getDim1() );
+      ASSERT_EQ( 7, m.getDim2() );
+      PSampleGrid<float,3> h( layout );
+      h.setDim( 5, 7, 2, 1 );
+      for( int i = 0; i < 5; i++ )
+        for( int j = 0; j < 7; j++ ) {
+          ASSERT_EQ( 3, m[i][j].getDim1() );
+          ASSERT_EQ( 2, m[i][j].getDim2() );
+          h[i][j] = m[i][j];
+        }
+      for( int i = 0; i < 5; i++ )
+        for( int j = 0; j < 7; j++ )
+          for( int k = 0; k < 3; k++ )
+            for( int l = 0; l < 2; l++ )
+              EXPECT_EQ( g(i,j,k,l), h(i,j,k,l) );
+
+      PSampleGrid<float,3> copy( g );
+      EXPECT_EQ( g.getLayout(), copy.getLayout() );
+      EXPECT_EQ( g(4,6,2,1), copy(4,6,2,1) );
+    }
+  }
+
+
+  TEST(Parametrics_SampleGrid, PSampleGrid_keepsAllocation) {
+
+    PSampleGrid<float,3> g( PSampleGrid<float,3>::LAYOUT_SOA );
+    g.setDim( 100, 80, 1, 1 );
+    const Vector<float,3>* p = g.getPtr();
+
+    // Shrinking and growing back within the first size does not allocate
+    g.setDim( 40, 40, 1, 1 );
+    EXPECT_EQ( p, g.getPtr() );
+    g.setDim( 80, 100, 0, 0 );
+    EXPECT_EQ( p, g.getPtr() );
+    g.setLayout( PSampleGrid<float,3>::LAYOUT_AOS );
+    g.setDim( 100, 80, 1, 1 );
+    EXPECT_EQ( p, g.getPtr() );
+
+    g.setDim( 200, 200, 1, 1 );
+    EXPECT_TRUE( isAligned( g.getPtr() ) );
+    EXPECT_GE( g.getSize(), size_t(200*200*4) );
+  }
+
+
+  TEST(Parametrics_SampleGrid, PSurf_resampleGrid) {
+
+    Torus torus;
+    for( int dd = 0; dd < 2; dd++ ) {
+      torus.setDerivationMethod( dd ? GM_DERIVATION_DD : GM_DERIVATION_EXPLICIT );
+
+      for( int par = 0; par < 2; par++ ) {
+        torus.setParallelResample( par == 1, 8 );
+
+        DMatrix< DMatrix< Vector<float,3> > > ref;
+        DMatrix< Vector<float,3> >            ref_n;
+        torus.resample( ref, 33, 21, 1, 2, 0.0f, 0.0f, 6.0f, 6.2f );
+        torus.resampleNormals( ref, ref_n );
+
+        const PSampleGrid<float,3>::LAYOUT layouts[2] = { PSampleGrid<float,3>::LAYOUT_AOS,
+                                                          PSampleGrid<float,3>::LAYOUT_SOA };
+        for( auto layout : layouts ) {
+
+          PSampleGrid<float,3> p( layout ), n( layout );
+          torus.resample( p, 33, 21, 1, 2, 0.0f, 0.0f, 6.0f, 6.2f );
+          torus.resampleNormals( p, n );
+
+          ASSERT_EQ( 33, p.getDim1() );
+          ASSERT_EQ( 21, p.getDim2() );
+          ASSERT_EQ( 1, p.getDerivativesU() );
+          ASSERT_EQ( 2, p.getDerivativesV() );
+          for( int i = 0; i < 33; i++ )
+            for( int j = 0; j < 21; j++ ) {
+              for( int k = 0; k < 2; k++ )
+                for( int l = 0; l < 3; l++ )
+                  ASSERT_EQ( ref[i][j][k][l], p(i,j,k,l) );
+              ASSERT_EQ( ref_n[i][j], n(i,j) );
+            }
+        }
+      }
+    }
+  }
+
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+
+#include "../src/surfaces/gmpbeziersurf.h"
+#include "../src/surfaces/gmpbsplinesurf.h"
+using namespace GMlib;
+
+
+namespace {
+
+  // Keeps the samples a surface hands to its visualizers on replot
+  class SampleVisualizer : public PSurfVisualizer<float,3> {
+  public:
+    GM_VISUALIZER(SampleVisualizer)
+  public:
+    using PSurfVisualizer<float,3>::replot;
+
+    void replot( const PSampleGrid<float,3>& p, const PSampleGrid<float,3>& /*normals*/,
+                 int /*m1*/, int /*m2*/, int /*d1*/, int /*d2*/, bool /*closed_u*/, bool /*closed_v*/ ) override {
+      samples = p;
+    }
+
+    void replot( const DMatrix< DMatrix< Vector<float,3> > >& p, const DMatrix< Vector<float,3> >& /*normals*/,
+                 int /*m1*/, int /*m2*/, int /*d1*/, int /*d2*/, bool /*closed_u*/, bool /*closed_v*/ ) override {
+      matrix = p;
+    }
+
+    PSampleGrid<float,3>                samples;
+    DMatrix< DMatrix< Vector<float,3> > > matrix;
+  };
+
+
+  // Calls the nested matrix resample() of a surface, which PSurf keeps protected
+  class Resampler : public PSurf<float,3> {
+  public:
+    typedef void (PSurf<float,3>::*Resample)( DMatrix< DMatrix< Vector<float,3> > >&, int, int, int, int,
+                                               float, float, float, float );
+
+    static void call( PSurf<float,3>& surf, DMatrix< DMatrix< Vector<float,3> > >& p, int m1, int m2, int d1, int d2 ) {
+
+      const Resample r = &Resampler::resample;
+      (surf.*r)( p, m1, m2, d1, d2, surf.getParStartU(), surf.getParStartV(),
+                 surf.getParStartU() + surf.getParDeltaU(), surf.getParStartV() + surf.getParDeltaV() );
+    }
+  };
+
+
+  // A B-spline surface whose partition visualization keeps the samples of each patch
+  class PartitionedSurf : public PBSplineSurf<float> {
+  public:
+    PartitionedSurf( const DMatrix< Vector<float,3> >& c, const DVector<float>& u, const DVector<float>& v, int du, int dv )
+      : PBSplineSurf<float>( c, u, v, du, dv ) {}
+
+    ~PartitionedSurf() {
+      for( int i = 0; i < _patches.getSize(); i++ ) {
+        removeVisualizer( _patches[i] );
+        delete _patches[i];
+      }
+    }
+
+    int                     getNoPatchesU() const     { return _visu.getDim1(); }
+    int                     getNoPatchesV() const     { return _visu.getDim2(); }
+    const SampleVisualizer& getPatch( int i, int j )  { return *_patches[i*_visu.getDim2() + j]; }
+    Vector<float,2>         getPatchU( int i ) const  { return _visu(i)(0).s_u; }
+    Vector<float,2>         getPatchV( int j ) const  { return _visu(0)(j).s_v; }
+
+  protected:
+    PSurfVisualizer<float,3>* makePartitionVisualizer() override {
+      _patches += new SampleVisualizer;
+      return _patches.back();
+    }
+
+  private:
+    Array<SampleVisualizer*>  _patches;
+  };
+
+
+  DMatrix< Vector<float,3> > makeControlPoints( int n1, int n2 ) {
+
+    DMatrix< Vector<float,3> > c( n1, n2 );
+    for( int i = 0; i < n1; i++ )
+      for( int j = 0; j < n2; j++ )
+        c[i][j] = Vector<float,3>( float(i), float(j), std::sin( 0.7f*i ) * std::cos( 1.3f*j ) + 0.1f*i*j );
+    return c;
+  }
+
+
+  DVector<float> makeKnots( int n, int d ) {
+
+    // Clamped, uniform inside
+    DVector<float> t( n+d+1 );
+    for( int i = 0; i < t.getDim(); i++ )
+      t[i] = float( std::min( std::max( i-d, 0 ), n-d ) );
+    return t;
+  }
+
+
+  // Samples of an m1 x m2 grid over [u(0),u(1)] x [v(0),v(1)] against the
+  // surface evaluated one point at a time. Derivatives across a parameter
+  // in jump are not compared on it.
+  template <typename F>
+  void expectEvaluate( PSurf<float,3>& surf, F sample, int m1, int m2, int d1, int d2,
+                       const Vector<float,2>& u, const Vector<float,2>& v, float jump_u = -1.0f, float jump_v = -1.0f ) {
+
+    DMatrix< Vector<float,3> > q;
+    for( int i = 0; i < m1; i++ )
+      for( int j = 0; j < m2; j++ ) {
+        const float pu = u(0) + i * ( u(1) - u(0) ) / (m1-1);
+        const float pv = v(0) + j * ( v(1) - v(0) ) / (m2-1);
+        surf.evaluate( pu, pv, d1, d2, q );
+        for( int k = 0; k <= d1; k++ )
+          for( int l = 0; l <= d2; l++ ) {
+            if( ( k > 0 && pu == jump_u ) || ( l > 0 && pv == jump_v ) ) continue;
+            for( int c = 0; c < 3; c++ )
+              ASSERT_NEAR( q[k][l][c], sample( i, j, k, l )[c], 1e-3f * ( 1 + std::abs( q[k][l][c] ) ) )
+                << "sample " << i << "," << j << " derivative " << k << "," << l;
+          }
+      }
+  }
+
+
+  Vector<float,2> domainU( const PSurf<float,3>& surf ) {
+    return Vector<float,2>( surf.getParStartU(), surf.getParStartU() + surf.getParDeltaU() );
+  }
+
+
+  Vector<float,2> domainV( const PSurf<float,3>& surf ) {
+    return Vector<float,2>( surf.getParStartV(), surf.getParStartV() + surf.getParDeltaV() );
+  }
+
+
+  // The nested matrix resample(), on a fresh and on a reused grid
+  void compareMatrixToEvaluate( PSurf<float,3>& surf ) {
+
+    DMatrix< DMatrix< Vector<float,3> > > p;
+    const int dims[][4] = { { 7, 5, 1, 1 }, { 3, 9, 2, 1 }, { 7, 5, 0, 0 }, { 12, 6, 1, 2 } };
+    for( int t = 0; t < 4; t++ ) {
+      const int m1 = dims[t][0], m2 = dims[t][1], d1 = dims[t][2], d2 = dims[t][3];
+      Resampler::call( surf, p, m1, m2, d1, d2 );
+      ASSERT_EQ( m1, p.getDim1() );
+      ASSERT_EQ( m2, p.getDim2() );
+      expectEvaluate( surf, [&p]( int i, int j, int k, int l ) { return p[i][j][k][l]; },
+                      m1, m2, d1, d2, domainU( surf ), domainV( surf ) );
+    }
+  }
+
+
+  // The replot samples against the surface evaluated one point at a time
+  void compareToEvaluate( PSurf<float,3>& surf, int m1, int m2, int d1, int d2 ) {
+
+    SampleVisualizer visu;
+    surf.insertVisualizer( &visu );
+
+    for( int par = 0; par < 2; par++ ) {
+      surf.setParallelResample( par == 1, 4 );
+      surf.replot( m1, m2, d1, d2 );
+
+      const PSampleGrid<float,3>& p = visu.samples;
+      ASSERT_EQ( m1, p.getDim1() );
+      ASSERT_EQ( m2, p.getDim2() );
+      ASSERT_EQ( d1, p.getDerivativesU() );
+      ASSERT_EQ( d2, p.getDerivativesV() );
+
+      expectEvaluate( surf, [&p]( int i, int j, int k, int l ) { return p(i,j,k,l); },
+                      m1, m2, d1, d2, domainU( surf ), domainV( surf ) );
+    }
+
+    surf.removeVisualizer( &visu );
+  }
+
+
+  TEST(Parametrics_TensorProduct, PBezierSurf_resample) {
+
+    PBezierSurf<float> surf( makeControlPoints( 4, 3 ) );
+    compareToEvaluate( surf, 17, 9, 2, 1 );
+
+    // Derivatives above the degree are zero
+    compareToEvaluate( surf, 5, 12, 1, 2 );
+  }
+
+
+  TEST(Parametrics_TensorProduct, PBSplineSurf_resample) {
+
+    PBSplineSurf<float> surf( makeControlPoints( 7, 5 ), makeKnots( 7, 3 ), makeKnots( 5, 2 ), 3, 2 );
+    compareToEvaluate( surf, 23, 11, 2, 1 );
+
+    // The second derivative of the quadratic direction jumps at the knots,
+    // 32 samples do not hit them
+    compareToEvaluate( surf, 6, 32, 1, 2 );
+  }
+
+
+  TEST(Parametrics_TensorProduct, PBezierSurf_resampleMatrix) {
+
+    PBezierSurf<float> surf( makeControlPoints( 4, 3 ) );
+    compareMatrixToEvaluate( surf );
+  }
+
+
+  TEST(Parametrics_TensorProduct, PBSplineSurf_resampleMatrix) {
+
+    PBSplineSurf<float> surf( makeControlPoints( 7, 5 ), makeKnots( 7, 3 ), makeKnots( 5, 2 ), 3, 2 );
+    compareMatrixToEvaluate( surf );
+  }
+
+
+  TEST(Parametrics_TensorProduct, PBSplineSurf_partitionReplot) {
+
+    // Only C0 at u = 2 and v = 1, so both directions are split in two
+    DVector<float> u( 12 ), v( 8 );
+    const float ku[] = { 0,0,0,0, 1, 2,2,2, 3,3,3,3 };
+    const float kv[] = { 0,0,0, 1,1, 2,2,2 };
+    for( int i = 0; i < 12; i++ ) u[i] = ku[i];
+    for( int i = 0; i < 8; i++ )  v[i] = kv[i];
+
+    PartitionedSurf surf( makeControlPoints( 8, 5 ), u, v, 3, 2 );
+    surf.enablePartitionVisualizer( 1, 1 );
+
+    const int d[][2] = { { 1, 1 }, { 2, 1 }, { 1, 2 } };
+    for( int t = 0; t < 3; t++ ) {
+      surf.replot( 20, 12, d[t][0], d[t][1] );
+      ASSERT_EQ( 2, surf.getNoPatchesU() );
+      ASSERT_EQ( 2, surf.getNoPatchesV() );
+
+      for( int i = 0; i < 2; i++ )
+        for( int j = 0; j < 2; j++ ) {
+          const DMatrix< DMatrix< Vector<float,3> > >& p = surf.getPatch( i, j ).matrix;
+          ASSERT_GT( p.getDim1(), 1 );
+          ASSERT_GT( p.getDim2(), 1 );
+          ASSERT_EQ( d[t][0]+1, p(0)(0).getDim1() );
+          ASSERT_EQ( d[t][1]+1, p(0)(0).getDim2() );
+          expectEvaluate( surf, [&p]( int a, int b, int k, int l ) { return p(a)(b)(k)(l); },
+                          p.getDim1(), p.getDim2(), d[t][0], d[t][1],
+                          surf.getPatchU( i ), surf.getPatchV( j ), 2.0f, 1.0f );
+        }
+    }
+  }
+
+}
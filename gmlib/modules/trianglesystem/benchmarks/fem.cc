@@ -0,0 +1,396 @@
+#include <benchmark/benchmark.h>
+
+#include "../src/gmmeshgenerator.h"
+#include "../src/gmtrianglesystem.h"
+#include "../src/visualizers/gmtrianglefacetsdefaultvisualizer.h"
+#include <core/containers/gmsparseassembler.h>
+#include <core/fem/gmtrianglekernels.h>
+#include <core/solvers/gmsparsecholesky.h>
+using namespace GMlib;
+
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <string>
+
+/*!
+ * \brief BM_Fem
+ * The stages of the FEM membrane, as FEMObject runs them, on a disk meshed
+ * with about range(0) triangles: mesh generation, Delaunay triangulation,
+ * assembly, factorization, solve, the per-frame height update and the
+ * vertex buffer fill of the dynamic visualizer. No OpenGL context is
+ * needed.
+ *
+ * The compact TriangleMesh is measured against the vertex, edge and
+ * triangle objects: the cost of making it, the bytes per vertex of both
+ * (B_per_vertex, objects_B_per_vertex) and one pass over all one-rings (a
+ * Laplacian of the heights) through the pointers and through the index
+ * arrays.
+ *
+ * Besides the time, each stage reports the peak resident memory while it
+ * ran (peak_MB) and how much of it the stage itself added (stage_MB).
+ */
+
+
+namespace {
+
+  // Resident memory from /proc (Linux), 0 elsewhere
+  double memoryMB( const char* key ) {
+
+    std::ifstream status( "/proc/self/status" );
+    std::string   line;
+    while( std::getline( status, line ) )
+      if( line.compare( 0, std::string(key).size(), key ) == 0 )
+        return std::stod( line.substr( std::string(key).size() ) ) / 1024.0;
+    return 0.0;
+  }
+
+
+  // Peak memory is measured from here
+  double resetPeak() {
+
+    std::ofstream( "/proc/self/clear_refs" ) << "5";
+    return memoryMB( "VmRSS:" );
+  }
+
+
+  void reportMemory( benchmark::State& state, double base ) {
+
+    const double peak = std::max( memoryMB( "VmHWM:" ), base );
+    state.counters["peak_MB"]  = peak;
+    state.counters["stage_MB"] = peak - base;
+  }
+
+
+  // Unit disk meshed with about nt triangles, as FEMObject::makeRandom()
+  void generate( MeshGenerator<float>& mesh, int nt ) {
+
+    const double s = std::sqrt( 4*M_PI / ( std::sqrt(3.0) * nt ) );
+    const int    k = int( 2*M_PI / s );
+
+    DVector< Point<float,2> > circle( k );
+    for( int i = 0; i < k; i++ )
+      circle[i] = Point<float,2>( std::cos( 2*M_PI*i/k ), std::sin( 2*M_PI*i/k ) );
+
+    mesh.setBoundary( circle );
+    mesh.setSpacing( float( 0.85*s ) );
+    mesh.generate();
+  }
+
+
+  void insertVertices( const MeshGenerator<float>& mesh, TriangleFacets<float>& tf ) {
+
+    const DVector< Point<float,2> >& p = mesh.getPoints();
+    const DVector<bool>&             b = mesh.getBoundaryFlags();
+    tf.setMaxSize( p.getDim() + 3 );
+    for( int i = 0; i < p.getDim(); i++ ) {
+      Point<float,2> q = p(i);
+      if( b(i) ) q /= q.getLength();
+      tf.insertAlways( TSVertex<float>( q ) );
+    }
+  }
+
+
+  // The data of the stages, each fixture builds it up to the stage it needs
+  struct Membrane {
+
+    MeshGenerator<float>             mesh;
+    TriangleFacets<float>            tf;
+    DVector<int>                     node;       // Node of each vertex, -1 on the boundary
+    DVector<TSVertex<float>*>        vertex;     // Vertex of each node
+    DVector<int>                     tri;        // Vertex indices of the triangles
+    SparseAssembler<float>           assembler;
+    SparseCholesky<float>            solver;
+    DVector<float>                   x0;         // Response to the unit load
+
+    Membrane() : assembler(3) {}
+
+    void triangulate() {
+      insertVertices( mesh, tf );
+      tf.triangulateDelaunay();
+      tf.getTriangleIndices( tri );
+    }
+
+    void assemble() {
+
+      const int n  = tf.getSize();
+      const int nt = tri.getDim() / 3;
+
+      node.setDim( n );
+      int nn = 0;
+      for( int i = 0; i < n; i++ ) node[i] = tf.getVertex(i)->boundary() ? -1 : nn++;
+      vertex.setDim( nn );
+      for( int i = 0; i < n; i++ ) if( node[i] >= 0 ) vertex[node[i]] = tf.getVertex(i);
+
+      DVector<int>   elem( 3*nt );
+      DVector<float> xy( 6*nt );
+      for( int t = 0; t < nt; t++ )
+        for( int i = 0; i < 3; i++ ) {
+          const int v = tri[3*t+i];
+          const Point<float,2> p = tf.getVertex(v)->getParameter();
+          elem[3*t+i]        = node[v];
+          xy[(2*i)*nt+t]     = p[0];
+          xy[(2*i+1)*nt+t]   = p[1];
+        }
+
+      assembler.setElements( nn, elem );
+      linearTriangleElements( nt, xy.getPtr(), assembler.getElementMatrix(0), assembler.getElementVector(0) );
+      assembler.assemble();
+    }
+  };
+
+
+  std::unique_ptr<Membrane> makeMembrane( int nt, int stage ) {
+
+    std::unique_ptr<Membrane> m( new Membrane );
+    generate( m->mesh, nt );
+    if( stage > 0 ) m->triangulate();
+    if( stage > 1 ) m->assemble();
+    if( stage > 2 ) m->solver.factorize( m->assembler.getMatrix() );
+    if( stage > 3 ) m->solver.solve( m->assembler.getVector(), m->x0 );
+    return m;
+  }
+
+}
+
+
+static void BM_Fem_meshGenerator(benchmark::State& state)
+{
+  const double base = resetPeak();
+
+  // The test loop
+  while (state.KeepRunning()) {
+    MeshGenerator<float> mesh;
+    generate( mesh, int(state.range(0)) );
+    benchmark::DoNotOptimize( mesh.getNoTriangles() );
+  }
+  reportMemory( state, base );
+  state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+BENCHMARK(BM_Fem_meshGenerator)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+static void BM_Fem_delaunay(benchmark::State& state)
+{
+  // Setup
+  std::unique_ptr<Membrane> m = makeMembrane( int(state.range(0)), 0 );
+  const double base = resetPeak();
+
+  // The test loop, vertices are inserted into an empty mesh and triangulated
+  while (state.KeepRunning()) {
+    m->tf.clear();
+    insertVertices( m->mesh, m->tf );
+    m->tf.triangulateDelaunay();
+  }
+  reportMemory( state, base );
+  state.SetItemsProcessed( state.iterations() * m->tf.getNoTriangles() );
+}
+BENCHMARK(BM_Fem_delaunay)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+static void BM_Fem_assemble(benchmark::State& state)
+{
+  // Setup
+  std::unique_ptr<Membrane> m = makeMembrane( int(state.range(0)), 1 );
+  const double base = resetPeak();
+
+  // The test loop, pattern, element matrices and the sum
+  while (state.KeepRunning()) {
+    m->assembler = SparseAssembler<float>(3);
+    m->assemble();
+  }
+  reportMemory( state, base );
+  state.SetItemsProcessed( state.iterations() * m->assembler.getNoElements() );
+}
+BENCHMARK(BM_Fem_assemble)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+static void BM_Fem_factorize(benchmark::State& state)
+{
+  // Setup
+  std::unique_ptr<Membrane> m = makeMembrane( int(state.range(0)), 2 );
+  const double base = resetPeak();
+
+  // The test loop
+  while (state.KeepRunning()) {
+    SparseCholesky<float> solver;
+    solver.factorize( m->assembler.getMatrix() );
+  }
+  reportMemory( state, base );
+  state.SetItemsProcessed( state.iterations() * m->assembler.getMatrix().getDim() );
+}
+BENCHMARK(BM_Fem_factorize)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+static void BM_Fem_solve(benchmark::State& state)
+{
+  // Setup
+  std::unique_ptr<Membrane> m = makeMembrane( int(state.range(0)), 3 );
+  DVector<float> x;
+  const double base = resetPeak();
+
+  // The test loop
+  while (state.KeepRunning()) {
+    m->solver.solve( m->assembler.getVector(), x );
+    benchmark::DoNotOptimize( x.getPtr() );
+  }
+  reportMemory( state, base );
+  state.SetItemsProcessed( state.iterations() * x.getDim() );
+}
+BENCHMARK(BM_Fem_solve)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+static void BM_Fem_frame(benchmark::State& state)
+{
+  // Setup
+  std::unique_ptr<Membrane> m = makeMembrane( int(state.range(0)), 4 );
+  const int n = m->vertex.getDim();
+  float     a = 0.0f;
+  const double base = resetPeak();
+
+  // The test loop, the precomputed response scaled by the load factor
+  while (state.KeepRunning()) {
+    a += 0.01f;
+    for (int i = 0; i < n; ++i) m->vertex[i]->setZ( a * m->x0[i] );
+  }
+  reportMemory( state, base );
+  state.SetItemsProcessed( state.iterations() * n );
+}
+BENCHMARK(BM_Fem_frame)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+static void BM_Fem_visualizerFill(benchmark::State& state)
+{
+  // Setup
+  std::unique_ptr<Membrane> m = makeMembrane( int(state.range(0)), 4 );
+  const int n = m->tf.getSize();
+
+  DVector<TSVertex<float>*>   vertex( n );
+  for (int i = 0; i < n; ++i) vertex[i] = m->tf.getVertex(i);
+  DVector<float>              pos( 3*n ), nor( 3*n );
+  DVector<GL::GLVertexNormal> buffer( n );
+  const double base = resetPeak();
+
+  // The test loop
+  while (state.KeepRunning()) {
+    TriangleFacetsDefaultVisualizer<float>::fillDynamic( vertex, m->tri, pos.getPtr(), nor.getPtr(), buffer.getPtr() );
+    benchmark::DoNotOptimize( buffer.getPtr() );
+  }
+  reportMemory( state, base );
+  state.SetItemsProcessed( state.iterations() * n );
+}
+BENCHMARK(BM_Fem_visualizerFill)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+static void BM_Fem_compactMesh(benchmark::State& state)
+{
+  // Setup
+  std::unique_ptr<Membrane> m = makeMembrane( int(state.range(0)), 1 );
+  TriangleMesh<float> mesh;
+  const double base = resetPeak();
+
+  // The test loop
+  while (state.KeepRunning()) {
+    m->tf.getMesh( mesh );
+    benchmark::DoNotOptimize( mesh.getTriangles().getPtr() );
+  }
+  reportMemory( state, base );
+
+  // The objects and the pointers to them, without allocator overhead
+  const int n = m->tf.getSize();
+  double objects = double(n) * sizeof(TSVertex<float>)
+                 + double(m->tf.getNoEdges()) * ( sizeof(TSEdge<float>) + 3*sizeof(void*) )
+                 + double(m->tf.getNoTriangles()) * ( sizeof(TSTriangle<float>) + sizeof(void*) );
+
+  state.counters["B_per_vertex"]         = double(mesh.getSize()) / n;
+  state.counters["objects_B_per_vertex"] = objects / n;
+  state.SetItemsProcessed( state.iterations() * n );
+}
+BENCHMARK(BM_Fem_compactMesh)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+static void BM_Fem_ringObjects(benchmark::State& state)
+{
+  // Setup
+  std::unique_ptr<Membrane> m = makeMembrane( int(state.range(0)), 1 );
+  const int n = m->tf.getSize();
+  DVector<float> lz( n );
+
+  // The test loop, neighbours through the edges of each vertex
+  while (state.KeepRunning()) {
+    for (int i = 0; i < n; ++i) {
+      TSVertex<float>*          v = m->tf.getVertex(i);
+      ArrayT<TSEdge<float>*>&   e = v->getEdges();
+      float s = 0.0f;
+      for (int k = 0; k < e.getSize(); ++k) {
+        TSVertex<float>* w = e[k]->getFirstVertex() == v ? e[k]->getLastVertex() : e[k]->getFirstVertex();
+        s += w->getPos()[2] - v->getPos()[2];
+      }
+      lz[i] = s;
+    }
+    benchmark::DoNotOptimize( lz.getPtr() );
+  }
+  state.SetItemsProcessed( state.iterations() * n );
+}
+BENCHMARK(BM_Fem_ringObjects)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+static void BM_Fem_ringCompact(benchmark::State& state)
+{
+  // Setup
+  std::unique_ptr<Membrane> m = makeMembrane( int(state.range(0)), 1 );
+  TriangleMesh<float> mesh;
+  m->tf.getMesh( mesh );
+  DVector<int> row, col;
+  mesh.getVertexAdjacency( row, col );
+
+  const int n = mesh.getNoVertices();
+  const Point<float,3>* p = mesh.getPositions().getPtr();
+  DVector<float> lz( n );
+
+  // The test loop, neighbours from the adjacency arrays
+  while (state.KeepRunning()) {
+    for (int i = 0; i < n; ++i) {
+      float s = 0.0f;
+      for (int k = row[i]; k < row[i+1]; ++k)
+        s += p[col[k]][2] - p[i][2];
+      lz[i] = s;
+    }
+    benchmark::DoNotOptimize( lz.getPtr() );
+  }
+  state.SetItemsProcessed( state.iterations() * n );
+}
+BENCHMARK(BM_Fem_ringCompact)
+  ->Unit(benchmark::kMillisecond)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000);
+
+
+BENCHMARK_MAIN();
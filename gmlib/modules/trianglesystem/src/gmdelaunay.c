@@ -0,0 +1,1100 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+
+namespace GMlib {
+
+
+  namespace Private {
+
+    /*! \brief Exact floating point expansions for the Delaunay predicates
+     *
+     *  A value is kept as a sum of doubles of increasing magnitude that do
+     *  not overlap (Shewchuk, Adaptive precision floating-point arithmetic
+     *  and fast robust geometric predicates, 1997). Zero components are
+     *  dropped, so zero is the empty expansion and the sign of any other is
+     *  the sign of its last component. Only used when the rounded predicate
+     *  is too close to zero to be trusted.
+     */
+    namespace Expansion {
+
+      inline void fastTwoSum( double a, double b, double& x, double& y ) {
+
+        x = a + b;
+        y = b - ( x - a );
+      }
+
+
+      inline void twoSum( double a, double b, double& x, double& y ) {
+
+        x = a + b;
+        const double bv = x - a;
+        const double av = x - bv;
+        y = ( a - av ) + ( b - bv );
+      }
+
+
+      inline void twoDiff( double a, double b, double& x, double& y ) {
+
+        x = a - b;
+        const double bv = a - x;
+        const double av = x + bv;
+        y = ( a - av ) + ( bv - b );
+      }
+
+
+      inline void split( double a, double& hi, double& lo ) {
+
+        const double c = 134217729.0 * a;   // 2^27 + 1
+        hi = c - ( c - a );
+        lo = a - hi;
+      }
+
+
+      inline void twoProduct( double a, double b, double& x, double& y ) {
+
+        x = a * b;
+        double ahi, alo, bhi, blo;
+        split( a, ahi, alo );
+        split( b, bhi, blo );
+        y = alo * blo - ( ( ( x - ahi * bhi ) - alo * bhi ) - ahi * blo );
+      }
+
+
+      // e = a - b
+      inline void diff( double a, double b, std::vector<double>& e ) {
+
+        double x, y;
+        twoDiff( a, b, x, y );
+        e.clear();
+        if( y != 0.0 ) e.push_back( y );
+        if( x != 0.0 ) e.push_back( x );
+      }
+
+
+      // h = e + f
+      inline void sum( const std::vector<double>& e, const std::vector<double>& f, std::vector<double>& h ) {
+
+        std::vector<double> g( e.size() + f.size() );
+        std::merge( e.begin(), e.end(), f.begin(), f.end(), g.begin(),
+                    []( double a, double b ) { return std::abs( a ) < std::abs( b ); } );
+
+        h.clear();
+        if( g.empty() ) return;
+
+        double q = g[0], x, y;
+        for( size_t i = 1; i < g.size(); i++ ) {
+          twoSum( q, g[i], x, y );
+          if( y != 0.0 ) h.push_back( y );
+          q = x;
+        }
+        if( q != 0.0 ) h.push_back( q );
+      }
+
+
+      // h = e * b
+      inline void scale( const std::vector<double>& e, double b, std::vector<double>& h ) {
+
+        h.clear();
+        if( e.empty() || b == 0.0 ) return;
+
+        double q, x, y, p1, p0;
+        twoProduct( e[0], b, q, y );
+        if( y != 0.0 ) h.push_back( y );
+        for( size_t i = 1; i < e.size(); i++ ) {
+          twoProduct( e[i], b, p1, p0 );
+          twoSum( q, p0, x, y );
+          if( y != 0.0 ) h.push_back( y );
+          fastTwoSum( p1, x, q, y );
+          if( y != 0.0 ) h.push_back( y );
+        }
+        if( q != 0.0 ) h.push_back( q );
+      }
+
+
+      // h = e * f
+      inline void product( const std::vector<double>& e, const std::vector<double>& f, std::vector<double>& h ) {
+
+        std::vector<double> s, t;
+        h.clear();
+        for( size_t i = 0; i < f.size(); i++ ) {
+          scale( e, f[i], s );
+          sum( h, s, t );
+          h.swap( t );
+        }
+      }
+
+
+      // h = a*d - b*c
+      inline void cross( const std::vector<double>& a, const std::vector<double>& b,
+                         const std::vector<double>& c, const std::vector<double>& d,
+                         std::vector<double>& h ) {
+
+        std::vector<double> ad, bc;
+        product( a, d, ad );
+        product( b, c, bc );
+        for( size_t i = 0; i < bc.size(); i++ ) bc[i] = -bc[i];
+        sum( ad, bc, h );
+      }
+
+
+      inline double sign( const std::vector<double>& e ) {
+
+        return e.empty() ? 0.0 : e.back();
+      }
+
+    } // END namespace Expansion
+
+  } // END namespace Private
+
+
+  template <typename T>
+  inline
+  Delaunay<T>::Delaunay() : _last(0), _dirty(false) {}
+
+
+  template <typename T>
+  inline
+  int Delaunay<T>::getNoPoints() const {
+
+    return int(_x.size());
+  }
+
+
+  template <typename T>
+  inline
+  int Delaunay<T>::getNoTriangles() const {
+
+    _sync();
+    return _tri.getDim() / 3;
+  }
+
+
+  /*! \brief The opposite half-edge of each half-edge, -1 on the boundary */
+  template <typename T>
+  inline
+  const DVector<int>& Delaunay<T>::getNeighbours() const {
+
+    _sync();
+    return _nbr;
+  }
+
+
+  /*! \brief Three vertex indices per triangle, counter-clockwise */
+  template <typename T>
+  inline
+  const DVector<int>& Delaunay<T>::getTriangles() const {
+
+    _sync();
+    return _tri;
+  }
+
+
+  /*! \brief The vertex half-edge h starts at
+   *
+   *  Reads the working arrays, so it is up to date after insert() without
+   *  copying the result.
+   */
+  template <typename T>
+  inline
+  int Delaunay<T>::getVertex( int h ) const {
+
+    return _v[h];
+  }
+
+
+  /*! \brief Insert one more point into the triangulation
+   *
+   *  The point must lie inside the convex hull of the triangulated points,
+   *  or on its boundary. Triangles keep their index, new ones are appended.
+   *
+   *  \param[in] p  The point
+   *  \return The index of the new point, of the point it coincides with, or
+   *          -1 if it is outside the triangulation
+   */
+  template <typename T>
+  int Delaunay<T>::insert( const Point<T,2>& p ) {
+
+    if( _v.empty() ) return -1;
+
+    const double x = p(0), y = p(1);
+    int on;
+    const int t = _locate( x, y, on, _last );
+
+    for( int j = 0; j < 3; j++ ) {
+      const int a = _v[3*t+j];
+      if( on == -2 && _x[a] == x && _y[a] == y ) return a;
+      if( _orient( a, _v[3*t + (j+1)%3], x, y ) < 0.0 ) return -1;
+    }
+
+    const int i = int(_x.size());
+    _x.push_back( x );
+    _y.push_back( y );
+    _fixed.push_back( false );
+
+    _last = t;
+    _insert( i );
+    _dirty = true;
+    return i;
+  }
+
+
+  /*! \brief Triangulate the point set p
+   *
+   *  \param[in] p      The points
+   *  \param[in] fixed  Optional, an edge between two fixed points is never
+   *                    flipped once it has been made (as for constant
+   *                    vertices in TriangleFacets), all other edges are
+   *                    locally Delaunay
+   */
+  template <typename T>
+  void Delaunay<T>::triangulate( const DVector< Point<T,2> >& p, const DVector<bool>& fixed ) {
+
+    const int n = p.getDim();
+
+    _tri.setDim( 0 );
+    _nbr.setDim( 0 );
+    _id.clear();
+    _v.clear();
+    _adj.clear();
+    _dirty = false;
+    if( n < 3 ) return;
+
+    _x.resize( n+3 );
+    _y.resize( n+3 );
+    _fixed.assign( n+3, false );
+    for( int i = 0; i < n; i++ ) {
+      _x[i] = p(i)(0);
+      _y[i] = p(i)(1);
+      if( fixed.getDim() == n ) _fixed[i] = fixed(i);
+    }
+
+    _build( n );
+    _dirty = true;
+  }
+
+
+  /*! \brief Triangulate the point set p using several threads
+   *
+   *  The points are sorted along x and split in strips of equal size, which
+   *  are triangulated concurrently. A strip triangle whose circumcircle lies
+   *  strictly inside the strip has no other point in it, and is kept. The
+   *  remaining points of each strip and its hull points form the seam, which
+   *  is triangulated once more. Seam triangles that do not lie inside a kept
+   *  strip triangle fill the gaps. The result is the same as triangulate().
+   *
+   *  Fixed edges can not be merged this way, if any point is fixed the
+   *  serial triangulate() is used instead.
+   *
+   *  \param[in] p       The points
+   *  \param[in] fixed   Optional, see triangulate()
+   *  \param[in] strips  Number of strips, 0 for one per thread
+   */
+  template <typename T>
+  void Delaunay<T>::triangulateParallel( const DVector< Point<T,2> >& p, const DVector<bool>& fixed, int strips ) {
+
+    const int n = p.getDim();
+
+    for( int i = 0; i < fixed.getDim(); i++ )
+      if( fixed(i) ) { triangulate( p, fixed );  return; }
+
+#ifdef _OPENMP
+    if( strips <= 0 ) strips = omp_get_max_threads();
+#endif
+    strips = std::min( strips, n / 1024 );
+    if( strips < 2 ) { triangulate( p );  return; }
+
+    _tri.setDim( 0 );
+    _nbr.setDim( 0 );
+    _v.clear();
+    _adj.clear();
+    _dirty = false;
+
+    // Split along x
+    std::vector<int> sorted( n );
+    std::iota( sorted.begin(), sorted.end(), 0 );
+    std::sort( sorted.begin(), sorted.end(),
+               [&p]( int i, int j ) { return p(i)(0) < p(j)(0); } );
+
+    double x0 = p(0)(0), x1 = x0, y0 = p(0)(1), y1 = y0;
+    for( int i = 1; i < n; i++ ) {
+      x0 = std::min( x0, double(p(i)(0)) );  x1 = std::max( x1, double(p(i)(0)) );
+      y0 = std::min( y0, double(p(i)(1)) );  y1 = std::max( y1, double(p(i)(1)) );
+    }
+    const double tol = 1e-9 * std::max( x1 - x0, y1 - y0 );
+
+    std::vector<int>    first( strips+1 );
+    std::vector<double> bound( strips+1 );
+    for( int s = 0; s <= strips; s++ ) first[s] = int( (long long)(n) * s / strips );
+    bound[0]      = -std::numeric_limits<double>::infinity();
+    bound[strips] =  std::numeric_limits<double>::infinity();
+    for( int s = 1; s < strips; s++ )
+      bound[s] = 0.5 * ( double(p(sorted[first[s]-1])(0)) + double(p(sorted[first[s]])(0)) );
+
+    std::vector< Delaunay<T> >       part( strips );
+    std::vector< std::vector<int> >  kept( strips );  // Output triangle, -1 if not kept
+    std::vector<int>                 strip( n ), hint( n, -1 );
+    std::vector<char>                seam( n, 0 );
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+    for( int s = 0; s < strips; s++ ) {
+
+      Delaunay<T>& d = part[s];
+      const int m = first[s+1] - first[s];
+
+      d._x.resize( m+3 );
+      d._y.resize( m+3 );
+      d._id.resize( m+3 );
+      d._fixed.assign( m+3, false );
+      for( int i = 0; i < m; i++ ) {
+        const int k = sorted[first[s] + i];
+        d._x[i]  = p(k)(0);
+        d._y[i]  = p(k)(1);
+        d._id[i] = k;
+        strip[k] = s;
+      }
+      for( int i = 0; i < 3; i++ ) d._id[m+i] = n + i;
+
+      d._build( m );
+
+      // Keep the triangles with a circumcircle inside the strip
+      const int nt = int(d._v.size()) / 3;
+      std::vector<int>& id = kept[s];
+      id.assign( nt, -1 );
+      for( int t = 0; t < nt; t++ ) {
+
+        const int a = d._v[3*t], b = d._v[3*t+1], c = d._v[3*t+2];
+        const double bx = d._x[b] - d._x[a], by = d._y[b] - d._y[a];
+        const double cx = d._x[c] - d._x[a], cy = d._y[c] - d._y[a];
+        const double bb = bx*bx + by*by, cc = cx*cx + cy*cy;
+        const double det = 2.0 * ( bx*cy - by*cx );
+        const double ux = ( cy*bb - by*cc ) / det;
+        const double uy = ( bx*cc - cx*bb ) / det;
+        const double r  = std::sqrt( ux*ux + uy*uy );
+        const double mx = d._x[a] + ux;
+
+        // Rounding error of the circle, large for slivers, which then go
+        // to the seam
+        const double err = 16.0 * std::numeric_limits<double>::epsilon() *
+                           ( std::abs( cy )*bb + std::abs( by )*cc + std::abs( bx )*cc + std::abs( cx )*bb +
+                             ( std::abs( ux ) + std::abs( uy ) ) * ( std::abs( bx*cy ) + std::abs( by*cx ) ) ) /
+                           std::abs( det );
+
+        if( mx - r - err > bound[s] + tol && mx + r + err < bound[s+1] - tol ) id[t] = 1;
+      }
+
+      // The points of the other triangles and the hull points go to the seam
+      if( nt == 0 )
+        for( int i = 0; i < m; i++ ) seam[d._id[i]] = 1;
+      for( int h = 0; h < 3*nt; h++ ) {
+        if( id[h/3] >= 0 && d._adj[h] >= 0 ) continue;
+        const int k = d._id[d._v[h]];
+        seam[k] = 1;
+        hint[k] = h/3;
+      }
+    }
+
+    // Triangulate the seam
+    Delaunay<T> sd;
+    for( int i = 0; i < n; i++ )
+      if( seam[i] ) sd._id.push_back( i );
+
+    const int ms = int(sd._id.size());
+    sd._x.resize( ms+3 );
+    sd._y.resize( ms+3 );
+    sd._fixed.assign( ms+3, false );
+    for( int i = 0; i < ms; i++ ) {
+      sd._x[i] = p(sd._id[i])(0);
+      sd._y[i] = p(sd._id[i])(1);
+    }
+    for( int i = 0; i < 3; i++ ) sd._id.push_back( n + i );
+    sd._build( ms );
+
+    // Seam triangles inside a kept strip triangle are dropped
+    const int nst = int(sd._v.size()) / 3;
+    std::vector<int> sid( nst, -1 );
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int t = 0; t < nst; t++ ) {
+
+      const int a = sd._v[3*t], b = sd._v[3*t+1], c = sd._v[3*t+2];
+      const double x = ( sd._x[a] + sd._x[b] + sd._x[c] ) / 3.0;
+      const double y = ( sd._y[a] + sd._y[b] + sd._y[c] ) / 3.0;
+
+      const int s = int( std::upper_bound( bound.begin() + 1, bound.end() - 1, x ) - bound.begin() ) - 1;
+      const Delaunay<T>& d = part[s];
+      if( d._v.empty() ) { sid[t] = 1;  continue; }
+
+      int start = 0;
+      for( int j = 0; j < 3; j++ ) {
+        const int k = sd._id[sd._v[3*t+j]];
+        if( strip[k] == s && hint[k] >= 0 ) start = hint[k];
+      }
+
+      int on;
+      const int u = d._locate( x, y, on, start );
+      const bool inside = d._orient( d._v[3*u],   d._v[3*u+1], x, y ) >= 0.0 &&
+                          d._orient( d._v[3*u+1], d._v[3*u+2], x, y ) >= 0.0 &&
+                          d._orient( d._v[3*u+2], d._v[3*u],   x, y ) >= 0.0;
+      if( !inside || kept[s][u] < 0 ) sid[t] = 1;
+    }
+
+    // Number the output triangles, strips first
+    int nt = 0;
+    for( int s = 0; s < strips; s++ )
+      for( size_t t = 0; t < kept[s].size(); t++ )
+        if( kept[s][t] >= 0 ) kept[s][t] = nt++;
+    for( int t = 0; t < nst; t++ )
+      if( sid[t] >= 0 ) sid[t] = nt++;
+
+    _tri.setDim( 3*nt );
+    _nbr.setDim( 3*nt );
+
+    // Copy, neighbours across a strip or seam border are found afterwards
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic)
+#endif
+    for( int s = 0; s <= strips; s++ ) {
+
+      const Delaunay<T>&      d  = s < strips ? part[s] : sd;
+      const std::vector<int>& id = s < strips ? kept[s] : sid;
+
+      for( size_t t = 0; t < id.size(); t++ ) {
+        if( id[t] < 0 ) continue;
+        for( int j = 0; j < 3; j++ ) {
+          const int g = d._adj[3*t+j];
+          _tri[3*id[t]+j] = d._id[d._v[3*t+j]];
+          _nbr[3*id[t]+j] = ( g >= 0 && id[g/3] >= 0 ) ? 3*id[g/3] + g%3 : -2;
+        }
+      }
+    }
+
+    std::unordered_map<unsigned long long, int> open;
+    for( int h = 0; h < 3*nt; h++ ) {
+      if( _nbr[h] != -2 ) continue;
+      const unsigned long long a = (unsigned int)_tri[h];
+      const unsigned long long b = (unsigned int)_tri[3*(h/3) + (h+1)%3];
+      open[ ( a << 32 ) | b ] = h;
+    }
+    for( auto& e : open ) {
+      const unsigned long long key = ( e.first << 32 ) | ( e.first >> 32 );
+      const auto it = open.find( key );
+      _nbr[e.second] = it != open.end() ? it->second : -1;
+    }
+
+    // Working arrays for insert()
+    _x.resize( n );
+    _y.resize( n );
+    _fixed.assign( n, false );
+    _id.clear();
+    for( int i = 0; i < n; i++ ) {
+      _x[i] = p(i)(0);
+      _y[i] = p(i)(1);
+    }
+    _v.assign( _tri.getPtr(), _tri.getPtr() + 3*nt );
+    _adj.assign( _nbr.getPtr(), _nbr.getPtr() + 3*nt );
+    _last  = 0;
+    _dirty = false;
+  }
+
+
+  /*! \brief Copy the working arrays to the result after a change */
+  template <typename T>
+  void Delaunay<T>::_sync() const {
+
+    if( !_dirty ) return;
+
+    const int m = int(_v.size());
+    _tri.setDim( m );
+    _nbr.setDim( m );
+    for( int h = 0; h < m; h++ ) {
+      _tri[h] = _v[h];
+      _nbr[h] = _adj[h];
+    }
+    _dirty = false;
+  }
+
+
+  /*! \brief Triangulate the first n points of _x, _y
+   *
+   *  The arrays hold n+3 entries, the last three are used for the
+   *  surrounding triangle.
+   */
+  template <typename T>
+  void Delaunay<T>::_build( int n ) {
+
+    _v.clear();
+    _adj.clear();
+    _stack.clear();
+    if( n < 3 ) return;
+
+    double x0 = _x[0], x1 = _x[0], y0 = _y[0], y1 = _y[0];
+    for( int i = 1; i < n; i++ ) {
+      x0 = std::min( x0, _x[i] );  x1 = std::max( x1, _x[i] );
+      y0 = std::min( y0, _y[i] );  y1 = std::max( y1, _y[i] );
+    }
+
+    // Surrounding triangle, removed again at the end
+    double l = std::max( x1 - x0, y1 - y0 );
+    if( l <= 0.0 ) l = 1.0;
+    const double cx = 0.5 * ( x0 + x1 );
+    const double cy = 0.5 * ( y0 + y1 );
+    _x[n]   = cx - 20.0*l;  _y[n]   = cy - 10.0*l;
+    _x[n+1] = cx + 20.0*l;  _y[n+1] = cy - 10.0*l;
+    _x[n+2] = cx;           _y[n+2] = cy + 20.0*l;
+
+    _v.reserve( 3 * ( 2*n + 8 ) );
+    _adj.reserve( 3 * ( 2*n + 8 ) );
+    _newTriangle( n, n+1, n+2 );
+    _last = 0;
+
+    std::vector<int> order;
+    _order( n, order );
+    for( int i = 0; i < n; i++ ) _insert( order[i] );
+
+    _compact( n );
+    _repairHull();
+
+    // A flip refused across a fixed edge is not followed up by the
+    // insertion, so with fixed points all edges are checked once more
+    if( std::find( _fixed.begin(), _fixed.begin() + n, true ) != _fixed.begin() + n ) {
+      for( int h = 0; h < int(_adj.size()); h++ )
+        if( _adj[h] > h ) _stack.push_back( h );
+      _legalize( true );
+    }
+
+    // The surrounding vertices are no longer used
+    _x.resize( n );
+    _y.resize( n );
+    _fixed.resize( n );
+    if( !_id.empty() ) _id.resize( n );
+  }
+
+
+  /*! \brief Remove all triangles that use one of the surrounding vertices */
+  template <typename T>
+  void Delaunay<T>::_compact( int n ) {
+
+    const int nt = int(_v.size()) / 3;
+    std::vector<int> id( nt, -1 );
+
+    int k = 0;
+    for( int t = 0; t < nt; t++ )
+      if( _v[3*t] < n && _v[3*t+1] < n && _v[3*t+2] < n ) id[t] = k++;
+
+    for( int t = 0; t < nt; t++ ) {
+      if( id[t] < 0 ) continue;
+      for( int j = 0; j < 3; j++ ) {
+        const int g = _adj[3*t+j];
+        _v[3*id[t]+j]   = _v[3*t+j];
+        _adj[3*id[t]+j] = ( g >= 0 && id[g/3] >= 0 ) ? 3*id[g/3] + g%3 : -1;
+      }
+    }
+
+    _v.resize( 3*k );
+    _adj.resize( 3*k );
+
+    // The triangles are renumbered, insert() starts its walk anew
+    _last = 0;
+  }
+
+
+  /*! \brief Flip the edge of half-edge h
+   *
+   *  The triangles (a,b,c) and (b,a,d) become (c,a,d) and (c,d,b), so the
+   *  apex c of h is kept as the first vertex of both.
+   */
+  template <typename T>
+  void Delaunay<T>::_flip( int h ) {
+
+    const int g  = _adj[h];
+    const int t1 = h / 3;
+    const int t2 = g / 3;
+    const int hn = 3*t1 + (h+1)%3, hp = 3*t1 + (h+2)%3;
+    const int gn = 3*t2 + (g+1)%3, gp = 3*t2 + (g+2)%3;
+
+    const int a = _v[h], b = _v[hn], c = _v[hp], d = _v[gp];
+    const int ca = _adj[hp], bc = _adj[hn];
+    const int ad = _adj[gn], db = _adj[gp];
+
+    _v[3*t1] = c;  _v[3*t1+1] = a;  _v[3*t1+2] = d;
+    _v[3*t2] = c;  _v[3*t2+1] = d;  _v[3*t2+2] = b;
+
+    _link( 3*t1,   ca );
+    _link( 3*t1+1, ad );
+    _link( 3*t1+2, 3*t2 );
+    _link( 3*t2+1, db );
+    _link( 3*t2+2, bc );
+  }
+
+
+  /*! \brief Insert point i, split the triangle or edge it falls on
+   *
+   *  All points are inside the surrounding triangle, so the fan around a
+   *  duplicated vertex is closed.
+   */
+  template <typename T>
+  void Delaunay<T>::_insert( int i ) {
+
+    int on;
+    const int t = _locate( _x[i], _y[i], on, _last );
+
+    // Duplicated point, the one of the lowest global index is kept. Ties
+    // around it were broken on the old index, so its edges and the edges
+    // facing it are checked again.
+    if( on == -2 ) {
+      int h = 3*t;
+      while( _x[_v[h]] != _x[i] || _y[_v[h]] != _y[i] ) h++;
+      const int v = _v[h];
+      if( ( _id.empty() ? i : _id[i] ) < ( _id.empty() ? v : _id[v] ) ) {
+        _fixed[i] = _fixed[i] || _fixed[v];
+        const int h0 = h;
+        do {
+          _v[h] = i;
+          _stack.push_back( h );
+          _stack.push_back( 3*(h/3) + (h+1)%3 );
+          h = _adj[3*(h/3) + (h+2)%3];
+        } while( h != h0 );
+        _legalize( true );
+      }
+      return;
+    }
+
+    if( on == -1 ) {
+
+      // Inside, split (a,b,c) into three
+      const int a = _v[3*t], b = _v[3*t+1], c = _v[3*t+2];
+      const int ab = _adj[3*t], bc = _adj[3*t+1], ca = _adj[3*t+2];
+
+      const int t1 = _newTriangle( b, c, i );
+      const int t2 = _newTriangle( c, a, i );
+      _v[3*t+2] = i;
+
+      _link( 3*t,    ab );
+      _link( 3*t1,   bc );
+      _link( 3*t2,   ca );
+      _link( 3*t+1,  3*t1+2 );
+      _link( 3*t1+1, 3*t2+2 );
+      _link( 3*t2+1, 3*t+2 );
+
+      _stack.push_back( 3*t );
+      _stack.push_back( 3*t1 );
+      _stack.push_back( 3*t2 );
+    }
+    else {
+
+      // On the edge of half-edge h = (a,b), split both sides into two
+      const int h  = on;
+      const int g  = _adj[h];
+      const int t1 = h / 3;
+      const int a  = _v[h], b = _v[3*t1 + (h+1)%3], c = _v[3*t1 + (h+2)%3];
+      const int bc = _adj[3*t1 + (h+1)%3], ca = _adj[3*t1 + (h+2)%3];
+
+      _v[3*t1] = c;  _v[3*t1+1] = a;  _v[3*t1+2] = i;
+      const int t3 = _newTriangle( b, c, i );
+
+      _link( 3*t1,   ca );
+      _link( 3*t3,   bc );
+      _link( 3*t1+2, 3*t3+1 );
+      _stack.push_back( 3*t1 );
+      _stack.push_back( 3*t3 );
+
+      if( g >= 0 ) {
+
+        const int t2 = g / 3;
+        const int d  = _v[3*t2 + (g+2)%3];
+        const int ad = _adj[3*t2 + (g+1)%3], db = _adj[3*t2 + (g+2)%3];
+
+        _v[3*t2] = a;  _v[3*t2+1] = d;  _v[3*t2+2] = i;
+        const int t4 = _newTriangle( d, b, i );
+
+        _link( 3*t2,   ad );
+        _link( 3*t4,   db );
+        _link( 3*t2+1, 3*t4+2 );
+        _link( 3*t1+1, 3*t2+2 );
+        _link( 3*t4+1, 3*t3+2 );
+        _stack.push_back( 3*t2 );
+        _stack.push_back( 3*t4 );
+      }
+      else {
+        _adj[3*t1+1] = -1;
+        _adj[3*t3+2] = -1;
+      }
+    }
+
+    _last = t;
+    _legalize( false );
+  }
+
+
+  /*! \brief Positive if d is inside the circumcircle of the counter-clockwise (a,b,c)
+   *
+   *  The determinant is evaluated in double precision, and again exactly if
+   *  it is too close to zero for its sign to be trusted, so the sign never
+   *  depends on rounding or on the order of the points. Cocircular points
+   *  are resolved by lifting the point of the lowest global index slightly,
+   *  as in simulation of simplicity, so the serial and the parallel
+   *  triangulation make the same choice.
+   */
+  template <typename T>
+  double Delaunay<T>::_incircle( int a, int b, int c, int d ) const {
+
+    {
+      const double adx = _x[a] - _x[d], ady = _y[a] - _y[d];
+      const double bdx = _x[b] - _x[d], bdy = _y[b] - _y[d];
+      const double cdx = _x[c] - _x[d], cdy = _y[c] - _y[d];
+      const double aa  = adx*adx + ady*ady;
+      const double bb  = bdx*bdx + bdy*bdy;
+      const double cc  = cdx*cdx + cdy*cdy;
+
+      const double det = aa * ( bdx*cdy - cdx*bdy )
+                       + bb * ( cdx*ady - adx*cdy )
+                       + cc * ( adx*bdy - bdx*ady );
+      const double per = aa * ( std::abs( bdx*cdy ) + std::abs( cdx*bdy ) )
+                       + bb * ( std::abs( cdx*ady ) + std::abs( adx*cdy ) )
+                       + cc * ( std::abs( adx*bdy ) + std::abs( bdx*ady ) );
+
+      // Error bound of the rounded determinant (Shewchuk)
+      const double eps = 0.5 * std::numeric_limits<double>::epsilon();
+      if( std::abs( det ) > ( 10.0 + 96.0*eps ) * eps * per ) return det;
+    }
+
+    {
+      using namespace Private::Expansion;
+
+      std::vector<double> adx, ady, bdx, bdy, cdx, cdy;
+      diff( _x[a], _x[d], adx );  diff( _y[a], _y[d], ady );
+      diff( _x[b], _x[d], bdx );  diff( _y[b], _y[d], bdy );
+      diff( _x[c], _x[d], cdx );  diff( _y[c], _y[d], cdy );
+
+      std::vector<double> bc, ca, ab, xx, yy, aa, bb, cc, u, v, w, det;
+      cross( bdx, bdy, cdx, cdy, bc );
+      cross( cdx, cdy, adx, ady, ca );
+      cross( adx, ady, bdx, bdy, ab );
+
+      product( adx, adx, xx );  product( ady, ady, yy );  sum( xx, yy, aa );
+      product( bdx, bdx, xx );  product( bdy, bdy, yy );  sum( xx, yy, bb );
+      product( cdx, cdx, xx );  product( cdy, cdy, yy );  sum( xx, yy, cc );
+
+      product( aa, bc, u );
+      product( bb, ca, v );
+      product( cc, ab, w );
+      sum( u, v, xx );
+      sum( xx, w, det );
+
+      if( !det.empty() ) return sign( det );
+    }
+
+    // Cocircular, sort the points on their global index
+    int  q[4] = { a, b, c, d };
+    bool odd  = false;
+    for( int i = 1; i < 4; i++ )
+      for( int j = i; j > 0; j-- ) {
+        const int gj = _id.empty() ? q[j]   : _id[q[j]];
+        const int gi = _id.empty() ? q[j-1] : _id[q[j-1]];
+        if( gi < gj ) break;
+        std::swap( q[j], q[j-1] );
+        odd = !odd;
+      }
+
+    // The cofactors of the lifted coordinates, in the order of the lift
+    const double lift[4] = {  _orient( q[1], q[2], _x[q[3]], _y[q[3]] ),
+                              _orient( q[2], q[0], _x[q[3]], _y[q[3]] ),
+                              _orient( q[0], q[1], _x[q[3]], _y[q[3]] ),
+                             -_orient( q[0], q[1], _x[q[2]], _y[q[2]] ) };
+    double det = 0.0;
+    for( int i = 0; i < 4 && det == 0.0; i++ ) det = lift[i];
+
+    return odd ? -det : det;
+  }
+
+
+  /*! \brief True if the edge of h is not locally Delaunay
+   *
+   *  The apex of h against the circumcircle of the opposite triangle. The
+   *  flip must also give two proper triangles, with exact predicates this
+   *  only excludes a quadrilateral that is not strictly convex.
+   */
+  template <typename T>
+  bool Delaunay<T>::_isIllegal( int h ) const {
+
+    const int g = _adj[h];
+    if( g < 0 ) return false;
+
+    const int t = h / 3;
+    const int a = _v[h], b = _v[3*t + (h+1)%3], c = _v[3*t + (h+2)%3];
+    const int d = _v[3*(g/3) + (g+2)%3];
+
+    if( _fixed[a] && _fixed[b] ) return false;
+
+    return _incircle( a, b, c, d ) > 0.0 &&
+           _orient( c, a, _x[d], _y[d] ) > 0.0 && _orient( d, b, _x[c], _y[c] ) > 0.0;
+  }
+
+
+  /*! \brief Flip illegal edges until the stack is empty
+   *
+   *  With all = false the stacked half-edges have the new point as apex and
+   *  only the two edges facing away from it are checked after a flip.
+   */
+  template <typename T>
+  void Delaunay<T>::_legalize( bool all ) {
+
+    while( !_stack.empty() ) {
+
+      const int h = _stack.back();
+      _stack.pop_back();
+      if( !_isIllegal( h ) ) continue;
+
+      const int t1 = h / 3;
+      const int t2 = _adj[h] / 3;
+      _flip( h );
+
+      _stack.push_back( 3*t1+1 );
+      _stack.push_back( 3*t2+1 );
+      if( all ) {
+        _stack.push_back( 3*t1 );
+        _stack.push_back( 3*t2+2 );
+      }
+    }
+  }
+
+
+  template <typename T>
+  inline
+  void Delaunay<T>::_link( int h, int g ) {
+
+    _adj[h] = g;
+    if( g >= 0 ) _adj[g] = h;
+  }
+
+
+  /*! \brief Walk from triangle t to the one containing (x,y)
+   *
+   *  on is set to -1 if the point is inside, to the half-edge it lies on,
+   *  or to -2 if it coincides with a vertex. The first edge tested is
+   *  rotated each step, so the walk cannot cycle.
+   */
+  template <typename T>
+  int Delaunay<T>::_locate( double x, double y, int& on, int t ) const {
+
+    const int nt = int(_v.size()) / 3;
+
+    for( int step = 0; ; step++ ) {
+
+      int next = -1;
+      for( int j = 0; j < 3 && next < 0; j++ ) {
+        const int h = 3*t + ( j + step ) % 3;
+        if( _adj[h] >= 0 && _orient( _v[h], _v[3*t + (h+1)%3], x, y ) < 0.0 )
+          next = _adj[h] / 3;
+      }
+      if( next < 0 ) break;
+      t = next;
+
+      // Safety net for degenerate input, search all triangles
+      if( step > nt ) {
+        for( t = 0; t < nt; t++ )
+          if( _orient( _v[3*t],   _v[3*t+1], x, y ) >= 0.0 &&
+              _orient( _v[3*t+1], _v[3*t+2], x, y ) >= 0.0 &&
+              _orient( _v[3*t+2], _v[3*t],   x, y ) >= 0.0 ) break;
+        break;
+      }
+    }
+
+    on = -1;
+    for( int j = 0; j < 3; j++ ) {
+      const int h = 3*t + j;
+      if( _x[_v[h]] == x && _y[_v[h]] == y ) { on = -2; break; }
+      if( _orient( _v[h], _v[3*t + (j+1)%3], x, y ) == 0.0 ) on = h;
+    }
+
+    return t;
+  }
+
+
+  template <typename T>
+  inline
+  int Delaunay<T>::_newTriangle( int a, int b, int c ) {
+
+    const int t = int(_v.size()) / 3;
+    _v.push_back( a );    _v.push_back( b );    _v.push_back( c );
+    _adj.push_back( -1 ); _adj.push_back( -1 ); _adj.push_back( -1 );
+    return t;
+  }
+
+
+  /*! \brief Biased randomized insertion order
+   *
+   *  The points are shuffled and split in rounds of doubling size. Each
+   *  round is sorted along a Hilbert curve, so consecutive points are close
+   *  and the walks stay short.
+   */
+  template <typename T>
+  void Delaunay<T>::_order( int n, std::vector<int>& order ) const {
+
+    order.resize( n );
+    std::iota( order.begin(), order.end(), 0 );
+    std::shuffle( order.begin(), order.end(), std::mt19937( 5489u ) );
+
+    double x0 = _x[0], x1 = _x[0], y0 = _y[0], y1 = _y[0];
+    for( int i = 1; i < n; i++ ) {
+      x0 = std::min( x0, _x[i] );  x1 = std::max( x1, _x[i] );
+      y0 = std::min( y0, _y[i] );  y1 = std::max( y1, _y[i] );
+    }
+    const double sx = x1 > x0 ? 65535.0 / ( x1 - x0 ) : 0.0;
+    const double sy = y1 > y0 ? 65535.0 / ( y1 - y0 ) : 0.0;
+
+    std::vector<unsigned int> key( n );
+    for( int i = 0; i < n; i++ ) {
+
+      unsigned int x = (unsigned int)( ( _x[i] - x0 ) * sx );
+      unsigned int y = (unsigned int)( ( _y[i] - y0 ) * sy );
+      unsigned int d = 0;
+      for( unsigned int s = 1u << 15; s > 0; s >>= 1 ) {
+        const unsigned int rx = ( x & s ) ? 1 : 0;
+        const unsigned int ry = ( y & s ) ? 1 : 0;
+        d += s * s * ( ( 3 * rx ) ^ ry );
+        if( ry == 0 ) {
+          if( rx == 1 ) { x = 65535 - x;  y = 65535 - y; }
+          std::swap( x, y );
+        }
+      }
+      key[i] = d;
+    }
+
+    std::vector<int> bound( 1, n );
+    while( bound.back() > 64 ) bound.push_back( bound.back() / 2 );
+    bound.push_back( 0 );
+
+    for( size_t r = 1; r < bound.size(); r++ )
+      std::sort( order.begin() + bound[r], order.begin() + bound[r-1],
+                 [&key]( int i, int j ) { return key[i] < key[j]; } );
+  }
+
+
+  /*! \brief Twice the signed area of (a,b,(x,y)), positive if counter-clockwise
+   *
+   *  The sign is exact, the area is evaluated again exactly if the rounded
+   *  one is too close to zero.
+   */
+  template <typename T>
+  inline
+  double Delaunay<T>::_orient( int a, int b, double x, double y ) const {
+
+    const double l   = ( _x[b] - _x[a] ) * ( y - _y[a] );
+    const double r   = ( _y[b] - _y[a] ) * ( x - _x[a] );
+    const double det = l - r;
+
+    // Error bound of the rounded determinant (Shewchuk)
+    const double eps = 0.5 * std::numeric_limits<double>::epsilon();
+    if( std::abs( det ) > ( 3.0 + 16.0*eps ) * eps * ( std::abs( l ) + std::abs( r ) ) ) return det;
+
+    using namespace Private::Expansion;
+
+    std::vector<double> bx, by, px, py, e;
+    diff( _x[b], _x[a], bx );  diff( _y[b], _y[a], by );
+    diff( x, _x[a], px );      diff( y, _y[a], py );
+    cross( bx, by, px, py, e );
+
+    return sign( e );
+  }
+
+
+  /*! \brief Make the boundary convex
+   *
+   *  Hull triangles whose circumcircle holds a surrounding vertex are
+   *  missing after _compact(). Reflex boundary vertices are closed with
+   *  ears, and the new edges are legalized.
+   */
+  template <typename T>
+  void Delaunay<T>::_repairHull() {
+
+    const int m = int(_v.size());
+    if( m == 0 ) return;
+
+    // Boundary half-edges as a circular list
+    std::vector<int> bnext( m, -1 ), bprev( m, -1 );
+    int first = -1, count = 0;
+    for( int h = 0; h < m; h++ ) {
+      if( _adj[h] >= 0 ) continue;
+      int g = 3*(h/3) + (h+1)%3;
+      while( _adj[g] >= 0 ) g = 3*(_adj[g]/3) + (_adj[g]+1)%3;
+      bnext[h] = g;
+      bprev[g] = h;
+      first = h;
+      count++;
+    }
+
+    int h = first, unchanged = 0;
+    while( unchanged < count ) {
+
+      const int g = bnext[h];
+      const int a = _v[h], b = _v[g], c = _v[3*(g/3) + (g+1)%3];
+
+      if( _orient( a, b, _x[c], _y[c] ) < 0.0 ) {
+
+        const int t = _newTriangle( a, c, b );
+        _link( 3*t+1, g );
+        _link( 3*t+2, h );
+        _stack.push_back( 3*t+1 );
+        _stack.push_back( 3*t+2 );
+
+        bnext.resize( 3*t+3, -1 );
+        bprev.resize( 3*t+3, -1 );
+        const int p = bprev[h], q = bnext[g];
+        bnext[p] = 3*t;  bprev[3*t] = p;
+        bnext[3*t] = q;  bprev[q] = 3*t;
+
+        count--;
+        unchanged = 0;
+        h = p;
+      }
+      else {
+        h = g;
+        unchanged++;
+      }
+    }
+
+    _legalize( true );
+  }
+
+
+} // END namespace GMlib
@@ -0,0 +1,126 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+/*! \file gmdelaunay.h
+ *
+ *  Interface for the Delaunay class.
+ */
+
+
+#ifndef GM_TRIANGLESYSTEM_DELAUNAY_H
+#define GM_TRIANGLESYSTEM_DELAUNAY_H
+
+
+// gmlib
+#include <core/containers/gmdvector.h>
+#include <core/types/gmpoint.h>
+
+// stl
+#include <vector>
+
+
+namespace GMlib {
+
+
+  /*! \class Delaunay gmdelaunay.h <gmDelaunay>
+   *  \brief Incremental Delaunay triangulation of a planar point set
+   *
+   *  The points are inserted in a biased randomized insertion order (BRIO),
+   *  each round sorted along a Hilbert curve. They are located by walking
+   *  from the last created triangle, and the Delaunay property is restored
+   *  by edge flips. Triangles are stored compactly as index triples with a
+   *  neighbour (opposite half-edge) array. Predicates are evaluated in double
+   *  precision, and exactly when the rounded sign can not be trusted.
+   *  Cocircular points are resolved by a symbolic perturbation on the point
+   *  index, so the triangulation is unique.
+   *
+   *  triangulateParallel() splits the points in strips along x, triangulates
+   *  the strips concurrently and merges them: a strip triangle whose
+   *  circumcircle stays inside the strip is part of the global triangulation,
+   *  the rest is made from one triangulation of the seam points.
+   *
+   *  Half-edge h of triangle t = h/3 goes from vertex h to vertex
+   *  3t + (h+1)%3. The result covers the convex hull of the points,
+   *  duplicated points are left out. Further points inside the hull can be
+   *  added with insert(), as done by mesh refinement.
+   */
+  template <typename T>
+  class Delaunay {
+  public:
+    Delaunay();
+
+    int                   getNoPoints() const;
+    int                   getNoTriangles() const;
+    const DVector<int>&   getNeighbours() const;
+    const DVector<int>&   getTriangles() const;
+    int                   getVertex( int h ) const;
+
+    int                   insert( const Point<T,2>& p );
+
+    void                  triangulate( const DVector< Point<T,2> >& p,
+                                       const DVector<bool>& fixed = DVector<bool>() );
+    void                  triangulateParallel( const DVector< Point<T,2> >& p,
+                                               const DVector<bool>& fixed = DVector<bool>(),
+                                               int strips = 0 );
+
+  private:
+    std::vector<double>   _x, _y;
+    std::vector<bool>     _fixed;
+    std::vector<int>      _id;      // Global point index, empty if the same as the local
+    std::vector<int>      _v;       // Vertex of each half-edge
+    std::vector<int>      _adj;     // Opposite half-edge, -1 on the boundary
+    std::vector<int>      _stack;   // Half-edges to legalize
+    int                   _last;    // Start triangle for the next walk
+
+    mutable DVector<int>  _tri;
+    mutable DVector<int>  _nbr;
+    mutable bool          _dirty;   // _tri, _nbr are behind _v, _adj
+
+    void                  _build( int n );
+    void                  _compact( int n );
+    void                  _flip( int h );
+    void                  _insert( int i );
+    double                _incircle( int a, int b, int c, int d ) const;
+    bool                  _isIllegal( int h ) const;
+    void                  _legalize( bool all );
+    void                  _link( int h, int g );
+    int                   _locate( double x, double y, int& on, int t ) const;
+    int                   _newTriangle( int a, int b, int c );
+    void                  _order( int n, std::vector<int>& order ) const;
+    double                _orient( int a, int b, double x, double y ) const;
+    void                  _repairHull();
+    void                  _sync() const;
+
+  }; // END class Delaunay
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmdelaunay.c"
+
+
+#endif // GM_TRIANGLESYSTEM_DELAUNAY_H
@@ -0,0 +1,608 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+
+// stl
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  inline
+  MeshGenerator<T>::MeshGenerator()
+    : _h(T(0)), _max_area(T(0)), _min_angle(25), _seed(5489u), _r(0.0) {}
+
+
+  /*! \brief Make the mesh
+   *
+   *  \return false if there is no boundary, or nothing to triangulate
+   */
+  template <typename T>
+  bool MeshGenerator<T>::generate() {
+
+    _p.setDim( 0 );
+    _tri.setDim( 0 );
+    _nbr.setDim( 0 );
+    _bnd.setDim( 0 );
+    if( _loops.empty() || _loops[0].getDim() < 3 ) return false;
+
+    const DVector< Point<T,2> >& outer = _loops[0];
+    _x0 = _x1 = outer(0)(0);
+    _y0 = _y1 = outer(0)(1);
+    for( int i = 1; i < outer.getDim(); i++ ) {
+      _x0 = std::min( _x0, double(outer(i)(0)) );  _x1 = std::max( _x1, double(outer(i)(0)) );
+      _y0 = std::min( _y0, double(outer(i)(1)) );  _y1 = std::max( _y1, double(outer(i)(1)) );
+    }
+    if( _x1 <= _x0 || _y1 <= _y0 ) return false;
+
+    _r = _h > T(0) ? double(_h) : std::max( _x1 - _x0, _y1 - _y0 ) / 32.0;
+
+    _segments();
+    _buildRows();
+    _sample();
+
+    const int n = int(_x.size());
+    DVector< Point<T,2> > p( n );
+    for( int i = 0; i < n; i++ ) p[i] = Point<T,2>( T(_x[i]), T(_y[i]) );
+    _dt.triangulate( p );
+    if( _dt.getNoTriangles() == 0 ) return false;
+
+    _refine();
+    _finish();
+
+    return _tri.getDim() > 0;
+  }
+
+
+  /*! \brief Make the mesh and put it into tf
+   *
+   *  tf is cleared first. The vertices are stored in the order of
+   *  getPoints(), boundary vertices are set constant.
+   */
+  template <typename T>
+  bool MeshGenerator<T>::generate( TriangleFacets<T>& tf ) {
+
+    if( !generate() ) return false;
+
+    tf.clear();
+    tf.setMaxSize( _p.getDim() );
+    for( int i = 0; i < _p.getDim(); i++ ) {
+      TSVertex<T> v( _p(i) );
+      v.setConst( _bnd(i) );
+      tf.insertAlways( v );
+    }
+
+    tf.__e.set( tf );
+    tf._setTopology( _tri, _nbr );
+    return true;
+  }
+
+
+  /*! \brief True for the points on the boundary or a hole */
+  template <typename T>
+  inline
+  const DVector<bool>& MeshGenerator<T>::getBoundaryFlags() const {
+
+    return _bnd;
+  }
+
+
+  /*! \brief The opposite half-edge of each half-edge, -1 on the boundary */
+  template <typename T>
+  inline
+  const DVector<int>& MeshGenerator<T>::getNeighbours() const {
+
+    return _nbr;
+  }
+
+
+  template <typename T>
+  inline
+  int MeshGenerator<T>::getNoTriangles() const {
+
+    return _tri.getDim() / 3;
+  }
+
+
+  template <typename T>
+  inline
+  const DVector< Point<T,2> >& MeshGenerator<T>::getPoints() const {
+
+    return _p;
+  }
+
+
+  /*! \brief Three point indices per triangle, counter-clockwise */
+  template <typename T>
+  inline
+  const DVector<int>& MeshGenerator<T>::getTriangles() const {
+
+    return _tri;
+  }
+
+
+  /*! \brief Add a hole, a polygon inside the boundary */
+  template <typename T>
+  inline
+  void MeshGenerator<T>::insertHole( const DVector< Point<T,2> >& polygon ) {
+
+    if( _loops.empty() ) _loops.push_back( DVector< Point<T,2> >() );
+    _loops.push_back( polygon );
+  }
+
+
+  /*! \brief Set the outer boundary polygon, either orientation */
+  template <typename T>
+  inline
+  void MeshGenerator<T>::setBoundary( const DVector< Point<T,2> >& polygon ) {
+
+    if( _loops.empty() ) _loops.push_back( polygon );
+    else                 _loops[0] = polygon;
+  }
+
+
+  /*! \brief Largest triangle area, 0 (default) for no bound */
+  template <typename T>
+  inline
+  void MeshGenerator<T>::setMaxArea( T area ) {
+
+    _max_area = area;
+  }
+
+
+  /*! \brief Smallest triangle angle, 25 degrees by default
+   *
+   *  Refinement is guaranteed to end for angles up to about 20 degrees, in
+   *  practice it does up to about 33.
+   */
+  template <typename T>
+  inline
+  void MeshGenerator<T>::setMinAngle( const Angle& a ) {
+
+    _min_angle = a;
+  }
+
+
+  /*! \brief Seed of the random numbers used for the sampling */
+  template <typename T>
+  inline
+  void MeshGenerator<T>::setSeed( unsigned int seed ) {
+
+    _seed = seed;
+  }
+
+
+  /*! \brief Smallest distance between the sampled points
+   *
+   *  Also the largest length of the boundary segments. By default 1/32 of
+   *  the size of the domain.
+   */
+  template <typename T>
+  inline
+  void MeshGenerator<T>::setSpacing( T h ) {
+
+    _h = h;
+  }
+
+
+  /*! \brief Bucket the segments in rows of height h
+   *
+   *  A segment is put in every row its diametral circle reaches, so a row
+   *  holds all segments that cross it and all that may be encroached by a
+   *  point in it. Segments split off later are searched one by one until
+   *  the rows are made again.
+   */
+  template <typename T>
+  void MeshGenerator<T>::_buildRows() {
+
+    const int ns = int(_sa.size());
+    _row_count = ns;
+    _rows = std::max( 1, int( ( _y1 - _y0 ) / _r ) + 1 );
+    _row_start.assign( _rows + 1, 0 );
+
+    auto range = [this]( int s, int& r0, int& r1 ) {
+      const double xa = _x[_sa[s]], ya = _y[_sa[s]];
+      const double xb = _x[_sb[s]], yb = _y[_sb[s]];
+      const double l  = 0.5 * std::sqrt( ( xb - xa )*( xb - xa ) + ( yb - ya )*( yb - ya ) );
+      const double my = 0.5 * ( ya + yb );
+      r0 = std::max( 0,         int( ( my - l - _y0 ) / _r ) );
+      r1 = std::min( _rows - 1, int( ( my + l - _y0 ) / _r ) );
+    };
+
+    int r0, r1;
+    for( int s = 0; s < ns; s++ ) {
+      range( s, r0, r1 );
+      for( int r = r0; r <= r1; r++ ) _row_start[r+1]++;
+    }
+    for( int r = 0; r < _rows; r++ ) _row_start[r+1] += _row_start[r];
+
+    std::vector<int> fill( _row_start.begin(), _row_start.end() - 1 );
+    _row_seg.resize( _row_start[_rows] );
+    for( int s = 0; s < ns; s++ ) {
+      range( s, r0, r1 );
+      for( int r = r0; r <= r1; r++ ) _row_seg[fill[r]++] = s;
+    }
+  }
+
+
+  /*! \brief A segment whose diametral circle holds (x,y), -1 if none */
+  template <typename T>
+  int MeshGenerator<T>::_encroached( double x, double y ) const {
+
+    auto test = [this,x,y]( int s ) {
+      const double ax = _x[_sa[s]] - x, ay = _y[_sa[s]] - y;
+      const double bx = _x[_sb[s]] - x, by = _y[_sb[s]] - y;
+      return ax*bx + ay*by < 0.0;
+    };
+
+    const int r = std::min( std::max( int( ( y - _y0 ) / _r ), 0 ), _rows - 1 );
+    for( int k = _row_start[r]; k < _row_start[r+1]; k++ )
+      if( test( _row_seg[k] ) ) return _row_seg[k];
+    for( int s = _row_count; s < int(_sa.size()); s++ )
+      if( test( s ) ) return s;
+    return -1;
+  }
+
+
+  /*! \brief Keep the triangles inside the domain and renumber them */
+  template <typename T>
+  void MeshGenerator<T>::_finish() {
+
+    _buildRows();
+
+    const DVector<int>& tri = _dt.getTriangles();
+    const DVector<int>& nbr = _dt.getNeighbours();
+    const int nt = tri.getDim() / 3;
+
+    std::vector<int> id( nt, -1 );
+    int k = 0;
+    for( int t = 0; t < nt; t++ ) {
+      const int a = tri(3*t), b = tri(3*t+1), c = tri(3*t+2);
+      if( _inside( ( _x[a] + _x[b] + _x[c] ) / 3.0, ( _y[a] + _y[b] + _y[c] ) / 3.0 ) ) id[t] = k++;
+    }
+
+    _tri.setDim( 3*k );
+    _nbr.setDim( 3*k );
+    for( int t = 0; t < nt; t++ ) {
+      if( id[t] < 0 ) continue;
+      for( int j = 0; j < 3; j++ ) {
+        const int g = nbr(3*t+j);
+        _tri[3*id[t]+j] = tri(3*t+j);
+        _nbr[3*id[t]+j] = ( g >= 0 && id[g/3] >= 0 ) ? 3*id[g/3] + g%3 : -1;
+      }
+    }
+
+    const int n = int(_x.size());
+    _p.setDim( n );
+    _bnd.setDim( n );
+    for( int i = 0; i < n; i++ ) {
+      _p[i]   = Point<T,2>( T(_x[i]), T(_y[i]) );
+      _bnd[i] = false;
+    }
+    for( size_t s = 0; s < _sa.size(); s++ )
+      _bnd[_sa[s]] = _bnd[_sb[s]] = true;
+  }
+
+
+  /*! \brief Point in polygon by the even-odd rule, a ray along +x */
+  template <typename T>
+  bool MeshGenerator<T>::_inside( double x, double y ) const {
+
+    if( x < _x0 || x > _x1 || y < _y0 || y > _y1 ) return false;
+
+    auto cross = [this,x,y]( int s ) {
+      const double xa = _x[_sa[s]], ya = _y[_sa[s]];
+      const double xb = _x[_sb[s]], yb = _y[_sb[s]];
+      return ( ya > y ) != ( yb > y ) && xa + ( y - ya ) * ( xb - xa ) / ( yb - ya ) > x;
+    };
+
+    const int r = std::min( int( ( y - _y0 ) / _r ), _rows - 1 );
+    bool in = false;
+    for( int k = _row_start[r]; k < _row_start[r+1]; k++ )
+      if( cross( _row_seg[k] ) ) in = !in;
+    for( int s = _row_count; s < int(_sa.size()); s++ )
+      if( cross( s ) ) in = !in;
+    return in;
+  }
+
+
+  /*! \brief Insert a point into the triangulation
+   *
+   *  \return Its index, -1 if it was not inserted
+   */
+  template <typename T>
+  int MeshGenerator<T>::_insert( double x, double y ) {
+
+    const Point<T,2> p = Point<T,2>( T(x), T(y) );
+    const int i = _dt.insert( p );
+    if( i != int(_x.size()) ) return -1;
+
+    _x.push_back( double(p(0)) );
+    _y.push_back( double(p(1)) );
+    return i;
+  }
+
+
+  /*! \brief Ruppert refinement, in rounds
+   *
+   *  Each round first splits the boundary segments that are missing from
+   *  the triangulation or have an inside triangle apex in their diametral
+   *  circle. Only when there are none, the inside triangles with a too small
+   *  angle or too large area get their circumcenter inserted, or the segment
+   *  it encroaches split instead. A triangle already changed by an insertion
+   *  in the round is left for the next one, so every inserted circumcenter
+   *  has an empty circumcircle as in the sequential algorithm. Features
+   *  smaller than h/100 are not refined.
+   *
+   *  \return true if the quality bounds are met
+   */
+  template <typename T>
+  bool MeshGenerator<T>::_refine() {
+
+    const double lmin = 1e-4 * _r * _r;
+    const double smin = std::sin( _min_angle.getRad() );
+    const double amax = 2.0 * double(_max_area);
+
+    for( int round = 0; round < 1000; round++ ) {
+
+      _buildRows();
+
+      const DVector<int>& tri = _dt.getTriangles();
+      const DVector<int>& nbr = _dt.getNeighbours();
+      const int nt = tri.getDim() / 3;
+
+      std::vector<int> vh( _x.size(), -1 );
+      for( int h = 0; h < 3*nt; h++ ) vh[tri(h)] = h;
+
+      // The half-edge between a and b, -1 if there is none
+      auto edge = [&tri, &nbr, &vh]( int a, int b ) -> int {
+
+        const int h0 = vh[a];
+        if( h0 < 0 ) return -1;
+
+        int h = h0;
+        do {
+          if( tri(3*(h/3) + (h+1)%3) == b ) return h;
+          const int p = 3*(h/3) + (h+2)%3;
+          if( tri(p) == b ) return p;
+          h = nbr(p);
+        } while( h >= 0 && h != h0 );
+        if( h == h0 ) return -1;
+
+        for( h = h0; nbr(h) >= 0; ) {
+          const int g = nbr(h);
+          h = 3*(g/3) + (g+1)%3;
+          if( tri(3*(h/3) + (h+1)%3) == b ) return h;
+          const int p = 3*(h/3) + (h+2)%3;
+          if( tri(p) == b ) return p;
+        }
+        return -1;
+      };
+
+      std::vector<char> in( nt );
+      for( int t = 0; t < nt; t++ ) {
+        const int a = tri(3*t), b = tri(3*t+1), c = tri(3*t+2);
+        in[t] = _inside( ( _x[a] + _x[b] + _x[c] ) / 3.0, ( _y[a] + _y[b] + _y[c] ) / 3.0 );
+      }
+
+      // Segments
+      bool changed = false;
+      const int ns = int(_sa.size());
+      for( int s = 0; s < ns; s++ ) {
+
+        const int a = _sa[s], b = _sb[s];
+        const int h = edge( a, b );
+        bool split = h < 0;
+
+        for( int g = h; !split && g >= 0; g = ( g == h ) ? nbr(h) : -1 ) {
+          const int c = tri(3*(g/3) + (g+2)%3);
+          split = in[g/3] && ( _x[a] - _x[c] ) * ( _x[b] - _x[c] ) + ( _y[a] - _y[c] ) * ( _y[b] - _y[c] ) < 0.0;
+        }
+
+        if( split && _splitSegment( s ) ) changed = true;
+      }
+      if( changed ) continue;
+
+      // Triangles, skipped if they were changed by an insertion this round
+      for( int t = 0; t < nt; t++ ) {
+
+        if( !in[t] ) continue;
+
+        const int a = tri(3*t), b = tri(3*t+1), c = tri(3*t+2);
+        const int va = _dt.getVertex(3*t), vb = _dt.getVertex(3*t+1), vc = _dt.getVertex(3*t+2);
+        if( !( ( va == a && vb == b && vc == c ) || ( va == b && vb == c && vc == a ) ||
+               ( va == c && vb == a && vc == b ) ) ) continue;
+
+        const double bx = _x[b] - _x[a], by = _y[b] - _y[a];
+        const double cx = _x[c] - _x[a], cy = _y[c] - _y[a];
+        const double bb = bx*bx + by*by, cc = cx*cx + cy*cy;
+        const double aa = ( cx - bx )*( cx - bx ) + ( cy - by )*( cy - by );
+        const double d  = 2.0 * ( bx*cy - by*cx );
+        const double ux = ( cy*bb - by*cc ) / d;
+        const double uy = ( bx*cc - cx*bb ) / d;
+        const double l  = std::min( aa, std::min( bb, cc ) );
+
+        // sin of the smallest angle is l / 2R
+        const bool bad = l < 4.0 * ( ux*ux + uy*uy ) * smin * smin || ( amax > 0.0 && d > amax );
+        if( !bad || l < lmin ) continue;
+
+        const double x = _x[a] + ux, y = _y[a] + uy;
+        const int s = _encroached( x, y );
+        if( s >= 0 ) {
+          if( _splitSegment( s ) ) changed = true;
+        }
+        else if( _inside( x, y ) && _insert( x, y ) >= 0 )
+          changed = true;
+      }
+
+      if( !changed ) return true;
+    }
+
+    return false;
+  }
+
+
+  /*! \brief Poisson-disk sampling of the inside
+   *
+   *  The boundary points are the seeds. Candidates are tried on a circle of
+   *  radius h around a random active point, at evenly spaced angles from a
+   *  random start. The first that is inside and at least h from all points
+   *  is taken, a point without one is retired. A background grid with cells
+   *  of size h/sqrt(2) holds the points for the distance test.
+   */
+  template <typename T>
+  void MeshGenerator<T>::_sample() {
+
+    const int    tries = 16;
+    const double r     = _r * ( 1.0 + 1e-6 );
+    const double rr    = _r * _r;
+    const double cell  = _r / std::sqrt( 2.0 );
+    const int    nx    = int( ( _x1 - _x0 ) / cell ) + 1;
+    const int    ny    = int( ( _y1 - _y0 ) / cell ) + 1;
+
+    std::vector<int> head( size_t(nx) * ny, -1 );
+    std::vector<int> next;
+    std::vector<int> active;
+
+    auto cellOf = [&]( double x, double y, int& i, int& j ) {
+      i = std::min( std::max( int( ( x - _x0 ) / cell ), 0 ), nx - 1 );
+      j = std::min( std::max( int( ( y - _y0 ) / cell ), 0 ), ny - 1 );
+    };
+    auto add = [&]( int k ) {
+      int i, j;
+      cellOf( _x[k], _y[k], i, j );
+      next.push_back( head[size_t(j)*nx + i] );
+      head[size_t(j)*nx + i] = k;
+      active.push_back( k );
+    };
+
+    for( int k = 0; k < int(_x.size()); k++ ) add( k );
+
+    std::mt19937 rng( _seed );
+    std::uniform_real_distribution<double> u( 0.0, 1.0 );
+
+    while( !active.empty() ) {
+
+      const int k = std::min( int( u( rng ) * active.size() ), int(active.size()) - 1 );
+      const int p = active[k];
+      const double a0 = 2.0 * M_PI * u( rng );
+
+      bool found = false;
+      for( int t = 0; t < tries && !found; t++ ) {
+
+        const double a = a0 + 2.0 * M_PI * t / tries;
+        const double x = _x[p] + r * std::cos( a );
+        const double y = _y[p] + r * std::sin( a );
+        if( x <= _x0 || x >= _x1 || y <= _y0 || y >= _y1 ) continue;
+
+        int ci, cj;
+        cellOf( x, y, ci, cj );
+        bool free = true;
+        for( int j = std::max( cj-2, 0 ); j <= std::min( cj+2, ny-1 ) && free; j++ )
+          for( int i = std::max( ci-2, 0 ); i <= std::min( ci+2, nx-1 ) && free; i++ )
+            for( int q = head[size_t(j)*nx + i]; q >= 0 && free; q = next[q] )
+              free = ( _x[q] - x )*( _x[q] - x ) + ( _y[q] - y )*( _y[q] - y ) >= rr;
+
+        if( free && _inside( x, y ) ) {
+          _x.push_back( double( T(x) ) );
+          _y.push_back( double( T(y) ) );
+          add( int(_x.size()) - 1 );
+          found = true;
+        }
+      }
+
+      if( !found ) {
+        active[k] = active.back();
+        active.pop_back();
+      }
+    }
+  }
+
+
+  /*! \brief Split the boundary polygons in segments no longer than h */
+  template <typename T>
+  void MeshGenerator<T>::_segments() {
+
+    _x.clear();
+    _y.clear();
+    _sa.clear();
+    _sb.clear();
+
+    for( size_t l = 0; l < _loops.size(); l++ ) {
+
+      const DVector< Point<T,2> >& loop = _loops[l];
+      int m = loop.getDim();
+      if( m > 1 && loop(0) == loop(m-1) ) m--;
+      if( m < 3 ) continue;
+
+      const int first = int(_x.size());
+      for( int i = 0; i < m; i++ ) {
+
+        const double xa = loop(i)(0),       ya = loop(i)(1);
+        const double xb = loop((i+1)%m)(0), yb = loop((i+1)%m)(1);
+        const double len = std::sqrt( ( xb - xa )*( xb - xa ) + ( yb - ya )*( yb - ya ) );
+        const int k = std::max( 1, int( std::ceil( len / _r - 1e-9 ) ) );
+
+        for( int j = 0; j < k; j++ ) {
+          _x.push_back( double( T( xa + ( xb - xa ) * j / k ) ) );
+          _y.push_back( double( T( ya + ( yb - ya ) * j / k ) ) );
+        }
+      }
+
+      const int last = int(_x.size());
+      for( int i = first; i < last; i++ ) {
+        _sa.push_back( i );
+        _sb.push_back( i+1 < last ? i+1 : first );
+      }
+    }
+  }
+
+
+  /*! \brief Split segment s at its midpoint
+   *
+   *  \return false if it is too short or the midpoint could not be inserted
+   */
+  template <typename T>
+  bool MeshGenerator<T>::_splitSegment( int s ) {
+
+    const int a = _sa[s], b = _sb[s];
+    const double dx = _x[b] - _x[a], dy = _y[b] - _y[a];
+    if( dx*dx + dy*dy < 1e-4 * _r * _r ) return false;
+
+    const int i = _insert( _x[a] + 0.5*dx, _y[a] + 0.5*dy );
+    if( i < 0 ) return false;
+
+    _sb[s] = i;
+    _sa.push_back( i );
+    _sb.push_back( b );
+    return true;
+  }
+
+
+} // END namespace GMlib
@@ -0,0 +1,129 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+
+/*! \file gmmeshgenerator.h
+ *
+ *  Interface for the MeshGenerator class.
+ */
+
+
+#ifndef GM_TRIANGLESYSTEM_MESHGENERATOR_H
+#define GM_TRIANGLESYSTEM_MESHGENERATOR_H
+
+
+#include "gmdelaunay.h"
+#include "gmtrianglesystem.h"
+
+// gmlib
+#include <core/containers/gmdvector.h>
+#include <core/types/gmangle.h>
+#include <core/types/gmpoint.h>
+
+// stl
+#include <vector>
+
+
+namespace GMlib {
+
+
+  /*! \class MeshGenerator gmmeshgenerator.h <gmMeshGenerator>
+   *  \brief Quality triangle meshes of polygonal domains
+   *
+   *  The domain is an outer polygon with optional polygonal holes. The
+   *  boundary is split in segments no longer than the spacing h, and the
+   *  inside is filled with Poisson-disk samples (no two points closer than
+   *  h) drawn with a uniform background grid, in O(N). The points are
+   *  triangulated by Delaunay, and the mesh is refined as in Ruppert's
+   *  algorithm: encroached boundary segments are split at their midpoint,
+   *  and triangles with a too small angle or a too large area get their
+   *  circumcenter inserted. Refinement runs in rounds, each inserting an
+   *  independent set of points.
+   */
+  template <typename T>
+  class MeshGenerator {
+  public:
+    MeshGenerator();
+
+    bool                          generate();
+    bool                          generate( TriangleFacets<T>& tf );
+
+    const DVector<bool>&          getBoundaryFlags() const;
+    const DVector<int>&           getNeighbours() const;
+    int                           getNoTriangles() const;
+    const DVector< Point<T,2> >&  getPoints() const;
+    const DVector<int>&           getTriangles() const;
+
+    void                          insertHole( const DVector< Point<T,2> >& polygon );
+    void                          setBoundary( const DVector< Point<T,2> >& polygon );
+    void                          setMaxArea( T area );
+    void                          setMinAngle( const Angle& a );
+    void                          setSeed( unsigned int seed );
+    void                          setSpacing( T h );
+
+  private:
+    std::vector< DVector< Point<T,2> > >  _loops;   // Outer boundary first, then the holes
+    T                             _h;
+    T                             _max_area;
+    Angle                         _min_angle;
+    unsigned int                  _seed;
+
+    // Working data
+    double                        _r;               // Spacing in use
+    std::vector<double>           _x, _y;
+    std::vector<int>              _sa, _sb;         // Boundary segments
+    double                        _x0, _y0, _x1, _y1;
+    int                           _rows;            // Segment buckets, one per row of height h
+    int                           _row_count;       // Segments when the buckets were made
+    std::vector<int>              _row_start, _row_seg;
+    Delaunay<T>                   _dt;
+
+    // Result
+    DVector< Point<T,2> >         _p;
+    DVector<int>                  _tri;
+    DVector<int>                  _nbr;
+    DVector<bool>                 _bnd;
+
+    void                          _buildRows();
+    int                           _encroached( double x, double y ) const;
+    void                          _finish();
+    bool                          _inside( double x, double y ) const;
+    int                           _insert( double x, double y );
+    bool                          _refine();
+    void                          _sample();
+    void                          _segments();
+    bool                          _splitSegment( int s );
+
+  }; // END class MeshGenerator
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmmeshgenerator.c"
+
+
+#endif // GM_TRIANGLESYSTEM_MESHGENERATOR_H
@@ -0,0 +1,237 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+
+
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  inline
+  TriangleMesh<T>::TriangleMesh() {}
+
+
+  /*! \brief Area weighted vertex normals from the positions */
+  template <typename T>
+  void TriangleMesh<T>::computeNormals() {
+
+    const int n = _pos.getDim();
+    _nor.setDim( n );
+    for( int i = 0; i < n; i++ ) _nor[i] = Vector<T,3>( T(0), T(0), T(0) );
+
+    for( int h = 0; h < _tri.getDim(); h += 3 ) {
+      const int a = _tri(h), b = _tri(h+1), c = _tri(h+2);
+      const Vector<T,3> ab = _pos(b) - _pos(a);
+      const Vector<T,3> ac = _pos(c) - _pos(a);
+      const Vector<T,3> nt = ab ^ ac;
+      _nor[a] += nt;
+      _nor[b] += nt;
+      _nor[c] += nt;
+    }
+
+    for( int i = 0; i < n; i++ )
+      if( _nor(i).getLength() > T(0) ) _nor[i].normalize();
+      else                             _nor[i] = Vector<T,3>( T(0), T(0), T(1) );
+  }
+
+
+  /*! \brief A half-edge of edge e, the first one of the edge if it has two */
+  template <typename T>
+  inline
+  int TriangleMesh<T>::getEdge( int e ) const {
+
+    return _edge(e);
+  }
+
+
+  /*! \brief The next half-edge of the triangle of h */
+  template <typename T>
+  inline
+  int TriangleMesh<T>::getNext( int h ) const {
+
+    return h % 3 == 2 ? h-2 : h+1;
+  }
+
+
+  template <typename T>
+  inline
+  int TriangleMesh<T>::getNoEdges() const {
+
+    return _edge.getDim();
+  }
+
+
+  template <typename T>
+  inline
+  int TriangleMesh<T>::getNoTriangles() const {
+
+    return _tri.getDim() / 3;
+  }
+
+
+  template <typename T>
+  inline
+  int TriangleMesh<T>::getNoVertices() const {
+
+    return _pos.getDim();
+  }
+
+
+  /*! \brief The opposite half-edge of each half-edge, -1 on the boundary */
+  template <typename T>
+  inline
+  const DVector<int>& TriangleMesh<T>::getNeighbours() const {
+
+    return _nbr;
+  }
+
+
+  template <typename T>
+  inline
+  const DVector< Vector<T,3> >& TriangleMesh<T>::getNormals() const {
+
+    return _nor;
+  }
+
+
+  /*! \brief A half-edge starting at vertex i, -1 if i is in no triangle
+   *
+   *  On the boundary it is the one with no opposite half-edge, so turning
+   *  counter-clockwise from it (getPrevious(), then the opposite) visits
+   *  all edges of the vertex.
+   */
+  template <typename T>
+  inline
+  int TriangleMesh<T>::getOutgoing( int i ) const {
+
+    return _out(i);
+  }
+
+
+  template <typename T>
+  inline
+  const DVector< Point<T,3> >& TriangleMesh<T>::getPositions() const {
+
+    return _pos;
+  }
+
+
+  /*! \brief The positions, to be changed in place (call computeNormals() after) */
+  template <typename T>
+  inline
+  DVector< Point<T,3> >& TriangleMesh<T>::getPositions() {
+
+    return _pos;
+  }
+
+
+  /*! \brief The previous half-edge of the triangle of h */
+  template <typename T>
+  inline
+  int TriangleMesh<T>::getPrevious( int h ) const {
+
+    return h % 3 == 0 ? h+2 : h-1;
+  }
+
+
+  /*! \brief Bytes held by the arrays */
+  template <typename T>
+  size_t TriangleMesh<T>::getSize() const {
+
+    return _pos.getDim()   * sizeof( Point<T,3> )
+         + _nor.getDim()   * sizeof( Vector<T,3> )
+         + _const.getDim() * sizeof( bool )
+         + ( _tri.getDim() + _nbr.getDim() + _edge.getDim() + _out.getDim() ) * sizeof( int );
+  }
+
+
+  /*! \brief Three vertex indices per triangle, counter-clockwise */
+  template <typename T>
+  inline
+  const DVector<int>& TriangleMesh<T>::getTriangles() const {
+
+    return _tri;
+  }
+
+
+  /*! \brief The vertex graph of the edges, in compressed row form
+   *
+   *  The neighbours of vertex i are col[row[i]] ... col[row[i+1]-1],
+   *  counter-clockwise. Same graph as TriangleFacets::getVertexAdjacency(),
+   *  found by walking the half-edges instead of following pointers.
+   */
+  template <typename T>
+  void TriangleMesh<T>::getVertexAdjacency( DVector<int>& row, DVector<int>& col ) const {
+
+    const int n = _pos.getDim();
+
+    // The walk around a vertex, the visitor gets each neighbour
+    auto walk = [this]( int i, auto visit ) {
+      const int h0 = _out(i);
+      if( h0 < 0 ) return;
+      int h = h0;
+      do {
+        visit( _tri( getNext(h) ) );
+        const int p = getPrevious(h);
+        h = _nbr(p);
+        if( h < 0 ) visit( _tri(p) );
+      } while( h >= 0 && h != h0 );
+    };
+
+    row.setDim( n+1 );
+    row[0] = 0;
+    for( int i = 0; i < n; i++ ) {
+      int k = 0;
+      walk( i, [&k]( int ) { k++; } );
+      row[i+1] = row[i] + k;
+    }
+
+    col.setDim( row[n] );
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for( int i = 0; i < n; i++ ) {
+      int k = row(i);
+      walk( i, [&col, &k]( int j ) { col[k++] = j; } );
+    }
+  }
+
+
+  /*! \brief True if vertex i is on the boundary of the mesh */
+  template <typename T>
+  inline
+  bool TriangleMesh<T>::isBoundary( int i ) const {
+
+    return _out(i) >= 0 && _nbr( _out(i) ) < 0;
+  }
+
+
+  template <typename T>
+  inline
+  bool TriangleMesh<T>::isConst( int i ) const {
+
+    return _const(i);
+  }
+
+
+} // END namespace GMlib
@@ -0,0 +1,115 @@
+/**********************************************************************************
+**
+** Copyright (C) 1994 Narvik University College
+** Contact: GMlib Online Portal at http://episteme.hin.no
+**
+** This file is part of the Geometric Modeling Library, GMlib.
+**
+** GMlib is free software: you can redistribute it and/or modify
+** it under the terms of the GNU Lesser General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** GMlib is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU Lesser General Public License for more details.
+**
+** You should have received a copy of the GNU Lesser General Public License
+** along with GMlib.  If not, see <http://www.gnu.org/licenses/>.
+**
+**********************************************************************************/
+/*! \file gmtrianglemesh.h
+ *
+ *  Interface for the TriangleMesh class.
+ */
+
+
+#ifndef GM_TRIANGLESYSTEM_TRIANGLEMESH_H
+#define GM_TRIANGLESYSTEM_TRIANGLEMESH_H
+
+
+// gmlib
+#include <core/containers/gmdvector.h>
+#include <core/types/gmpoint.h>
+
+// stl
+#include <cstddef>
+
+
+namespace GMlib {
+
+
+  template <typename T>
+  class TriangleFacets;
+
+
+  /*! \class TriangleMesh gmtrianglemesh.h <gmTriangleMesh>
+   *  \brief Compact, index based export of a triangle mesh
+   *
+   *  TriangleFacets keeps every vertex, edge and triangle as an object of
+   *  its own, linked by pointers, which is what incremental insertion and
+   *  edge swaps work on, and it stays the storage of the mesh. This class
+   *  is a copy of the mesh in a few contiguous arrays, for everything that
+   *  only walks it:
+   *
+   *  - position, normal and constant flag of every vertex
+   *  - three vertex indices per triangle, counter-clockwise. Half-edge
+   *    h = 3t+j runs from vertex tri[h] to vertex tri[3t+(j+1)%3]
+   *  - the opposite half-edge of every half-edge, -1 on the boundary
+   *  - one half-edge of every edge, and one outgoing half-edge of every
+   *    vertex (a boundary one on the boundary)
+   *
+   *  This is about 90 bytes per vertex for T = float, a fraction of the
+   *  vertex, edge and triangle objects. The indices are those of
+   *  TriangleFacets::getVertex(), getEdge() and getTriangle().
+   *  TriangleFacets::getMesh() takes the copy, later edits of the facets
+   *  are not seen by it. TriangleFacets::setMesh() makes the objects again.
+   */
+  template <typename T>
+  class TriangleMesh {
+  public:
+    TriangleMesh();
+
+    void                          computeNormals();
+
+    int                           getEdge( int e ) const;
+    int                           getNext( int h ) const;
+    int                           getNoEdges() const;
+    int                           getNoTriangles() const;
+    int                           getNoVertices() const;
+    const DVector<int>&           getNeighbours() const;
+    const DVector< Vector<T,3> >& getNormals() const;
+    int                           getOutgoing( int i ) const;
+    const DVector< Point<T,3> >&  getPositions() const;
+    DVector< Point<T,3> >&        getPositions();
+    int                           getPrevious( int h ) const;
+    size_t                        getSize() const;
+    const DVector<int>&           getTriangles() const;
+    void                          getVertexAdjacency( DVector<int>& row, DVector<int>& col ) const;
+
+    bool                          isBoundary( int i ) const;
+    bool                          isConst( int i ) const;
+
+  private:
+    DVector< Point<T,3> >         _pos;
+    DVector< Vector<T,3> >        _nor;
+    DVector<bool>                 _const;
+    DVector<int>                  _tri;     // Three vertices per triangle
+    DVector<int>                  _nbr;     // Opposite half-edge, -1 on the boundary
+    DVector<int>                  _edge;    // A half-edge of every edge
+    DVector<int>                  _out;     // An outgoing half-edge of every vertex, -1 if none
+
+  friend class TriangleFacets<T>;
+
+  }; // END class TriangleMesh
+
+
+} // END namespace GMlib
+
+
+// Include implementations
+#include "gmtrianglemesh.c"
+
+
+#endif // GM_TRIANGLESYSTEM_TRIANGLEMESH_H
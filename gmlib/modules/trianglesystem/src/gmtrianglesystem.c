@@ -23,16 +23,22 @@
 
 
 #include "visualizers/gmtrianglefacetsdefaultvisualizer.h"
+#include "gmdelaunay.h"
 
 // stl
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <unordered_map>
 
 
 namespace GMlib {
 
   template <class T>
-  TriangleFacets<T>* TriangleSystem<T>::_tv = NULL;
+  thread_local TriangleFacets<T>* TriangleSystem<T>::_tv = NULL;
+
+  template <typename T>
+  std::atomic<unsigned int> TSVertex<T>::_moves( 0 );
 
   template <typename T>
   inline
@@ -42,8 +48,8 @@ namespace GMlib {
 
     //setStreamMode();
     _dlist_name=0;
-    glGenBuffers( 1, &_vbo );
-    glGenBuffers( 1, &_ibo );
+    _revision=0;
+    _vgrid_size=-1;
 
     _default_visualizer = 0x0;
   }
@@ -58,8 +64,8 @@ namespace GMlib {
     for(int i=0; i<v.size(); i++) (*this)[i] = v(i);
 
     _dlist_name = 0;
-    glGenBuffers( 1, &_vbo );
-    glGenBuffers( 1, &_ibo );
+    _revision = 0;
+    _vgrid_size = -1;
 
     _default_visualizer = 0x0;
   }
@@ -68,56 +74,8 @@ namespace GMlib {
   template <typename T>
   TriangleFacets<T>::~TriangleFacets() {
 
-    int k=0,r=0,s=0,p=0;
-    int i,j;
-    for(i=0; i < _tri_order.getDim1(); i++)
-    {
-      for(j=0; j< _tri_order.getDim2(); j++)
-      {
-        r += _tri_order[i][j].getMaxSize();
-        s += _tri_order[i][j].getSize();
-        k += _tri_order[i][j].getMaxSize() - _tri_order[i][j].getSize();
-        if(_tri_order[i][j].getMaxSize() > 20) p++;
-      }
-    }
-
-    int ptbt=8*_tri_order.getDim1()*_tri_order.getDim2()+8 + 8*_tri_order.getDim1();
-
-    std::cout << "antall element strre enn 20: " << p << " Av totalt: "
-       << _tri_order.getDim1()*_tri_order.getDim2() << std::endl;
-
-    std::cout << "Total byte pr element i matrise  : "
-       << (4*r)/double(_tri_order.getDim1()*_tri_order.getDim2()) << std::endl;
-
-    std::cout << "Total kbyte bruk i matrise  : " << (4*r + ptbt)/1024 << std::endl;
-    std::cout << "Minimum kbyte bruk i matrise: " << (4*s + ptbt)/1024 << std::endl;
-    std::cout << "For mye kbyte bruk i matrise: " << (4*k)/1024  << std::endl;
-
-    std::cout << "Total byte pr pkt i matrise  : " << (4*r + ptbt)/double(this->getSize()) << std::endl;
-    std::cout << "Minimum byte pr pkt i matrise: " << (4*s + ptbt)/double(this->getSize()) << std::endl;
-    std::cout << "For mye byte pr pkt i matrise: " << (4*k)/double(this->getSize()) << std::endl;
-
-    for(k=i=0; i< this->getSize(); i++) k += 4+8+4*(*this)[i].getEdges().getMaxSize();
-    for(i=0; i< _edges.getSize(); i++) k += 4*5;
-    for(i=0; i< _triangles.getSize(); i++) k += 14;
-
-
-    std::cout << "Totalt brukt memory :" << (4*r+ptbt+k)/1024 << " kbyte\n";
-
-
-    for(r=k=i=0; i< this->getSize(); i++)
-    {
-      k += (*this)[i].getEdges().getSize();
-      r += (*this)[i].getEdges().getMaxSize();
-    }
-    std::cout << "Antall edger i snitt i Verticene: " << double(k)/i << std::endl;
-    std::cout << "Max edger i snitt i Verticene   : " << double(r)/i << std::endl;
-
     clear();
 
-    glDeleteBuffers( 1, &_vbo );
-    glDeleteBuffers( 1, &_ibo );
-
     enableDefaultVisualizer( false );
     if( _default_visualizer )
       delete _default_visualizer;
@@ -246,24 +204,158 @@ namespace GMlib {
   template <typename T>
   TSVertex<T>*  TriangleFacets<T>::_find( const Point<T,3>& p ) const {
 
-    int i;
-    for( i = 0; i < this->getSize(); i++ )
-      if( this->getElement(i).getPosition() == p) break;
+    const int i = _findIndex( p, false );
 
-    if (i < this->getSize()) return &( this->getElement(i));
+    if (i >= 0) return &( this->getElement(i));
     else			return NULL;
   }
 
 
+  /** TSEdge<T>* TriangleFacets<T>::_find( const Point<T,3>& p1, const Point<T,3>& p2 ) const
+   *  \brief The edge between the vertices at p1 and p2
+   *
+   *  The first vertex is found through the vertex grid, the edge
+   *  through its edge list.
+   */
   template <typename T>
   TSEdge<T>*   TriangleFacets<T>::_find( const Point<T,3>& p1, const Point<T,3>& p2 ) const {
 
-    int i;
-    for(i=0; i<_edges.getSize(); i++)
-      if( _edges(i)->hasPoints( p1, p2 ) ) break;
+    TSVertex<T> *v = _find( p1 );
+    if( !v ) return NULL;
 
-    if (i < _edges.getSize()) return _edges(i);
-    else			return NULL;
+    ArrayT<TSEdge<T>*>& edges = v->getEdges();
+    for( int i = 0; i < edges.getSize(); i++ )
+      if( edges[i]->getOtherVertex(*v)->getPosition() == p2 )
+        return edges[i];
+
+    return NULL;
+  }
+
+
+  /** int TriangleFacets<T>::_findIndex( const Point<T,3>& p, bool param ) const
+   *  \brief Lowest index of a vertex equal to p, -1 if none
+   *
+   *  Looks in the grid cell of p and its neighbours. The cells are never
+   *  smaller than the point tolerance, so this finds the same vertex as a
+   *  linear search. If param is true only the parameter (x,y) is compared,
+   *  as in TSVertex::operator==.
+   *
+   *  The grid is rebuilt when the number of vertices has changed behind its
+   *  back, or when a vertex has been moved in the plane by setPos(). Moves
+   *  through the Point interface of the vertex are not tracked.
+   */
+  template <typename T>
+  int TriangleFacets<T>::_findIndex( const Point<T,3>& p, bool param ) const {
+
+    if( this->getSize() == 0 ) return -1;
+    if( _vgrid_size != this->getSize() ||
+        _vgrid_moves != TSVertex<T>::_moves.load( std::memory_order_relaxed ) ) _vgridBuild();
+
+    const int c  = _vgridCell( p );
+    const int ci = c % _vgrid_nx;
+    const int cj = c / _vgrid_nx;
+
+    int idx = -1;
+    for( int j = std::max( cj-1, 0 ); j <= std::min( cj+1, _vgrid_ny-1 ); j++ )
+      for( int i = std::max( ci-1, 0 ); i <= std::min( ci+1, _vgrid_nx-1 ); i++ )
+        for( int k = _vgrid_head[j*_vgrid_nx + i]; k >= 0; k = _vgrid_next[k] ) {
+
+          if( idx >= 0 && k > idx ) continue;
+
+          const TSVertex<T> &v = this->getElement(k);
+          if( param ? v.getParameter() == Point<T,2>(p) : v.getPosition() == p )
+            idx = k;
+        }
+
+    return idx;
+  }
+
+
+  /** void TriangleFacets<T>::_vgridBuild() const
+   *  \brief Bucket all vertices in a uniform grid
+   *
+   *  About one vertex per cell, also for long thin point sets.
+   */
+  template <typename T>
+  void TriangleFacets<T>::_vgridBuild() const {
+
+    const int n = this->getSize();
+    _vgrid_moves = TSVertex<T>::_moves.load( std::memory_order_relaxed );
+
+    T x0, x1, y0, y1;
+    x0 = x1 = this->getElement(0).getPos()(0);
+    y0 = y1 = this->getElement(0).getPos()(1);
+    for( int k = 1; k < n; k++ ) {
+      const Point<T,3> &p = this->getElement(k).getPos();
+      x0 = std::min( x0, p(0) );  x1 = std::max( x1, p(0) );
+      y0 = std::min( y0, p(1) );  y1 = std::max( y1, p(1) );
+    }
+
+    const T dx = x1 - x0;
+    const T dy = y1 - y0;
+    T h = std::sqrt( dx*dy / n );
+    h = std::max( h, std::max( dx, dy ) / n );
+    h = std::max( h, T(std::sqrt( POS_TOLERANCE )) );
+
+    _vgrid_x  = x0;
+    _vgrid_y  = y0;
+    _vgrid_h  = h;
+    _vgrid_nx = int( dx / h ) + 1;
+    _vgrid_ny = int( dy / h ) + 1;
+
+    _vgrid_head.setDim( _vgrid_nx * _vgrid_ny );
+    _vgrid_head.clear( -1 );
+    _vgrid_next.resize( n );
+
+    // Link backwards so each bucket lists its vertices in index order
+    for( int k = n-1; k >= 0; k-- ) _vgridLink( k );
+
+    _vgrid_size  = n;
+    _vgrid_built = n;
+  }
+
+
+  template <typename T>
+  inline
+  int TriangleFacets<T>::_vgridCell( const Point<T,3>& p ) const {
+
+    const int i = std::min( std::max( int( std::floor( ( p(0) - _vgrid_x ) / _vgrid_h ) ), 0 ), _vgrid_nx-1 );
+    const int j = std::min( std::max( int( std::floor( ( p(1) - _vgrid_y ) / _vgrid_h ) ), 0 ), _vgrid_ny-1 );
+    return j*_vgrid_nx + i;
+  }
+
+
+  template <typename T>
+  inline
+  void TriangleFacets<T>::_vgridLink( int i ) const {
+
+    if( int(_vgrid_next.size()) <= i ) _vgrid_next.resize( i+1 );
+
+    const int c = _vgridCell( this->getElement(i).getPos() );
+    _vgrid_next[i] = _vgrid_head[c];
+    _vgrid_head[c] = i;
+  }
+
+
+  /** bool TriangleFacets<T>::_vgridUnlink( int i ) const
+   *  \brief Take vertex i out of its bucket
+   *
+   *  Returns false, and invalidates the grid, if the vertex has been moved
+   *  out of the bucket it was inserted in.
+   */
+  template <typename T>
+  bool TriangleFacets<T>::_vgridUnlink( int i ) const {
+
+    const int c = _vgridCell( this->getElement(i).getPos() );
+
+    for( int *k = &_vgrid_head[c]; *k >= 0; k = &_vgrid_next[*k] )
+      if( *k == i ) {
+        *k = _vgrid_next[i];
+        return true;
+      }
+
+    _vgrid_size = -1;
+    return false;
   }
 
 
@@ -271,6 +363,7 @@ namespace GMlib {
   void TriangleFacets<T>::_insertTriangle( TSTriangle<T>* t ) {
 
     _triangles += t;
+    _revision++;
 
     t->_updateBox( _u, _v, _d );
 
@@ -294,6 +387,7 @@ namespace GMlib {
   void TriangleFacets<T>::_removeTriangle( TSTriangle<T>* t ) {
 
     _triangles.remove(t);
+    _revision++;
 
     Box<unsigned char,2> b	= t->_getBox();
 
@@ -328,6 +422,51 @@ namespace GMlib {
   }
 
 
+  /** void TriangleFacets<T>::_setTriOrder( int d )
+   *  \brief Build the bucket grid of triangles
+   *
+   *  A 2^d x 2^d grid over the bounding box, d <= 8. Every triangle is put
+   *  into the buckets its box overlaps.
+   */
+  template <typename T>
+  void TriangleFacets<T>::_setTriOrder( int d ) {
+
+    int i,j;
+    _d = d;
+    int n = 1 << _d;
+
+    _tri_order.setDim(n,n);
+    _u.clear();
+    _v.clear();
+    _u.setMaxSize(n+1);
+    _v.setMaxSize(n+1);
+
+    for(i=0; i<= n; i++)
+    {
+      _u += _box.getValueMin(0) + i*_box.getValueDelta(0)/n;
+      _v += _box.getValueMin(1) + i*_box.getValueDelta(1)/n;
+    }
+
+    for(i=0; i< n; i++)
+      for(j=0; j< n; j++)
+      {
+        _tri_order[i][j].clear();
+        _tri_order[i][j].setMaxSize(20);
+      }
+
+    for( int k = 0; k < _triangles.getSize(); k++ ) {
+
+      TSTriangle<T>* t = _triangles[k];
+      t->_updateBox( _u, _v, _d );
+
+      Box<unsigned char,2> b = t->_getBox();
+      for( i = b.getValueAt(0,0); i <= b.getValueAt(1,0); i++ )
+        for( j = b.getValueAt(0,1); j <= b.getValueAt(1,1); j++ )
+          _tri_order[i][j] += t;
+    }
+  }
+
+
   template <typename T>
   int  TriangleFacets<T>::_surroundingTriangle( TSTriangle<T>*& t, const TSVertex<T>& v ) {
 
@@ -414,11 +553,13 @@ namespace GMlib {
 
     _triangles.clear();
     _edges.clear();
+    _revision++;
 
   _vorpnts.clear();
   _voredges.clear();
 
     ArrayLX<TSVertex<T>>::clear();
+    _vgrid_size = -1;
 
     if (d >= 0)
       _d = d;
@@ -519,6 +660,74 @@ namespace GMlib {
   }
 
 
+  /** void TriangleFacets<T>::getMesh( TriangleMesh<T>& mesh ) const
+   *  \brief A copy of the mesh in compact, index based form
+   *
+   *  One pass over the vertices, edges and triangles after a pointer to
+   *  index map of the vertices and edges is built, O(V + E + T).
+   */
+  template <typename T>
+  void TriangleFacets<T>::getMesh( TriangleMesh<T>& mesh ) const {
+
+    const int n  = this->getSize();
+    const int ne = _edges.getSize();
+    const int nt = _triangles.getSize();
+
+    std::unordered_map<const TSVertex<T>*, int> index;
+    index.reserve( n );
+    mesh._pos.setDim( n );
+    mesh._nor.setDim( n );
+    mesh._const.setDim( n );
+    for( int i = 0; i < n; i++ ) {
+      const TSVertex<T>* v = getVertex(i);
+      index[v]        = i;
+      mesh._pos[i]    = v->getPosition();
+      mesh._nor[i]    = v->getNormal();
+      mesh._const[i]  = v->isConst();
+    }
+
+    std::unordered_map<const TSEdge<T>*, int> edge;
+    edge.reserve( ne );
+    for( int e = 0; e < ne; e++ )
+      edge[ _edges(e) ] = e;
+
+    // Triangle edges are (v0,v1), (v1,v2), (v2,v0), as in
+    // TSTriangle::getVertices(), so edge j is half-edge 3t+j
+
+    mesh._tri.setDim( 3*nt );
+    mesh._nbr.setDim( 3*nt );
+    mesh._edge.setDim( ne );
+    for( int e = 0; e < ne; e++ ) mesh._edge[e] = -1;
+
+    for( int t = 0; t < nt; t++ ) {
+
+      TSEdge<T>* const* te = _triangles(t)->_edge;
+      mesh._tri[3*t]   = index[ te[2]->getCommonVertex( *te[0] ) ];
+      mesh._tri[3*t+1] = index[ te[0]->getCommonVertex( *te[1] ) ];
+      mesh._tri[3*t+2] = index[ te[1]->getCommonVertex( *te[2] ) ];
+
+      for( int j = 0; j < 3; j++ ) {
+        const int h = 3*t+j;
+        const int e = edge[ te[j] ];
+        mesh._nbr[h] = -1;
+        if( mesh._edge[e] < 0 )
+          mesh._edge[e] = h;
+        else {
+          mesh._nbr[h] = mesh._edge[e];
+          mesh._nbr[ mesh._edge[e] ] = h;
+        }
+      }
+    }
+
+    mesh._out.setDim( n );
+    for( int i = 0; i < n; i++ ) mesh._out[i] = -1;
+    for( int h = 0; h < 3*nt; h++ ) {
+      int& o = mesh._out[ mesh._tri[h] ];
+      if( o < 0 || mesh._nbr[h] < 0 ) o = h;
+    }
+  }
+
+
   template <typename T>
   inline
   int TriangleFacets<T>::getNoVertices()	const {
@@ -543,6 +752,21 @@ namespace GMlib {
   }
 
 
+  /** int TriangleFacets<T>::getTopologyRevision() const
+   *  \brief Changes whenever triangles are inserted or removed
+   *
+   *  Also changes when vertex indices change. Data derived from the
+   *  topology, like an index buffer, only has to be rebuilt when the
+   *  revision differs from the one it was built from.
+   */
+  template <typename T>
+  inline
+  int TriangleFacets<T>::getTopologyRevision() const {
+
+    return _revision;
+  }
+
+
   template <typename T>
   inline
   TSTriangle<T>* TriangleFacets<T>::getTriangle( int i )	const {
@@ -551,6 +775,29 @@ namespace GMlib {
   }
 
 
+  /** void TriangleFacets<T>::getTriangleIndices( DVector<int>& indices ) const
+   *  \brief The vertex indices of all triangles, three per triangle
+   *
+   *  A pointer to index map is built first, so the cost is O(V + T).
+   */
+  template <typename T>
+  void TriangleFacets<T>::getTriangleIndices( DVector<int>& indices ) const {
+
+    std::unordered_map<const TSVertex<T>*, int> index;
+    index.reserve( this->getSize() );
+    for( int i = 0; i < this->getSize(); i++ )
+      index[ getVertex(i) ] = i;
+
+    indices.setDim( 3 * _triangles.getSize() );
+    for( int i = 0; i < _triangles.getSize(); i++ ) {
+
+      Array< TSVertex<T>* > v = _triangles(i)->getVertices();
+      for( int j = 0; j < 3; j++ )
+        indices[3*i+j] = index[ v[j] ];
+    }
+  }
+
+
   template <typename T>
   inline
   TSVertex<T>* TriangleFacets<T>::getVertex( int i )	const	{
@@ -559,6 +806,39 @@ namespace GMlib {
   }
 
 
+  /** void TriangleFacets<T>::getVertexAdjacency( DVector<int>& row, DVector<int>& col ) const
+   *  \brief The vertex graph of the edges, in compressed row form
+   *
+   *  The neighbours of vertex i are col[row[i]] ... col[row[i+1]-1], in the
+   *  order of the vertex' edges. This is the graph the orderings of
+   *  GMgraph take.
+   */
+  template <typename T>
+  void TriangleFacets<T>::getVertexAdjacency( DVector<int>& row, DVector<int>& col ) const {
+
+    const int n = this->getSize();
+
+    std::unordered_map<const TSVertex<T>*, int> index;
+    index.reserve( n );
+    for( int i = 0; i < n; i++ )
+      index[ getVertex(i) ] = i;
+
+    row.setDim( n+1 );
+    row[0] = 0;
+    for( int i = 0; i < n; i++ )
+      row[i+1] = row[i] + getVertex(i)->_edges.getSize();
+
+    col.setDim( row[n] );
+    for( int i = 0; i < n; i++ ) {
+
+      // By pointer, getOtherVertex() compares positions
+      const ArrayT<TSEdge<T>*>& e = getVertex(i)->_edges;
+      for( int k = 0; k < e.getSize(); k++ )
+        col[row[i]+k] = index[ e(k)->_vertex[ e(k)->_vertex[0] == getVertex(i) ? 1 : 0 ] ];
+    }
+  }
+
+
   template <typename T>
   const Array<TSVEdge<T> >& TriangleFacets<T>::getVoronoiEdges() const {
 
@@ -674,12 +954,18 @@ namespace GMlib {
 
     bool inserted = true;
 
-    int i = this->getIndex( v );
+    int i = _findIndex( v.getPosition(), true );
 
     if (i<0) {
 
-      insertAlways(v);
+      this->insertAlways(v);
       i = this->getSize()-1;
+
+      // Keep the grid in sync, rebuild it when it has doubled
+      if( _vgrid_size == i && 2*_vgrid_built > i ) {
+        _vgridLink( i );
+        _vgrid_size++;
+      }
     }
     else
       inserted = false;
@@ -696,6 +982,11 @@ namespace GMlib {
 
     _set(i);
 
+    // Refine the bucket grid of triangles when the buckets get crowded,
+    // the locate above scans a bucket linearly
+    if( _d < 8 && _triangles.getSize() > ( 64 << (2*_d) ) )
+      _setTriOrder( _d+1 );
+
     return inserted;
   }
 
@@ -706,16 +997,28 @@ namespace GMlib {
 
     __e.set(*this);
 
-    int id = this->getIndex(v);
+    int id = _findIndex( v.getPosition(), true );
     if( id < 0 ) return false;
 
     v._deleteEdges();
 
-    ArrayT<TSEdge<T>*> edges = (*this)[this->getSize()-1].getEdges();
+    // The last vertex is moved into the slot of the removed one
+    const int last = this->getSize()-1;
+    const bool grid = _vgrid_size == this->getSize() &&
+                      _vgridUnlink( id ) && ( id == last || _vgridUnlink( last ) );
+
+    ArrayT<TSEdge<T>*> edges = (*this)[last].getEdges();
     for ( int i=0; i < edges.getSize(); i++ )
-      edges[i]->_swapVertex((*this)[this->getSize() - 1],(*this)[id]);
+      edges[i]->_swapVertex((*this)[last],(*this)[id]);
 
-    return this->removeIndex(id);
+    const bool removed = this->removeIndex(id);
+
+    if( grid ) {
+      if( id != last ) _vgridLink( id );
+      _vgrid_size--;
+    }
+
+    return removed;
   }
 
 
@@ -797,6 +1100,96 @@ namespace GMlib {
       _tmptiles[i]->render();*/
   }
 
+  /** bool TriangleFacets<T>::renumberVertices( const DVector<int>& perm )
+   *  \brief Reorder the vertex storage
+   *
+   *  \param[in] perm New-to-old permutation: vertex k is the old vertex perm[k]
+   *
+   *  The vertices are moved in place and the edges are pointed at their new
+   *  addresses, so pointers to vertices held outside the mesh are no longer
+   *  valid. The edges and triangles are then sorted by their lowest vertex,
+   *  so that traversals of all three follow the new vertex order. With a
+   *  bandwidth reducing permutation (GMgraph::reverseCuthillMcKee() of
+   *  getVertexAdjacency()) neighbouring vertices end up close in memory.
+   *
+   *  Returns false, and changes nothing, if perm is not a permutation.
+   */
+  template <typename T>
+  bool TriangleFacets<T>::renumberVertices( const DVector<int>& perm ) {
+
+    __e.set( *this );
+
+    const int n = this->getSize();
+    if( perm.getDim() != n ) return false;
+
+    DVector<int> pinv( n, -1 );
+    for( int k = 0; k < n; k++ ) {
+      const int o = perm(k);
+      if( o < 0 || o >= n || pinv[o] >= 0 ) return false;
+      pinv[o] = k;
+    }
+
+    // New index of each vertex address, the addresses are reused
+
+    std::unordered_map<const TSVertex<T>*, int> index;
+    index.reserve( n );
+    for( int i = 0; i < n; i++ )
+      index[ getVertex(i) ] = pinv[i];
+
+    const int ne = _edges.getSize();
+    std::vector<int> ev( 2*ne );
+    for( int i = 0; i < ne; i++ )
+      for( int j = 0; j < 2; j++ )
+        ev[2*i+j] = index[ _edges[i]->_vertex[j] ];
+
+    std::vector<int> tv( _triangles.getSize() );
+    for( int i = 0; i < _triangles.getSize(); i++ ) {
+      Array< TSVertex<T>* > v = _triangles[i]->getVertices();
+      tv[i] = std::min( index[v[0]], std::min( index[v[1]], index[v[2]] ) );
+    }
+
+    // Move the vertices
+
+    {
+      std::vector< TSVertex<T> > old;
+      old.reserve( n );
+      for( int i = 0; i < n; i++ )
+        old.push_back( (*this)[i] );
+      for( int k = 0; k < n; k++ )
+        (*this)[k] = old[perm(k)];
+    }
+
+    for( int i = 0; i < ne; i++ )
+      for( int j = 0; j < 2; j++ )
+        _edges[i]->_vertex[j] = getVertex( ev[2*i+j] );
+
+    // Edges and triangles by their lowest vertex
+
+    auto sortBy = []( auto& a, const std::vector<int>& key ) {
+
+      const int m = int( key.size() );
+      std::vector<int> order( m );
+      for( int i = 0; i < m; i++ ) order[i] = i;
+      std::stable_sort( order.begin(), order.end(), [&key]( int x, int y ) { return key[x] < key[y]; } );
+
+      std::vector< typename std::decay<decltype( a[0] )>::type > tmp( m );
+      for( int i = 0; i < m; i++ ) tmp[i] = a[order[i]];
+      for( int i = 0; i < m; i++ ) a[i] = tmp[i];
+    };
+
+    std::vector<int> ek( ne );
+    for( int i = 0; i < ne; i++ ) ek[i] = std::min( ev[2*i], ev[2*i+1] );
+    sortBy( _edges, ek );
+
+    sortBy( _triangles, tv );
+
+    _vgrid_size = -1;
+    _revision++;
+
+    return true;
+  }
+
+
   template <typename T>
   void TriangleFacets<T>::replot() {
     Sphere<float,3> s( getVertex(0)->getPos() );
@@ -832,157 +1225,132 @@ namespace GMlib {
   }
 
 
+  /** void TriangleFacets<T>::triangulateDelaunay( bool parallel )
+   *  \brief Delaunay triangulation of the vertices
+   *
+   *  The triangulation is computed by Delaunay (BRIO/Hilbert insertion
+   *  order, walking point location, compact half-edge store) and then
+   *  turned into TSEdge/TSTriangle objects. Edges between two constant
+   *  vertices are not flipped. The boundary is the convex hull.
+   *
+   *  With parallel = true the vertices are split in strips triangulated on
+   *  one thread each and merged (Delaunay::triangulateParallel()). The mesh
+   *  is the same, constant vertices make it fall back to the serial path.
+   *
+   *  The mesh a thread works on is kept per thread, so different meshes can
+   *  be triangulated from different threads at the same time.
+   */
   template <typename T>
-  void TriangleFacets<T>::triangulateDelaunay() {
+  void TriangleFacets<T>::triangulateDelaunay( bool parallel ) {
 
     __e.set( *this );
 
-    int i,j;
+    const int n = this->getSize();
+    if( n < 3 ) return;
 
-    if( this->getSize() < 3 ) return;
-
-    ArrayLX<TSVertex<T> >& vertex = *this;
-
-    // Set the size of edge and triangle array to the upper bound.
-    // Remember that there is only 3 outer edges.
-
-    _edges.setMaxSize(3* this->getSize()+3);
-    _triangles.setMaxSize(2* this->getSize()+1);
-
-    // Make surrounding box and tree new vertices
-
-    _box.reset(vertex[0].getPosition());
-
-    for (i=1; i<vertex.getSize(); i++)
-      _box += vertex[i].getPosition();
-
-    double dx	  = _box.getValueDelta(0);
-    double dy	  = _box.getValueDelta(1);
-    double delta  = dx>dy?dx:dy;
-
-    TSVertex<T> p1(_box.getValueMin(0) - delta,   _box.getValueMin(1) - delta);
-    TSVertex<T> p2(_box.getValueMax(0) + 3*delta, _box.getValueMin(1) - delta);
-    TSVertex<T> p3(_box.getValueMin(0) - delta,   _box.getValueMax(1) + 3*delta);
-
-    vertex += p1;
-    vertex += p2;
-    vertex += p3;
-
-    // Make tree Edges.
-
-    _edges += new TSEdge<T>(vertex[vertex.getSize()-3], vertex[vertex.getSize()-2]);
-    _edges += new TSEdge<T>(vertex[vertex.getSize()-2], vertex[vertex.getSize()-1]);
-    _edges += new TSEdge<T>(vertex[vertex.getSize()-1], vertex[vertex.getSize()-3]);
-
-    // Make a triangle.
-
-    _triangles += new TSTriangle<T>(_edges[0],_edges[1],_edges[2]);
+    DVector< Point<T,2> > p( n );
+    DVector<bool>         fixed( n );
+    for( int i = 0; i < n; i++ ) {
+      const TSVertex<T> &v = (*this)[i];
+      p[i]     = v.getParameter();
+      fixed[i] = v.isConst();
+    }
 
-    _edges[0]->_setTriangle(_triangles[0],NULL);
-    _edges[1]->_setTriangle(_triangles[0],NULL);
-    _edges[2]->_setTriangle(_triangles[0],NULL);
+    Delaunay<T> dt;
+    if( parallel ) dt.triangulateParallel( p, fixed );
+    else           dt.triangulate( p, fixed );
 
-    //**********************************************************************
-    // Here we constuct the dervided structure for speeding up the algoritm
-    //**********************************************************************
+    _setTopology( dt.getTriangles(), dt.getNeighbours() );
+  }
 
-    if(this->getSize() < 200)         _d = 2;
-    else if(this->getSize() < 800)    _d = 3;
-    else if(this->getSize() < 3200)   _d = 4;
-    else if(this->getSize() < 12800)  _d = 5;
-    else if(this->getSize() < 51200)  _d = 6;
-    else if(this->getSize() < 204800) _d = 7;
-    else                              _d = 8;
 
-    int n = 1 << _d;
+  /** void TriangleFacets<T>::setMesh( const TriangleMesh<T>& mesh )
+   *  \brief Replace the mesh by a compact one
+   *
+   *  The vertices, edges and triangles are made from the arrays of mesh,
+   *  in its order, so getMesh() gives back the same arrays (the edges are
+   *  numbered by their first half-edge).
+   */
+  template <typename T>
+  void TriangleFacets<T>::setMesh( const TriangleMesh<T>& mesh ) {
 
-    _tri_order.setDim(n,n);
-    _u.setMaxSize(n+1);
-    _v.setMaxSize(n+1);
+    clear();
 
-    for(i=0; i<= n; i++)
-    {
-      _u += _box.getValueMin(0) + i*_box.getValueDelta(0)/n;
-      _v += _box.getValueMin(1) + i*_box.getValueDelta(1)/n;
+    const int n = mesh.getNoVertices();
+    this->setMaxSize( n );
+    for( int i = 0; i < n; i++ ) {
+      TSVertex<T> v( mesh._pos(i), mesh._nor(i) );
+      v.setConst( mesh._const(i) );
+      this->insertAlways( v );
     }
 
-    for(i=0; i< n; i++)
-      for(j=0; j< n; j++)
-      {
-        _tri_order[i][j].setMaxSize(20);//,10);
-        _tri_order[i][j] += _triangles[0];
-      }
-
-    //*****************************************************
-    // End dervided structure for speeding up the algoritm
-    //*****************************************************
+    if( mesh.getNoTriangles() == 0 ) return;
 
+    __e.set( *this );
+    _setTopology( mesh._tri, mesh._nbr );
+  }
 
-    // Go through all vertices and if a vertex is on an edge split the edge
-    // and the two neighbour triangles, or if the vertex is inside one triangle
-    // split the triangle into tree treangles.
-
-    for ( i = 0; i < vertex.getSize()-3; i++ ) _set(i);
-
-    // remove constructed outer triangles
-
-    _removeLastVertex();
-    _removeLastVertex();
-    _removeLastVertex();
 
-    // Insert Edges and Triangles to make a convecs boundary
+  /** void TriangleFacets<T>::_setTopology( const DVector<int>& tri, const DVector<int>& nbr )
+   *  \brief Build edges and triangles from index triangles
+   *
+   *  \param[in] tri Three vertex indices per triangle, counter-clockwise
+   *  \param[in] nbr The opposite half-edge of each half-edge, -1 on the boundary
+   *
+   *  One TSEdge is made per pair of half-edges. Triangle edges are ordered
+   *  (a,b), (b,c), (c,a), and the first triangle of an edge is the one on
+   *  its left. The bucket grid used for point location is rebuilt.
+   */
+  template <typename T>
+  void TriangleFacets<T>::_setTopology( const DVector<int>& tri, const DVector<int>& nbr ) {
 
-    int n_bound=0;
-    for(i=0; i< _edges.getSize(); i++)
-      if(_edges[i]->boundary())
-      {
-        n_bound++;
-        TSTriangle<T>* t = _edges[i]->_getOther(NULL);
-        if (t) {
-          t->_reverse(_edges[i]);
-          Array<TSEdge<T>*> edges = t->getEdges();
-          if( _edges[i]->_isFirst( _edges[i]->getCommonVertex(*edges[1]) ) )
-            _edges[i]->_reverse();
-        }
-      }
+    int i;
+    const int m  = tri.getDim();
+    const int nt = m / 3;
 
-    for(i=0; i< _edges.getSize(); i++)
-      if( _edges[i]->boundary() )
-        break;
+    ArrayLX<TSVertex<T> >& vertex = *this;
 
-    TSEdge<T> *a = _edges[i];
-    TSEdge<T> *b = a->_getNext();
+    _edges.setMaxSize( _edges.getSize() + m/2 + 3 );
+    _triangles.setMaxSize( _triangles.getSize() + nt + 1 );
 
+    // Bounding box and the bucket grid of triangles
 
-    for(i=0; i<n_bound;i++)
-    {
-      Vector<T,2>		v = a->getVector2D();
-      UnitVector<T,2>	u = v + b->getVector2D();
-      if((u^v) > POS_TOLERANCE) {
+    _box.reset( vertex[0].getPosition() );
+    for( i = 1; i < vertex.getSize(); i++ )
+      _box += vertex[i].getPosition();
 
-        TSEdge<T> *ne = new TSEdge<T>(*(a->getFirstVertex()),*(b->getLastVertex()));
-        TSTriangle<T> *nt = new TSTriangle<T>(ne,b,a);
-        a->_swapTriangle(NULL,nt);
-        b->_swapTriangle(NULL,nt);
-        ne->_setTriangle(nt,NULL);
-        _edges += ne;
-        _insertTriangle(nt);
-        a = ne;
-        b = a->_getNext();
-        i--;
-      }
-      else
-      {
-        a = b;
-        b = a->_getNext();
-      }
+    if(this->getSize() < 200)         _setTriOrder(2);
+    else if(this->getSize() < 800)    _setTriOrder(3);
+    else if(this->getSize() < 3200)   _setTriOrder(4);
+    else if(this->getSize() < 12800)  _setTriOrder(5);
+    else if(this->getSize() < 51200)  _setTriOrder(6);
+    else if(this->getSize() < 204800) _setTriOrder(7);
+    else                              _setTriOrder(8);
+
+    // Edges, one per half-edge pair
+
+    std::vector<TSEdge<T>*> edge( m, NULL );
+    for( int h = 0; h < m; h++ ) {
+      if( nbr(h) >= 0 && nbr(h) < h ) continue;
+      edge[h] = new TSEdge<T>( vertex[tri(h)], vertex[tri(3*(h/3) + (h+1)%3)] );
+      if( nbr(h) >= 0 ) edge[nbr(h)] = edge[h];
+      _edges += edge[h];
     }
-  }
-
 
+    // Triangles
 
+    std::vector<TSTriangle<T>*> triangle( nt );
+    for( int t = 0; t < nt; t++ )
+      triangle[t] = new TSTriangle<T>( edge[3*t], edge[3*t+1], edge[3*t+2] );
 
+    for( int h = 0; h < m; h++ ) {
+      if( nbr(h) >= 0 && nbr(h) < h ) continue;
+      edge[h]->_setTriangle( triangle[h/3], nbr(h) >= 0 ? triangle[nbr(h)/3] : NULL );
+    }
 
+    for( int t = 0; t < nt; t++ )
+      _insertTriangle( triangle[t] );
+  }
 
 
   //#if defined GM_STREAM
@@ -1271,7 +1639,7 @@ namespace GMlib {
   inline
   void TSVertex<T>::_set( const Point<T,3>& p, const Vector<T,3>& n ) {
 
-    this->setPos(p);
+    Arrow<T,3>::setPos(p);
     this->setDir(n);
   }
 
@@ -1448,6 +1816,23 @@ namespace GMlib {
   }
 
 
+  /** void TSVertex<T>::setPos( const APoint<T,3>& p )
+   *  \brief Move the vertex
+   *
+   *  A move in the plane is counted, the vertex grids of the meshes are
+   *  then rebuilt at their next lookup. A new height is not counted.
+   */
+  template <typename T>
+  inline
+  void TSVertex<T>::setPos( const APoint<T,3>& p ) {
+
+    if( p(0) != this->getPos()(0) || p(1) != this->getPos()(1) )
+      _moves.fetch_add( 1, std::memory_order_relaxed );
+
+    Arrow<T,3>::setPos( p );
+  }
+
+
   template <typename T>
   void TSVertex<T>::setZ( T z ) {
 
@@ -1674,6 +2059,15 @@ namespace GMlib {
 
     Point<T,2> pt = a[0]->getParameter();
 
+    // The swap is only valid in a strictly convex quadrilateral. The end
+    // points must be clearly on opposite sides of the new edge, else the
+    // circle test of (nearly) collinear vertices can make a sliver.
+    UnitVector<T,2> d = a[1]->getParameter() - pt;
+    T h0 = d ^ ( _vertex[0]->getParameter() - pt );
+    T h1 = d ^ ( _vertex[1]->getParameter() - pt );
+    if( !( ( h0 > POS_TOLERANCE && h1 < -POS_TOLERANCE ) || ( h0 < -POS_TOLERANCE && h1 > POS_TOLERANCE ) ) )
+      return;
+
     if(
       pt.isInsideCircle(
         _vertex[0]->getParameter(),
@@ -1806,7 +2200,6 @@ namespace GMlib {
       _triangle[1]->_setEdges(e1,edg2[1],e);
       e->_setTriangle(t2,_triangle[1]);
 
-      e2->_setTriangle(t1,t2);
       edg2[2]->_swapTriangle(_triangle[1], t2);
 
       this->insert(e);
@@ -1815,13 +2208,21 @@ namespace GMlib {
       this->adjust(_triangle[1]);
     }
 
-    if( _triangle[0] != NULL ) {
+    // The new half has the new triangle on each side, one may be missing
+    e2->_setTriangle(t1,t2);
+
+    // A swap can move the triangles of this edge between the two slots,
+    // so the sides are recorded before legalizing
+    const bool left  = _triangle[0] != NULL;
+    const bool right = _triangle[1] != NULL;
+
+    if( left ) {
 
       edg1[1]->_okDelaunay();
       edg1[2]->_okDelaunay();
     }
 
-    if( _triangle[1] != NULL ) {
+    if( right ) {
 
       edg2[1]->_okDelaunay();
       edg2[2]->_okDelaunay();
@@ -30,6 +30,8 @@
 
 
 
+#include "gmtrianglemesh.h"
+
 // gmlib
 #include <core/containers/gmarray.h>
 #include <core/containers/gmarrayt.h>
@@ -37,6 +39,10 @@
 #include <core/containers/gmdmatrix.h>
 #include <scene/gmsceneobject.h>
 
+// stl
+#include <atomic>
+#include <vector>
+
 
 namespace GMlib {
 
@@ -57,6 +63,9 @@ namespace GMlib {
   template <typename T>
   class TriangleSystem;
 
+  template <typename T>
+  class MeshGenerator;
+
   template <typename T>
   class TSVertex;
 
@@ -108,12 +117,16 @@ namespace GMlib {
     Box<T,3>                          getBoundBox() const;
 
     TSEdge<T>*                        getEdge(int i) const;
+    void                              getMesh( TriangleMesh<T>& mesh ) const;
     int                               getNoVertices() const;
     int                               getNoEdges() const;
     int                               getNoTriangles() const;
+    int                               getTopologyRevision() const;
 
     TSTriangle<T>*                    getTriangle(int i) const;
+    void                              getTriangleIndices( DVector<int>& indices ) const;
     TSVertex<T>*                      getVertex(int i) const;
+    void                              getVertexAdjacency( DVector<int>& row, DVector<int>& col ) const;
 
     const Array<TSVEdge<T> >&         getVoronoiEdges() const;
     const Array<Point<T,2> >&         getVoronoiPoints() const;
@@ -124,11 +137,13 @@ namespace GMlib {
     bool                              removeVertexNew( TSVertex<T>& v);
 
     void                              renderVoronoi();
+    bool                              renumberVertices( const DVector<int>& perm );
     void                              replot();
 
     bool                              setConstEdge(TSVertex<T> v1, TSVertex<T> v2);
+    void                              setMesh( const TriangleMesh<T>& mesh );
 
-    void                              triangulateDelaunay();
+    void                              triangulateDelaunay( bool parallel = false );
 
 
     void                              enableDefaultVisualizer( bool enable = true );
@@ -138,8 +153,6 @@ namespace GMlib {
 
    protected:
     int	                              _dlist_name;
-    GLuint                            _vbo;
-    GLuint                            _ibo;
 
     Array< TriangleFacetsVisualizer<T>* >   _tf_visualizers;
     TriangleFacetsDefaultVisualizer<T>     *_default_visualizer;
@@ -152,6 +165,16 @@ namespace GMlib {
     Array<Point<T,2> >                _vorpnts;
 
     int                               _d;
+    int                               _revision;
+
+    // Uniform grid over the vertex parameters, buckets are index lists
+    mutable DVector<int>              _vgrid_head;
+    mutable std::vector<int>          _vgrid_next;
+    mutable int                       _vgrid_nx, _vgrid_ny;
+    mutable int                       _vgrid_size;    // Vertices in the grid, -1 if invalid
+    mutable int                       _vgrid_built;   // Vertices when it was built
+    mutable unsigned int              _vgrid_moves;   // TSVertex::_moves when it was built
+    mutable T                         _vgrid_x, _vgrid_y, _vgrid_h;
 
     DMatrix<ArrayT<TSTriangle<T>*> >  _tri_order;
     ArrayT<T>                         _u;
@@ -165,15 +188,23 @@ namespace GMlib {
     bool                              _fillPolygon(Array<TSEdge<T>*>&);
     bool                              _removeLastVertex();
     void                              _set(int i);
+    void                              _setTriOrder( int d );
     int                               _surroundingTriangle(TSTriangle<T>*&, const TSVertex<T>&);// const;
+    void                              _setTopology( const DVector<int>& tri, const DVector<int>& nbr );
 
 
   friend class TriangleSystem<T>;
+  friend class MeshGenerator<T>;
   private:
     void                              _adjustTriangle( TSTriangle<T>*, bool wider = false );
     ArrayLX<TSEdge<T>* >&             _getEdges();
     TSVertex<T>*                      _find( const Point<T,3>& ) const;
     TSEdge<T>*                        _find( const Point<T,3>&, const Point<T,3>& ) const;
+    int                               _findIndex( const Point<T,3>& p, bool param ) const;
+    void                              _vgridBuild() const;
+    int                               _vgridCell( const Point<T,3>& p ) const;
+    void                              _vgridLink( int i ) const;
+    bool                              _vgridUnlink( int i ) const;
     void                              _insertTriangle( TSTriangle<T>* );
     void                              _removeTriangle( TSTriangle<T>* );
     ArrayLX<TSTriangle<T>* >&         _triangle();
@@ -237,7 +268,7 @@ namespace GMlib {
 
 
   private:
-    static TriangleFacets<T>    *_tv;
+    static thread_local TriangleFacets<T>  *_tv;   // The mesh worked on by this thread
   };
 
   /** \class VEdge
@@ -295,6 +326,7 @@ namespace GMlib {
     void                    setRadius( T r );
     void                    setRadiusMax( T r );
     void                    setRadiusMin( T r );
+    void                    setPos( const APoint<T,3>& p );
     void                    setZ( T z );
 
     TSVertex<T>&            operator=(const TSVertex<T>& t);
@@ -312,6 +344,8 @@ namespace GMlib {
 
     bool                    _const;
 
+    static std::atomic<unsigned int>  _moves;  // In-plane moves by setPos(), of all vertices
+
 
     void                    _set( const Point<T,3>& p, const Vector<T,3>& n );
 
@@ -31,12 +31,19 @@
 #include <opengl/gmopenglmanager.h>
 #include <scene/render/gmdefaultrenderer.h>
 
+// stl
+#include <algorithm>
+#include <cmath>
+
 
 namespace GMlib {
 
   template <typename T>
   TriangleFacetsDefaultVisualizer<T>::TriangleFacetsDefaultVisualizer() :
-    _no_elements(0) {
+    _vbo_offset(0), _no_elements(0), _ibo_tf(0x0), _ibo_revision(0),
+    _dynamic(false), _capacity(0), _region(0), _mapped(0x0) {
+
+    for( int i = 0; i < 3; i++ ) _fence[i] = 0x0;
 
     initShader();
 
@@ -49,7 +56,37 @@ namespace GMlib {
   }
 
   template <typename T>
-  TriangleFacetsDefaultVisualizer<T>::~TriangleFacetsDefaultVisualizer() {}
+  TriangleFacetsDefaultVisualizer<T>::~TriangleFacetsDefaultVisualizer() {
+
+    _releaseDynamic();
+  }
+
+  template <typename T>
+  inline
+  bool TriangleFacetsDefaultVisualizer<T>::isDynamic() const {
+
+    return _dynamic;
+  }
+
+  /*! void TriangleFacetsDefaultVisualizer<T>::setDynamic( bool dynamic )
+   *  \brief Stream only heights and normals on replot
+   *
+   *  For animated height fields where the topology and the x/y coordinates
+   *  stay fixed. The vertex buffer is split in three regions that are
+   *  written round robin, so the CPU never waits on a region the GPU still
+   *  reads. With ARB_buffer_storage the buffer is mapped persistently and
+   *  only z and the normal of each vertex are written per replot. Normals
+   *  are recomputed from the cached triangle indices instead of calling
+   *  TriangleFacets::computeNormals().
+   */
+  template <typename T>
+  void TriangleFacetsDefaultVisualizer<T>::setDynamic( bool dynamic ) {
+
+    if( dynamic == _dynamic ) return;
+
+    _releaseDynamic();
+    _dynamic = dynamic;
+  }
 
   template <typename T>
   inline
@@ -88,8 +125,8 @@ namespace GMlib {
       GL::AttributeLocation normal_loc = _prog.getAttributeLocation( "in_normal" );
 
       _vbo.bind();
-      _vbo.enable( vert_loc, 3, GL_FLOAT, GL_FALSE,  sizeof(GL::GLVertexNormal), 0x0 );
-      _vbo.enable( normal_loc, 3, GL_FLOAT, GL_TRUE, sizeof(GL::GLVertexNormal), reinterpret_cast<const GLvoid*>(sizeof(GL::GLVertex)) );
+      _vbo.enable( vert_loc, 3, GL_FLOAT, GL_FALSE,  sizeof(GL::GLVertexNormal), reinterpret_cast<const GLvoid*>(_vbo_offset) );
+      _vbo.enable( normal_loc, 3, GL_FLOAT, GL_TRUE, sizeof(GL::GLVertexNormal), reinterpret_cast<const GLvoid*>(_vbo_offset + sizeof(GL::GLVertex)) );
 
       draw();
 
@@ -104,10 +141,22 @@ namespace GMlib {
   inline
   void TriangleFacetsDefaultVisualizer<T>::replot(TriangleFacets<T> *tf) {
 
+    if( _dynamic ) {
+      _replotDynamic( tf );
+      return;
+    }
+
     TriangleFacetsVisualizer<T>::fillStandardVBO( _vbo, tf );
-    TriangleFacetsVisualizer<T>::fillStandardIBO( _ibo, tf );
 
-    _no_elements = tf->getNoTriangles() * 3;
+    // The index buffer only depends on the topology
+    if( tf != _ibo_tf || tf->getTopologyRevision() != _ibo_revision ) {
+
+      TriangleFacetsVisualizer<T>::fillStandardIBO( _ibo, tf );
+
+      _ibo_tf       = tf;
+      _ibo_revision = tf->getTopologyRevision();
+      _no_elements  = tf->getNoTriangles() * 3;
+    }
   }
 
   template <typename T>
@@ -117,6 +166,12 @@ namespace GMlib {
     _ibo.bind();
     _ibo.drawElements( GL_TRIANGLES, _no_elements, GL_UNSIGNED_INT, reinterpret_cast<const GLvoid*>(0x0) );
     _ibo.unbind();
+
+    // Mark the region as in use until the GPU has finished reading it
+    if( _mapped ) {
+      if( _fence[_region] ) GL_CHECK(::glDeleteSync( _fence[_region] ));
+      GL_CHECK(_fence[_region] = ::glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 ));
+    }
   }
 
   template <typename T>
@@ -211,6 +266,9 @@ namespace GMlib {
     _prog.attachShader( vshader );
     _prog.attachShader( fshader );
     link_ok = _prog.link();
+    if( !link_ok ) {
+      std::cout << "Error: " << _prog.getLinkerLog() << std::endl;
+    }
     assert(link_ok);
 
   }
@@ -225,7 +283,7 @@ namespace GMlib {
         GL::AttributeLocation vertice_loc = _color_prog.getAttributeLocation( "in_vertex" );
 
         _vbo.bind();
-        _vbo.enable( vertice_loc, 3, GL_FLOAT, GL_FALSE, sizeof(GL::GLVertexNormal), reinterpret_cast<const GLvoid*>(0x0) );
+        _vbo.enable( vertice_loc, 3, GL_FLOAT, GL_FALSE, sizeof(GL::GLVertexNormal), reinterpret_cast<const GLvoid*>(_vbo_offset) );
 
         draw();
 
@@ -235,4 +293,175 @@ namespace GMlib {
       } _color_prog.unbind();
   }
 
+  /*! void TriangleFacetsDefaultVisualizer<T>::_allocateDynamic( int n )
+   *  \brief Storage for three regions of n vertices
+   *
+   *  The buffer is only reallocated when n exceeds the current capacity.
+   */
+  template <typename T>
+  void TriangleFacetsDefaultVisualizer<T>::_allocateDynamic( int n ) {
+
+    if( n <= _capacity ) return;
+
+    _releaseDynamic();
+    _capacity = n;
+
+    const GLsizeiptr size = 3 * GLsizeiptr(n) * sizeof(GL::GLVertexNormal);
+
+    if( GLEW_ARB_buffer_storage ) {
+
+      const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+      _vbo.bufferStorage( size, 0x0, flags );
+      _mapped = _vbo.mapBufferRange<GL::GLVertexNormal>( 0, size, flags );
+    }
+    else
+      _vbo.bufferData( size, 0x0, GL_STREAM_DRAW );
+
+    if( !_mapped ) _mirror.setDim( n );
+  }
+
+  /*! void TriangleFacetsDefaultVisualizer<T>::_releaseDynamic()
+   *  \brief Unmap and drop the dynamic storage
+   *
+   *  Storage made by bufferStorage() is immutable, so a new buffer object is
+   *  created in its place.
+   */
+  template <typename T>
+  void TriangleFacetsDefaultVisualizer<T>::_releaseDynamic() {
+
+    for( int i = 0; i < 3; i++ )
+      if( _fence[i] ) {
+        GL_CHECK(::glDeleteSync( _fence[i] ));
+        _fence[i] = 0x0;
+      }
+
+    if( _mapped ) {
+      _vbo.unmapBuffer();
+      _mapped = 0x0;
+      _vbo = GL::VertexBufferObject();
+      _vbo.create();
+    }
+
+    _capacity   = 0;
+    _region     = 0;
+    _vbo_offset = 0;
+    _ibo_tf     = 0x0;
+    _mirror.setDim( 0 );
+  }
+
+  /*! void TriangleFacetsDefaultVisualizer<T>::_waitRegion( int r )
+   *  \brief Block until the GPU has finished drawing from region r
+   */
+  template <typename T>
+  void TriangleFacetsDefaultVisualizer<T>::_waitRegion( int r ) {
+
+    if( !_fence[r] ) return;
+
+    GL_CHECK(::glClientWaitSync( _fence[r], GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000000) ));
+    GL_CHECK(::glDeleteSync( _fence[r] ));
+    _fence[r] = 0x0;
+  }
+
+  /*! void TriangleFacetsDefaultVisualizer<T>::fillDynamic( ... )
+   *  \brief Heights and area weighted normals of a height field
+   *
+   *  Writes z and the normal of each vertex into dst, x and y are left as
+   *  they are. pos and nor are work arrays of 3 floats per vertex. This is
+   *  the per-frame work of a dynamic replot, without any OpenGL calls.
+   */
+  template <typename T>
+  void TriangleFacetsDefaultVisualizer<T>::fillDynamic( const DVector<TSVertex<T>*>& vertex, const DVector<int>& tri,
+                                                        float* pos, float* nor, GL::GLVertexNormal* dst ) {
+
+    const int n = vertex.getDim();
+    for( int i = 0; i < n; i++ ) {
+      const Point<T,3> &p = vertex(i)->getPos();
+      pos[3*i]   = float(p(0));
+      pos[3*i+1] = float(p(1));
+      pos[3*i+2] = float(p(2));
+    }
+
+    // Area weighted vertex normals, oriented upwards as for a height field
+    std::fill( nor, nor + 3*n, 0.0f );
+    for( int t = 0; t < tri.getDim(); t += 3 ) {
+      const float *a = pos + 3*tri(t);
+      const float *b = pos + 3*tri(t+1);
+      const float *c = pos + 3*tri(t+2);
+      const float u[3] = { b[0]-a[0], b[1]-a[1], b[2]-a[2] };
+      const float v[3] = { c[0]-a[0], c[1]-a[1], c[2]-a[2] };
+      float w[3] = { u[1]*v[2] - u[2]*v[1], u[2]*v[0] - u[0]*v[2], u[0]*v[1] - u[1]*v[0] };
+      if( w[2] < 0.0f ) { w[0] = -w[0]; w[1] = -w[1]; w[2] = -w[2]; }
+      for( int k = 0; k < 3; k++ ) {
+        float *m = nor + 3*tri(t+k);
+        m[0] += w[0];  m[1] += w[1];  m[2] += w[2];
+      }
+    }
+
+    for( int i = 0; i < n; i++ ) {
+      const float *m = nor + 3*i;
+      const float  l = std::sqrt( m[0]*m[0] + m[1]*m[1] + m[2]*m[2] );
+      dst[i].z = pos[3*i+2];
+      if( l > 0.0f ) { dst[i].nx = m[0]/l;  dst[i].ny = m[1]/l;  dst[i].nz = m[2]/l; }
+      else           { dst[i].nx = 0.0f;    dst[i].ny = 0.0f;    dst[i].nz = 1.0f;   }
+    }
+  }
+
+
+  /*! void TriangleFacetsDefaultVisualizer<T>::_replotDynamic( TriangleFacets<T>* tf )
+   *  \brief Write heights and normals into the next region
+   *
+   *  The vertex pointers, triangle indices and x/y coordinates are only
+   *  gathered when the topology changes. Per replot the work is one pass
+   *  over the vertices and one over the triangles, without allocations.
+   */
+  template <typename T>
+  void TriangleFacetsDefaultVisualizer<T>::_replotDynamic( TriangleFacets<T>* tf ) {
+
+    const int n = tf->getSize();
+
+    if( tf != _ibo_tf || tf->getTopologyRevision() != _ibo_revision || n != _vertex.getDim() ) {
+
+      tf->getTriangleIndices( _tri );
+
+      const int no_indices = _tri.getDim();
+      DVector<GLuint> indices( no_indices );
+      for( int i = 0; i < no_indices; i++ ) indices[i] = GLuint(_tri[i]);
+      _ibo.bufferData( no_indices * sizeof(GLuint), indices.getPtr(), GL_STATIC_DRAW );
+
+      _vertex.setDim( n );
+      for( int i = 0; i < n; i++ ) _vertex[i] = tf->getVertex(i);
+      _pos.setDim( 3*n );
+      _nor.setDim( 3*n );
+
+      _allocateDynamic( n );
+
+      // x and y are constant, write them once to every region
+      for( int r = 0; r < 3; r++ ) {
+        _waitRegion( r );
+        GL::GLVertexNormal *dst = _mapped ? _mapped + r * _capacity : _mirror.getPtr();
+        for( int i = 0; i < n; i++ ) {
+          const Point<T,3> &p = _vertex[i]->getPos();
+          dst[i].x = float(p(0));
+          dst[i].y = float(p(1));
+        }
+        if( !_mapped ) break;
+      }
+
+      _ibo_tf       = tf;
+      _ibo_revision = tf->getTopologyRevision();
+      _no_elements  = no_indices;
+    }
+
+    // Next region, wait until the GPU is done with it
+    _region = ( _region + 1 ) % 3;
+    _waitRegion( _region );
+
+    GL::GLVertexNormal *dst = _mapped ? _mapped + _region * _capacity : _mirror.getPtr();
+    fillDynamic( _vertex, _tri, _pos.getPtr(), _nor.getPtr(), dst );
+
+    _vbo_offset = size_t(_region) * _capacity * sizeof(GL::GLVertexNormal);
+    if( !_mapped )
+      _vbo.bufferSubData( _vbo_offset, n * sizeof(GL::GLVertexNormal), _mirror.getPtr() );
+  }
+
 } // END namespace GMlib
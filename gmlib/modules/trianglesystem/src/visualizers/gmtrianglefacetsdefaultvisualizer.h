@@ -33,6 +33,7 @@
 #include <opengl/bufferobjects/gmvertexbufferobject.h>
 #include <opengl/bufferobjects/gmindexbufferobject.h>
 #include <opengl/gmprogram.h>
+#include <core/containers/gmdvector.h>
 
 
 namespace GMlib {
@@ -40,6 +41,9 @@ namespace GMlib {
   template <typename T>
   class TriangleFacets;
 
+  template <typename T>
+  class TSVertex;
+
   template <typename T>
   class TriangleFacetsDefaultVisualizer : public TriangleFacetsVisualizer<T> {
     GM_VISUALIZER(TriangleFacetsDefaultVisualizer)
@@ -53,11 +57,17 @@ namespace GMlib {
 
     void          replot(TriangleFacets<T> *tf);
 
+    bool          isDynamic() const;
+    void          setDynamic( bool dynamic );
+
+    static void   fillDynamic( const DVector<TSVertex<T>*>& vertex, const DVector<int>& tri,
+                               float* pos, float* nor, GL::GLVertexNormal* dst );
 
 
   protected:
     GL::VertexBufferObject        _vbo;
     GL::IndexBufferObject         _ibo;
+    size_t                        _vbo_offset;     // Byte offset of the vertices to draw
     void                          draw() const;
 
 
@@ -69,8 +79,28 @@ namespace GMlib {
 
     int                           _no_elements;
 
+    const TriangleFacets<T>*      _ibo_tf;
+    int                           _ibo_revision;   // Topology the IBO was built from
+
+    // Dynamic (height only) update
+    bool                          _dynamic;
+    int                           _capacity;       // Vertices per region
+    int                           _region;         // Region written last
+    GL::GLVertexNormal*           _mapped;         // Persistent mapping, 0x0 if not supported
+    mutable GLsync                _fence[3];
+    DVector<GL::GLVertexNormal>   _mirror;         // Upload buffer if not mapped
+    DVector<TSVertex<T>*>         _vertex;
+    DVector<int>                  _tri;
+    DVector<float>                _pos;
+    DVector<float>                _nor;
+
     void                          initShader();
 
+    void                          _allocateDynamic( int n );
+    void                          _releaseDynamic();
+    void                          _replotDynamic( TriangleFacets<T>* tf );
+    void                          _waitRegion( int r );
+
   }; // END class TriangleFacetsDefaultVisualizer
 
 } // END namespace GMlib
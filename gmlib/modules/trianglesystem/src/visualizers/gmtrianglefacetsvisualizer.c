@@ -64,19 +64,14 @@ namespace GMlib {
   void TriangleFacetsVisualizer<T>::fillStandardIBO(
       GL::IndexBufferObject& ibo, const TriangleFacets<T>* tf ) {
 
-    int no_indices = tf->getNoTriangles() * 3;
+    DVector<int> tri;
+    tf->getTriangleIndices( tri );
 
-    DVector<GLuint> indices(no_indices);
-    GLuint *iptr = indices.getPtr();
-
-    for( int i = 0; i < tf->getNoTriangles(); i++ ) {
+    int no_indices = tri.getDim();
 
-      Array< TSVertex<float>* > tri_verts = tf->getTriangle(i)->getVertices();
-      for( int j = 0; j < tri_verts.getSize(); j++ )
-        for( int k = 0; k < tf->getSize(); k++ )
-          if( tri_verts[j] == tf->getVertex(k) )
-            *iptr++ = k;
-    }
+    DVector<GLuint> indices(no_indices);
+    for( int i = 0; i < no_indices; i++ )
+      indices[i] = GLuint(tri[i]);
 
     ibo.bufferData( no_indices * sizeof(GLuint), indices.getPtr(), GL_STATIC_DRAW );
 
@@ -0,0 +1,342 @@
+#include <gtest/gtest.h>
+
+#include "../src/gmdelaunay.h"
+using namespace GMlib;
+
+// stl
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+
+namespace {
+
+  // The points have integer coordinates below 2^21, so the predicates are
+  // exact in 128-bit integers
+
+  __extension__ typedef __int128 Int;
+
+  Int orient( const Point<float,2>& a, const Point<float,2>& b, const Point<float,2>& c ) {
+
+    const Int bx = Int(b(0)) - Int(a(0)), by = Int(b(1)) - Int(a(1));
+    const Int cx = Int(c(0)) - Int(a(0)), cy = Int(c(1)) - Int(a(1));
+    return bx*cy - by*cx;
+  }
+
+
+  Int incircle( const Point<float,2>& a, const Point<float,2>& b,
+                const Point<float,2>& c, const Point<float,2>& d ) {
+
+    const Int adx = Int(a(0)) - Int(d(0)), ady = Int(a(1)) - Int(d(1));
+    const Int bdx = Int(b(0)) - Int(d(0)), bdy = Int(b(1)) - Int(d(1));
+    const Int cdx = Int(c(0)) - Int(d(0)), cdy = Int(c(1)) - Int(d(1));
+    return ( adx*adx + ady*ady ) * ( bdx*cdy - cdx*bdy )
+         + ( bdx*bdx + bdy*bdy ) * ( cdx*ady - adx*cdy )
+         + ( cdx*cdx + cdy*cdy ) * ( adx*bdy - bdx*ady );
+  }
+
+
+  // Twice the area of the convex hull (monotone chain)
+  Int hullArea2( const DVector< Point<float,2> >& p ) {
+
+    std::vector< Point<float,2> > q( p.getPtr(), p.getPtr() + p.getDim() );
+    std::sort( q.begin(), q.end(), []( const Point<float,2>& a, const Point<float,2>& b ) {
+      return a(0) < b(0) || ( a(0) == b(0) && a(1) < b(1) ); } );
+
+    std::vector< Point<float,2> > h( 2*q.size() );
+    int k = 0;
+    for( size_t i = 0; i < q.size(); i++ ) {
+      while( k >= 2 && orient( h[k-2], h[k-1], q[i] ) <= 0 ) k--;
+      h[k++] = q[i];
+    }
+    for( int i = int(q.size())-2, l = k+1; i >= 0; i-- ) {
+      while( k >= l && orient( h[k-2], h[k-1], q[i] ) <= 0 ) k--;
+      h[k++] = q[i];
+    }
+
+    Int a = 0;
+    for( int i = 1; i+1 < k-1; i++ ) a += orient( h[0], h[i], h[i+1] );
+    return a;
+  }
+
+
+  // Proper counter-clockwise triangles with consistent neighbours, that
+  // cover the convex hull
+  void expectValid( const Delaunay<float>& d, const DVector< Point<float,2> >& p ) {
+
+    const DVector<int>& tri = d.getTriangles();
+    const DVector<int>& nbr = d.getNeighbours();
+    const int nt = d.getNoTriangles();
+    ASSERT_GT( nt, 0 );
+
+    Int area = 0;
+    for( int t = 0; t < nt; t++ ) {
+      const Int a2 = orient( p(tri(3*t)), p(tri(3*t+1)), p(tri(3*t+2)) );
+      EXPECT_GT( a2, 0 );
+      area += a2;
+
+      for( int j = 0; j < 3; j++ ) {
+        const int h = 3*t+j, g = nbr(h);
+        if( g < 0 ) continue;
+        EXPECT_EQ( h, nbr(g) );
+        EXPECT_EQ( tri(h), tri(3*(g/3) + (g+1)%3) );
+      }
+    }
+    EXPECT_TRUE( area == hullArea2( p ) );
+  }
+
+
+  // Number of triangles with a point strictly inside the circumcircle
+  int countNonEmpty( const Delaunay<float>& d, const DVector< Point<float,2> >& p ) {
+
+    const DVector<int>& tri = d.getTriangles();
+    int bad = 0;
+    for( int t = 0; t < d.getNoTriangles(); t++ )
+      for( int i = 0; i < p.getDim(); i++ )
+        if( incircle( p(tri(3*t)), p(tri(3*t+1)), p(tri(3*t+2)), p(i) ) > 0 ) { bad++;  break; }
+    return bad;
+  }
+
+
+  DVector< Point<float,2> > randomPoints( int n, int size, unsigned int seed ) {
+
+    std::mt19937 g( seed );
+    std::uniform_int_distribution<int> u( 0, size-1 );
+    DVector< Point<float,2> > p( n );
+    for( int i = 0; i < n; i++ ) p[i] = Point<float,2>( float(u(g)), float(u(g)) );
+    return p;
+  }
+
+
+  // Every third point close to a circle of radius 2^20, rounded to the
+  // integer grid, the others inside. Gives slivers of near cocircular points.
+  DVector< Point<float,2> > nearCircle( int n, unsigned int seed ) {
+
+    std::mt19937 g( seed );
+    std::uniform_real_distribution<double> u( 0.0, 1.0 );
+    const double r = 1 << 20;
+    DVector< Point<float,2> > p( n );
+    for( int i = 0; i < n; i++ ) {
+      const double a = 2.0 * M_PI * u(g);
+      const double s = i % 3 == 0 ? r : r * std::sqrt( u(g) );
+      p[i] = Point<float,2>( float( std::round( s*std::cos(a) ) ), float( std::round( s*std::sin(a) ) ) );
+    }
+    return p;
+  }
+
+
+  // The triangles as vertex triples starting at the lowest index
+  std::set< std::array<int,3> > triangleSet( const Delaunay<float>& d ) {
+
+    const DVector<int>& tri = d.getTriangles();
+    std::set< std::array<int,3> > s;
+    for( int t = 0; t < d.getNoTriangles(); t++ ) {
+      std::array<int,3> a = {{ tri(3*t), tri(3*t+1), tri(3*t+2) }};
+      std::rotate( a.begin(), std::min_element( a.begin(), a.end() ), a.end() );
+      s.insert( a );
+    }
+    return s;
+  }
+
+
+  TEST(TriangleSystem_Delaunay, Delaunay_emptyCircle) {
+
+    for( unsigned int seed = 1; seed <= 3; seed++ ) {
+      const DVector< Point<float,2> > p = randomPoints( 1000, 1 << 16, seed );
+      Delaunay<float> d;
+      d.triangulate( p );
+      expectValid( d, p );
+      EXPECT_EQ( 0, countNonEmpty( d, p ) );
+    }
+  }
+
+
+  TEST(TriangleSystem_Delaunay, Delaunay_emptyCirclePointsOnCircle) {
+
+    // All lattice points on x^2 + y^2 = 5525^2, exactly cocircular, and the centre
+    const int r = 5525;
+    std::vector< Point<float,2> > q( 1, Point<float,2>( 0.0f, 0.0f ) );
+    for( int x = -r; x <= r; x++ ) {
+      const int y = int( std::lround( std::sqrt( double(r)*r - double(x)*x ) ) );
+      if( x*x + y*y != r*r ) continue;
+      q.push_back( Point<float,2>( float(x), float(y) ) );
+      if( y != 0 ) q.push_back( Point<float,2>( float(x), float(-y) ) );
+    }
+    ASSERT_EQ( 181u, q.size() );
+
+    DVector< Point<float,2> > p( int(q.size()) );
+    for( size_t i = 0; i < q.size(); i++ ) p[int(i)] = q[i];
+
+    Delaunay<float> d;
+    d.triangulate( p );
+    expectValid( d, p );
+    EXPECT_EQ( 0, countNonEmpty( d, p ) );
+    EXPECT_EQ( 180, d.getNoTriangles() );
+
+    // Near cocircular
+    for( unsigned int seed = 1; seed <= 3; seed++ ) {
+      const DVector< Point<float,2> > c = nearCircle( 3000, seed );
+      d.triangulate( c );
+      expectValid( d, c );
+      EXPECT_EQ( 0, countNonEmpty( d, c ) );
+    }
+  }
+
+
+  TEST(TriangleSystem_Delaunay, Delaunay_convexHull) {
+
+    // A grid, collinear points on the hull and cocircular points everywhere
+    const int m = 30;
+    DVector< Point<float,2> > p( m*m );
+    for( int i = 0; i < m; i++ )
+      for( int j = 0; j < m; j++ )
+        p[i*m+j] = Point<float,2>( float(i), float(j) );
+
+    Delaunay<float> d;
+    d.triangulate( p );
+    expectValid( d, p );
+    EXPECT_EQ( 0, countNonEmpty( d, p ) );
+    EXPECT_EQ( 2*(m-1)*(m-1), d.getNoTriangles() );
+
+    // Every boundary edge has all points on its left or on it
+    const DVector<int>& tri = d.getTriangles();
+    const DVector<int>& nbr = d.getNeighbours();
+    int boundary = 0;
+    for( int h = 0; h < tri.getDim(); h++ ) {
+      if( nbr(h) >= 0 ) continue;
+      boundary++;
+      const Point<float,2>& a = p(tri(h));
+      const Point<float,2>& b = p(tri(3*(h/3) + (h+1)%3));
+      for( int i = 0; i < p.getDim(); i++ )
+        EXPECT_GE( orient( a, b, p(i) ), 0 );
+    }
+    EXPECT_EQ( 4*(m-1), boundary );
+  }
+
+
+  TEST(TriangleSystem_Delaunay, Delaunay_duplicatePoints) {
+
+    const DVector< Point<float,2> > q = randomPoints( 500, 1 << 10, 7 );
+
+    // Each point once more, in the reverse order after the originals
+    DVector< Point<float,2> > p( 2*q.getDim() );
+    for( int i = 0; i < q.getDim(); i++ ) {
+      p[i]                   = q(i);
+      p[2*q.getDim() - 1 - i] = q(i);
+    }
+
+    Delaunay<float> a, b;
+    a.triangulate( q );
+    b.triangulate( p );
+    expectValid( b, p );
+    EXPECT_EQ( 0, countNonEmpty( b, p ) );
+    EXPECT_EQ( a.getNoTriangles(), b.getNoTriangles() );
+
+    // Only the first of equal points is used
+    const DVector<int>& tri = b.getTriangles();
+    for( int h = 0; h < tri.getDim(); h++ ) {
+      const int i = tri(h);
+      for( int k = 0; k < i; k++ )
+        EXPECT_FALSE( p(k) == p(i) && p(k)(0) == p(i)(0) && p(k)(1) == p(i)(1) );
+    }
+
+    // And inserting an existing point gives the existing one
+    EXPECT_EQ( tri(0), b.insert( p(tri(0)) ) );
+  }
+
+
+  TEST(TriangleSystem_Delaunay, Delaunay_fixedEdges) {
+
+    // Rows of flat diamonds, the short diagonal (a,b) is not Delaunay
+    const int m = 12;
+    DVector< Point<float,2> > p( 4*m*m );
+    DVector<bool>             fixed( 4*m*m );
+    for( int i = 0; i < m; i++ )
+      for( int j = 0; j < m; j++ ) {
+        const int   k = 4*(i*m+j);
+        const float x = 100.0f*i, y = 100.0f*j;
+        p[k]   = Point<float,2>( x,         y );          // a
+        p[k+1] = Point<float,2>( x + 40.0f, y );          // b
+        p[k+2] = Point<float,2>( x + 20.0f, y + 15.0f );
+        p[k+3] = Point<float,2>( x + 20.0f, y - 15.0f );
+        fixed[k] = fixed[k+1] = true;
+        fixed[k+2] = fixed[k+3] = false;
+      }
+
+    Delaunay<float> free, con;
+    free.triangulate( p );
+    con.triangulate( p, fixed );
+    expectValid( free, p );
+    expectValid( con, p );
+    EXPECT_EQ( 0, countNonEmpty( free, p ) );
+
+    auto hasEdge = []( const Delaunay<float>& d, int a, int b ) {
+      const DVector<int>& tri = d.getTriangles();
+      for( int h = 0; h < tri.getDim(); h++ )
+        if( tri(h) == a && tri(3*(h/3) + (h+1)%3) == b ) return true;
+      return false;
+    };
+
+    // Every edge is locally Delaunay, except those between fixed points
+    const DVector<int>& tri = con.getTriangles();
+    const DVector<int>& nbr = con.getNeighbours();
+    int kept = 0;
+    for( int h = 0; h < tri.getDim(); h++ ) {
+      const int g = nbr(h);
+      if( g < 0 ) continue;
+      const int a = tri(h), b = tri(3*(h/3) + (h+1)%3), c = tri(3*(h/3) + (h+2)%3);
+      const int e = tri(3*(g/3) + (g+2)%3);
+      if( fixed(a) && fixed(b) ) {
+        if( incircle( p(a), p(b), p(c), p(e) ) > 0 ) kept++;
+      }
+      else
+        EXPECT_LE( incircle( p(a), p(b), p(c), p(e) ), 0 );
+    }
+
+    // Some diagonals are made during the insertion and stay, all are flipped without fixing
+    EXPECT_GT( kept, 0 );
+    for( int k = 0; k < 4*m*m; k += 4 )
+      EXPECT_FALSE( hasEdge( free, k, k+1 ) || hasEdge( free, k+1, k ) );
+  }
+
+
+
+  TEST(TriangleSystem_Delaunay, Delaunay_parallelEqualsSerial) {
+
+    std::vector< DVector< Point<float,2> > > sets;
+
+    // Near cocircular slivers, the case where rounding used to decide
+    sets.push_back( nearCircle( 30000, 11 ) );
+    sets.push_back( nearCircle( 30000, 12 ) );
+
+    // Many equal x, so strip borders pass through points, and duplicates
+    sets.push_back( randomPoints( 20000, 256, 13 ) );
+
+    // Exactly cocircular grid
+    DVector< Point<float,2> > g( 100*100 );
+    for( int i = 0; i < 100; i++ )
+      for( int j = 0; j < 100; j++ )
+        g[i*100+j] = Point<float,2>( float(i), float(j) );
+    sets.push_back( g );
+
+    for( size_t k = 0; k < sets.size(); k++ ) {
+
+      const DVector< Point<float,2> >& p = sets[k];
+      Delaunay<float> serial;
+      serial.triangulate( p );
+
+      for( int strips = 2; strips <= 5; strips += 3 ) {
+
+        Delaunay<float> parallel;
+        parallel.triangulateParallel( p, DVector<bool>(), strips );
+        expectValid( parallel, p );
+        EXPECT_EQ( serial.getNoTriangles(), parallel.getNoTriangles() );
+        EXPECT_TRUE( triangleSet( serial ) == triangleSet( parallel ) ) << "set " << k << ", " << strips << " strips";
+      }
+    }
+  }
+
+}
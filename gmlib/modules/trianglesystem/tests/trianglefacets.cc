@@ -0,0 +1,443 @@
+#include <gtest/gtest.h>
+
+#include "../src/gmtrianglesystem.h"
+using namespace GMlib;
+
+// stl
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+
+namespace {
+
+  typedef std::set< std::array<int,3> > TriangleSet;
+
+
+  // Every third point on the unit circle, the others inside
+  DVector< Point<float,2> > diskPoints( int n, unsigned int seed ) {
+
+    std::mt19937 g( seed );
+    std::uniform_real_distribution<float> u( 0.0f, 1.0f );
+    DVector< Point<float,2> > p( n );
+    for( int i = 0; i < n; i++ ) {
+      const float a = float( 2.0 * M_PI ) * u(g);
+      const float r = i % 3 == 0 ? 1.0f : std::sqrt( u(g) );
+      p[i] = Point<float,2>( r * std::cos(a), r * std::sin(a) );
+    }
+    return p;
+  }
+
+
+  void setVertices( TriangleFacets<float>& tf, const DVector< Point<float,2> >& p ) {
+
+    tf.clear();
+    tf.setMaxSize( p.getDim() );
+    for( int i = 0; i < p.getDim(); i++ )
+      tf.insertAlways( TSVertex<float>( p(i) ) );
+  }
+
+
+  // The triangles as vertex triples starting at the lowest index
+  TriangleSet triangleSet( const DVector<int>& tri ) {
+
+    TriangleSet s;
+    for( int t = 0; t < tri.getDim() / 3; t++ ) {
+      std::array<int,3> a = {{ tri(3*t), tri(3*t+1), tri(3*t+2) }};
+      std::rotate( a.begin(), std::min_element( a.begin(), a.end() ), a.end() );
+      s.insert( a );
+    }
+    return s;
+  }
+
+
+  TriangleSet triangleSet( const TriangleFacets<float>& tf ) {
+
+    DVector<int> tri;
+    tf.getTriangleIndices( tri );
+    return triangleSet( tri );
+  }
+
+
+  // Exposes the vertex lookup of the triangle system
+  class Finder : public TriangleSystem<float> {
+  public:
+    using TriangleSystem<float>::find;
+  };
+
+
+  // The linear search the vertex grid replaced, lowest index first
+  const TSVertex<float>* linearFind( const TriangleFacets<float>& tf, const Point<float,3>& p, bool param ) {
+
+    for( int i = 0; i < tf.getNoVertices(); i++ ) {
+      const TSVertex<float>* v = tf.getVertex(i);
+      if( param ? v->getParameter() == Point<float,2>(p) : v->getPosition() == p ) return v;
+    }
+    return 0x0;
+  }
+
+
+  TEST(TriangleSystem_TriangleFacets, TriangleFacets_findIndex) {
+
+    TriangleFacets<float> tf;
+    setVertices( tf, diskPoints( 2000, 5 ) );
+    tf.triangulateDelaunay();
+
+    // Duplicates and points closer than the tolerance, added raw
+    for( int i = 0; i < 50; i++ ) {
+      const Point<float,3> p = tf.getVertex( 37*i )->getPosition();
+      tf.insertAlways( TSVertex<float>( p ) );
+      tf.insertAlways( TSVertex<float>( p(0) + 4e-4f, p(1) - 4e-4f ) );
+    }
+
+    // Far outside the grid
+    tf.insertAlways( TSVertex<float>( 1000.0f, -1000.0f ) );
+
+    std::mt19937 g( 9 );
+    std::uniform_int_distribution<int>     vi( 0, tf.getNoVertices() - 1 );
+    std::uniform_real_distribution<float>  u( -1.0f, 1.0f );
+
+    std::vector< Point<float,3> > q;
+    for( int i = 0; i < 2000; i++ ) {
+      const Point<float,3> p = tf.getVertex( vi(g) )->getPosition();
+      const float          d = i % 4 == 0 ? 0.0f : i % 4 == 1 ? 6e-4f : i % 4 == 2 ? 9e-4f : 2e-3f;
+      const float          a = float( 2.0 * M_PI ) * u(g);
+      q.push_back( p + Vector<float,3>( d*std::cos(a), d*std::sin(a), 0.0f ) );
+    }
+    for( int i = 0; i < 200; i++ ) q.push_back( Point<float,3>( u(g), u(g), 0.0f ) );
+    q.push_back( Point<float,3>( 1000.0f, -1000.0f, 0.0f ) );
+    q.push_back( Point<float,3>( 1000.0f, -1000.0f, 1.0f ) );    // Same parameter, other height
+    q.push_back( Point<float,3>( 2.0f, 2.0f, 0.0f ) );           // Outside, nothing there
+    q.push_back( Point<float,3>( -5.0f, 0.0f, 0.0f ) );
+
+    Finder f;
+    f.set( tf );
+
+    int found = 0;
+    for( size_t i = 0; i < q.size(); i++ ) {
+      const TSVertex<float>* v = linearFind( tf, q[i], false );
+      EXPECT_EQ( v, f.find( q[i] ) ) << "query " << i;
+      if( v ) found++;
+
+      // insertVertex() finds an existing vertex on the parameter alone
+      if( linearFind( tf, q[i], true ) ) {
+        TSVertex<float> w( q[i] );
+        EXPECT_FALSE( tf.insertVertex( w ) );
+      }
+    }
+    EXPECT_GT( found, 1000 );
+
+    // The grid is kept up to date by insertVertex() and removeVertex()
+    const int n = tf.getNoVertices();
+    for( int i = 0; i < 300; i++ ) {
+      TSVertex<float> w( Point<float,2>( 0.5f*u(g), 0.5f*u(g) ) );
+      const bool exists = linearFind( tf, w.getPosition(), true ) != 0x0;
+      EXPECT_EQ( !exists, tf.insertVertex( w ) );
+    }
+    for( int i = 0; i < 100; i++ ) {
+      std::uniform_int_distribution<int> ri( n, tf.getNoVertices() - 1 );
+      EXPECT_TRUE( tf.removeVertex( tf[ ri(g) ] ) );
+    }
+    f.set( tf );
+    for( int i = 0; i < tf.getNoVertices(); i += 7 ) {
+      const Point<float,3> p = tf.getVertex(i)->getPosition();
+      EXPECT_EQ( linearFind( tf, p, false ), f.find( p ) );
+    }
+  }
+
+
+  TEST(TriangleSystem_TriangleFacets, TriangleFacets_findMoved) {
+
+    TriangleFacets<float> tf;
+    setVertices( tf, diskPoints( 500, 13 ) );
+
+    Finder f;
+    f.set( tf );
+    const Point<float,3> p = tf.getVertex( 100 )->getPosition();
+    ASSERT_EQ( tf.getVertex( 100 ), f.find( p ) );
+
+    // Moved in the plane, across the grid and out of its box
+    const Point<float,3> q( -p(0), 3.0f, p(2) );
+    tf.getVertex( 100 )->setPos( q );
+    EXPECT_EQ( tf.getVertex( 100 ), f.find( q ) );
+    EXPECT_EQ( linearFind( tf, p, false ), f.find( p ) );
+
+    TSVertex<float> w( q );
+    EXPECT_FALSE( tf.insertVertex( w ) );
+
+    // A new height only
+    tf.getVertex( 200 )->setZ( 2.0f );
+    EXPECT_EQ( tf.getVertex( 200 ), f.find( tf.getVertex( 200 )->getPosition() ) );
+
+    for( int i = 0; i < tf.getNoVertices(); i += 11 ) {
+      const Point<float,3> r = tf.getVertex(i)->getPosition();
+      EXPECT_EQ( linearFind( tf, r, false ), f.find( r ) );
+    }
+  }
+
+
+  // The neighbours of each vertex, vertex indices mapped by map
+  std::vector< std::set<int> > adjacency( const TriangleFacets<float>& tf, const DVector<int>& map ) {
+
+    DVector<int> row, col;
+    tf.getVertexAdjacency( row, col );
+
+    std::vector< std::set<int> > a( tf.getNoVertices() );
+    for( int i = 0; i < tf.getNoVertices(); i++ )
+      for( int k = row(i); k < row(i+1); k++ )
+        a[ map(i) ].insert( map(col(k)) );
+    return a;
+  }
+
+
+  TEST(TriangleSystem_TriangleFacets, TriangleFacets_renumberVertices) {
+
+    TriangleFacets<float> tf;
+    setVertices( tf, diskPoints( 1500, 21 ) );
+    for( int i = 0; i < tf.getNoVertices(); i += 10 ) tf[i].setConst( true );
+    tf.triangulateDelaunay();
+
+    const int n = tf.getNoVertices();
+    DVector<int> id( n );
+    for( int i = 0; i < n; i++ ) id[i] = i;
+
+    std::vector< Point<float,3> > pos( n );
+    std::vector<bool>             fix( n );
+    for( int i = 0; i < n; i++ ) {
+      pos[i] = tf.getVertex(i)->getPosition();
+      fix[i] = tf.getVertex(i)->isConst();
+    }
+    DVector<int> tri;
+    tf.getTriangleIndices( tri );
+    const std::vector< std::set<int> > adj = adjacency( tf, id );
+    const int ne  = tf.getNoEdges();
+    const int nt  = tf.getNoTriangles();
+    const int rev = tf.getTopologyRevision();
+
+    // Not permutations, nothing changes
+    DVector<int> bad = id;
+    bad[7] = bad[8];
+    EXPECT_FALSE( tf.renumberVertices( bad ) );
+    bad[7] = n;
+    EXPECT_FALSE( tf.renumberVertices( bad ) );
+    EXPECT_FALSE( tf.renumberVertices( DVector<int>( n-1, 0 ) ) );
+    EXPECT_EQ( rev, tf.getTopologyRevision() );
+    for( int i = 0; i < n; i++ ) ASSERT_EQ( pos[i], tf.getVertex(i)->getPosition() );
+
+    // New-to-old perm, old-to-new pinv
+    std::vector<int> order( n );
+    for( int i = 0; i < n; i++ ) order[i] = i;
+    std::shuffle( order.begin(), order.end(), std::mt19937( 4 ) );
+    DVector<int> perm( n ), pinv( n );
+    for( int k = 0; k < n; k++ ) {
+      perm[k]        = order[k];
+      pinv[order[k]] = k;
+    }
+
+    ASSERT_TRUE( tf.renumberVertices( perm ) );
+    EXPECT_NE( rev, tf.getTopologyRevision() );
+    ASSERT_EQ( n,  tf.getNoVertices() );
+    ASSERT_EQ( ne, tf.getNoEdges() );
+    ASSERT_EQ( nt, tf.getNoTriangles() );
+
+    // Vertex k is the old vertex perm[k]
+    for( int k = 0; k < n; k++ ) {
+      EXPECT_EQ( pos[perm(k)](0), tf.getVertex(k)->getPosition()(0) );
+      EXPECT_EQ( pos[perm(k)](1), tf.getVertex(k)->getPosition()(1) );
+      EXPECT_EQ( fix[perm(k)],    tf.getVertex(k)->isConst() );
+    }
+
+    // The same triangles and neighbours, under the new numbering
+    DVector<int> mapped( tri.getDim() );
+    for( int h = 0; h < tri.getDim(); h++ ) mapped[h] = pinv(tri(h));
+    EXPECT_TRUE( triangleSet( mapped ) == triangleSet( tf ) );
+    EXPECT_TRUE( adjacency( tf, perm ) == adj );
+
+    // Edges point into the vertex storage, edges and triangles follow the vertex order
+    std::map<const TSVertex<float>*, int> stored;
+    for( int k = 0; k < n; k++ ) stored[ tf.getVertex(k) ] = k;
+
+    int last = 0;
+    for( int e = 0; e < ne; e++ ) {
+      const TSEdge<float>* edge = tf.getEdge(e);
+      ASSERT_TRUE( stored.count( edge->getFirstVertex() ) && stored.count( edge->getLastVertex() ) );
+      const int lo = std::min( stored[ edge->getFirstVertex() ], stored[ edge->getLastVertex() ] );
+      EXPECT_LE( last, lo );
+      last = lo;
+    }
+
+    DVector<int> now;
+    tf.getTriangleIndices( now );
+    last = 0;
+    for( int t = 0; t < nt; t++ ) {
+      const int lo = std::min( now(3*t), std::min( now(3*t+1), now(3*t+2) ) );
+      EXPECT_LE( last, lo );
+      last = lo;
+    }
+
+    // The vertex grid is made again for the new order
+    Finder f;
+    f.set( tf );
+    for( int k = 0; k < n; k += 13 ) {
+      const Point<float,3> p = tf.getVertex(k)->getPosition();
+      EXPECT_EQ( linearFind( tf, p, false ), f.find( p ) );
+    }
+  }
+
+
+  std::vector< std::set<int> > adjacency( const DVector<int>& row, const DVector<int>& col ) {
+
+    std::vector< std::set<int> > a( row.getDim() - 1 );
+    for( int i = 0; i + 1 < row.getDim(); i++ )
+      for( int k = row(i); k < row(i+1); k++ )
+        a[i].insert( col(k) );
+    return a;
+  }
+
+
+  void expectSameMesh( const TriangleMesh<float>& a, const TriangleMesh<float>& b ) {
+
+    ASSERT_EQ( a.getNoVertices(),  b.getNoVertices() );
+    ASSERT_EQ( a.getNoEdges(),     b.getNoEdges() );
+    ASSERT_EQ( a.getNoTriangles(), b.getNoTriangles() );
+
+    for( int i = 0; i < a.getNoVertices(); i++ ) {
+      for( int j = 0; j < 3; j++ ) {
+        EXPECT_EQ( a.getPositions()(i)(j), b.getPositions()(i)(j) );
+        EXPECT_EQ( a.getNormals()(i)(j),   b.getNormals()(i)(j) );
+      }
+      EXPECT_EQ( a.isConst(i),     b.isConst(i) );
+      EXPECT_EQ( a.isBoundary(i),  b.isBoundary(i) );
+      EXPECT_EQ( a.getOutgoing(i), b.getOutgoing(i) );
+    }
+    for( int h = 0; h < 3*a.getNoTriangles(); h++ ) {
+      EXPECT_EQ( a.getTriangles()(h),  b.getTriangles()(h) );
+      EXPECT_EQ( a.getNeighbours()(h), b.getNeighbours()(h) );
+    }
+    for( int e = 0; e < a.getNoEdges(); e++ )
+      EXPECT_EQ( a.getEdge(e), b.getEdge(e) );
+  }
+
+
+  TEST(TriangleSystem_TriangleFacets, TriangleFacets_meshRoundTrip) {
+
+    TriangleFacets<float> tf;
+    setVertices( tf, diskPoints( 1200, 8 ) );
+    for( int i = 0; i < tf.getNoVertices(); i += 9 ) tf[i].setConst( true );
+    tf.triangulateDelaunay();
+
+    TriangleMesh<float> m1, m2, m3;
+    tf.getMesh( m1 );
+    ASSERT_EQ( tf.getNoTriangles(), m1.getNoTriangles() );
+
+    TriangleFacets<float> copy;
+    copy.setMesh( m1 );
+    copy.getMesh( m2 );
+    expectSameMesh( m1, m2 );
+
+    copy.setMesh( m2 );
+    copy.getMesh( m3 );
+    expectSameMesh( m2, m3 );
+
+    // The vertex graph is unchanged, and the same as the one of the mesh
+    DVector<int> row, col;
+    tf.getVertexAdjacency( row, col );
+    const std::vector< std::set<int> > adj = adjacency( row, col );
+
+    copy.getVertexAdjacency( row, col );
+    EXPECT_TRUE( adjacency( row, col ) == adj );
+    m1.getVertexAdjacency( row, col );
+    EXPECT_TRUE( adjacency( row, col ) == adj );
+
+    EXPECT_TRUE( triangleSet( tf ) == triangleSet( copy ) );
+  }
+
+
+  TEST(TriangleSystem_TriangleFacets, TriangleFacets_triangulateParallel) {
+
+#ifdef _OPENMP
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads( 4 );
+#endif
+
+    const DVector< Point<float,2> > p = diskPoints( 20000, 3 );
+
+    Delaunay<float> d;
+    d.triangulate( p );
+    const TriangleSet ref = triangleSet( d.getTriangles() );
+
+    TriangleFacets<float> serial, parallel;
+    setVertices( serial, p );
+    setVertices( parallel, p );
+    serial.triangulateDelaunay( false );
+    parallel.triangulateDelaunay( true );
+
+    EXPECT_EQ( d.getNoTriangles(), serial.getNoTriangles() );
+    EXPECT_EQ( d.getNoTriangles(), parallel.getNoTriangles() );
+    EXPECT_EQ( serial.getNoEdges(), parallel.getNoEdges() );
+    EXPECT_TRUE( ref == triangleSet( serial ) );
+    EXPECT_TRUE( ref == triangleSet( parallel ) );
+
+    // Euler, V - E + F = 1 for a triangulated disk, duplicated points are not used
+    std::set<int> used;
+    for( const auto& t : ref ) used.insert( t.begin(), t.end() );
+    EXPECT_EQ( 1, int(used.size()) - parallel.getNoEdges() + parallel.getNoTriangles() );
+
+#ifdef _OPENMP
+    omp_set_num_threads( threads );
+#endif
+  }
+
+
+  TEST(TriangleSystem_TriangleFacets, TriangleFacets_concurrentMeshes) {
+
+    // Separate meshes triangulated from separate threads at the same time,
+    // the mesh each thread works on is thread local
+    const int nt = 4;
+    std::vector< DVector< Point<float,2> > > p( nt );
+    std::vector< TriangleSet >               ref( nt ), res( nt );
+    std::vector< TriangleFacets<float>* >    tf( nt );
+
+    for( int k = 0; k < nt; k++ ) {
+      p[k] = diskPoints( 5000 + 1000*k, 20 + k );
+
+      TriangleFacets<float> s;
+      setVertices( s, p[k] );
+      s.triangulateDelaunay();
+      ref[k] = triangleSet( s );
+
+      tf[k] = new TriangleFacets<float>;
+      setVertices( *tf[k], p[k] );
+    }
+
+    std::vector<std::thread> threads;
+    for( int k = 0; k < nt; k++ )
+      threads.emplace_back( [&tf,&res,k]() {
+        for( int r = 0; r < 3; r++ ) {
+          setVertices( *tf[k], diskPoints( 2000, 100 + k ) );
+          tf[k]->triangulateDelaunay();
+        }
+        setVertices( *tf[k], diskPoints( 5000 + 1000*k, 20 + k ) );
+        tf[k]->triangulateDelaunay();
+        res[k] = triangleSet( *tf[k] );
+      } );
+    for( auto& t : threads )
+      t.join();
+
+    for( int k = 0; k < nt; k++ ) {
+      EXPECT_TRUE( ref[k] == res[k] ) << "mesh " << k;
+      EXPECT_EQ( int(ref[k].size()), tf[k]->getNoTriangles() );
+      delete tf[k];
+    }
+  }
+
+}
@@ -3,6 +3,28 @@
 #include <gmCoreModule>
 #include <gmSceneModule>
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+
+namespace {
+
+    //Higher order elements from the reference tables, triangle t of the nt
+    //corner arrays xy = (x0,y0,x1,y1,x2,y2). The stiffness matrix (row major)
+    //and the load vector of the unit source.
+
+    template <int p>
+    void elementStiffness(const GMlib::LagrangeTriangle<float,p>& e, const float* xy, int nt, int t, float* ke, float* fe)
+    {
+        const GMlib::Point<float,2> p0(xy[t], xy[nt+t]), p1(xy[2*nt+t], xy[3*nt+t]), p2(xy[4*nt+t], xy[5*nt+t]);
+        e.elementStiffness(p0, p1, p2, ke);
+        e.elementLoad(p0, p1, p2, fe);
+    }
+
+}
+
 
 FEMObject::FEMObject():GMlib:: TriangleFacets<float>()
 
@@ -11,6 +33,18 @@ FEMObject::FEMObject():GMlib:: TriangleFacets<float>()
     _maxInterval =4;
     _func=0;
     _down=true;
+    _iterative=false;
+    _multigrid=false;
+    _transient=false;
+    _lumped=true;
+    _order=1;
+    _dt=1.0f/60;
+    _elapsed=0;
+    _precomputed=true;
+    _cg.setPreconditioner(GMlib::PCGSolver<float>::PRECONDITIONER_IC0);
+    _cg.setTolerance(1e-5);
+    _ts.setScheme(GMlib::TransientSolver<float>::SCHEME_NEWMARK);
+    _ts.getIterativeSolver().setTolerance(1e-5);
 }
 
 
@@ -20,6 +54,18 @@ FEMObject::FEMObject(GMlib::ArrayLX<GMlib::TSVertex<float> > &pt)
     _maxInterval =4;
     _func=0;
     _down=true;
+    _iterative=false;
+    _multigrid=false;
+    _transient=false;
+    _lumped=true;
+    _order=1;
+    _dt=1.0f/60;
+    _elapsed=0;
+    _precomputed=true;
+    _cg.setPreconditioner(GMlib::PCGSolver<float>::PRECONDITIONER_IC0);
+    _cg.setTolerance(1e-5);
+    _ts.setScheme(GMlib::TransientSolver<float>::SCHEME_NEWMARK);
+    _ts.getIterativeSolver().setTolerance(1e-5);
 
 
 }
@@ -50,42 +96,33 @@ void FEMObject ::makeRandom(int triangels ,double rad)
 {
     double s = std::sqrt(4*M_PI*(rad * rad)/(std::sqrt(3)*triangels));//length of sides of triangels
     int k=(2*M_PI*(rad)/s);//no.of boundary points
-    int n =((triangels+2+k)/2);//no. of inner points
-
-    std ::cout<< "length of side "<< s <<std::endl;
-    std ::cout<< "k "<< k <<std::endl;
-    std ::cout<< "n "<< n <<std::endl;
-
 
-    GMlib::Angle a = GMlib::Angle((M_2PI)/k);
-    GMlib::SqMatrix<float,2> mt(a,GMlib::Vector<float,2>(1,0),GMlib::Vector<float,2>(0,1));
-    GMlib::Vector<float,2> vec(rad,0);
-    for ( int i = 1;i<=k;i++)
+    GMlib::DVector<GMlib::Point<float,2>> circle(k);
+    for (int i=0;i<k;i++)
+        circle[i] = GMlib::Point<float,2>(rad*std::cos(M_2PI*i/k), rad*std::sin(M_2PI*i/k));
+
+    //Poisson-disk points with a minimum spacing, refined until no angle is
+    //below 25 degrees. The nearest neighbours are on average a bit further
+    //apart than the spacing, so it is scaled to give about the requested
+    //number of triangles. The points splitting the boundary segments are
+    //moved out onto the circle, so the boundary is strictly convex and
+    //triangulateDelaunay() makes the same mesh from these vertices, without
+    //slivers between collinear boundary points.
+
+    GMlib::MeshGenerator<float> mesh;
+    mesh.setBoundary(circle);
+    mesh.setSpacing(0.85*s);
+    mesh.generate();
+
+    const GMlib::DVector<GMlib::Point<float,2>>& p = mesh.getPoints();
+    const GMlib::DVector<bool>& boundary = mesh.getBoundaryFlags();
+    for (int i=0;i<p.getDim();i++)
     {
-        vec=mt*vec;
-        this->insertAlways(GMlib::TSVertex<float> (static_cast<GMlib::Point<float,2>>(vec)));
-
+        GMlib::Point<float,2> q = p(i);
+        if (boundary(i))
+            q *= float(rad / q.getLength());
+        this->insertAlways(GMlib::TSVertex<float>(q));
     }
-
-    //correction of Radius//
-
-    double kat= std::cos(a.getRad()/2)*rad;
-    double corRad=rad-kat;
-    double newRad=rad-(corRad*2);
-
-    for (int i=1;i<=n;i++)
-    {
-        auto pt = GMlib::TSVertex<float> (RandomFloat(-newRad,newRad),RandomFloat(-newRad,newRad));
-        if (pt.getParameter().getLength() < newRad)// check weather  point is in radius
-        {
-            this->insertAlways(GMlib::TSVertex<float>(pt));
-        }
-    }
-
-
-
-
-
 }
 //random float generator(end result lies betn. a and b)
 
@@ -107,11 +144,13 @@ float FEMObject :: RandomFloat(float a, float b)
 void FEMObject::computeValue()
 {
 
-    //Create nodes, removing the bounding vertices
+    //Create nodes: the interior vertices and the boundary vertices that
+    //are only on Neumann edges. The other vertices have Dirichlet values.
 
+    nodes.clear();
     for(int i = 0; i < this->size(); i++)
     {
-        if(!(*this)[i].boundary())
+        if(_isFree(&(*this)[i]))
             nodes += Nodes((*this)[i]);
 
     }
@@ -121,93 +160,161 @@ void FEMObject::computeValue()
 
 void FEMObject::stiffness()
 {
-    //Create stiffness matrix
-    _A.setDim(nodes.size(), nodes.size());
+    //Map vertices to node (unknown) indices. The Dirichlet vertices get
+    //none, the elements refer to their value d by -1-d.
 
+    std::unordered_map<const GMlib::TSVertex<float>*, int> index;
+    index.reserve(nodes.size());
     for(int i = 0; i < nodes.size(); i++)
-        for(int j = 0; j < nodes.size(); j++)
-            _A[i][j] = 0;
+        index[nodes[i].getVertex()] = i;
 
+    std::unordered_map<const GMlib::TSVertex<float>*, int> fixed;
+    _fixed.setDim(this->size() - nodes.size());
+    for(int i = 0, d = 0; i < this->size(); i++)
+        if(!index.count(this->getVertex(i)))
+        {
+            fixed[this->getVertex(i)] = d;
+            _fixed[d++] = this->getVertex(i);
+        }
 
+    //Gather the node indices and corner points of every triangle into flat
+    //arrays, the element loop below then only touches these. The corners are
+    //stored per coordinate (x0 of all triangles, then y0, ...) for the batched
+    //linear kernel.
 
+    const int nt = this->getNoTriangles();
+    GMlib::DVector<int>   elem(3*nt);
+    GMlib::DVector<float> xy(6*nt);
+    GMlib::DVector<GMlib::TSVertex<float>*> corner(3*nt);
 
-    for (int i=0; i < nodes.size() ;i++)
+    for(int t = 0; t < nt; t++)
     {
-        for(int j = i+1; j < nodes.size(); j++)
+        GMlib::Array<GMlib::TSVertex<float>*> vertices = this->getTriangle(t)->getVertices();
+        for(int i = 0; i < 3; i++)
         {
-            GMlib::TSEdge<float> * edge = nodes[i].neighbour(nodes[j]);
-            if(edge != nullptr)
-            {
+            auto it = index.find(vertices[i]);
+            elem[3*t+i] = (it != index.end()) ? it->second : -1 - fixed[vertices[i]];
+            corner[3*t+i] = vertices[i];
 
-                GMlib::Vector<GMlib::Vector<float,2>,3> d = findVectors(edge);
+            GMlib::Point<float,2> p = vertices[i]->getParameter();
+            xy[(2*i)*nt+t]   = p[0];
+            xy[(2*i+1)*nt+t] = p[1];
+        }
+    }
 
-                float d0d0 = d[0] * d[0];
+    //Higher order elements add the unknowns of the edges and interiors
 
-                float dd = 1 / (d0d0);  //properties of diagonal
+    const int k = (_order+1)*(_order+2)/2;
+    int ndofs = nodes.size();
+    std::unordered_map<const GMlib::TSEdge<float>*, int> edge;
+    _fixedEdges.clear();
+    if(_order > 1)
+        ndofs = _elementDofs(elem, nt, edge);
 
-                //horizontal length
+    if(_assembler.getNoNodesPerElement() != k)
+        _assembler = GMlib::SparseAssembler<float>(k);
 
-                float dh1 = dd * (d[1] * d[0]);
-                float dh2 = dd * (d[2] * d[0]);
+    //Element matrices of the last assembly. Refinement keeps the slot of
+    //a triangle and appends the new ones, so a slot with the same corners
+    //in the same order still holds a valid element matrix. Linear elements
+    //are cheaper to recompute in a batch than to copy.
 
-                //calculation of area
-                float area1 = std::abs(d[0] ^ d[1]);
-                float area2 = std::abs(d[2] ^ d[0]);
+    const int nt0 = _order > 1 ? std::min(_corner.getDim()/3, _assembler.getNoElements()) : 0;
+    GMlib::DVector<float> ke0(k*k*nt0), fe0(k*nt0);
+    if(nt0 > 0)
+    {
+        std::copy(_assembler.getElementMatrix(0), _assembler.getElementMatrix(nt0), ke0.getPtr());
+        std::copy(_assembler.getElementVector(0), _assembler.getElementVector(nt0), fe0.getPtr());
+    }
 
-                //verticalheight
+    //Sparse pattern and reduction maps are built once for the mesh
 
-                float h1 = dd * area1 * area1;
-                float h2 = dd * area2 * area2;
+    _assembler.setElements(ndofs, elem);
 
+    //Element matrices and load vectors, independent per triangle
 
-                //computing stiffness matrix outside the diagonal
+    if(_order == 1)
+        GMlib::linearTriangleElements(nt, xy.getPtr(), _assembler.getElementMatrix(0), _assembler.getElementVector(0));
+    else
+    {
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+        for(int t = 0; t < nt; t++)
+        {
+            float* ke = _assembler.getElementMatrix(t);
+            float* fe = _assembler.getElementVector(t);
 
-                _A[i][j]=_A[j][i]= (((dh1 *(1-dh1))/h1)-dd) * (area1/2) + (((dh2 *(1-dh2))/h2)-dd) * (area2/2);
+            if(t < nt0 && _corner(3*t) == corner(3*t) && _corner(3*t+1) == corner(3*t+1) && _corner(3*t+2) == corner(3*t+2))
+            {
+                std::copy(ke0.getPtr() + k*k*t, ke0.getPtr() + k*k*(t+1), ke);
+                std::copy(fe0.getPtr() + k*t, fe0.getPtr() + k*(t+1), fe);
             }
-
-
-            //  std::cout << "Matrix A: " << _A << std::endl;
+            else if(_order == 2)
+                elementStiffness(_p2, xy.getPtr(), nt, t, ke, fe);
+            else
+                elementStiffness(_p3, xy.getPtr(), nt, t, ke, fe);
         }
+    }
+    _corner = corner;
 
+    _assembler.assemble();
+    _b = _assembler.getVector();
 
+    //Nodes of the Neumann edges, for their flux
 
-        //computing stiffness matrix diagonal elements
-
-
+    _fluxEdges.clear();
+    _fluxDofs.clear();
+    for(int i = 0; i < this->getNoEdges(); i++)
+    {
+        GMlib::TSEdge<float>* e = this->getEdge(i);
+        if(!e->boundary() || !_neumann.count(_edgeKey(e->getFirstVertex(), e->getLastVertex())))
+            continue;
+
+        auto a = index.find(e->getFirstVertex()), b = index.find(e->getLastVertex());
+        _fluxEdges.push_back(e);
+        _fluxDofs.push_back(a != index.end() ? a->second : -1);
+        for(int j = 0; j < _order-1; j++)
+            _fluxDofs.push_back(edge[e] + j);
+        _fluxDofs.push_back(b != index.end() ? b->second : -1);
+    }
 
+    _applyBoundaryConditions();
 
-        GMlib::Array<GMlib::TSTriangle<float>* > triangular = nodes[i].getTriangles();
+    const GMlib::SparseMatrix<float>& A = _assembler.getMatrix();
 
-        for (int j=0; j < triangular.getSize(); j++)
-        {
-            GMlib::Vector<GMlib::Vector<float,2>,3>  d = findVectors(nodes[i], triangular[j]);
-            _A[i][i] += (d[2]*d[2]) / (2*std::abs(d[0] ^ d[1]));
 
-        }
+    //Factorize the stiffness matrix once, every update is then a solve.
+    //The iterative solver only needs its preconditioner.
 
-    }
+    //The multigrid hierarchy is the one of the refinements, if the nodes do
+    //not match it the matrix is solved directly on a single level.
 
-    //Create the load vector
-
-    _b.setDim(nodes.size());
-
-    for(int i = 0; i < nodes.size(); i++)
+    _x.setDim(0);
+    if(!_iterative)
+        _solver.factorize(A);
+    else if(!_multigrid)
+        _cg.compute(A);
+    else if(!_mg.compute(A))
     {
-        GMlib::Array<GMlib::TSTriangle<float>* > triangle = nodes[i].getTriangles();
-
-        _b[i] = 0;//triangle[0]->getArea2D()/3;
-        //  std::cout << "Vector j: " << _b;
-
-        for(int j = 1; j < triangle.size(); j++)
-            _b[i] += triangle[j]->getArea2D()/3;
-        // std::cout << "Vector b: " << _b;
+        _mg.clearProlongations();
+        _mg.compute(A);
     }
 
+    _vertex.setDim(nodes.size());
+    for(int i = 0; i < nodes.size(); i++)
+        _vertex[i] = nodes[i].getVertex();
 
-    //Invert the stiffness matrix
+    _x0.setDim(0);
 
+    //The time stepping matrix M + c A is factorized once for the fixed
+    //time step
 
-    _Ainvert = _A.invert();
+    if(_transient)
+    {
+        _massMatrix();
+        _ts.compute(_mass, A, _dt);
+    }
 
 }
 GMlib::Vector<GMlib::Vector<float,2>,3> FEMObject::findVectors(Nodes pn, GMlib::TSTriangle<float>* triangle)
@@ -279,43 +386,882 @@ GMlib::Vector<GMlib::Vector<float,2>,3> FEMObject::findVectors(GMlib::TSEdge<flo
 
 void FEMObject::htupdate(float a)
 {
+    const int n = _vertex.getDim();
+
+    if(_r.getDim() != _b.getDim())
+        _applyBoundaryConditions();
+
+    if(_precomputed)
+    {
+        //The system is linear in the load factor, so the unit response and
+        //the response to the boundary conditions are solved once and every
+        //update only scales and adds them
+
+        if(_x0.getDim() != _b.getDim())
+            _solve(_b, _x0);
+        if(_xb.getDim() != _b.getDim())
+            _solve(_r, _xb);
+
+        _z.setDim(n);
+
+        const float* x0 = _x0.getPtr();
+        const float* xb = _xb.getPtr();
+        float*       z  = _z.getPtr();
+        for(int i = 0; i < n; i++)
+            z[i] = a * x0[i] + xb[i];
+    }
+    else
+    {
+        //The previous frame is the initial guess of the iterative solver
+
+        _solve(a * _b + _r, _x);
+
+        _z = _x;
+    }
+
+    for(int i = 0; i < n; i++)
+        _vertex[i]->setZ(_z[i]);
+}
+
+
+//Solve A x = b with the selected solver, x is the initial guess of the
+//iterative one
+
+void FEMObject::_solve(const GMlib::DVector<float>& b, GMlib::DVector<float>& x)
+{
+    if(!_iterative)
+        _solver.solve(b, x);
+    else if(_multigrid)
+        _cg.solve(_assembler.getMatrix(), _mg, b, x);
+    else
+        _cg.solve(b, x);
+}
+
+
+//Element unknowns of the higher order elements. elem holds the vertex
+//nodes of every triangle, it is widened to the element layout of
+//LagrangeTriangle: the vertices, p-1 nodes per edge running from the first
+//vertex to the second, the interior nodes. The vertex nodes keep their
+//numbers, then come the nodes of the interior and Neumann edges and of
+//the triangle interiors. The nodes of the other boundary edges have
+//Dirichlet values, numbered after those of the vertices. The first node of
+//every edge is returned in edge. Returns the number of unknowns.
+
+int FEMObject::_elementDofs(GMlib::DVector<int>& elem, int nt, std::unordered_map<const GMlib::TSEdge<float>*, int>& edge)
+{
+    const int p  = _order;
+    const int k  = (p+1)*(p+2)/2;
+    const int ni = k - 3*p;// interior nodes per triangle
+
+    int n = nodes.size();
+
+    int d = _fixed.getDim();
+
+    edge.reserve(this->getNoEdges());
+    for(int i = 0; i < this->getNoEdges(); i++)
+    {
+        GMlib::TSEdge<float>* e = this->getEdge(i);
+        if(!e->boundary() || _neumann.count(_edgeKey(e->getFirstVertex(), e->getLastVertex())))
+        {
+            edge[e] = n;
+            n += p-1;
+        }
+        else
+        {
+            edge[e] = -1 - d;
+            d += p-1;
+            _fixedEdges.push_back(e);
+        }
+    }
+
+    GMlib::DVector<int> vertexNodes = elem;
+    elem.setDim(k*nt);
+
+    for(int t = 0; t < nt; t++)
+    {
+        GMlib::TSTriangle<float>* tri = this->getTriangle(t);
+        GMlib::Array<GMlib::TSVertex<float>*> vertices = tri->getVertices();
+        GMlib::Array<GMlib::TSEdge<float>*> edges = tri->getEdges();
+        int* el = elem.getPtr() + k*t;
+
+        for(int i = 0; i < 3; i++)
+            el[i] = vertexNodes[3*t+i];
+
+        for(int i = 0; i < 3; i++)
+        {
+            GMlib::TSVertex<float>* a = vertices[i];
+            GMlib::TSVertex<float>* b = vertices[(i+1)%3];
+
+            GMlib::TSEdge<float>* e = edges[0];
+            for(int j = 1; j < 3; j++)
+                if((edges[j]->getFirstVertex() == a && edges[j]->getLastVertex() == b) ||
+                   (edges[j]->getFirstVertex() == b && edges[j]->getLastVertex() == a))
+                    e = edges[j];
+
+            const int  base    = edge[e];
+            const bool forward = e->getFirstVertex() == a;
+            for(int j = 0; j < p-1; j++)
+                el[3 + i*(p-1) + j] = base < 0 ? base - (forward ? j : p-2-j) : base + (forward ? j : p-2-j);
+        }
+
+        for(int j = 0; j < ni; j++)
+            el[3*p + j] = n + ni*t + j;
+    }
+
+    return n + ni*nt;
+}
+
+
+//Mass matrix of the linear triangles. The load vector of an element is a
+//third of its area at each corner, which is the lumped mass. The
+//consistent mass matrix is area/12 * (1 + delta_ij), a quarter of it times
+//(1 + delta_ij).
+
+void FEMObject::_massMatrix()
+{
+    const int nt = _assembler.getNoElements();
+
+    //Row sum lumping fails for higher order elements (zero or negative
+    //vertex masses), they always get the consistent mass matrix
+
+    if(_order > 1)
+    {
+        const int k = _assembler.getNoNodesPerElement();
+        GMlib::DVector<float> me(k*k*nt);
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+        for(int t = 0; t < nt; t++)
+        {
+            GMlib::Array<GMlib::TSVertex<float>*> v = this->getTriangle(t)->getVertices();
+            const GMlib::Point<float,2> p0 = v[0]->getParameter(), p1 = v[1]->getParameter(), p2 = v[2]->getParameter();
+            if(_order == 2)
+                _p2.elementMass(p0, p1, p2, me.getPtr() + k*k*t);
+            else
+                _p3.elementMass(p0, p1, p2, me.getPtr() + k*k*t);
+        }
+
+        _assembler.assemble(me, _mass);
+        return;
+    }
+
+    GMlib::DVector<float> me(9*nt);
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+    for(int t = 0; t < nt; t++)
+    {
+        const float* fe = _assembler.getElementVector(t);
+        float*       m  = me.getPtr() + 9*t;
+        for(int i = 0; i < 3; i++)
+            for(int j = 0; j < 3; j++)
+                m[3*i+j] = _lumped ? (i == j ? fe[i] : 0.0f) : (i == j ? fe[i]/2 : fe[i]/4);
+    }
+
+    _assembler.assemble(me, _mass);
+}
+
+
+//Zienkiewicz-Zhu error indicator of the unit response. The piecewise
+//constant gradient is averaged to the vertices, weighted by area, and the
+//difference between this recovered gradient and the gradient of each
+//triangle is integrated by the edge midpoint rule, which is exact here.
+//Returns the global estimate, the square root of the sum of squares.
+
+float FEMObject::estimate()
+{
+    const int n  = _vertex.getDim();
+    const int nv = this->size();
+    const int nt = this->getNoTriangles();
+
+    if(_x0.getDim() != _b.getDim())
+        _solve(_b, _x0);
+
+    std::unordered_map<const GMlib::TSVertex<float>*, int> index;
+    index.reserve(nv);
+    for(int i = 0; i < nv; i++)
+        index[&(*this)[i]] = i;
+
+    //Values at all vertices, zero at the Dirichlet vertices
+
+    GMlib::DVector<float> u(nv, 0.0f);
+    for(int i = 0; i < n; i++)
+        u[index[_vertex[i]]] = _x0[i];
+
+    //Gradient and area of each triangle
+
+    GMlib::DVector<int>   tv(3*nt);
+    GMlib::DVector<float> g(2*nt), area(nt);
 
-    GMlib::DVector<float> b = a * _b;
-    GMlib::DVector<float> x = _Ainvert * b;
-    x.setDim(_b.getDim());
+    for(int t = 0; t < nt; t++)
+    {
+        GMlib::Array<GMlib::TSVertex<float>*> vertices = this->getTriangle(t)->getVertices();
+        float p[6], z[3];
+        for(int i = 0; i < 3; i++)
+        {
+            tv[3*t+i] = index[vertices[i]];
+            GMlib::Point<float,2> q = vertices[i]->getParameter();
+            p[2*i]   = q[0];
+            p[2*i+1] = q[1];
+            z[i]     = u[tv[3*t+i]];
+        }
+
+        const float dx[3] = { p[4]-p[2], p[0]-p[4], p[2]-p[0] };
+        const float dy[3] = { p[5]-p[3], p[1]-p[5], p[3]-p[1] };
+        const float area2 = dx[1]*dy[2] - dy[1]*dx[2];
+
+        g[2*t]   = -(z[0]*dy[0] + z[1]*dy[1] + z[2]*dy[2]) / area2;
+        g[2*t+1] =  (z[0]*dx[0] + z[1]*dx[1] + z[2]*dx[2]) / area2;
+        area[t]  = std::abs(area2) / 2;
+    }
+
+    //Recovered gradient at the vertices
+
+    GMlib::DVector<float> gr(2*nv, 0.0f), w(nv, 0.0f);
+    for(int t = 0; t < nt; t++)
+        for(int i = 0; i < 3; i++)
+        {
+            const int v = tv[3*t+i];
+            gr[2*v]   += area[t] * g[2*t];
+            gr[2*v+1] += area[t] * g[2*t+1];
+            w[v]      += area[t];
+        }
+    for(int v = 0; v < nv; v++)
+        if(w[v] > 0)
+        {
+            gr[2*v]   /= w[v];
+            gr[2*v+1] /= w[v];
+        }
+
+    _eta.setDim(nt);
+
+    double sum = 0;
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(static) reduction(+:sum)
+#endif
+    for(int t = 0; t < nt; t++)
+    {
+        float e = 0;
+        for(int i = 0; i < 3; i++)
+        {
+            const int a = tv[3*t+i], b = tv[3*t+(i+1)%3];
+            const float ex = (gr[2*a]   + gr[2*b])   / 2 - g[2*t];
+            const float ey = (gr[2*a+1] + gr[2*b+1]) / 2 - g[2*t+1];
+            e += ex*ex + ey*ey;
+        }
+        _eta[t] = std::sqrt(area[t] * e / 3);
+        sum += double(_eta[t]) * _eta[t];
+    }
+
+    return std::sqrt(sum);
+}
+
+
+//One adaptive step. The triangles carrying the given fraction of the
+//squared error estimate are marked (bulk marking), and each is bisected
+//by inserting the midpoint of its longest edge; insertVertex() keeps the
+//mesh Delaunay. The new interior vertices are appended to the nodes, so
+//the old unknowns keep their numbering. The system is then rebuilt by
+//stiffness(): pattern, assembly and factorization (or preconditioner) are
+//redone for the whole mesh, and only higher order elements reuse the
+//element matrices of the untouched triangles. The unit response is solved
+//again, starting from the old one interpolated to the new vertices.
+//Returns the number of vertices inserted.
+
+int FEMObject::refine(float fraction)
+{
+    const int nt = this->getNoTriangles();
+    if(_eta.getDim() != nt)
+        estimate();
+
+    std::vector<int> order(nt);
+    double total = 0;
+    for(int t = 0; t < nt; t++)
+    {
+        order[t] = t;
+        total += double(_eta[t]) * _eta[t];
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) { return _eta[a] > _eta[b]; });
+
+    //Longest edge of every marked triangle, each edge once
+
+    std::vector<GMlib::TSEdge<float>*> split;
+    std::unordered_set<GMlib::TSEdge<float>*> marked;
+    double sum = 0;
+    for(int k = 0; k < nt && sum < fraction * total; k++)
+    {
+        const int t = order[k];
+        sum += double(_eta[t]) * _eta[t];
+
+        GMlib::Array<GMlib::TSEdge<float>*> edges = this->getTriangle(t)->getEdges();
+        GMlib::TSEdge<float>* e = edges[0];
+        for(int i = 1; i < 3; i++)
+            if(edges[i]->getLength2D() > e->getLength2D())
+                e = edges[i];
+
+        if(marked.insert(e).second)
+            split.push_back(e);
+    }
+
+    const int nc = nodes.size();
+    std::vector<int> parent;
+    const int inserted = _bisect(split, parent);
+    if(inserted == 0)
+        return 0;
+
+    //The old response interpolated to the new nodes is the initial guess
+
+    std::vector<float> x;
+    if(_x0.getDim() == nc)
+    {
+        x.assign(_x0.getPtr(), _x0.getPtr() + nc);
+        for(size_t i = 0; i < parent.size(); i += 2)
+            x.push_back(((parent[i]   >= 0 ? _x0[parent[i]]   : 0.0f) +
+                         (parent[i+1] >= 0 ? _x0[parent[i+1]] : 0.0f)) / 2);
+    }
+
+    _insertLevel(nc, parent);
+    stiffness();
+
+    _x0.setDim(int(x.size()));
+    std::copy(x.begin(), x.end(), _x0.getPtr());
+    _solve(_b, _x0);
+
+    _eta.setDim(0);
+    return inserted;
+}
+
+
+//Uniform refinement: every edge is split at its midpoint, repeated the
+//given number of times. Each refinement adds a level to the multigrid
+//hierarchy. computeValue() must have been called for the initial mesh.
+
+void FEMObject::refineUniform(int levels)
+{
+    for(int l = 0; l < levels; l++)
+    {
+        std::vector<GMlib::TSEdge<float>*> split(this->getNoEdges());
+        for(int i = 0; i < this->getNoEdges(); i++)
+            split[i] = this->getEdge(i);
+
+        const int nc = nodes.size();
+        std::vector<int> parent;
+        _bisect(split, parent);
+        _insertLevel(nc, parent);
+    }
+
+    stiffness();
+}
+
+
+//Insert the midpoint of every edge, insertVertex() keeps the mesh
+//Delaunay. The new free vertices are appended to the nodes, so the old
+//ones keep their numbering, and for each the node indices of the edge end
+//points, -1 for Dirichlet vertices, are appended to parent. Returns the
+//number of vertices inserted.
+
+int FEMObject::_bisect(const std::vector<GMlib::TSEdge<float>*>& split, std::vector<int>& parent)
+{
+    //Midpoints and end points are taken before any edge is split
+
+    const int m = int(split.size());
+    std::vector<GMlib::Point<float,2>> mid(m);
+    std::vector<GMlib::TSVertex<float>*> end(2*m);
+    for(int i = 0; i < m; i++)
+    {
+        end[2*i]   = split[i]->getFirstVertex();
+        end[2*i+1] = split[i]->getLastVertex();
+        mid[i]     = split[i]->getCenterPos2D();
+    }
+
+    std::unordered_map<const GMlib::TSVertex<float>*, int> index;
+    index.reserve(nodes.size());
     for(int i = 0; i < nodes.size(); i++)
+        index[nodes[i].getVertex()] = i;
+
+    auto node = [&](const GMlib::TSVertex<float>* v) {
+        auto it = index.find(v);
+        return it != index.end() ? it->second : -1;
+    };
+
+    int inserted = 0;
+    for(int i = 0; i < m; i++)
+    {
+        GMlib::TSVertex<float> v(mid[i]);
+        if(!this->insertVertex(v))
+            continue;
+
+        inserted++;
+        GMlib::TSVertex<float>& nv = (*this)[this->size()-1];
+        if(nv.boundary())
+        {
+            _splitBoundary(end[2*i], end[2*i+1], &nv);
+            if(!_isFree(&nv))
+                continue;
+        }
+
+        nodes += Nodes(nv);
+        parent.push_back(node(end[2*i]));
+        parent.push_back(node(end[2*i+1]));
+    }
+
+    return inserted;
+}
+
+
+//Linear interpolation from the nc nodes before a refinement to the nodes
+//after it, the old nodes keep their value and a new node gets the mean of
+//its parents. It becomes the finest level of the multigrid hierarchy.
+
+void FEMObject::_insertLevel(int nc, const std::vector<int>& parent)
+{
+    const int n = nc + int(parent.size()) / 2;
+    GMlib::DVector<int>   row(n+1), col(nc + int(parent.size()));
+    GMlib::DVector<float> val(col.getDim());
+
+    int k = 0;
+    row[0] = 0;
+    for(int i = 0; i < nc; i++)
+    {
+        col[k] = i;
+        val[k] = 1;
+        row[i+1] = ++k;
+    }
+    for(int i = nc; i < n; i++)
+    {
+        for(int j = 0; j < 2; j++)
+        {
+            const int p = parent[2*(i-nc)+j];
+            if(p < 0)
+                continue;
+            col[k] = p;
+            val[k] = 0.5f;
+            k++;
+        }
+        row[i+1] = k;
+    }
+    col.setDim(k);
+    val.setDim(k);
+
+    _mg.insertProlongation(nc, row, col, val);
+}
+
+
+//Refine until the global estimate is below tol or the number of unknowns
+//reaches maxNodes. computeValue() and stiffness() must have been called
+//for the initial mesh. Returns the final estimate.
+
+float FEMObject::solveAdaptive(float tol, int maxNodes, float fraction)
+{
+    float eta = estimate();
+    while(eta > tol && nodes.size() < maxNodes)
     {
-        nodes[i].setZ(x[i]);
+        if(refine(fraction) == 0)
+            break;
+        eta = estimate();
     }
-    //        std::cout << "value b: " << b << std::endl;
+    return eta;
+}
+
+
+const GMlib::DVector<float>& FEMObject::getErrorIndicators() const
+{
+    return _eta;
+}
+
+
+//Renumber the vertices, and with them the nodes, by an ordering of the
+//mesh graph: reverse Cuthill-McKee for a small bandwidth, or nested
+//dissection for a small fill. Matrix-vector products, the factorization
+//and the per-frame vertex update then run through memory nearly
+//contiguously. An assembled system is assembled again, the solution and
+//the time stepping state follow their nodes. The multigrid hierarchy of
+//the refinements is dropped.
+
+void FEMObject::renumber(ORDERING ordering)
+{
+    GMlib::DVector<int> row, col, perm, pinv;
+    this->getVertexAdjacency(row, col);
+    if(ordering == NESTED_DISSECTION)
+        GMlib::GMgraph::nestedDissection(row, col, perm);
+    else
+        GMlib::GMgraph::reverseCuthillMcKee(row, col, perm);
+    GMlib::GMgraph::invertPermutation(perm, pinv);
+
+    //Vertex of every node, in the new numbering
+
+    std::unordered_map<const GMlib::TSVertex<float>*, int> index;
+    index.reserve(this->size());
+    for(int i = 0; i < this->size(); i++)
+        index[this->getVertex(i)] = i;
+
+    const int nc = nodes.size();
+    std::vector<int> vertex(nc);
+    for(int i = 0; i < nc; i++)
+        vertex[i] = pinv[index[nodes[i].getVertex()]];
+
+    const bool assembled = _assembler.getNoElements() > 0;
+    const GMlib::DVector<float> u = _ts.getSolution(), v = _ts.getVelocity();
+
+    if(!this->renumberVertices(perm))
+        return;
+
+    //The boundary conditions follow their vertices
+
+    auto moved = [&](const GMlib::TSVertex<float>* v) -> const GMlib::TSVertex<float>* {
+        return this->getVertex(pinv[index[v]]);
+    };
+
+    std::unordered_map<const GMlib::TSVertex<float>*, float> dirichlet;
+    for(const auto& g : _dirichlet)
+        dirichlet[moved(g.first)] = g.second;
+    std::map<EdgeKey, float> neumann;
+    for(const auto& h : _neumann)
+        neumann[_edgeKey(moved(h.first.first), moved(h.first.second))] = h.second;
+    _dirichlet.swap(dirichlet);
+    _neumann.swap(neumann);
+
+    //The nodes are the free vertices in the new order
+
+    if(nc == 0)
+        return;
+    computeValue();
+
+    std::vector<int> node(this->size(), -1);
+    for(int i = 0; i < nodes.size(); i++)
+        node[index[nodes[i].getVertex()]] = i;
+
+    auto permute = [&](const GMlib::DVector<float>& x) {
+        GMlib::DVector<float> y;
+        if(x.getDim() == nc)
+        {
+            y.setDim(nc);
+            for(int i = 0; i < nc; i++)
+                y[node[vertex[i]]] = x(i);
+        }
+        return y;
+    };
+
+    const GMlib::DVector<float> x = permute(_x), x0 = permute(_x0);
+    _x  = x;
+    _x0 = x0;
+    _corner.setDim(0);
+    _eta.setDim(0);
+    _mg.clearProlongations();
+
+    if(!assembled)
+        return;
+
+    stiffness();
+    _x  = x;
+    _x0 = x0;
+
+    if(_transient)
+    {
+        GMlib::DVector<float> u0 = permute(u), v0 = permute(v);
+        if(u0.getDim() != _b.getDim())
+        {
+            u0 = GMlib::DVector<float>(_b.getDim(), 0.0f);
+            v0 = u0;
+        }
+        _ts.setInitial(u0, v0);
+    }
+}
+
+
+//Boundary conditions, they stay with their vertices and edges through
+//refinement and renumbering. Where nothing is set the boundary is fixed at
+//0. A boundary vertex is an unknown if all its boundary edges are Neumann
+//edges and it has no Dirichlet value.
+//
+//A new value of a condition already in the assembled system only changes
+//the right hand side, which is updated together with the response at the
+//next frame, the factorization is kept. A condition that changes the
+//unknowns returns false, it takes effect at the next computeValue() and
+//stiffness().
+
+bool FEMObject::setDirichlet(GMlib::TSVertex<float>* vertex, float value)
+{
+    const bool free = _isFree(vertex);
+    _dirichlet[vertex] = value;
+    _r.setDim(0);
+    return !free;
+}
+
+//Both end vertices, the edge is no longer a Neumann edge
+
+bool FEMObject::setDirichlet(GMlib::TSEdge<float>* edge, float value)
+{
+    const bool a = setDirichlet(edge->getFirstVertex(), value);
+    const bool b = setDirichlet(edge->getLastVertex(), value);
+    return _neumann.erase(_edgeKey(edge->getFirstVertex(), edge->getLastVertex())) == 0 && a && b;
+}
+
+//Flux out of a boundary edge, the normal derivative. Dirichlet values of
+//the end vertices are kept. Interior edges are ignored.
+
+bool FEMObject::setNeumann(GMlib::TSEdge<float>* edge, float flux)
+{
+    if(!edge->boundary())
+        return false;
+
+    const EdgeKey key = _edgeKey(edge->getFirstVertex(), edge->getLastVertex());
+    const bool known = _neumann.count(key) > 0;
+    _neumann[key] = flux;
+    _r.setDim(0);
+    return known;
+}
+
+//Back to the boundary fixed at 0, at the next computeValue() and
+//stiffness()
+
+void FEMObject::clearBoundaryConditions()
+{
+    _dirichlet.clear();
+    _neumann.clear();
+    _r.setDim(0);
+}
+
+
+//Dirichlet values and the boundary part of the right hand side for the
+//last assembly, and the heights of the Dirichlet vertices. The values on
+//the nodes of an edge are interpolated linearly between its end vertices.
+
+void FEMObject::_applyBoundaryConditions()
+{
+    const int p  = _order;
+    const int nf = _fixed.getDim();
+
+    _g.setDim(nf + (p-1)*int(_fixedEdges.size()));
+    for(int d = 0; d < nf; d++)
+        _g[d] = _dirichletValue(_fixed[d]);
+    for(size_t k = 0; k < _fixedEdges.size(); k++)
+    {
+        const float a = _dirichletValue(_fixedEdges[k]->getFirstVertex());
+        const float b = _dirichletValue(_fixedEdges[k]->getLastVertex());
+        for(int j = 0; j < p-1; j++)
+            _g[nf + (p-1)*int(k) + j] = a + (b-a)*(j+1)/p;
+    }
+
+    //Lifting of the Dirichlet values, and the flux of the Neumann edges
+    //integrated against the edge nodes (closed Newton-Cotes weights)
+
+    static const float w[3][4] = { {1/2.0f, 1/2.0f},
+                                   {1/6.0f, 2/3.0f, 1/6.0f},
+                                   {1/8.0f, 3/8.0f, 3/8.0f, 1/8.0f} };
+
+    _r = GMlib::DVector<float>(_b.getDim(), 0.0f);
+    _assembler.lift(_g, _r);
+
+    for(size_t k = 0; k < _fluxEdges.size(); k++)
+    {
+        GMlib::TSEdge<float>* e = _fluxEdges[k];
+        const float h = _neumann[_edgeKey(e->getFirstVertex(), e->getLastVertex())] * e->getLength2D();
+        for(int j = 0; j <= p; j++)
+        {
+            const int i = _fluxDofs[(p+1)*k + j];
+            if(i >= 0)
+                _r[i] += h * w[p-1][j];
+        }
+    }
+
+    _xb.setDim(0);
+
+    for(int d = 0; d < nf; d++)
+        _fixed[d]->setZ(_g[d]);
+}
+
+
+//A vertex is an unknown unless it has a Dirichlet value or is on a
+//boundary edge that is not a Neumann edge
+
+bool FEMObject::_isFree(GMlib::TSVertex<float>* v) const
+{
+    if(_dirichlet.count(v))
+        return false;
+    if(!v->boundary())
+        return true;
+
+    GMlib::ArrayT<GMlib::TSEdge<float>*>& edges = v->getEdges();
+    for(int i = 0; i < edges.getSize(); i++)
+        if(edges[i]->boundary() && !_neumann.count(_edgeKey(edges[i]->getFirstVertex(), edges[i]->getLastVertex())))
+            return false;
+    return true;
+}
+
+
+float FEMObject::_dirichletValue(const GMlib::TSVertex<float>* v) const
+{
+    auto it = _dirichlet.find(v);
+    return it != _dirichlet.end() ? it->second : 0.0f;
+}
+
+
+//The halves of a split boundary edge keep its condition, a Dirichlet
+//midpoint gets the mean of the end values
+
+void FEMObject::_splitBoundary(GMlib::TSVertex<float>* a, GMlib::TSVertex<float>* b, GMlib::TSVertex<float>* m)
+{
+    auto it = _neumann.find(_edgeKey(a, b));
+    if(it != _neumann.end())
+    {
+        const float h = it->second;
+        _neumann.erase(it);
+        _neumann[_edgeKey(a, m)] = h;
+        _neumann[_edgeKey(m, b)] = h;
+    }
+    else if(_dirichlet.count(a) || _dirichlet.count(b))
+        _dirichlet[m] = (_dirichletValue(a) + _dirichletValue(b)) / 2;
+}
+
+
+FEMObject::EdgeKey FEMObject::_edgeKey(const GMlib::TSVertex<float>* a, const GMlib::TSVertex<float>* b)
+{
+    return a < b ? EdgeKey(a, b) : EdgeKey(b, a);
+}
+
+
+void FEMObject::setIterativeSolver(bool iterative)
+{
+    _iterative = iterative;
+}
+
+void FEMObject::setPrecomputedResponse(bool precomputed)
+{
+    _precomputed = precomputed;
+}
+
+GMlib::PCGSolver<float>& FEMObject::getIterativeSolver()
+{
+    return _cg;
+}
+
+void FEMObject::setMultigrid(bool multigrid)
+{
+    _multigrid = multigrid;
+}
+
+GMlib::MultigridSolver<float>& FEMObject::getMultigridSolver()
+{
+    return _mg;
+}
+
+//Degree of the Lagrange elements, 1 to 3, takes effect at the next
+//stiffness(). The vertices show the values of their nodes. The multigrid
+//hierarchy of the refinements is for linear elements only.
+
+void FEMObject::setOrder(int order)
+{
+    _order = std::max(1, std::min(3, order));
+}
+
+int FEMObject::getOrder() const
+{
+    return _order;
+}
+
+//Dynamics instead of the static solution, the membrane is driven by the
+//load. Takes effect at the next stiffness().
+
+void FEMObject::setTransient(bool transient)
+{
+    _transient = transient;
+}
+
+//Lumped (diagonal) or consistent mass matrix, takes effect at the next
+//stiffness()
+
+void FEMObject::setLumpedMass(bool lumped)
+{
+    _lumped = lumped;
+}
+
+//The factorization is for the time step given at the last stiffness(),
+//until the next one the steps are solved with warm started CG
+
+void FEMObject::setTimeStep(float dt)
+{
+    _dt = dt;
+}
+
+GMlib::TransientSolver<float>& FEMObject::getTransientSolver()
+{
+    return _ts;
+}
+
+const GMlib::SparseMatrix<float>& FEMObject::getMassMatrix() const
+{
+    return _mass;
 }
 
 
 void FEMObject::simulation()
 {
     start=true;
+
+    // Only the heights change while animating
+    if(_default_visualizer)
+        _default_visualizer->setDynamic(true);
+}
+
+//The load factor moves up and down between -_maxInterval and _maxInterval
+
+void FEMObject::_advance(double dt)
+{
+    if(_down)
+        _func += dt*2;
+    else
+        _func -= dt*2;
+
+    // qDebug() << _func << " " << _down;
+
+    if(_func > _maxInterval)
+        _down = false;
+
+    if(_func < -_maxInterval)
+        _down = true;
 }
 
 void FEMObject::localSimulate(double dt)
 {
     if (start){
 
-        if(_down)
-            _func += dt*2;
-        else
-            _func -= dt*2;
+        if(!_transient)
+        {
+            _advance(dt);
+            this->htupdate(_func);
+            this->replot();
+            return;
+        }
 
-        // qDebug() << _func << " " << _down;
+        //Fixed time steps, so every step is a solve with the factorization.
+        //A slow frame does at most a few, the rest of the time is dropped.
 
-        if(_func > _maxInterval)
-            _down = false;
+        if(_r.getDim() != _b.getDim())
+            _applyBoundaryConditions();
 
-        if(_func < -_maxInterval)
-            _down = true;
+        _elapsed += dt;
+        int steps = 0;
+        while(_elapsed >= _dt && steps < 4)
+        {
+            _advance(_dt);
+            _f = _func * _b + _r;
+            _ts.step(_f, _dt);
+            _elapsed -= _dt;
+            steps++;
+        }
+        if(steps == 4)
+            _elapsed = 0;
+        if(steps == 0)
+            return;
 
-        this->htupdate(_func);
-        this->replot();
+        const GMlib::DVector<float>& z = _ts.getSolution();
+        for(int i = 0; i < _vertex.getDim(); i++)
+            _vertex[i]->setZ(z(i));
 
+        this->replot();
     }
 }
 
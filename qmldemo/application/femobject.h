@@ -7,10 +7,20 @@
 #include <gmSceneModule>
 #include <QDebug>
 
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 
 class FEMObject:public GMlib::TriangleFacets<float>
 {
 public:
+    enum ORDERING {
+      RCM,
+      NESTED_DISSECTION
+    };
+
     FEMObject();
     FEMObject (GMlib::ArrayLX<GMlib::TSVertex<float>> & pt);
     int d= 0;
@@ -24,7 +34,31 @@ public:
     void    simulation();
     void    computeValue();
 
+    float   estimate();
+    int     refine(float fraction = 0.5f);
+    void    refineUniform(int levels);
+    float   solveAdaptive(float tol, int maxNodes, float fraction = 0.5f);
+    const GMlib::DVector<float>& getErrorIndicators() const;
+    void    renumber(ORDERING ordering = RCM);
+
+    bool    setDirichlet(GMlib::TSVertex<float>* vertex, float value);
+    bool    setDirichlet(GMlib::TSEdge<float>* edge, float value);
+    bool    setNeumann(GMlib::TSEdge<float>* edge, float flux);
+    void    clearBoundaryConditions();
+
     void    htupdate(float a);
+    void    setIterativeSolver(bool iterative);
+    void    setPrecomputedResponse(bool precomputed);
+    GMlib::PCGSolver<float>& getIterativeSolver();
+    void    setMultigrid(bool multigrid);
+    GMlib::MultigridSolver<float>& getMultigridSolver();
+    void    setOrder(int order);
+    int     getOrder() const;
+    void    setTransient(bool transient);
+    void    setLumpedMass(bool lumped);
+    void    setTimeStep(float dt);
+    GMlib::TransientSolver<float>& getTransientSolver();
+    const GMlib::SparseMatrix<float>& getMassMatrix() const;
     float   RandomFloat(float a, float b);
     double  newRad();
     int     numberOfBoundaryNodes() const;
@@ -38,10 +72,44 @@ private :
 
 
     GMlib::ArrayLX<Nodes> nodes ;
-    GMlib::DMatrix<float> _A;//stiffness matrix
-    GMlib::DMatrix<float> _Ainvert;
+    GMlib::SparseAssembler<float> _assembler;//stiffness matrix and load vector
+    GMlib::SparseCholesky<float> _solver;// factorization of the stiffness matrix
+    GMlib::PCGSolver<float> _cg;// iterative solver for large meshes
+    GMlib::MultigridSolver<float> _mg;// preconditioner over the refinement levels
+    GMlib::DVector<float> _x;// last solution, initial guess for _cg
+    GMlib::TransientSolver<float> _ts;// time stepping of M x'' + A x = f
+    GMlib::SparseMatrix<float> _mass;// mass matrix, same pattern as the stiffness matrix
+    GMlib::DVector<float> _f;// load of the current time step
+    bool _iterative;
+    bool _multigrid;
+    bool _transient;
+    bool _lumped;
+    int  _order;// degree of the Lagrange elements
+    GMlib::LagrangeTriangle<float,2> _p2;
+    GMlib::LagrangeTriangle<float,3> _p3;
+    float _dt;// fixed time step of _ts
+    double _elapsed;// simulated time not yet stepped
+
+    GMlib::DVector<float> _x0;// response to the unit load, A x0 = b
+    GMlib::DVector<float> _z;// heights of the current frame
+    GMlib::DVector<GMlib::TSVertex<float>*> _vertex;// vertex of each node
+    GMlib::DVector<GMlib::TSVertex<float>*> _corner;// corners of each triangle at the last assembly
+    GMlib::DVector<float> _eta;// ZZ error indicator of each triangle
+    bool _precomputed;
     GMlib::DVector<float> _b;// load vector
 
+    typedef std::pair<const GMlib::TSVertex<float>*, const GMlib::TSVertex<float>*> EdgeKey;
+
+    std::unordered_map<const GMlib::TSVertex<float>*, float> _dirichlet;// values set on vertices and edges, the rest of the boundary is 0
+    std::map<EdgeKey, float> _neumann;// flux out of the boundary edges, by their end vertices
+    GMlib::DVector<GMlib::TSVertex<float>*> _fixed;// Dirichlet vertices at the last assembly
+    std::vector<GMlib::TSEdge<float>*> _fixedEdges;// Dirichlet edges with nodes (order > 1)
+    std::vector<GMlib::TSEdge<float>*> _fluxEdges;// Neumann edges at the last assembly
+    std::vector<int> _fluxDofs;// their order+1 nodes from the first vertex to the last, -1 if Dirichlet
+    GMlib::DVector<float> _g;// Dirichlet values, of _fixed and then of the nodes of _fixedEdges
+    GMlib::DVector<float> _r;// boundary part of the right hand side
+    GMlib::DVector<float> _xb;// response to the boundary conditions, A xb = r
+
     int _numbofBoundaryNodes ;
 
 
@@ -52,6 +120,18 @@ private :
     float _maxInterval;
     float _update;
 
+    int  _bisect(const std::vector<GMlib::TSEdge<float>*>& split, std::vector<int>& parent);
+    void _insertLevel(int nc, const std::vector<int>& parent);
+    void _solve(const GMlib::DVector<float>& b, GMlib::DVector<float>& x);
+    int  _elementDofs(GMlib::DVector<int>& elem, int nt, std::unordered_map<const GMlib::TSEdge<float>*, int>& edge);
+    bool _isFree(GMlib::TSVertex<float>* v) const;
+    float _dirichletValue(const GMlib::TSVertex<float>* v) const;
+    void _splitBoundary(GMlib::TSVertex<float>* a, GMlib::TSVertex<float>* b, GMlib::TSVertex<float>* m);
+    void _applyBoundaryConditions();
+    static EdgeKey _edgeKey(const GMlib::TSVertex<float>* a, const GMlib::TSVertex<float>* b);
+    void _massMatrix();
+    void _advance(double dt);
+
 protected:
     void localSimulate(double dt);
 
@@ -27,6 +27,7 @@ GMlib::TSEdge<float>* Nodes::neighbour(Nodes &n)
         if(n.isThis(edge[i]->getOtherVertex(* _pt)))
             return edge[i];
     }
+    return nullptr;
 }
 //this implementation is to get triangles
 GMlib::Array<GMlib::TSTriangle<float>*> Nodes::getTriangles()